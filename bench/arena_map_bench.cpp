@@ -0,0 +1,92 @@
+/*
+ * PongX arena benchmark
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cmath>
+#include <cstdio>
+
+#include <benchmark/benchmark.h>
+
+#include "../src/game_math.hpp"
+#include "../src/Server/ArenaMap.hpp"
+
+///Small random circles and rects on a field that grows with their amount, so the density is the same
+static std::vector<ArenaMap::Obstacle> random_obstacles(unsigned int count, float& field_size) {
+	field_size = std::sqrt(static_cast<float>(count)) * 100.0F;
+	gm::Randomizer randomizer(1);
+	std::vector<ArenaMap::Obstacle> obstacles;
+	for (unsigned int i = 0; i < count; i++) {
+		float x = gm::random_number(randomizer, 0.0F, field_size);
+		float y = gm::random_number(randomizer, 0.0F, field_size);
+		if (i % 2 == 0)
+			obstacles.push_back({ ArenaMap::Circle, x, y, x, y, 15.0F });
+		else
+			obstacles.push_back({ ArenaMap::RoundedRect, x, y, x + 40.0F, y + 20.0F, 5.0F });
+	}
+	return obstacles;
+}
+
+//Query of the ball at random places. The argument is the amount of obstacles
+static void arena_query(benchmark::State& state) {
+	float field_size;
+	ArenaMap arena(random_obstacles(static_cast<unsigned int>(state.range(0)), field_size));
+	gm::Randomizer randomizer(2);
+	std::vector<sf::Vector2f> points(1024);
+	for (sf::Vector2f& point : points) {
+		point.x = gm::random_number(randomizer, 0.0F, field_size);
+		point.y = gm::random_number(randomizer, 0.0F, field_size);
+	}
+
+	std::size_t i = 0;
+	for (auto _ : state) {
+		ArenaMap::Contact contact;
+		benchmark::DoNotOptimize(arena.query(points[i++ % points.size()], 10.0F, contact));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(arena_query)->Arg(16)->Arg(1024)->Arg(65536)->Arg(1 << 20);
+
+//Baseline: the same query by checking every obstacle
+static void arena_query_brute_force(benchmark::State& state) {
+	float field_size;
+	std::vector<ArenaMap::Obstacle> obstacles =
+		random_obstacles(static_cast<unsigned int>(state.range(0)), field_size);
+	gm::Randomizer randomizer(2);
+	sf::Vector2f point(gm::random_number(randomizer, 0.0F, field_size),
+					   gm::random_number(randomizer, 0.0F, field_size));
+
+	for (auto _ : state) {
+		float distance = 1e9F;
+		sf::Vector2f normal;
+		for (const ArenaMap::Obstacle& obstacle : obstacles)
+			distance = std::min(distance, ArenaMap::obstacle_distance(obstacle, point, normal));
+		benchmark::DoNotOptimize(distance);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(arena_query_brute_force)->Arg(16)->Arg(1024)->Arg(65536);
+
+//Mapping of the baked arena file. The argument is the amount of obstacles
+static void arena_load(benchmark::State& state) {
+	float field_size;
+	std::string path = "pongx_arena_bench.pxa";
+	ArenaMap(random_obstacles(static_cast<unsigned int>(state.range(0)), field_size)).save(path);
+
+	for (auto _ : state)
+		benchmark::DoNotOptimize(ArenaMap::load(path));
+	std::remove(path.c_str());
+}
+BENCHMARK(arena_load)->Arg(1024)->Arg(1 << 20);
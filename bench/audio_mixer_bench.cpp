@@ -0,0 +1,42 @@
+/*
+ * PongX audio mixer benchmark
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <memory>
+
+#include <benchmark/benchmark.h>
+
+#include "../src/Audio/AudioMixer.hpp"
+
+//Mix a period of 128 frames with the argument amount of voices
+static void audio_mix_period(benchmark::State& state) {
+	std::shared_ptr<SoundBank> bank = std::make_shared<SoundBank>();
+	unsigned int tone = bank->add_tone(440.0F, 10.0F, 0.1F, 1.0F);
+	AudioMixer mixer(bank);
+	std::int16_t frames[2 * 128];
+	for (auto _ : state) {
+		//The tone is long, so the voices are restarted once per thousands of periods
+		if (mixer.get_active_voices() == 0) {
+			for (long long i = 0; i < state.range(0); i++)
+				mixer.execute({ 0, tone, 1.0F, 0.0F, PlaySound });
+		}
+		mixer.mix(frames, 128);
+		benchmark::DoNotOptimize(frames);
+	}
+	state.SetItemsProcessed(state.iterations() * 128);
+}
+BENCHMARK(audio_mix_period)->Arg(1)->Arg(8)->Arg(AudioMixer::MAX_VOICES);
@@ -0,0 +1,69 @@
+/*
+ * PongX ball path prediction benchmark
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+
+#include <benchmark/benchmark.h>
+
+#include "../src/game_math.hpp"
+#include "../src/Server/Server.hpp"
+
+///Server without paddles where the ball can be placed anywhere
+class BallOnlyServer : public Server {
+public:
+	BallOnlyServer(sf::Vector2u window_size, sf::Vector2f ball_pos, float ball_direction) : Server(window_size) {
+		this->ball_pos = ball_pos;
+		this->ball_direction = ball_direction;
+		ball_speed = 5.0F;
+		ball_radius = 10.0F;
+		player_rect = enemy_rect = sf::FloatRect({ -10000.0F, 0.0F }, { 1.0F, 1.0F });
+		waiting_for_input = false;
+	}
+
+	void update() override {
+		internal_update();
+	}
+};
+
+static const sf::Vector2u WINDOW_SIZE(1280, 720);
+static const float TARGET_X = 1250.0F;
+
+//Where the ball reaches the right paddle: step the server until it gets there
+static void ball_path_stepping(benchmark::State& state) {
+	float direction = 0.1F;
+	for (auto _ : state) {
+		BallOnlyServer server(WINDOW_SIZE, { 30.0F, 360.0F }, direction);
+		while (server.get_ball_pos().x < TARGET_X)
+			server.update();
+		benchmark::DoNotOptimize(server.get_ball_pos());
+		direction = direction < 1.2F ? direction + 0.01F : 0.1F; //Various amounts of bounces
+	}
+}
+BENCHMARK(ball_path_stepping);
+
+//The same with the closed-form prediction
+static void ball_path_closed_form(benchmark::State& state) {
+	float direction = 0.1F;
+	for (auto _ : state) {
+		gm::BallPath path;
+		gm::predict_ball_path({ 30.0F, 360.0F }, direction, 5.0F, 10.0F, WINDOW_SIZE, TARGET_X, path);
+		benchmark::DoNotOptimize(path);
+		direction = direction < 1.2F ? direction + 0.01F : 0.1F;
+	}
+}
+BENCHMARK(ball_path_closed_form);
@@ -0,0 +1,44 @@
+/*
+ * PongX batched environment benchmark
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../src/Env/BatchedEnv.hpp"
+
+//Steps of 4096 matches, the argument is the amount of threads
+static void batched_env_step(benchmark::State& state) {
+	const unsigned int env_count = 4096;
+	EnvSettings settings;
+	settings.threads = static_cast<unsigned int>(state.range(0));
+	BatchedEnv env(settings, env_count, nullptr);
+
+	std::vector<float> actions(env_count, 0.5F), observations(env_count * BatchedEnv::OBSERVATION_SIZE),
+		rewards(env_count);
+	std::vector<std::uint8_t> dones(env_count);
+	env.reset(observations.data());
+
+	for (auto _ : state) {
+		env.step(actions.data(), observations.data(), rewards.data(), dones.data());
+		for (unsigned int i = 0; i < env_count; i++) //Change the direction sometimes
+			actions[i] = observations[i * BatchedEnv::OBSERVATION_SIZE + 1] > 0.5F ? 1.0F : -1.0F;
+	}
+	state.SetItemsProcessed(state.iterations() * env_count);
+}
+BENCHMARK(batched_env_step)->Arg(1)->Arg(4)->Arg(0)->UseRealTime();
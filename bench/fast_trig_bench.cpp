@@ -0,0 +1,124 @@
+/*
+ * PongX fast trigonometry benchmark
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../src/fast_trig.hpp"
+#include "../src/game_math.hpp"
+
+///Amount of values per iteration
+constexpr std::size_t COUNT = 4096;
+
+///Random angles of the ball and vectors of its velocity
+struct TrigInput {
+	std::vector<float> angles, x, y;
+	std::vector<float> sin, cos, atan;
+
+	TrigInput() : angles(COUNT), x(COUNT), y(COUNT), sin(COUNT), cos(COUNT), atan(COUNT) {
+		gm::Randomizer randomizer(1);
+		for (std::size_t i = 0; i < COUNT; i++) {
+			angles[i] = gm::random_number(randomizer, -10.0F, 10.0F);
+			x[i] = gm::random_number(randomizer, -20.0F, 20.0F);
+			y[i] = gm::random_number(randomizer, -20.0F, 20.0F);
+		}
+	}
+
+	///Maximal errors of the results against the double functions
+	void report_errors(benchmark::State& state, bool has_sin_cos) {
+		double max_error = 0.0;
+		for (std::size_t i = 0; i < COUNT; i++) {
+			if (has_sin_cos) {
+				max_error = std::max(max_error, std::abs(sin[i] - std::sin(static_cast<double>(angles[i]))));
+				max_error = std::max(max_error, std::abs(cos[i] - std::cos(static_cast<double>(angles[i]))));
+			} else {
+				max_error = std::max(max_error, std::abs(atan[i] - std::atan2(static_cast<double>(y[i]), x[i])));
+			}
+		}
+		state.counters["max_error"] = max_error;
+		state.SetItemsProcessed(state.iterations() * COUNT);
+	}
+};
+
+static void sin_cos_std(benchmark::State& state) {
+	TrigInput input;
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < COUNT; i++) {
+			input.sin[i] = std::sin(input.angles[i]);
+			input.cos[i] = std::cos(input.angles[i]);
+		}
+		benchmark::ClobberMemory();
+	}
+	input.report_errors(state, true);
+}
+BENCHMARK(sin_cos_std);
+
+static void sin_cos_fast(benchmark::State& state) {
+	TrigInput input;
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < COUNT; i++)
+			gm::fast_sin_cos(input.angles[i], input.sin[i], input.cos[i]);
+		benchmark::ClobberMemory();
+	}
+	input.report_errors(state, true);
+}
+BENCHMARK(sin_cos_fast);
+
+static void sin_cos_fast_array(benchmark::State& state) {
+	TrigInput input;
+	for (auto _ : state) {
+		gm::fast_sin_cos(input.angles.data(), input.sin.data(), input.cos.data(), COUNT);
+		benchmark::ClobberMemory();
+	}
+	input.report_errors(state, true);
+}
+BENCHMARK(sin_cos_fast_array);
+
+static void atan2_std(benchmark::State& state) {
+	TrigInput input;
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < COUNT; i++)
+			input.atan[i] = std::atan2(input.y[i], input.x[i]);
+		benchmark::ClobberMemory();
+	}
+	input.report_errors(state, false);
+}
+BENCHMARK(atan2_std);
+
+static void atan2_fast(benchmark::State& state) {
+	TrigInput input;
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < COUNT; i++)
+			input.atan[i] = gm::fast_atan2(input.y[i], input.x[i]);
+		benchmark::ClobberMemory();
+	}
+	input.report_errors(state, false);
+}
+BENCHMARK(atan2_fast);
+
+static void atan2_fast_array(benchmark::State& state) {
+	TrigInput input;
+	for (auto _ : state) {
+		gm::fast_atan2(input.y.data(), input.x.data(), input.atan.data(), COUNT);
+		benchmark::ClobberMemory();
+	}
+	input.report_errors(state, false);
+}
+BENCHMARK(atan2_fast_array);
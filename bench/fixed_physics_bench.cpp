@@ -0,0 +1,43 @@
+/*
+ * PongX fixed-point physics benchmark
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <memory>
+
+#include <benchmark/benchmark.h>
+
+#include "../src/Server/Server.hpp"
+
+//One tick of the match with the moving paddles. The argument is the PhysicsBackend
+static void physics_tick(benchmark::State& state) {
+	ServerSettings settings;
+	settings.server_type = LocalNetworkHost;
+	settings.physics = static_cast<PhysicsBackend>(state.range(0));
+	settings.window_size = { 1280, 720 };
+	settings.seed = 1;
+	std::unique_ptr<Server> server(Server::create(settings));
+
+	unsigned int tick = 0;
+	for (auto _ : state) {
+		server->player_relative_speed = (tick & 64) != 0 ? 1.0F : -1.0F;
+		server->set_enemy_relative_speed((tick & 128) != 0 ? 1.0F : -1.0F);
+		server->update();
+		tick++;
+	}
+	benchmark::DoNotOptimize(server->get_ball_pos());
+}
+BENCHMARK(physics_tick)->Arg(FloatPhysics)->Arg(FixedPointPhysics);
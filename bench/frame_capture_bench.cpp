@@ -0,0 +1,59 @@
+/*
+ * PongX frame capture benchmark
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../src/Render/FrameCapture.hpp"
+
+///Start the capture of 1280x720 frames into the temporary video
+static std::unique_ptr<FrameCapture> start_video(CapturePolicy policy) {
+	FrameCaptureSettings settings;
+	settings.path = "pongx_capture_bench.y4m";
+	settings.policy = policy;
+	return FrameCapture::start(settings);
+}
+
+//Cost of capture() for the renderer when the encoder can not keep up (most frames are dropped)
+static void capture_frame_render_thread(benchmark::State& state) {
+	std::vector<std::uint8_t> pixels(1280 * 720 * 4, 100);
+	std::unique_ptr<FrameCapture> capture = start_video(DropNewFrames);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(capture->capture(pixels.data(), 1280, 720));
+	state.counters["dropped"] = static_cast<double>(capture->get_dropped_frames());
+	capture.reset();
+	std::remove("pongx_capture_bench.y4m");
+}
+BENCHMARK(capture_frame_render_thread)->Unit(benchmark::kMicrosecond);
+
+//Frames converted and written per second, nothing is dropped
+static void capture_frame_encoded(benchmark::State& state) {
+	std::vector<std::uint8_t> pixels(1280 * 720 * 4, 100);
+	std::unique_ptr<FrameCapture> capture = start_video(BlockRenderer);
+	for (auto _ : state)
+		capture->capture(pixels.data(), 1280, 720);
+	capture->flush();
+	state.counters["fps"] = benchmark::Counter(static_cast<double>(state.iterations()),
+											   benchmark::Counter::kIsRate);
+	capture.reset();
+	std::remove("pongx_capture_bench.y4m");
+}
+BENCHMARK(capture_frame_encoded)->Unit(benchmark::kMicrosecond)->UseRealTime();
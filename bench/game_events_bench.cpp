@@ -0,0 +1,50 @@
+/*
+ * PongX game events benchmark
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <memory>
+
+#include <benchmark/benchmark.h>
+
+#include "../src/Server/GameEvents.hpp"
+
+//The cost of an event for the simulation step
+static void game_event_publish(benchmark::State& state) {
+	GameEventBus bus(1024);
+	GameEvent event = { 0, 1.0F, 2.0F, PaddleHit, 4, true };
+	for (auto _ : state) {
+		bus.publish(event);
+		event.tick++;
+	}
+}
+BENCHMARK(game_event_publish);
+
+//Publish and take the events in batches of the argument
+static void game_event_batch(benchmark::State& state) {
+	std::size_t batch = static_cast<std::size_t>(state.range(0));
+	std::shared_ptr<GameEventBus> bus = std::make_shared<GameEventBus>(1024);
+	GameEventSubscriber subscriber(bus);
+	GameEvent event = { 0, 1.0F, 2.0F, WallBounce, 1, false };
+	GameEvent events[256];
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < batch; i++)
+			bus->publish(event);
+		benchmark::DoNotOptimize(subscriber.poll(events, batch));
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<long long>(batch));
+}
+BENCHMARK(game_event_batch)->Arg(1)->Arg(64)->Arg(256);
@@ -0,0 +1,61 @@
+/*
+ * PongX benchmarks of the analog stick sampling
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+
+#include "../src/Input/JoystickSampler.hpp"
+
+///Stick that moves on every read, so every read is a sample
+class SweepingJoystickDevice : public JoystickDevice {
+public:
+	bool read(float& position) override {
+		reads++;
+		position = static_cast<float>(reads % 200) / 100.0F - 1.0F;
+		return true;
+	}
+
+private:
+	unsigned int reads = 0;
+};
+
+//Frames of 60 FPS against the sampler at 1 kHz: the cost of the latch of every sample of the frame
+//and the rate that the sampling thread really reaches
+static void joystick_frame_latch(benchmark::State& state) {
+	std::unique_ptr<JoystickSampler> sampler =
+		JoystickSampler::start(std::unique_ptr<JoystickDevice>(new SweepingJoystickDevice()));
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (auto _ : state) {
+		state.PauseTiming();
+		std::this_thread::sleep_for(std::chrono::microseconds(16667));
+		state.ResumeTiming();
+
+		InputSnapshot snapshot;
+		snapshot.latch_time = sf::microseconds(std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now() - start).count());
+		sampler->latch(snapshot);
+		benchmark::DoNotOptimize(snapshot.stick);
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	state.counters["reads_per_second"] = static_cast<double>(sampler->get_read_count()) / seconds;
+	state.counters["max_read_interval_us"] = static_cast<double>(sampler->get_max_read_interval().asMicroseconds());
+}
+BENCHMARK(joystick_frame_latch)->Iterations(60);
@@ -0,0 +1,76 @@
+/*
+ * PongX match snapshot benchmark
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../src/Server/Server.hpp"
+
+static std::unique_ptr<Server> snapshot_server() {
+	ServerSettings settings;
+	settings.server_type = LocalNetworkHost;
+	settings.window_size = { 1280, 720 };
+	settings.seed = 1;
+	std::unique_ptr<Server> server(Server::create(settings));
+	server->serve();
+	server->update();
+	return server;
+}
+
+//The state of the match through the getters, as the view read it before the snapshots
+static void snapshot_getters(benchmark::State& state) {
+	std::unique_ptr<Server> server = snapshot_server();
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(server->get_ball_pos());
+		benchmark::DoNotOptimize(server->get_ball_dir());
+		benchmark::DoNotOptimize(server->get_player_rect());
+		benchmark::DoNotOptimize(server->get_enemy_rect());
+		benchmark::DoNotOptimize(server->get_player_score());
+		benchmark::DoNotOptimize(server->get_enemy_score());
+	}
+}
+BENCHMARK(snapshot_getters);
+
+//Write the snapshot straight into the send buffer and view it in place on the other side
+static void snapshot_write_view(benchmark::State& state) {
+	std::unique_ptr<Server> server = snapshot_server();
+	std::vector<std::uint64_t> buffer(sizeof(MatchSnapshot) / sizeof(std::uint64_t));
+	for (auto _ : state) {
+		server->write_snapshot(*reinterpret_cast<MatchSnapshot*>(buffer.data()));
+		benchmark::ClobberMemory();
+		benchmark::DoNotOptimize(MatchSnapshot::view(buffer.data(), sizeof(MatchSnapshot))->ball_x);
+	}
+	state.SetBytesProcessed(state.iterations() * sizeof(MatchSnapshot));
+}
+BENCHMARK(snapshot_write_view);
+
+static void snapshot_quantize(benchmark::State& state) {
+	std::unique_ptr<Server> server = snapshot_server();
+	MatchSnapshot snapshot, decoded;
+	server->write_snapshot(snapshot);
+	QuantizedSnapshot quantized;
+	for (auto _ : state) {
+		quantized.encode(snapshot);
+		benchmark::DoNotOptimize(quantized.decode(snapshot, decoded));
+		benchmark::ClobberMemory();
+	}
+	state.SetBytesProcessed(state.iterations() * sizeof(QuantizedSnapshot));
+}
+BENCHMARK(snapshot_quantize);
@@ -0,0 +1,49 @@
+/*
+ * PongX metrics benchmark
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "../src/Utils/Metrics.hpp"
+
+static MetricCounter bench_counter("pongx_bench_events_total", "Events of the benchmark");
+static MetricHistogram bench_histogram("pongx_bench_duration_seconds", "Durations of the benchmark",
+									   { 50, 100, 200, 400, 800, 1600, 3200, 6400, 12800 }, 1e-9);
+
+//Recording on the hot path, every thread into its own shard
+static void metric_counter_add(benchmark::State& state) {
+	for (auto _ : state)
+		bench_counter.add();
+	benchmark::DoNotOptimize(bench_counter.get());
+}
+BENCHMARK(metric_counter_add)->Threads(1)->Threads(4);
+
+static void metric_histogram_record(benchmark::State& state) {
+	std::uint64_t value = 0;
+	for (auto _ : state) {
+		bench_histogram.record(value);
+		value = (value + 97) & 4095;
+	}
+}
+BENCHMARK(metric_histogram_record);
+
+//The clock is the expensive part of a measurement
+static void metric_timer(benchmark::State& state) {
+	for (auto _ : state)
+		MetricTimer timer(bench_histogram);
+}
+BENCHMARK(metric_timer);
@@ -0,0 +1,40 @@
+/*
+ * PongX multi-ball world benchmark
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "../src/Server/MultiBallWorld.hpp"
+
+//One tick of the chaos mode: move, grid, ball-ball and paddle collisions. The argument is the amount of balls
+static void multi_ball_tick(benchmark::State& state) {
+	MultiBallWorld world({ 1280, 720 }, static_cast<unsigned int>(state.range(0)), 10.0F, 5.0F, 1);
+	sf::FloatRect player_rect({ 10.0F, 250.0F }, { 45.0F, 225.0F });
+	sf::FloatRect enemy_rect({ 1225.0F, 250.0F }, { 45.0F, 225.0F });
+
+	unsigned int player_points, enemy_points;
+	//Let the balls spread over the field first
+	for (unsigned int i = 0; i < 200; i++)
+		world.update(player_rect, enemy_rect, player_points, enemy_points);
+
+	for (auto _ : state) {
+		world.update(player_rect, enemy_rect, player_points, enemy_points);
+		benchmark::DoNotOptimize(player_points);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(multi_ball_tick)->Arg(500)->Arg(2000)->Arg(5000);
@@ -0,0 +1,81 @@
+/*
+ * PongX paddle AI benchmark
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../src/Server/SingleplayerServer.hpp"
+
+//Ticks of bot-vs-bot games: the enemy is controlled by the server's AI, the player by one more AI
+static void bot_vs_bot_tick(benchmark::State& state) {
+	ServerSettings settings;
+	settings.server_type = Singleplayer;
+	settings.window_size = { 1280, 720 };
+	settings.seed = 1;
+
+	std::vector<std::unique_ptr<Server>> servers;
+	std::vector<PaddleAI> player_ais;
+	for (int i = 0; i < state.range(0); i++) {
+		servers.emplace_back(Server::create(settings));
+		player_ais.emplace_back(i + 1);
+		player_ais.back().set_difficulty(settings.ai_reaction_delay, settings.ai_error);
+	}
+
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < servers.size(); i++) {
+			Server& server = *servers[i];
+			float speed = player_ais[i].update(server.get_player_rect(), server.get_ball_pos(),
+											   server.get_ball_dir(), server.get_ball_radius(),
+											   server.get_window_size());
+			server.player_relative_speed = speed != 0.0F ? speed : 0.1F; //Serve if the ball waits
+			server.update();
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bot_vs_bot_tick)->Arg(1)->Arg(10000);
+
+//The same ticks through the exact type of the server: the step has no virtual call
+static void bot_vs_bot_step(benchmark::State& state) {
+	ServerSettings settings;
+	settings.window_size = { 1280, 720 };
+	settings.seed = 1;
+
+	std::vector<std::unique_ptr<SingleplayerServer<>>> servers;
+	std::vector<PaddleAI> player_ais;
+	for (int i = 0; i < state.range(0); i++) {
+		servers.emplace_back(new SingleplayerServer<>(settings));
+		player_ais.emplace_back(i + 1);
+		player_ais.back().set_difficulty(settings.ai_reaction_delay, settings.ai_error);
+	}
+
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < servers.size(); i++) {
+			SingleplayerServer<>& server = *servers[i];
+			float speed = player_ais[i].update(server.get_player_rect(), server.get_ball_pos(),
+											   server.get_ball_dir(), server.get_ball_radius(),
+											   server.get_window_size());
+			server.player_relative_speed = speed != 0.0F ? speed : 0.1F; //Serve if the ball waits
+			server.step();
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bot_vs_bot_step)->Arg(1)->Arg(10000);
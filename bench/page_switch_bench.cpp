@@ -0,0 +1,90 @@
+/*
+ * PongX page switch benchmark
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../src/Pages/StartGamePage.hpp"
+#include "../src/UI/Button.hpp"
+#include "../src/UI/Label.hpp"
+#include "../src/UI/SpinBox.hpp"
+
+///Window is not opened, controls only need its size
+static sf::RenderWindow window;
+
+//Construction and destruction of the page with controls in the arena and the page in the BlockPool
+static void page_switch_pooled(benchmark::State& state) {
+	for (auto _ : state) {
+		Page* page = new StartGamePage(&window, LocalMultiplayer);
+		benchmark::DoNotOptimize(page);
+		delete page;
+	}
+}
+BENCHMARK(page_switch_pooled);
+
+///Set up the spinbox like StartGamePage does
+static void init_spinbox(SpinBox* spinbox) {
+	spinbox->set_minimal(1.0F);
+	spinbox->set_maximum(50.0F);
+	spinbox->set_step(1.0F);
+	spinbox->set_value(5.0F);
+	spinbox->set_precision(0);
+	spinbox->update_text();
+}
+
+//The same work as StartGamePage does, but every control and the page are allocated separately
+static void page_switch_heap(benchmark::State& state) {
+	for (auto _ : state) {
+		InputDispatcher* dispatcher = new InputDispatcher();
+		dispatcher->init(&window);
+		std::vector<UIControl*>* ui_list = new std::vector<UIControl*>();
+
+		Button* start_button = new Button(&window, { -25, -25 }, UIControl::RightBottom, UIControl::RightBottom,
+										  { 400, 100 }, "Start", 72);
+		start_button->set_callback([]() { });
+		Button* back_button = new Button(&window, { 25, -25 }, UIControl::LeftBottom, UIControl::LeftBottom,
+										 { 400, 100 }, "Back", 72);
+		back_button->set_callback([]() { });
+		SpinBox* ball_size_spinbox = new SpinBox(&window, { 25, 60 }, UIControl::LeftTop, UIControl::LeftTop,
+												 { 200, 75 }, 40);
+		init_spinbox(ball_size_spinbox);
+		SpinBox* ball_speed_spinbox = new SpinBox(&window, { 25, 180 }, UIControl::LeftTop, UIControl::LeftTop,
+												  { 200, 75 }, 40);
+		init_spinbox(ball_speed_spinbox);
+
+		ui_list->push_back(start_button);
+		ui_list->push_back(back_button);
+		ui_list->push_back(new Label(&window, "Ball size", { 25, 25 }, UIControl::LeftTop, UIControl::LeftTop, 36));
+		ui_list->push_back(ball_size_spinbox);
+		ui_list->push_back(new Label(&window, "Ball speed", { 25, 145 }, UIControl::LeftTop, UIControl::LeftTop,
+									 36));
+		ui_list->push_back(ball_speed_spinbox);
+		for (UIControl* control : *ui_list) {
+			if (control->is_interactive())
+				dispatcher->add(control);
+		}
+		benchmark::DoNotOptimize(ui_list->data());
+
+		for (unsigned int i = 0; i < ui_list->size(); i++)
+			delete (*ui_list)[i];
+		delete ui_list;
+		delete dispatcher;
+	}
+}
+BENCHMARK(page_switch_heap);
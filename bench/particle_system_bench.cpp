@@ -0,0 +1,66 @@
+/*
+ * PongX particle system benchmark
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../src/Render/ParticleSystem.hpp"
+
+//A frame of the full pool: update, emit the replacement of the dead particles, build the vertices
+static void particle_frame(benchmark::State& state) {
+	std::size_t capacity = static_cast<std::size_t>(state.range(0));
+	ParticleSystem particles(capacity, 300, 2);
+	ParticleBurst burst;
+	burst.position = { 640, 360 };
+	burst.min_speed = 50;
+	burst.max_speed = 500;
+	//Lives from 0.2 to 1.9 s, so some of the particles die every frame
+	auto refill = [&]() {
+		for (unsigned int i = 0; particles.size() < capacity; i++) {
+			burst.count = 1000;
+			burst.life = 0.2F + static_cast<float>(i % 18) * 0.1F;
+			particles.emit(burst);
+		}
+	};
+	refill();
+
+	std::vector<sf::Vertex> vertices;
+	for (auto _ : state) {
+		particles.update(1.0F / 60);
+		refill();
+		particles.build_vertices(vertices);
+		benchmark::DoNotOptimize(vertices.data());
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<long long>(capacity));
+}
+BENCHMARK(particle_frame)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+//Only the update kernels (integrate, fade, cull) of the full pool
+static void particle_update(benchmark::State& state) {
+	ParticleSystem particles(100000);
+	ParticleBurst burst;
+	burst.count = 100000;
+	burst.max_speed = 100;
+	burst.life = 1e9F;
+	particles.emit(burst);
+	for (auto _ : state)
+		particles.update(1.0F / 60);
+	state.SetItemsProcessed(state.iterations() * 100000);
+}
+BENCHMARK(particle_update)->Unit(benchmark::kMicrosecond);
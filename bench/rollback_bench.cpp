@@ -0,0 +1,62 @@
+/*
+ * PongX rollback benchmark
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "../src/Net/RollbackSession.hpp"
+
+//Rollback of the session by the argument amount of ticks: the remote input of the oldest tick arrives
+//and differs from the prediction, so the savestate is restored and the ticks are simulated again
+static void rollback_resimulate(benchmark::State& state) {
+	unsigned int ticks = static_cast<unsigned int>(state.range(0));
+	ServerSettings settings;
+	settings.window_size = { 1280, 720 };
+	settings.seed = 1;
+
+	RollbackSession session(settings, true, 64);
+	unsigned int remote_tick = 0;
+	PeerInput remote_input = 1;
+	for (auto _ : state) {
+		state.PauseTiming();
+		//The session runs ahead of the remote inputs
+		while (session.get_tick() < remote_tick + ticks)
+			session.advance(100);
+		//Always different from the prediction
+		remote_input = static_cast<PeerInput>(-remote_input);
+		session.receive_remote_input(remote_tick++, remote_input);
+		state.ResumeTiming();
+
+		session.resimulate();
+	}
+	state.SetItemsProcessed(state.iterations() * ticks);
+}
+BENCHMARK(rollback_resimulate)->Arg(1)->Arg(10)->Arg(30);
+
+//Savestate of the server, done every tick by the session
+static void server_save_state(benchmark::State& state) {
+	ServerSettings settings;
+	settings.server_type = LocalNetworkHost;
+	settings.window_size = { 1280, 720 };
+	std::unique_ptr<Server> server(Server::create(settings));
+	ServerState saved;
+	for (auto _ : state) {
+		server->save_state(saved);
+		benchmark::DoNotOptimize(saved);
+	}
+}
+BENCHMARK(server_save_state);
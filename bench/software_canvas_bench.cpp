@@ -0,0 +1,62 @@
+/*
+ * PongX software rasterizer benchmark
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../src/Render/MatchPainter.hpp"
+#include "../src/Render/ParticleSystem.hpp"
+#include "../src/Server/Server.hpp"
+
+//A 1280x720 frame of the match with 2000 particles: painting (recording and binning) and rasterization.
+//The argument is the amount of threads (0 - one per hardware thread)
+static void software_frame(benchmark::State& state) {
+	ServerSettings settings;
+	settings.server_type = Singleplayer;
+	settings.window_size = { 1280, 720 };
+	std::unique_ptr<Server> server(Server::create(settings));
+	server->serve();
+	MatchSnapshot snapshot;
+
+	ParticleSystem particles(4096);
+	ParticleBurst burst;
+	burst.position = { 640, 360 };
+	burst.count = 2000;
+	burst.max_speed = 300;
+	burst.life = 1e9F;
+	burst.size = 3;
+	particles.emit(burst);
+	particles.update(1.0F);
+	std::vector<sf::Vertex> particle_vertices;
+	particles.build_vertices(particle_vertices);
+
+	SoftwareCanvas canvas(1280, 720, static_cast<unsigned int>(state.range(0)));
+	MatchPainter painter;
+	for (auto _ : state) {
+		server->update();
+		server->write_snapshot(snapshot);
+		painter.paint(canvas, snapshot, &particle_vertices);
+		canvas.render();
+		benchmark::DoNotOptimize(canvas.get_pixels());
+	}
+	state.counters["fps"] = benchmark::Counter(static_cast<double>(state.iterations()),
+											   benchmark::Counter::kIsRate);
+}
+BENCHMARK(software_frame)->Arg(1)->Arg(0)->Unit(benchmark::kMicrosecond)->UseRealTime();
@@ -0,0 +1,98 @@
+/*
+ * PongX spectator relay benchmark
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../src/Net/SpectatorRelay.hpp"
+#include "../src/Server/Server.hpp"
+
+///Loopback spectator: takes every byte and only counts them
+class CountingConnection : public SpectatorConnection {
+public:
+	long send(const SendChunk* chunks, unsigned int count) override {
+		long sent = 0;
+		for (unsigned int i = 0; i < count; i++) {
+			benchmark::DoNotOptimize(*static_cast<const char*>(chunks[i].data));
+			sent += static_cast<long>(chunks[i].size);
+		}
+		received += static_cast<unsigned long long>(sent);
+		return sent;
+	}
+
+	unsigned long long received = 0;
+};
+
+static std::unique_ptr<Server> spectated_server() {
+	ServerSettings settings;
+	settings.server_type = LocalNetworkHost;
+	settings.window_size = { 1280, 720 };
+	settings.seed = 1;
+	std::unique_ptr<Server> server(Server::create(settings));
+	server->serve();
+	return server;
+}
+
+//One tick of the match sent to the spectators (the argument) with 4 different delays.
+//cpu_per_viewer is the CPU time per spectator per tick
+static void spectator_relay_tick(benchmark::State& state) {
+	unsigned int viewers = static_cast<unsigned int>(state.range(0));
+	std::unique_ptr<Server> server = spectated_server();
+	SpectatorRelay relay(600, 120, 60);
+	for (unsigned int i = 0; i < viewers; i++)
+		relay.add_viewer(std::unique_ptr<SpectatorConnection>(new CountingConnection()), (i % 4) * 30);
+
+	MatchSnapshot snapshot;
+	for (auto _ : state) {
+		server->update();
+		server->write_snapshot(snapshot);
+		relay.publish(snapshot);
+	}
+	double viewer_ticks = static_cast<double>(state.iterations()) * viewers;
+	state.counters["cpu_per_viewer"] = benchmark::Counter(viewer_ticks, benchmark::Counter::kIsRate |
+																		 benchmark::Counter::kInvert);
+	state.counters["dropped"] = static_cast<double>(relay.get_dropped_viewers());
+	state.SetBytesProcessed(static_cast<long long>(relay.get_sent_bytes()));
+}
+BENCHMARK(spectator_relay_tick)->Arg(1000)->Arg(10000);
+
+//The naive way for comparison: the state is serialized for every spectator
+static void spectator_encode_per_viewer(benchmark::State& state) {
+	unsigned int viewers = static_cast<unsigned int>(state.range(0));
+	std::unique_ptr<Server> server = spectated_server();
+	std::vector<CountingConnection> connections(viewers);
+
+	for (auto _ : state) {
+		server->update();
+		for (CountingConnection& connection : connections) {
+			MatchSnapshot snapshot;
+			server->write_snapshot(snapshot);
+			QuantizedSnapshot quantized;
+			quantized.encode(snapshot);
+			SendChunk chunk = { &quantized, sizeof(quantized) };
+			connection.send(&chunk, 1);
+		}
+	}
+	double viewer_ticks = static_cast<double>(state.iterations()) * viewers;
+	state.counters["cpu_per_viewer"] = benchmark::Counter(viewer_ticks, benchmark::Counter::kIsRate |
+																		 benchmark::Counter::kInvert);
+}
+BENCHMARK(spectator_encode_per_viewer)->Arg(10000);
@@ -0,0 +1,87 @@
+/*
+ * PongX training environment C API
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <new>
+
+#include "../src/Env/BatchedEnv.hpp"
+#include "pongx_env.h"
+
+///The C handle is the batch itself
+struct pongx_env {
+	BatchedEnv batch;
+
+	pongx_env(const EnvSettings& settings, uint32_t num_envs, const uint64_t* seeds) :
+		batch(settings, num_envs, seeds) { }
+};
+
+uint32_t pongx_env_abi_version(void) {
+	return PONGX_ENV_ABI_VERSION;
+}
+
+void pongx_env_default_config(pongx_env_config* config) {
+	EnvSettings settings;
+	config->window_width = settings.window_size.x;
+	config->window_height = settings.window_size.y;
+	config->ball_radius = settings.ball_radius;
+	config->ball_speed = settings.ball_speed;
+	config->ai_reaction_delay = settings.ai_reaction_delay;
+	config->ai_error = settings.ai_error;
+	config->points_to_win = settings.points_to_win;
+	config->max_steps = settings.max_steps;
+	config->threads = settings.threads;
+}
+
+pongx_env* pongx_env_create(const pongx_env_config* config, uint32_t num_envs, const uint64_t* seeds) {
+	if (config == nullptr || num_envs == 0 || config->points_to_win == 0 ||
+		config->ball_radius <= 0.0F || config->ball_speed <= 0.0F ||
+		config->window_height <= 2.0F * config->ball_radius)
+		return nullptr;
+
+	EnvSettings settings;
+	settings.window_size = { config->window_width, config->window_height };
+	settings.ball_radius = config->ball_radius;
+	settings.ball_speed = config->ball_speed;
+	settings.ai_reaction_delay = config->ai_reaction_delay;
+	settings.ai_error = config->ai_error;
+	settings.points_to_win = config->points_to_win;
+	settings.max_steps = config->max_steps;
+	settings.threads = config->threads;
+
+	//Exceptions must not cross the C boundary
+	try {
+		return new pongx_env(settings, num_envs, seeds);
+	} catch (...) {
+		return nullptr;
+	}
+}
+
+void pongx_env_destroy(pongx_env* env) {
+	delete env;
+}
+
+uint32_t pongx_env_num_envs(const pongx_env* env) {
+	return env->batch.get_env_count();
+}
+
+void pongx_env_reset(pongx_env* env, float* observations) {
+	env->batch.reset(observations);
+}
+
+void pongx_env_step(pongx_env* env, const float* actions, float* observations, float* rewards, uint8_t* dones) {
+	env->batch.step(actions, observations, rewards, dones);
+}
@@ -0,0 +1,97 @@
+/*
+ * PongX training environment C API
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PONGX_ENV_H
+#define PONGX_ENV_H
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+	#if defined(PONGX_ENV_BUILD)
+		#define PONGX_ENV_API __declspec(dllexport)
+	#else
+		#define PONGX_ENV_API __declspec(dllimport)
+	#endif
+#else
+	#define PONGX_ENV_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Version of this interface. It changes only when existing functions or structures change */
+#define PONGX_ENV_ABI_VERSION 1
+
+/* Amount of floats in the observation of one match:
+ * ball X, ball Y, ball direction cos, ball direction sin, player center Y, enemy center Y.
+ * Positions are divided by the window size */
+#define PONGX_ENV_OBSERVATION_SIZE 6
+
+/* Batch of singleplayer matches: the controller plays for the player against the AI enemy */
+typedef struct pongx_env pongx_env;
+
+/* Settings of every match. Fill it with pongx_env_default_config() and change what is needed */
+typedef struct pongx_env_config {
+	uint32_t window_width, window_height;
+	float ball_radius, ball_speed;
+	/* Ticks between the change of the ball direction and the reaction of the AI */
+	uint32_t ai_reaction_delay;
+	/* Maximal error of the AI in pixels */
+	float ai_error;
+	/* The match is done when someone has this amount of points */
+	uint32_t points_to_win;
+	/* The match is done (truncated) after this amount of steps, 0 - no limit */
+	uint32_t max_steps;
+	/* Amount of threads that step the matches, 0 - one per hardware thread */
+	uint32_t threads;
+} pongx_env_config;
+
+/* Get PONGX_ENV_ABI_VERSION of the loaded library */
+PONGX_ENV_API uint32_t pongx_env_abi_version(void);
+
+PONGX_ENV_API void pongx_env_default_config(pongx_env_config* config);
+
+/* Create num_envs matches. seeds: num_envs seeds, or NULL for 1, 2, 3...
+ * The same seed and the same actions give the same match.
+ * Returns NULL if the config is invalid */
+PONGX_ENV_API pongx_env* pongx_env_create(const pongx_env_config* config, uint32_t num_envs,
+										  const uint64_t* seeds);
+
+PONGX_ENV_API void pongx_env_destroy(pongx_env* env);
+
+PONGX_ENV_API uint32_t pongx_env_num_envs(const pongx_env* env);
+
+/* Start all matches from the beginning.
+ * observations: num_envs * PONGX_ENV_OBSERVATION_SIZE floats */
+PONGX_ENV_API void pongx_env_reset(pongx_env* env, float* observations);
+
+/* Step every match. Buffers belong to the caller, nothing is allocated.
+ * actions: num_envs speeds of the player (1 - max down, 0 - static, -1 - max up)
+ * observations: num_envs * PONGX_ENV_OBSERVATION_SIZE floats
+ * rewards: num_envs floats, 1 if the player scored on this step, -1 if the enemy scored, 0 otherwise
+ * dones: num_envs bytes, 1 if the match is done. Done matches are reset at once and
+ * their observation is the first observation of the next match */
+PONGX_ENV_API void pongx_env_step(pongx_env* env, const float* actions, float* observations, float* rewards,
+								  uint8_t* dones);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,153 @@
+/*
+ * PongX audio output devices
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AudioDevice.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+unsigned int AudioDevice::get_min_period(unsigned int) const {
+	return 1;
+}
+
+NullAudioDevice::NullAudioDevice(bool realtime) : realtime(realtime) { }
+
+bool NullAudioDevice::open(unsigned int sample_rate, unsigned int period) {
+	this->period = period;
+	period_time = std::chrono::nanoseconds(1000000000LL * period / sample_rate);
+	started = false;
+	return true;
+}
+
+void NullAudioDevice::write(const std::int16_t* frames) {
+	std::int32_t new_peak = peak.load(std::memory_order_relaxed);
+	for (unsigned int i = 0; i < 2 * period; i++)
+		new_peak = std::max(new_peak, std::abs(static_cast<std::int32_t>(frames[i])));
+	peak.store(new_peak, std::memory_order_relaxed);
+	written_frames.fetch_add(period, std::memory_order_relaxed);
+	if (!realtime)
+		return;
+
+	//The hardware plays one period while the next one is mixed
+	auto now = std::chrono::steady_clock::now();
+	if (!started) {
+		started = true;
+		play_end = now;
+	} else if (now < play_end) {
+		std::this_thread::sleep_until(play_end);
+	} else if (now - play_end > period_time / 4) {
+		//The mixer was late, so there was silence
+		underruns.fetch_add(1, std::memory_order_relaxed);
+		play_end = now;
+	}
+	play_end += period_time;
+}
+
+sf::Time NullAudioDevice::get_buffered_time() const {
+	if (!realtime)
+		return sf::Time::Zero;
+	return sf::microseconds(std::chrono::duration_cast<std::chrono::microseconds>(period_time).count());
+}
+
+std::uint64_t NullAudioDevice::get_underruns() const {
+	return underruns.load(std::memory_order_relaxed);
+}
+
+std::uint64_t NullAudioDevice::get_written_frames() const {
+	return written_frames.load(std::memory_order_relaxed);
+}
+
+std::int32_t NullAudioDevice::get_peak() const {
+	return peak.load(std::memory_order_relaxed);
+}
+
+SfmlAudioDevice::~SfmlAudioDevice() {
+	//The stream thread calls onGetData() until it is stopped
+	stop();
+}
+
+bool SfmlAudioDevice::open(unsigned int sample_rate, unsigned int period) {
+	this->sample_rate = sample_rate;
+	this->period = period;
+	ring.reset(new std::int16_t[2 * period * (RING_PERIODS + 1)]());
+	initialize(2, sample_rate);
+	play();
+	return getStatus() == Playing;
+}
+
+unsigned int SfmlAudioDevice::get_min_period(unsigned int sample_rate) const {
+	unsigned int period = 1;
+	while (1000ULL * period <= 1ULL * REFILL_INTERVAL_MS * sample_rate)
+		period *= 2;
+	return period;
+}
+
+void SfmlAudioDevice::write(const std::int16_t* frames) {
+	auto period_time = std::chrono::microseconds(1000000LL * period / sample_rate);
+	std::uint64_t index = written.load(std::memory_order_relaxed);
+	while (index - taken.load(std::memory_order_acquire) >= RING_PERIODS) {
+		//Nobody takes the periods, so drop them at the speed of the playback
+		if (getStatus() != Playing) {
+			std::this_thread::sleep_for(period_time);
+			return;
+		}
+		std::this_thread::sleep_for(period_time / 4);
+	}
+	std::memcpy(&ring[2 * period * (index % RING_PERIODS)], frames, 2 * period * sizeof(std::int16_t));
+	written.store(index + 1, std::memory_order_release);
+}
+
+sf::Time SfmlAudioDevice::get_buffered_time() const {
+	//Load taken first, so written is not older than it
+	std::uint64_t taken_periods = taken.load(std::memory_order_acquire);
+	std::uint64_t queued = written.load(std::memory_order_acquire) - taken_periods;
+	//The held period is copied to the stream already
+	if (holding.load(std::memory_order_acquire) && queued > 0)
+		queued--;
+	return sf::microseconds(1000000LL * static_cast<long long>(queued + STREAM_BUFFERS) * period / sample_rate);
+}
+
+std::uint64_t SfmlAudioDevice::get_underruns() const {
+	return underruns.load(std::memory_order_relaxed);
+}
+
+bool SfmlAudioDevice::onGetData(Chunk& data) {
+	//The stream has copied the previous period already
+	std::uint64_t index = taken.load(std::memory_order_relaxed);
+	if (holding.load(std::memory_order_relaxed)) {
+		//Not held first, so get_buffered_time() may count it once more but never less
+		holding.store(false, std::memory_order_release);
+		taken.store(++index, std::memory_order_release);
+	}
+
+	data.sampleCount = 2 * period;
+	if (index == written.load(std::memory_order_acquire)) {
+		//The silent period after the ring
+		underruns.fetch_add(1, std::memory_order_relaxed);
+		data.samples = &ring[2 * period * RING_PERIODS];
+	} else {
+		data.samples = &ring[2 * period * (index % RING_PERIODS)];
+		holding.store(true, std::memory_order_release);
+	}
+	//Keep streaming even if the mixer is late
+	return true;
+}
+
+void SfmlAudioDevice::onSeek(sf::Time) { }
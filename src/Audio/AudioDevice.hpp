@@ -0,0 +1,113 @@
+/*
+ * PongX audio output devices
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include <SFML/Audio/SoundStream.hpp>
+#include <SFML/System/Time.hpp>
+
+///Output of 16-bit interleaved stereo frames. The mixer thread writes a period of frames at a time,
+///the device blocks the writes to pace the mixer by its playback
+class AudioDevice {
+public:
+	virtual ~AudioDevice() = default;
+
+	///Prepare the output
+	///@param period amount of frames of every write()
+	///@returns false if there is no output
+	virtual bool open(unsigned int sample_rate, unsigned int period) = 0;
+	///Get the least amount of frames of a period the device plays without underruns
+	virtual unsigned int get_min_period(unsigned int sample_rate) const;
+	///Queue the frames. Blocks until the device has room for them
+	virtual void write(const std::int16_t* frames) = 0;
+	///Get the time of the sound queued after the last write() till it is heard
+	virtual sf::Time get_buffered_time() const = 0;
+	///Get amount of the periods when the device had nothing to play
+	virtual std::uint64_t get_underruns() const = 0;
+};
+
+///Device without the sound hardware: it only counts the frames. It plays them with the speed of the real
+///hardware, or (offline) takes them as fast as they are mixed, to measure the throughput of the mixer
+class NullAudioDevice : public AudioDevice {
+public:
+	NullAudioDevice(bool realtime);
+
+	bool open(unsigned int sample_rate, unsigned int period) override;
+	void write(const std::int16_t* frames) override;
+	sf::Time get_buffered_time() const override;
+	std::uint64_t get_underruns() const override;
+
+	std::uint64_t get_written_frames() const;
+	///Get the largest absolute value of the written samples
+	std::int32_t get_peak() const;
+
+private:
+	bool realtime;
+	unsigned int period = 0;
+	std::chrono::nanoseconds period_time { 0 };
+	///Was anything written since open()?
+	bool started = false;
+	///When the queued period ends playing
+	std::chrono::steady_clock::time_point play_end;
+	std::atomic<std::uint64_t> written_frames { 0 };
+	std::atomic<std::uint64_t> underruns { 0 };
+	std::atomic<std::int32_t> peak { 0 };
+};
+
+///Device of the sound card through sf::SoundStream. The stream pulls the periods from a small ring
+///filled by write() on its own thread. The stream buffering makes its latency tens of milliseconds
+class SfmlAudioDevice : public AudioDevice, private sf::SoundStream {
+public:
+	///Periods in the ring. One of them is held by the stream while it copies it
+	static constexpr unsigned int RING_PERIODS = 3;
+	///Buffers that sf::SoundStream queues to the sound card
+	static constexpr unsigned int STREAM_BUFFERS = 3;
+	///sf::SoundStream refills its buffers once in this time, so every buffer must play longer
+	static constexpr unsigned int REFILL_INTERVAL_MS = 10;
+
+	SfmlAudioDevice() = default;
+	~SfmlAudioDevice() override;
+
+	bool open(unsigned int sample_rate, unsigned int period) override;
+	///The smallest power of two longer than the refill interval: 512 frames at 48 kHz
+	unsigned int get_min_period(unsigned int sample_rate) const override;
+	void write(const std::int16_t* frames) override;
+	///The periods waiting in the ring and in the stream, the playing one counted in full
+	sf::Time get_buffered_time() const override;
+	std::uint64_t get_underruns() const override;
+
+private:
+	unsigned int sample_rate = 0;
+	unsigned int period = 0;
+	///RING_PERIODS periods and a silent one for the underruns
+	std::unique_ptr<std::int16_t[]> ring;
+	///Periods written and periods taken by the stream
+	std::atomic<std::uint64_t> written { 0 };
+	std::atomic<std::uint64_t> taken { 0 };
+	///Is a period held by the stream since the last onGetData()?
+	std::atomic<bool> holding { false };
+	std::atomic<std::uint64_t> underruns { 0 };
+
+	bool onGetData(Chunk& data) override;
+	void onSeek(sf::Time) override;
+};
@@ -0,0 +1,147 @@
+/*
+ * PongX audio engine
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AudioEngine.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+#include "../Utils/Metrics.hpp"
+
+static MetricHistogram trigger_latency_metric("pongx_audio_trigger_latency_seconds",
+											  "Time from the sound request till it is heard",
+											  { 1000, 2000, 4000, 6000, 8000, 10000, 15000, 20000, 40000 }, 1e-6);
+static MetricCounter underrun_metric("pongx_audio_underruns_total",
+									 "Periods when the sound card had nothing to play");
+
+///Nanoseconds of the steady clock
+static std::int64_t clock_now() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+AudioEngine::AudioEngine(std::shared_ptr<const SoundBank> bank, std::unique_ptr<AudioDevice> device,
+						 unsigned int period) :
+	bank(bank), device(std::move(device)), period(period), mixer(bank) { }
+
+std::unique_ptr<AudioEngine> AudioEngine::start(std::shared_ptr<const SoundBank> bank,
+												std::unique_ptr<AudioDevice> device, unsigned int period) {
+	period = std::max(1U, std::min(std::max(period, device->get_min_period(bank->get_sample_rate())),
+								   AudioMixer::MAX_PERIOD));
+	if (!device->open(bank->get_sample_rate(), period))
+		return nullptr;
+
+	std::unique_ptr<AudioEngine> engine(new AudioEngine(std::move(bank), std::move(device), period));
+	AudioEngine* thread_engine = engine.get();
+	engine->thread = std::thread([thread_engine]() { thread_engine->run(); });
+	return engine;
+}
+
+AudioEngine::~AudioEngine() {
+	stop_requested.store(true);
+	thread.join();
+}
+
+bool AudioEngine::play(unsigned int sound, float gain, float pan) {
+	return send({ clock_now(), sound, gain, pan, PlaySound });
+}
+
+bool AudioEngine::stop_all() {
+	return send({ clock_now(), 0, 0.0F, 0.0F, StopAllSounds });
+}
+
+bool AudioEngine::set_master_gain(float gain) {
+	return send({ clock_now(), 0, gain, 0.0F, SetMasterGain });
+}
+
+const AudioDevice& AudioEngine::get_device() const {
+	return *device;
+}
+
+unsigned int AudioEngine::get_period() const {
+	return period;
+}
+
+std::uint64_t AudioEngine::get_mixed_frames() const {
+	return mixed_frames.load(std::memory_order_relaxed);
+}
+
+std::uint64_t AudioEngine::get_dropped_commands() const {
+	return dropped_commands.load(std::memory_order_relaxed);
+}
+
+std::uint64_t AudioEngine::get_stolen_voices() const {
+	return stolen_voices.load(std::memory_order_relaxed);
+}
+
+std::uint64_t AudioEngine::get_started_sounds() const {
+	return started_sounds.load(std::memory_order_relaxed);
+}
+
+sf::Time AudioEngine::get_max_latency() const {
+	return sf::microseconds(max_latency.load(std::memory_order_relaxed) / 1000);
+}
+
+sf::Time AudioEngine::get_mean_latency() const {
+	std::uint64_t count = started_sounds.load(std::memory_order_relaxed);
+	if (count == 0)
+		return sf::Time::Zero;
+	return sf::microseconds(latency_sum.load(std::memory_order_relaxed) / static_cast<std::int64_t>(count) / 1000);
+}
+
+bool AudioEngine::send(const AudioCommand& command) {
+	if (commands.push(command))
+		return true;
+	dropped_commands.fetch_add(1, std::memory_order_relaxed);
+	return false;
+}
+
+void AudioEngine::run() {
+	//The only buffer of the thread, the mixing itself does not allocate
+	std::unique_ptr<std::int16_t[]> frames(new std::int16_t[2 * period]);
+	std::uint64_t underruns = 0;
+
+	while (!stop_requested.load(std::memory_order_relaxed)) {
+		//The commands sent while the previous period was written start in this one
+		AudioCommand command;
+		std::int64_t buffered = device->get_buffered_time().asMicroseconds() * 1000;
+		while (commands.pop(command)) {
+			mixer.execute(command);
+			if (command.type != PlaySound)
+				continue;
+
+			std::int64_t latency = clock_now() - command.time + buffered;
+			trigger_latency_metric.record(static_cast<std::uint64_t>(latency / 1000));
+			latency_sum.fetch_add(latency, std::memory_order_relaxed);
+			if (latency > max_latency.load(std::memory_order_relaxed))
+				max_latency.store(latency, std::memory_order_relaxed);
+			started_sounds.fetch_add(1, std::memory_order_relaxed);
+		}
+		stolen_voices.store(mixer.get_stolen_voices(), std::memory_order_relaxed);
+
+		mixer.mix(frames.get(), period);
+		device->write(frames.get());
+		mixed_frames.fetch_add(period, std::memory_order_relaxed);
+
+		std::uint64_t new_underruns = device->get_underruns();
+		if (new_underruns != underruns) {
+			underrun_metric.add(new_underruns - underruns);
+			underruns = new_underruns;
+		}
+	}
+}
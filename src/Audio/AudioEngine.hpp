@@ -0,0 +1,96 @@
+/*
+ * PongX audio engine
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#include <SFML/System/Time.hpp>
+
+#include "AudioDevice.hpp"
+#include "AudioMixer.hpp"
+
+///Plays the sounds of the bank on its own mixer thread. The game sends the commands through the lock-free queue,
+///the mixer takes them before every period, so a sound starts after at most one period plus the time buffered
+///by the device
+class AudioEngine {
+public:
+	///Frames mixed at once by default: 2.7 ms at 48 kHz. The device may need longer periods
+	static constexpr unsigned int DEFAULT_PERIOD = 128;
+
+	///Open the device and start the mixer thread
+	///@param period frames mixed at once (at least AudioDevice::get_min_period(), at most AudioMixer::MAX_PERIOD)
+	///@returns nullptr if the device can not be opened
+	static std::unique_ptr<AudioEngine> start(std::shared_ptr<const SoundBank> bank,
+											  std::unique_ptr<AudioDevice> device,
+											  unsigned int period = DEFAULT_PERIOD);
+
+	AudioEngine(const AudioEngine&) = delete;
+	AudioEngine& operator=(const AudioEngine&) = delete;
+	///Stop the mixer thread
+	~AudioEngine();
+
+	///Play the sound. The commands are sent by one thread only
+	///@param gain volume of the sound
+	///@param pan -1 - left, 0 - center, 1 - right
+	///@returns false if the mixer is too far behind (the command is dropped)
+	bool play(unsigned int sound, float gain = 1.0F, float pan = 0.0F);
+	///Silence all playing sounds
+	bool stop_all();
+	bool set_master_gain(float gain);
+
+	const AudioDevice& get_device() const;
+	///Get amount of the frames mixed at once
+	unsigned int get_period() const;
+	std::uint64_t get_mixed_frames() const;
+	///Get amount of the commands dropped because the queue was full
+	std::uint64_t get_dropped_commands() const;
+	std::uint64_t get_stolen_voices() const;
+	///Get amount of the play commands taken by the mixer
+	std::uint64_t get_started_sounds() const;
+	///Get the longest time from play() till the sound is heard (the time buffered by the device included)
+	sf::Time get_max_latency() const;
+	///Get the average time from play() till the sound is heard
+	sf::Time get_mean_latency() const;
+
+private:
+	std::shared_ptr<const SoundBank> bank;
+	std::unique_ptr<AudioDevice> device;
+	unsigned int period = DEFAULT_PERIOD;
+	AudioMixer mixer;
+	AudioCommandQueue commands;
+
+	std::atomic<std::uint64_t> mixed_frames { 0 };
+	std::atomic<std::uint64_t> dropped_commands { 0 };
+	std::atomic<std::uint64_t> stolen_voices { 0 };
+	std::atomic<std::uint64_t> started_sounds { 0 };
+	///Latencies of the started sounds (nanoseconds)
+	std::atomic<std::int64_t> max_latency { 0 };
+	std::atomic<std::int64_t> latency_sum { 0 };
+
+	std::atomic<bool> stop_requested { false };
+	std::thread thread;
+
+	AudioEngine(std::shared_ptr<const SoundBank> bank, std::unique_ptr<AudioDevice> device, unsigned int period);
+
+	bool send(const AudioCommand& command);
+	void run();
+};
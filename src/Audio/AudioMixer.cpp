@@ -0,0 +1,123 @@
+/*
+ * PongX audio mixer
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AudioMixer.hpp"
+
+#include <algorithm>
+
+AudioCommandQueue::AudioCommandQueue(std::size_t capacity) {
+	std::size_t size = 1;
+	while (size < capacity)
+		size *= 2;
+	commands.reset(new AudioCommand[size]);
+	mask = size - 1;
+}
+
+bool AudioCommandQueue::push(const AudioCommand& command) {
+	std::size_t index = tail.load(std::memory_order_relaxed);
+	if (index - head.load(std::memory_order_acquire) > mask)
+		return false;
+	commands[index & mask] = command;
+	tail.store(index + 1, std::memory_order_release);
+	return true;
+}
+
+bool AudioCommandQueue::pop(AudioCommand& command) {
+	std::size_t index = head.load(std::memory_order_relaxed);
+	if (index == tail.load(std::memory_order_acquire))
+		return false;
+	command = commands[index & mask];
+	head.store(index + 1, std::memory_order_release);
+	return true;
+}
+
+AudioMixer::AudioMixer(std::shared_ptr<const SoundBank> bank) : bank(std::move(bank)) { }
+
+void AudioMixer::execute(const AudioCommand& command) {
+	switch (command.type) {
+		case PlaySound: {
+			if (command.sound >= bank->get_sound_count() || bank->get_length(command.sound) == 0)
+				return;
+
+			Voice* voice;
+			if (active_voices < MAX_VOICES) {
+				voice = &voices[active_voices++];
+			} else {
+				voice = std::min_element(voices, voices + MAX_VOICES, [](const Voice& a, const Voice& b) {
+					return a.length - a.position < b.length - b.position;
+				});
+				stolen_voices++;
+			}
+			//Linear panning: the center is at full volume in both channels
+			float pan = std::max(-1.0F, std::min(1.0F, command.pan));
+			voice->samples = bank->get_samples(command.sound);
+			voice->length = bank->get_length(command.sound);
+			voice->position = 0;
+			voice->left = command.gain * std::min(1.0F, 1.0F - pan);
+			voice->right = command.gain * std::min(1.0F, 1.0F + pan);
+			break;
+		}
+		case StopAllSounds: {
+			active_voices = 0;
+			break;
+		}
+		case SetMasterGain: {
+			master_gain = command.gain;
+			break;
+		}
+	}
+}
+
+void AudioMixer::mix(std::int16_t* frames, unsigned int count) {
+	count = std::min(count, MAX_PERIOD);
+	std::fill(accumulator, accumulator + 2 * count, 0.0F);
+
+	for (unsigned int i = 0; i < active_voices; i++) {
+		Voice& voice = voices[i];
+		unsigned int samples = std::min<std::uint32_t>(count, voice.length - voice.position);
+		const std::int16_t* source = voice.samples + voice.position;
+		float left = voice.left, right = voice.right;
+		//Simple loop without branches, so the compiler vectorizes it
+		for (unsigned int j = 0; j < samples; j++) {
+			float sample = static_cast<float>(source[j]);
+			accumulator[2 * j] += sample * left;
+			accumulator[2 * j + 1] += sample * right;
+		}
+		voice.position += samples;
+
+		//The last voice takes the place of the finished one
+		if (voice.position == voice.length) {
+			voice = voices[--active_voices];
+			i--;
+		}
+	}
+
+	//Saturate instead of wrapping around when the voices are too loud together
+	for (unsigned int i = 0; i < 2 * count; i++) {
+		float value = std::max(-32768.0F, std::min(32767.0F, accumulator[i] * master_gain));
+		frames[i] = static_cast<std::int16_t>(value);
+	}
+}
+
+unsigned int AudioMixer::get_active_voices() const {
+	return active_voices;
+}
+
+std::uint64_t AudioMixer::get_stolen_voices() const {
+	return stolen_voices;
+}
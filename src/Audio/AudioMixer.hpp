@@ -0,0 +1,110 @@
+/*
+ * PongX audio mixer
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "SoundBank.hpp"
+
+enum AudioCommandType : std::uint8_t {
+	///Start a voice of the sound
+	PlaySound,
+	///Silence all voices
+	StopAllSounds,
+	///Change the gain of the whole output
+	SetMasterGain
+};
+
+struct AudioCommand {
+	///When the command was sent (nanoseconds of std::chrono::steady_clock), to measure the latency
+	std::int64_t time;
+	///PlaySound: id of the sound in the bank
+	unsigned int sound;
+	///PlaySound: volume of the voice. SetMasterGain: the new master gain
+	float gain;
+	///PlaySound: -1 - left, 0 - center, 1 - right
+	float pan;
+	AudioCommandType type;
+};
+
+///Bounded queue of the commands from one thread (the game) to the other one (the mixer). Lock-free and
+///allocation-free: a command that does not fit is rejected instead of waiting for the mixer
+class AudioCommandQueue {
+public:
+	///@param capacity most commands waiting for the mixer (rounded up to a power of 2)
+	AudioCommandQueue(std::size_t capacity = 256);
+
+	///Called only by the sending thread
+	///@returns false if the queue is full
+	bool push(const AudioCommand& command);
+	///Called only by the mixer thread
+	///@returns false if the queue is empty
+	bool pop(AudioCommand& command);
+
+private:
+	std::unique_ptr<AudioCommand[]> commands;
+	std::size_t mask;
+	///Written by the sender and the mixer, so they are on different cache lines
+	alignas(64) std::atomic<std::size_t> tail { 0 };
+	alignas(64) std::atomic<std::size_t> head { 0 };
+};
+
+///Mixes the voices of the sounds into 16-bit stereo frames. The voices and the mixing buffer are fixed,
+///so nothing is allocated after the construction. Used only by one thread
+class AudioMixer {
+public:
+	///Most sounds played at once. The new sound takes the place of the voice that is the closest to its end
+	static constexpr unsigned int MAX_VOICES = 32;
+	///Most frames mixed by one mix() call
+	static constexpr unsigned int MAX_PERIOD = 1024;
+
+	AudioMixer(std::shared_ptr<const SoundBank> bank);
+
+	///Apply the command. Commands with unknown sounds are ignored
+	void execute(const AudioCommand& command);
+	///Mix the next frames of the voices, the finished voices are released
+	///@param frames the result: count interleaved left and right samples
+	///@param count amount of frames (at most MAX_PERIOD)
+	void mix(std::int16_t* frames, unsigned int count);
+
+	unsigned int get_active_voices() const;
+	///Get amount of the voices cut off to play the new sounds
+	std::uint64_t get_stolen_voices() const;
+
+private:
+	struct Voice {
+		const std::int16_t* samples;
+		std::uint32_t length;
+		///Next sample
+		std::uint32_t position;
+		///Gains of the channels
+		float left, right;
+	};
+
+	std::shared_ptr<const SoundBank> bank;
+	Voice voices[MAX_VOICES];
+	unsigned int active_voices = 0;
+	std::uint64_t stolen_voices = 0;
+	float master_gain = 1.0F;
+	///Sum of the voices before the conversion to 16 bits
+	float accumulator[2 * MAX_PERIOD];
+};
@@ -0,0 +1,52 @@
+/*
+ * PongX sounds of the match events
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "GameSounds.hpp"
+
+GameSounds::GameSounds(SoundBank& bank) {
+	paddle_hit = bank.add_tone(880.0F, 0.08F, 0.6F, 5.0F);
+	wall_bounce = bank.add_tone(440.0F, 0.06F, 0.5F, 5.0F);
+	score = bank.add_tone(330.0F, 0.4F, 0.7F, 3.0F);
+	serve = bank.add_tone(1320.0F, 0.04F, 0.3F, 4.0F);
+}
+
+void GameSounds::play(AudioEngine& engine, const GameEvent& event, float field_width) const {
+	//The sound comes from the side of the field where the ball is, but it is never in one ear only
+	float pan = field_width > 0 ? 0.6F * (2.0F * event.x / field_width - 1.0F) : 0.0F;
+	switch (event.type) {
+		case PaddleHit: {
+			engine.play(paddle_hit, 1.0F, pan);
+			break;
+		}
+		case WallBounce: {
+			engine.play(wall_bounce, 0.8F, pan);
+			break;
+		}
+		case Score: {
+			engine.play(score);
+			break;
+		}
+		case Serve: {
+			engine.play(serve, 0.6F, pan);
+			break;
+		}
+		default: {
+			//Resume is silent
+		}
+	}
+}
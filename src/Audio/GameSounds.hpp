@@ -0,0 +1,37 @@
+/*
+ * PongX sounds of the match events
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "../Server/GameEvents.hpp"
+#include "AudioEngine.hpp"
+#include "SoundBank.hpp"
+
+///Sounds of the events of the match. They are synthesized, the game has no sound files
+class GameSounds {
+public:
+	///Synthesize the sounds into the bank
+	GameSounds(SoundBank& bank);
+
+	///Play the sound of the event, panned to the position of the ball
+	///@param field_width width of the field, for the panning
+	void play(AudioEngine& engine, const GameEvent& event, float field_width) const;
+
+private:
+	unsigned int paddle_hit, wall_bounce, score, serve;
+};
@@ -0,0 +1,96 @@
+/*
+ * PongX pre-decoded sounds
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SoundBank.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <SFML/Audio/SoundBuffer.hpp>
+
+///Samples that fade in at the start of the tone, so it does not click
+static constexpr unsigned int TONE_ATTACK = 48;
+
+SoundBank::SoundBank(unsigned int sample_rate) : sample_rate(sample_rate) { }
+
+unsigned int SoundBank::add(const std::int16_t* samples, std::size_t count) {
+	sounds.push_back({ static_cast<std::uint32_t>(pool.size()), static_cast<std::uint32_t>(count) });
+	pool.insert(pool.end(), samples, samples + count);
+	return static_cast<unsigned int>(sounds.size() - 1);
+}
+
+unsigned int SoundBank::load(const std::string& path) {
+	sf::SoundBuffer buffer;
+	if (!buffer.loadFromFile(path) || buffer.getChannelCount() == 0 || buffer.getSampleRate() == 0)
+		return INVALID_SOUND;
+
+	//Mix down to mono
+	unsigned int channels = buffer.getChannelCount();
+	std::size_t frames = static_cast<std::size_t>(buffer.getSampleCount()) / channels;
+	std::vector<float> mono(frames);
+	for (std::size_t i = 0; i < frames; i++) {
+		float sum = 0;
+		for (unsigned int channel = 0; channel < channels; channel++)
+			sum += buffer.getSamples()[i * channels + channel];
+		mono[i] = sum / static_cast<float>(channels);
+	}
+	if (frames == 0)
+		return add(nullptr, 0);
+
+	//Linear resampling is enough for the short effects
+	double step = static_cast<double>(buffer.getSampleRate()) / sample_rate;
+	std::size_t count = static_cast<std::size_t>(static_cast<double>(frames - 1) / step) + 1;
+	std::vector<std::int16_t> samples(count);
+	for (std::size_t i = 0; i < count; i++) {
+		double position = static_cast<double>(i) * step;
+		std::size_t index = static_cast<std::size_t>(position);
+		float fraction = static_cast<float>(position - static_cast<double>(index));
+		float next = mono[std::min(index + 1, frames - 1)];
+		float value = mono[index] + (next - mono[index]) * fraction;
+		samples[i] = static_cast<std::int16_t>(std::max(-32768.0F, std::min(32767.0F, value)));
+	}
+	return add(samples.data(), count);
+}
+
+unsigned int SoundBank::add_tone(float frequency, float duration, float volume, float decay) {
+	std::size_t count = static_cast<std::size_t>(duration * static_cast<float>(sample_rate));
+	std::vector<std::int16_t> samples(count);
+	float phase_step = 2.0F * 3.14159265F * frequency / static_cast<float>(sample_rate);
+	for (std::size_t i = 0; i < count; i++) {
+		float time = static_cast<float>(i) / static_cast<float>(count);
+		float amplitude = volume * std::exp(-decay * time) * std::min(1.0F, static_cast<float>(i) / TONE_ATTACK);
+		samples[i] = static_cast<std::int16_t>(32767.0F * amplitude * std::sin(phase_step * static_cast<float>(i)));
+	}
+	return add(samples.data(), count);
+}
+
+unsigned int SoundBank::get_sample_rate() const {
+	return sample_rate;
+}
+
+unsigned int SoundBank::get_sound_count() const {
+	return static_cast<unsigned int>(sounds.size());
+}
+
+const std::int16_t* SoundBank::get_samples(unsigned int sound) const {
+	return pool.data() + sounds[sound].offset;
+}
+
+std::uint32_t SoundBank::get_length(unsigned int sound) const {
+	return sounds[sound].length;
+}
@@ -0,0 +1,68 @@
+/*
+ * PongX pre-decoded sounds
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+///Sounds decoded once into one pool of 16-bit mono samples at the rate of the mixer.
+///The bank is filled before the audio starts and is not changed while it is played, so the mixer reads
+///the samples without locks, decoding or allocations
+class SoundBank {
+public:
+	///Returned instead of the id of a sound that can not be added
+	static constexpr unsigned int INVALID_SOUND = ~0U;
+
+	SoundBank(unsigned int sample_rate = 48000);
+
+	///Copy the samples (mono, at the rate of the bank) into the pool
+	///@returns id of the sound
+	unsigned int add(const std::int16_t* samples, std::size_t count);
+	///Decode the sound file (any format of sf::SoundBuffer), mix it down to mono
+	///and resample it to the rate of the bank
+	///@returns INVALID_SOUND if the file can not be decoded
+	unsigned int load(const std::string& path);
+	///Synthesize a sine tone that fades out exponentially
+	///@param frequency pitch (Hz)
+	///@param duration length (seconds)
+	///@param volume peak amplitude (0 - 1)
+	///@param decay how many times the amplitude drops by e till the end
+	///@returns id of the sound
+	unsigned int add_tone(float frequency, float duration, float volume, float decay);
+
+	unsigned int get_sample_rate() const;
+	unsigned int get_sound_count() const;
+	///Get the first sample of the sound
+	const std::int16_t* get_samples(unsigned int sound) const;
+	///Get amount of samples of the sound
+	std::uint32_t get_length(unsigned int sound) const;
+
+private:
+	///Place of the sound in the pool
+	struct Sound {
+		std::uint32_t offset;
+		std::uint32_t length;
+	};
+
+	unsigned int sample_rate;
+	std::vector<std::int16_t> pool;
+	std::vector<Sound> sounds;
+};
@@ -0,0 +1,203 @@
+/*
+ * PongX batched training environment
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "../fast_trig.hpp"
+#include "BatchedEnv.hpp"
+
+///Mix the seed of the match and the number of the episode into the seed of the server (splitmix64)
+static unsigned int episode_seed(std::uint64_t seed, std::uint64_t episode) {
+	std::uint64_t value = seed + episode * 0x9E3779B97F4A7C15ULL;
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+	value ^= value >> 31;
+	return static_cast<unsigned int>(value);
+}
+
+BatchedEnv::BatchedEnv(const EnvSettings& settings, unsigned int env_count, const std::uint64_t* seeds) {
+	this->settings = settings;
+
+	//Create every server once, matches only reset them
+	ServerSettings server_settings;
+	server_settings.window_size = settings.window_size;
+	server_settings.ball_radius = settings.ball_radius;
+	server_settings.ball_speed = settings.ball_speed;
+	server_settings.ai_reaction_delay = settings.ai_reaction_delay;
+	server_settings.ai_error = settings.ai_error;
+	//Paddles at the sides of the window
+	server_settings.player_rect.top = server_settings.enemy_rect.top =
+		(settings.window_size.y - server_settings.player_rect.height) * 0.5F;
+	server_settings.enemy_rect.left = settings.window_size.x - 10.0F - server_settings.enemy_rect.width;
+
+	matches.resize(env_count);
+	for (unsigned int i = 0; i < env_count; i++) {
+		server_settings.seed = 1; //Any, reset_match() sets the real one
+		matches[i].server.reset(new SingleplayerServer<>(server_settings));
+		matches[i].seed = seeds != nullptr ? seeds[i] : i + 1;
+		matches[i].episode = 0;
+		reset_match(matches[i]);
+	}
+
+	//Start the workers. The caller's thread steps the first part itself
+	unsigned int thread_count = settings.threads != 0 ? settings.threads : std::thread::hardware_concurrency();
+	thread_count = std::clamp(thread_count, 1U, std::max(env_count, 1U));
+	part_count = thread_count;
+	for (unsigned int i = 1; i < thread_count; i++)
+		workers.emplace_back(&BatchedEnv::worker_loop, this, i);
+}
+
+BatchedEnv::~BatchedEnv() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	step_started.notify_all();
+	for (std::thread& worker : workers)
+		worker.join();
+}
+
+unsigned int BatchedEnv::get_env_count() const {
+	return static_cast<unsigned int>(matches.size());
+}
+
+void BatchedEnv::reset(float* observations) {
+	for (unsigned int i = 0; i < matches.size(); i++) {
+		matches[i].episode = 0;
+		reset_match(matches[i]);
+		write_observation(matches[i], observations + i * OBSERVATION_SIZE);
+	}
+}
+
+void BatchedEnv::step(const float* actions, float* observations, float* rewards, std::uint8_t* dones) {
+	if (workers.empty()) {
+		step_actions = actions;
+		step_observations = observations;
+		step_rewards = rewards;
+		step_dones = dones;
+		step_part(0);
+		return;
+	}
+
+	//Give the buffers to the workers and wake them up
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		step_actions = actions;
+		step_observations = observations;
+		step_rewards = rewards;
+		step_dones = dones;
+		busy_workers = static_cast<unsigned int>(workers.size());
+		generation++;
+	}
+	step_started.notify_all();
+
+	//Do our part meanwhile
+	step_part(0);
+
+	//Wait for the others
+	std::unique_lock<std::mutex> lock(mutex);
+	step_finished.wait(lock, [this]() { return busy_workers == 0; });
+}
+
+void BatchedEnv::worker_loop(unsigned int worker_index) {
+	std::uint64_t seen_generation = 0;
+
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			step_started.wait(lock, [this, seen_generation]() {
+				return stopping || generation != seen_generation;
+			});
+			if (stopping)
+				return;
+			seen_generation = generation;
+		}
+
+		step_part(worker_index);
+
+		bool last;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			last = --busy_workers == 0;
+		}
+		if (last)
+			step_finished.notify_one();
+	}
+}
+
+void BatchedEnv::step_part(unsigned int part) {
+	//Contiguous parts, so the workers do not share cache lines of the buffers (except the edges)
+	std::size_t begin = matches.size() * part / part_count;
+	std::size_t end = matches.size() * (part + 1) / part_count;
+	for (std::size_t i = begin; i < end; i++)
+		step_match(static_cast<unsigned int>(i));
+}
+
+void BatchedEnv::reset_match(Match& match) {
+	match.server->reset(episode_seed(match.seed, match.episode));
+	match.server->serve();
+	match.steps = 0;
+}
+
+void BatchedEnv::step_match(unsigned int index) {
+	Match& match = matches[index];
+	SingleplayerServer<>& server = *match.server;
+
+	unsigned int player_score = server.get_player_score(), enemy_score = server.get_enemy_score();
+
+	server.player_relative_speed = std::clamp(step_actions[index], -1.0F, 1.0F);
+	server.step();
+	match.steps++;
+
+	//Reward for the point
+	float reward = 0.0F;
+	if (server.get_player_score() != player_score)
+		reward = 1.0F;
+	else if (server.get_enemy_score() != enemy_score)
+		reward = -1.0F;
+	step_rewards[index] = reward;
+
+	//Serve after the point at once, nobody waits for the input here
+	if (server.is_waiting_for_input())
+		server.serve();
+
+	bool done = server.get_player_score() >= settings.points_to_win ||
+		server.get_enemy_score() >= settings.points_to_win ||
+		(settings.max_steps != 0 && match.steps >= settings.max_steps);
+	step_dones[index] = done;
+
+	if (done) {
+		match.episode++;
+		reset_match(match);
+	}
+	write_observation(match, step_observations + index * OBSERVATION_SIZE);
+}
+
+void BatchedEnv::write_observation(const Match& match, float* observation) const {
+	SingleplayerServer<>& server = *match.server;
+	sf::Vector2f ball_pos = server.get_ball_pos();
+	sf::FloatRect player_rect = server.get_player_rect(), enemy_rect = server.get_enemy_rect();
+	float width = static_cast<float>(settings.window_size.x), height = static_cast<float>(settings.window_size.y);
+
+	observation[0] = ball_pos.x / width;
+	observation[1] = ball_pos.y / height;
+	gm::fast_sin_cos(server.get_ball_dir(), observation[3], observation[2]);
+	observation[4] = (player_rect.top + player_rect.height * 0.5F) / height;
+	observation[5] = (enemy_rect.top + enemy_rect.height * 0.5F) / height;
+}
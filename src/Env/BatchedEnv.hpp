@@ -0,0 +1,120 @@
+/*
+ * PongX batched training environment
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../Server/SingleplayerServer.hpp"
+
+///Settings of every match in BatchedEnv
+struct EnvSettings {
+	sf::Vector2u window_size = { 1280, 720 };
+	float ball_radius = 10.0F, ball_speed = 5.0F;
+	///Difficulty of the AI enemy, see PaddleAI::set_difficulty()
+	unsigned int ai_reaction_delay = 10;
+	float ai_error = 60.0F;
+	///The match is done when someone has this amount of points
+	unsigned int points_to_win = 1;
+	///The match is done (truncated) after this amount of steps, 0 - no limit
+	unsigned int max_steps = 10000;
+	///Amount of threads that step the matches, 0 - one per hardware thread
+	unsigned int threads = 0;
+};
+
+///Many independent singleplayer matches stepped at once, for training paddle controllers.
+///The controller plays for the player against the AI enemy. Every step writes the results into
+///buffers of the caller, so there are no allocations after the construction
+class BatchedEnv {
+public:
+	///Amount of floats in the observation of one match:
+	///ball X, ball Y, ball direction cos, ball direction sin, player center Y, enemy center Y.
+	///Positions are divided by the window size
+	static constexpr unsigned int OBSERVATION_SIZE = 6;
+
+	///@param seeds seed of every match (env_count seeds). Match i with seed s always plays the same way
+	///for the same actions. If nullptr, the seeds are 1, 2, 3...
+	BatchedEnv(const EnvSettings& settings, unsigned int env_count, const std::uint64_t* seeds);
+	~BatchedEnv();
+
+	BatchedEnv(const BatchedEnv&) = delete;
+	BatchedEnv& operator=(const BatchedEnv&) = delete;
+
+	unsigned int get_env_count() const;
+
+	///Start all matches from the beginning (first episode of every seed)
+	///@param observations the result: env_count * OBSERVATION_SIZE floats
+	void reset(float* observations);
+
+	///Make one step in every match. Finished matches are started again at once,
+	///their observation is the first observation of the new match
+	///@param actions speed of the player in every match (1 - max down, 0 - static, -1 - max up)
+	///@param observations the result: env_count * OBSERVATION_SIZE floats
+	///@param rewards the result: 1 if the player scored on this step, -1 if the enemy scored, 0 otherwise
+	///@param dones the result: 1 if the match is done on this step, 0 otherwise
+	void step(const float* actions, float* observations, float* rewards, std::uint8_t* dones);
+
+private:
+	struct Match {
+		///The exact type, so the step of the match has no virtual calls
+		std::unique_ptr<SingleplayerServer<>> server;
+		std::uint64_t seed;
+		///Amount of finished matches with this seed, every one gets its own seed from it
+		std::uint64_t episode;
+		unsigned int steps;
+	};
+
+	EnvSettings settings;
+	std::vector<Match> matches;
+
+	//BEGIN Worker threads
+	std::vector<std::thread> workers;
+	///Amount of the parts of the matches: one per worker and one for the caller's thread
+	unsigned int part_count = 1;
+	std::mutex mutex;
+	///Notifies the workers about the new step (or the stop)
+	std::condition_variable step_started;
+	///Notifies the caller that every worker finished its part
+	std::condition_variable step_finished;
+	///Incremented every step, so the workers know that there is a new one
+	std::uint64_t generation = 0;
+	unsigned int busy_workers = 0;
+	bool stopping = false;
+
+	///Buffers of the current step
+	const float* step_actions = nullptr;
+	float* step_observations = nullptr;
+	float* step_rewards = nullptr;
+	std::uint8_t* step_dones = nullptr;
+
+	void worker_loop(unsigned int worker_index);
+	///Step the matches of the part (all matches if there are no workers)
+	void step_part(unsigned int part);
+	//END Worker threads
+
+	///Start the next episode of the match
+	void reset_match(Match& match);
+	///Step one match and write its results
+	void step_match(unsigned int index);
+	void write_observation(const Match& match, float* observation) const;
+};
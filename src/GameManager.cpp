@@ -16,14 +16,56 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <cmath>
+
+#include "Audio/AudioEngine.hpp"
+#include "Audio/GameSounds.hpp"
+#include "Input/InputSampler.hpp"
+#include "Input/JoystickSampler.hpp"
+#include "Input/LatencyMeter.hpp"
+#include "Net/SharedMatchChannel.hpp"
+#include "Render/FrameCapture.hpp"
+#include "Server/ArenaMap.hpp"
 #include "UI/FPSMeter.hpp"
+#include "Pages/GamePage.hpp"
 #include "Pages/MainMenuPage.hpp"
+#include "Utils/Metrics.hpp"
 #include "GameManager.hpp"
 
+static MetricHistogram frame_time_metric("pongx_frame_seconds", "Time of the frame from the events to the display",
+										 { 1000, 2000, 4000, 8000, 16000, 33000, 66000, 133000 }, 1e-6);
+static MetricCounter page_switch_metric("pongx_page_switches_total", "Switches between the pages");
+
 //Define static variables
 std::vector<UIControl*> GameManager::ui_list;
 Page* GameManager::page = nullptr;
+Page* GameManager::next_page = nullptr;
 sf::Font GameManager::default_font;
+std::shared_ptr<const ArenaMap> GameManager::arena;
+std::unique_ptr<SharedMatchChannel> GameManager::attached_channel;
+std::unique_ptr<FrameCapture> GameManager::capture;
+bool GameManager::audio_disabled = false;
+std::unique_ptr<GameSounds> GameManager::game_sounds;
+std::unique_ptr<AudioEngine> GameManager::audio;
+sf::Clock GameManager::clock;
+std::function<sf::Time()> GameManager::custom_clock;
+InputSampler GameManager::input;
+std::unique_ptr<JoystickSampler> GameManager::joystick;
+LatencyMeter GameManager::latency_meter;
+sf::Texture GameManager::back_buffer;
+std::vector<sf::FloatRect> GameManager::damage;
+bool GameManager::full_redraw = true;
+std::future<Page*> GameManager::pending_page;
+std::vector<std::future<sf::Time>> GameManager::retired_pages;
+sf::Clock GameManager::transition_clock;
+PageTransitionStats GameManager::transition_stats;
+std::recursive_mutex GameManager::resource_mutex;
+
+///Time between event polls when GameManager::wait_event() waits with timeout
+const sf::Time IDLE_POLL_INTERVAL = sf::milliseconds(1);
+///Timeout of waiting for events while the page is being built in the background
+const sf::Time TRANSITION_POLL_INTERVAL = sf::milliseconds(2);
 
 int GameManager::start() {
 	//Create a window
@@ -36,49 +78,370 @@ int GameManager::start() {
 									   sf::Color::White);
 	ui_list.push_back(fps_meter);
 
+	//Pages find the audio when they are built
+	if (!audio_disabled)
+		start_audio();
+
 	//Create page
-	page = new MainMenuPage(&main_window);
+	if (attached_channel)
+		page = new GamePage(&main_window, std::move(attached_channel));
+	else
+		page = new MainMenuPage(&main_window);
+
+	//Create the back buffer for the pages rendered on demand
+	back_buffer.create(main_window.getSize().x, main_window.getSize().y);
 
 	//Main loop
 	while (main_window.isOpen()) {
 		//Handle events
 		sf::Event event;
-		while (main_window.pollEvent(event)) {
-			switch (event.type) {
-				case sf::Event::EventType::Closed: { //Close event
-					main_window.close(); //Close
-					break;
-				}
-				default: { //Other
-					break; //Ignore
-				}
-			}
+		bool has_event;
+		if (page->render_on_demand() && !collect_damage()) { //Nothing to redraw, so sleep until something happens
+			//Wake up periodically to check if the new page is ready
+			has_event = wait_event(main_window, event, pending_page.valid() ?
+								   TRANSITION_POLL_INTERVAL : page->idle_timeout());
 		}
+		else {
+			has_event = main_window.pollEvent(event);
+		}
+		sf::Clock frame_clock;
 
-		//Render stuff
-		main_window.clear();
-
-		//BEGIN render stuff
-		//Render UI
-		for (unsigned int i = 0; i < ui_list.size(); i++)
-			ui_list[i]->render();
+		while (has_event) {
+			handle_event(main_window, event);
+			has_event = main_window.pollEvent(event);
+		}
 
-		//Render page
-		page->render();
-		//END render stuff
+		run_frame(main_window);
 
-		main_window.display();
+		frame_time_metric.record(static_cast<std::uint64_t>(frame_clock.getElapsedTime().asMicroseconds()));
+		//Measure the frames that were rendered during the transition
+		if (pending_page.valid())
+			transition_stats.worst_frame_time = std::max(transition_stats.worst_frame_time,
+														 frame_clock.getElapsedTime());
 	}
 
+	close_pages();
+	audio.reset();
+	joystick.reset();
+	//The waiting frames are written
+	capture.reset();
+
 	return 0;
 }
 
+void GameManager::run_frame(sf::RenderWindow& window) {
+	//The switch requested outside of the event handling
+	apply_page_switch();
+	poll_pending_page();
+	poll_retired_pages();
+
+	//Render stuff. The text locks the resources itself, so the page builder waits only for the text drawing
+	if (page->render_on_demand())
+		render_damage(window);
+	else
+		render_full(window);
+}
+
+void GameManager::handle_event(sf::RenderWindow& window, const sf::Event& event) {
+	//Timestamp the input as soon as it is received
+	input.handle_event(event, now());
+
+	switch (event.type) {
+		case sf::Event::EventType::Closed: { //Close event
+			window.close(); //Close
+			break;
+		}
+		case sf::Event::EventType::LostFocus: { //Key releases will not come anymore
+			input.reset();
+			break;
+		}
+		default: { //Other (mouse, keyboard etc)
+			page->handle_event(event); //Let the page route it to the UI
+			apply_page_switch();
+			break;
+		}
+	}
+}
+
+bool GameManager::wait_event(sf::RenderWindow& window, sf::Event& event, sf::Time timeout) {
+	//Block until the event comes
+	if (timeout == sf::Time::Zero)
+		return window.waitEvent(event);
+
+	//SFML can't wait for event with timeout, so poll it with short sleeps
+	sf::Clock clock;
+	while (!window.pollEvent(event)) {
+		if (clock.getElapsedTime() >= timeout)
+			return false;
+		sf::sleep(IDLE_POLL_INTERVAL);
+	}
+	return true;
+}
+
+void GameManager::render_full(sf::RenderWindow& window) {
+	//Latch the input right before the simulation step, so it is as fresh as possible
+	InputSnapshot latched_input = input.latch(now());
+	//Every move of the stick since the previous frame, not only the last position
+	if (joystick)
+		joystick->latch(latched_input);
+	if (latched_input.has_new_input)
+		latency_meter.mark(InputReceived, latched_input.oldest_event_time);
+	latency_meter.mark(InputLatched, latched_input.latch_time);
+	page->update(latched_input);
+	latency_meter.mark(Simulated, now());
+
+	window.clear();
+
+	//BEGIN render stuff
+	//Render UI
+	for (unsigned int i = 0; i < ui_list.size(); i++)
+		ui_list[i]->render();
+
+	//Render page
+	page->render();
+	apply_page_switch();
+	//END render stuff
+
+	latency_meter.mark(Rendered, now());
+	//Only the readback is done here, the frame is encoded on the other thread
+	if (capture)
+		capture->capture(window);
+	window.display();
+	latency_meter.mark(Presented, now());
+	latency_meter.end_frame();
+
+	//The back buffer is outdated now
+	full_redraw = true;
+}
+
+bool GameManager::collect_damage() {
+	page->take_damage(damage);
+	//The global controls are drawn over the page, their regions of the page are just redrawn too
+	for (UIControl* control : ui_list) {
+		if (control->render_on_demand() && control->take_damage())
+			damage.push_back(control->bounds());
+	}
+	return full_redraw || !damage.empty();
+}
+
+void GameManager::render_damage(sf::RenderWindow& window) {
+	//Keep the last frame on the screen if nothing changed
+	if (!collect_damage())
+		return;
+
+	sf::Vector2f window_size = { static_cast<float>(window.getSize().x), static_cast<float>(window.getSize().y) };
+	if (full_redraw) {
+		damage.clear();
+		damage.push_back({ 0, 0, window_size.x, window_size.y });
+	}
+
+	window.clear();
+	//Restore the previous frame
+	if (!full_redraw)
+		window.draw(sf::Sprite(back_buffer));
+
+	//Redraw damaged regions only
+	sf::RectangleShape eraser;
+	eraser.setFillColor(sf::Color::Black);
+	for (sf::FloatRect region : damage) {
+		//Align the region to pixels and clamp it by the window
+		float left = std::max(std::floor(region.left), 0.0F);
+		float top = std::max(std::floor(region.top), 0.0F);
+		float right = std::min(std::ceil(region.left + region.width), window_size.x);
+		float bottom = std::min(std::ceil(region.top + region.height), window_size.y);
+		if (right <= left || bottom <= top)
+			continue;
+		region = { left, top, right - left, bottom - top };
+
+		//Clip all drawing by the region using the view with the same viewport
+		sf::View clip_view(region);
+		clip_view.setViewport({ region.left / window_size.x, region.top / window_size.y,
+								region.width / window_size.x, region.height / window_size.y });
+		window.setView(clip_view);
+
+		//Erase old image and draw the new one
+		eraser.setPosition(region.left, region.top);
+		eraser.setSize({ region.width, region.height });
+		window.draw(eraser);
+		page->render_region(region);
+	}
+	window.setView(window.getDefaultView());
+	damage.clear();
+	full_redraw = false;
+
+	//Save the page image for the next frames
+	back_buffer.update(window);
+
+	//Render UI over the page
+	for (unsigned int i = 0; i < ui_list.size(); i++) {
+		if (ui_list[i]->render_on_demand())
+			ui_list[i]->render();
+	}
+
+	if (capture)
+		capture->capture(window);
+	window.display();
+	apply_page_switch();
+}
+
 void GameManager::switch_page(Page* new_page) {
+	//If there are 2 switches during one event, the last one wins
+	delete next_page;
+	next_page = new_page;
+}
+
+bool GameManager::switch_page_async(std::function<Page*()> factory) {
+	if (pending_page.valid())
+		return false;
+
+	transition_stats = PageTransitionStats();
+	transition_clock.restart();
+	pending_page = std::async(std::launch::async, [factory]() {
+		sf::Clock build_clock;
+		Page* new_page = factory();
+		//It is read only after the future becomes ready, so there is no race
+		transition_stats.build_time = build_clock.getElapsedTime();
+		return new_page;
+	});
+	return true;
+}
+
+bool GameManager::is_switching_page() {
+	return pending_page.valid();
+}
+
+PageTransitionStats GameManager::get_last_transition_stats() {
+	return transition_stats;
+}
+
+sf::Time GameManager::now() {
+	return custom_clock ? custom_clock() : clock.getElapsedTime();
+}
+
+void GameManager::use_clock(std::function<sf::Time()> clock) {
+	custom_clock = std::move(clock);
+}
+
+InputSampler& GameManager::get_input() {
+	return input;
+}
+
+void GameManager::use_joystick(std::unique_ptr<JoystickSampler> joystick) {
+	GameManager::joystick = std::move(joystick);
+}
+
+JoystickSampler* GameManager::get_joystick() {
+	return joystick.get();
+}
+
+LatencyMeter& GameManager::get_latency_meter() {
+	return latency_meter;
+}
+
+std::recursive_mutex& GameManager::get_resource_mutex() {
+	return resource_mutex;
+}
+
+void GameManager::poll_pending_page() {
+	if (!pending_page.valid() || pending_page.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		return;
+
+	sf::Clock swap_clock;
+	switch_page(pending_page.get());
+	apply_page_switch();
+	transition_stats.swap_time = swap_clock.getElapsedTime();
+	transition_stats.latency = transition_clock.getElapsedTime();
+}
+
+void GameManager::poll_retired_pages() {
+	for (unsigned int i = 0; i < retired_pages.size(); i++) {
+		if (retired_pages[i].wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			continue;
+
+		transition_stats.teardown_time = retired_pages[i].get();
+		retired_pages.erase(retired_pages.begin() + i);
+		i--;
+	}
+}
+
+void GameManager::close_pages() {
+	//Wait for the background work to finish
+	if (pending_page.valid())
+		delete pending_page.get();
+	for (std::future<sf::Time>& retired_page : retired_pages)
+		retired_page.wait();
+	retired_pages.clear();
+
+	delete next_page;
+	next_page = nullptr;
 	delete page;
-	page = new_page;
+	page = nullptr;
+	full_redraw = true;
+}
+
+void GameManager::apply_page_switch() {
+	if (next_page == nullptr)
+		return;
+
+	Page* old_page = page;
+	if (old_page != nullptr && old_page->delete_in_background()) {
+		//Delete the old page on a background thread, it may take a while
+		retired_pages.push_back(std::async(std::launch::async, [old_page]() {
+			sf::Clock teardown_clock;
+			delete old_page;
+			return teardown_clock.getElapsedTime();
+		}));
+	} else {
+		sf::Clock teardown_clock;
+		delete old_page;
+		transition_stats.teardown_time = teardown_clock.getElapsedTime();
+	}
+
+	page = next_page;
+	next_page = nullptr;
+	page_switch_metric.add();
+
+	//The new page has to be drawn from scratch
+	full_redraw = true;
+}
+
+void GameManager::set_arena(std::shared_ptr<const ArenaMap> arena) {
+	GameManager::arena = std::move(arena);
+}
+
+std::shared_ptr<const ArenaMap> GameManager::get_arena() {
+	return arena;
+}
+
+void GameManager::attach(std::unique_ptr<SharedMatchChannel> channel) {
+	attached_channel = std::move(channel);
+}
+
+void GameManager::record(std::unique_ptr<FrameCapture> capture) {
+	GameManager::capture = std::move(capture);
+}
+
+void GameManager::disable_audio() {
+	audio_disabled = true;
+}
+
+AudioEngine* GameManager::get_audio() {
+	return audio.get();
+}
+
+const GameSounds* GameManager::get_game_sounds() {
+	return audio ? game_sounds.get() : nullptr;
+}
+
+void GameManager::start_audio() {
+	std::shared_ptr<SoundBank> bank = std::make_shared<SoundBank>();
+	game_sounds.reset(new GameSounds(*bank));
+	//The game stays silent if there is no sound card
+	audio = AudioEngine::start(bank, std::unique_ptr<AudioDevice>(new SfmlAudioDevice()));
 }
 
 sf::Font* GameManager::get_default_font() {
+	std::lock_guard<std::recursive_mutex> lock(resource_mutex);
 	if (default_font.getInfo().family == "")
 		default_font.loadFromFile("default.ttf");
 
@@ -18,24 +18,112 @@
 
 #pragma once
 
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 #include "Pages/Page.hpp"
 #include "UI/UIControl.hpp"
 
+class ArenaMap;
+class AudioEngine;
+class FrameCapture;
+class GameSounds;
+class InputSampler;
+class JoystickSampler;
+class LatencyMeter;
+class SharedMatchChannel;
+
 enum GameType : unsigned char {
 	LocalMultiplayer, Singleplayer, LocalNetworkHost, LocalNetworkClient
 };
 
+///Cost of the last page transition made by GameManager::switch_page_async()
+struct PageTransitionStats {
+	///Time spent on the construction of the new page (background thread)
+	sf::Time build_time;
+	///Time from the request to the moment when the new page was shown
+	sf::Time latency;
+	///Time spent by the render thread on the swap of pages
+	sf::Time swap_time;
+	///Time spent on the destruction of the old page (background thread if Page::delete_in_background(),
+	///otherwise the render thread as a part of swap_time)
+	sf::Time teardown_time;
+	///The longest frame rendered while the new page was being built
+	sf::Time worst_frame_time;
+};
+
 ///Static class. Analog of main, but members of this class are accessible from any place
 class GameManager {
 public:
 	///Start the game. WARNING: DO NOT CALL MORE THAN 1 TIME
 	static int start();
 
-	///Switch current page to specified one and delete previous
+	///Switch current page to specified one and delete previous.
+	///The switch is applied after the current event (or frame) is handled,
+	///so it is safe to call this from the page's own event handlers
 	static void switch_page(Page* new_page);
 
+	///Build the new page on a background thread and switch to it when it is ready.
+	///The current page keeps rendering meanwhile. The old page is deleted on a background thread too,
+	///if Page::delete_in_background() allows it
+	///@param factory function that constructs the new page (called on the background thread)
+	///@returns false if the other transition is still in progress (the request is ignored)
+	static bool switch_page_async(std::function<Page*()> factory);
+
+	///Delete the current page, the requested one and the ones being built or deleted in the background.
+	///Called at the end of start(). The next run_frame() needs a new page (see switch_page())
+	static void close_pages();
+
+	///Is the new page of switch_page_async() still being built?
+	static bool is_switching_page();
+	///Get the cost of the last asynchronous page transition
+	static PageTransitionStats get_last_transition_stats();
+
+	///Get the time since the game start. All input and latency timestamps use this clock
+	static sf::Time now();
+	///Replace the clock of now(), e.g. by a synthetic one in the tests (nullptr - the real clock)
+	static void use_clock(std::function<sf::Time()> clock);
+
+	///Handle the event as soon as the event loop receives it (the input is timestamped by now())
+	static void handle_event(sf::RenderWindow& window, const sf::Event& event);
+	///Run the frame after its events are handled: swap the pages, latch the input, simulate, render and present.
+	///The latency meter measures every stage
+	static void run_frame(sf::RenderWindow& window);
+
+	///Get the keyboard input collected from the window events
+	static InputSampler& get_input();
+	///Move the player by the analog stick too (nullptr - keyboard only). Call before start()
+	static void use_joystick(std::unique_ptr<JoystickSampler> joystick);
+	///Get the sampler of the analog stick (nullptr if there is no stick)
+	static JoystickSampler* get_joystick();
+	///Get the meter of input-to-present latency of the frames
+	static LatencyMeter& get_latency_meter();
+
+	///Mutex that guards shared SFML resources (fonts, text layout) between the render thread
+	///and the threads that build pages. Locked only while the text is laid out or drawn
+	static std::recursive_mutex& get_resource_mutex();
+
+	///Set the static obstacles of the field of the new games (nullptr - the empty field)
+	static void set_arena(std::shared_ptr<const ArenaMap> arena);
+	///Get the static obstacles of the field of the new games
+	static std::shared_ptr<const ArenaMap> get_arena();
+
+	///Watch the match of the other process instead of the main menu. Call before start()
+	static void attach(std::unique_ptr<SharedMatchChannel> channel);
+
+	///Write every presented frame (nullptr - no recording). Call before start()
+	static void record(std::unique_ptr<FrameCapture> capture);
+
+	///Play the game without sound. Call before start()
+	static void disable_audio();
+	///Get the engine that plays the sounds (nullptr if the game is silent)
+	static AudioEngine* get_audio();
+	///Get the sounds of the match events (nullptr if the game is silent)
+	static const GameSounds* get_game_sounds();
+
 	///Get default font ("default.ttf"). This function loads the font only once, then just return cached
 	static sf::Font* get_default_font();
 
@@ -44,7 +132,65 @@ private:
 	static std::vector<UIControl*> ui_list;
 	///Current page
 	static Page* page;
+	///Page that will replace the current one (nullptr if no switch requested)
+	static Page* next_page;
+
+	///Replace the current page with next_page, if requested
+	static void apply_page_switch();
+
+	///Page that is being built on the background thread
+	static std::future<Page*> pending_page;
+	///Old pages that are being deleted on background threads (the result is the deletion time)
+	static std::vector<std::future<sf::Time>> retired_pages;
+	///Measures the time since switch_page_async() call
+	static sf::Clock transition_clock;
+	static PageTransitionStats transition_stats;
+	static std::recursive_mutex resource_mutex;
+
+	///Switch to the pending page if it is ready
+	static void poll_pending_page();
+	///Collect the results of the finished page deletions
+	static void poll_retired_pages();
+
+	///Copy of the last frame of the page rendered on demand. Only damaged regions are redrawn over it
+	static sf::Texture back_buffer;
+	///Regions of the page damaged since the last frame
+	static std::vector<sf::FloatRect> damage;
+	///Has the whole page to be redrawn (e.g. after the page switch)?
+	static bool full_redraw;
+
+	///Wait for the event with timeout (sf::Time::Zero means no timeout)
+	///@returns false if timed out
+	static bool wait_event(sf::RenderWindow& window, sf::Event& event, sf::Time timeout);
+
+	///Render the page that is redrawn every frame
+	static void render_full(sf::RenderWindow& window);
+	///Collect the page damage
+	///@returns is there anything to redraw?
+	static bool collect_damage();
+	///Redraw damaged regions of the page that is rendered on demand and display the frame
+	static void render_damage(sf::RenderWindow& window);
 
 	///Cached default font
 	static sf::Font default_font;
+	static std::shared_ptr<const ArenaMap> arena;
+	///Channel of the match to watch from the start (see attach())
+	static std::unique_ptr<SharedMatchChannel> attached_channel;
+
+	///Recording of the presented frames (nullptr if the game is not recorded)
+	static std::unique_ptr<FrameCapture> capture;
+
+	static bool audio_disabled;
+	static std::unique_ptr<GameSounds> game_sounds;
+	static std::unique_ptr<AudioEngine> audio;
+	///Start the audio engine on the sound card
+	static void start_audio();
+
+	///Clock for now()
+	static sf::Clock clock;
+	///Clock that replaces the real one (empty if there is none)
+	static std::function<sf::Time()> custom_clock;
+	static InputSampler input;
+	static std::unique_ptr<JoystickSampler> joystick;
+	static LatencyMeter latency_meter;
 };
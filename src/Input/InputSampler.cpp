@@ -0,0 +1,75 @@
+/*
+ * PongX input sampler
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "InputSampler.hpp"
+
+bool InputSnapshot::is_key_pressed(sf::Keyboard::Key key) const {
+	if (key < 0 || key >= sf::Keyboard::KeyCount)
+		return false;
+	return keys[key];
+}
+
+float InputSnapshot::axis(sf::Keyboard::Key negative, sf::Keyboard::Key positive) const {
+	return static_cast<float>(is_key_pressed(positive)) - static_cast<float>(is_key_pressed(negative));
+}
+
+void InputSampler::handle_event(const sf::Event& event, sf::Time timestamp) {
+	if (event.type != sf::Event::KeyPressed && event.type != sf::Event::KeyReleased)
+		return;
+
+	sf::Keyboard::Key key = event.key.code;
+	if (key < 0 || key >= sf::Keyboard::KeyCount) //Unknown key
+		return;
+
+	if (event.type == sf::Event::KeyPressed) {
+		//Ignore key repeats, they are not new input
+		if (held[key])
+			return;
+		held[key] = true;
+		pressed_since_latch[key] = true;
+	}
+	else {
+		held[key] = false;
+	}
+
+	//Remember when the oldest unapplied input came
+	if (!has_new_input) {
+		has_new_input = true;
+		oldest_event_time = timestamp;
+	}
+}
+
+InputSnapshot InputSampler::latch(sf::Time timestamp) {
+	InputSnapshot snapshot;
+	snapshot.keys = held | pressed_since_latch;
+	snapshot.has_new_input = has_new_input;
+	snapshot.oldest_event_time = oldest_event_time;
+	snapshot.latch_time = timestamp;
+
+	//Start collecting the next input
+	pressed_since_latch.reset();
+	has_new_input = false;
+
+	return snapshot;
+}
+
+void InputSampler::reset() {
+	held.reset();
+	pressed_since_latch.reset();
+	has_new_input = false;
+}
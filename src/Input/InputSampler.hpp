@@ -0,0 +1,69 @@
+/*
+ * PongX input sampler
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <bitset>
+
+#include <SFML/System/Time.hpp>
+#include <SFML/Window/Event.hpp>
+#include <SFML/Window/Keyboard.hpp>
+
+///State of the keyboard latched by InputSampler (and of the stick, by JoystickSampler) for one simulation step
+struct InputSnapshot {
+	///Keys that are pressed now or were pressed since the previous latch (so short taps are not lost)
+	std::bitset<sf::Keyboard::KeyCount> keys;
+	///Average position of the analog stick since the previous latch (-1 - max up, 1 - max down, 0 without a stick)
+	float stick = 0.0F;
+	///Is there any key event (or stick move) since the previous latch?
+	bool has_new_input = false;
+	///Time of the oldest key event (or stick move) since the previous latch (valid if has_new_input)
+	sf::Time oldest_event_time;
+	///Time when the snapshot was latched
+	sf::Time latch_time;
+
+	bool is_key_pressed(sf::Keyboard::Key key) const;
+
+	///Get the axis value from 2 keys: -1 if only negative pressed, 1 if only positive, 0 otherwise
+	float axis(sf::Keyboard::Key negative, sf::Keyboard::Key positive) const;
+};
+
+///Builds the keyboard state from timestamped window events instead of polling the keyboard
+///at arbitrary points of the frame. The state is latched just before the simulation step
+class InputSampler {
+public:
+	///Record the key event. Events other than KeyPressed and KeyReleased are ignored
+	///@param timestamp time when the event was received
+	void handle_event(const sf::Event& event, sf::Time timestamp);
+
+	///Take the input for the simulation step and start collecting the next one
+	///@param timestamp current time
+	InputSnapshot latch(sf::Time timestamp);
+
+	///Forget all pressed keys (e.g. when the window loses focus)
+	void reset();
+
+private:
+	///Keys that are held now
+	std::bitset<sf::Keyboard::KeyCount> held;
+	///Keys that were pressed since the last latch (even if they are released already)
+	std::bitset<sf::Keyboard::KeyCount> pressed_since_latch;
+
+	bool has_new_input = false;
+	sf::Time oldest_event_time;
+};
@@ -0,0 +1,85 @@
+/*
+ * PongX analog stick devices
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "JoystickDevice.hpp"
+
+#include <algorithm>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <fcntl.h>
+#include <linux/joystick.h>
+#include <unistd.h>
+#endif
+
+LinuxJoystickDevice::LinuxJoystickDevice(const std::string& path, unsigned int axis) : path(path), axis(axis) { }
+
+std::unique_ptr<LinuxJoystickDevice> LinuxJoystickDevice::open(const std::string& path, unsigned int axis) {
+	std::unique_ptr<LinuxJoystickDevice> device(new LinuxJoystickDevice(path, axis));
+	if (!device->open_file())
+		return nullptr;
+	return device;
+}
+
+LinuxJoystickDevice::~LinuxJoystickDevice() {
+#if defined(__linux__)
+	if (file >= 0)
+		close(file);
+#endif
+}
+
+bool LinuxJoystickDevice::open_file() {
+#if defined(__linux__)
+	//Nonblocking, so a read takes only the events that came since the previous one
+	file = ::open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+	position = 0.0F;
+	return file >= 0;
+#else
+	return false;
+#endif
+}
+
+bool LinuxJoystickDevice::read(float& position) {
+#if defined(__linux__)
+	if (file < 0) {
+		if (++disconnected_reads < REOPEN_INTERVAL || !open_file())
+			return false;
+		disconnected_reads = 0;
+	}
+
+	//The driver sends the initial state as the events too, so the position is always known
+	js_event events[32];
+	ssize_t size;
+	while ((size = ::read(file, events, sizeof(events))) > 0) {
+		for (std::size_t i = 0; i < static_cast<std::size_t>(size) / sizeof(js_event); i++) {
+			if ((events[i].type & ~JS_EVENT_INIT) == JS_EVENT_AXIS && events[i].number == axis)
+				this->position = std::max(events[i].value / 32767.0F, -1.0F);
+		}
+	}
+	if (size < 0 && errno != EAGAIN) { //Unplugged
+		close(file);
+		file = -1;
+		return false;
+	}
+
+	position = this->position;
+	return true;
+#else
+	return false;
+#endif
+}
@@ -0,0 +1,69 @@
+/*
+ * PongX analog stick devices
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+///Source of the position of one analog axis. Read only by the thread of JoystickSampler
+class JoystickDevice {
+public:
+	virtual ~JoystickDevice() = default;
+
+	///Read the current position of the axis
+	///@param position the result: -1 - max up (left), 0 - center, 1 - max down (right) (reference)
+	///@returns false if the joystick is not connected
+	virtual bool read(float& position) = 0;
+};
+
+///Joystick of the Linux joystick API (/dev/input/jsN). The device has its own file, so it is read on the thread
+///of the sampler while the window reads the joysticks for its events. A disconnected joystick is opened again
+///every second. Other platforms have no device
+class LinuxJoystickDevice : public JoystickDevice {
+public:
+	///Reads between the attempts to open the disconnected joystick again (a second at 1 kHz)
+	static constexpr unsigned int REOPEN_INTERVAL = 1000;
+
+	///Open the joystick
+	///@param path device, e.g. "/dev/input/js0"
+	///@param axis number of the axis (1 - vertical axis of the left stick of the most gamepads)
+	///@returns nullptr if there is no such joystick
+	static std::unique_ptr<LinuxJoystickDevice> open(const std::string& path, unsigned int axis = 1);
+
+	LinuxJoystickDevice(const LinuxJoystickDevice&) = delete;
+	LinuxJoystickDevice& operator=(const LinuxJoystickDevice&) = delete;
+	~LinuxJoystickDevice() override;
+
+	bool read(float& position) override;
+
+private:
+	std::string path;
+	unsigned int axis;
+	///File of the joystick (-1 while disconnected)
+	int file = -1;
+	///Last position of the axis
+	float position = 0.0F;
+	///Reads since the joystick was disconnected
+	unsigned int disconnected_reads = 0;
+
+	LinuxJoystickDevice(const std::string& path, unsigned int axis);
+
+	///@returns false if the joystick can not be opened
+	bool open_file();
+};
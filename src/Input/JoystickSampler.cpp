@@ -0,0 +1,186 @@
+/*
+ * PongX high-frequency analog stick sampling
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "JoystickSampler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "../Utils/Metrics.hpp"
+
+static MetricHistogram read_interval_metric("pongx_joystick_read_interval_seconds",
+											"Time between two reads of the analog stick",
+											{ 250, 500, 900, 1100, 1500, 2000, 4000, 8000, 16000 }, 1e-6);
+static MetricCounter dropped_samples_metric("pongx_joystick_dropped_samples_total",
+											"Changes of the stick position lost because the queue was full");
+
+JoystickSampleQueue::JoystickSampleQueue(std::size_t capacity) {
+	std::size_t size = 1;
+	while (size < capacity)
+		size *= 2;
+	samples.reset(new JoystickSample[size]);
+	mask = size - 1;
+}
+
+bool JoystickSampleQueue::push(const JoystickSample& sample) {
+	std::size_t index = tail.load(std::memory_order_relaxed);
+	if (index - head.load(std::memory_order_acquire) > mask)
+		return false;
+	samples[index & mask] = sample;
+	tail.store(index + 1, std::memory_order_release);
+	return true;
+}
+
+bool JoystickSampleQueue::pop(JoystickSample& sample) {
+	std::size_t index = head.load(std::memory_order_relaxed);
+	if (index == tail.load(std::memory_order_acquire))
+		return false;
+	sample = samples[index & mask];
+	head.store(index + 1, std::memory_order_release);
+	return true;
+}
+
+bool JoystickSampleQueue::peek(JoystickSample& sample) const {
+	std::size_t index = head.load(std::memory_order_relaxed);
+	if (index == tail.load(std::memory_order_acquire))
+		return false;
+	sample = samples[index & mask];
+	return true;
+}
+
+JoystickSampler::JoystickSampler(std::unique_ptr<JoystickDevice> device, JoystickSettings settings) :
+	device(std::move(device)), settings(std::move(settings)), samples(this->settings.queue_capacity) {
+	if (!this->settings.clock) {
+		std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+		this->settings.clock = [epoch]() {
+			return sf::microseconds(std::chrono::duration_cast<std::chrono::microseconds>(
+				std::chrono::steady_clock::now() - epoch).count());
+		};
+	}
+	integrated_until = this->settings.clock();
+}
+
+std::unique_ptr<JoystickSampler> JoystickSampler::start(std::unique_ptr<JoystickDevice> device,
+														JoystickSettings settings) {
+	if (!device)
+		return nullptr;
+
+	std::unique_ptr<JoystickSampler> sampler(new JoystickSampler(std::move(device), std::move(settings)));
+	JoystickSampler* thread_sampler = sampler.get();
+	sampler->thread = std::thread([thread_sampler]() { thread_sampler->run(); });
+	return sampler;
+}
+
+JoystickSampler::~JoystickSampler() {
+	stop_requested.store(true);
+	thread.join();
+}
+
+void JoystickSampler::latch(InputSnapshot& snapshot) {
+	sf::Time start = integrated_until, end = std::max(snapshot.latch_time, integrated_until);
+	JoystickSample sample;
+
+	std::uint64_t dropped = dropped_samples.load(std::memory_order_acquire);
+	if (dropped != seen_dropped_samples) {
+		//Some changes are lost (nobody latched for a long time), so the history is useless: start from now.
+		//The reads that failed before the queue was emptied are seen too
+		while (samples.pop(sample)) { }
+		seen_dropped_samples = dropped_samples.load(std::memory_order_acquire);
+		position = last_position.load(std::memory_order_acquire);
+		integrated_until = end;
+		snapshot.stick = position;
+		return;
+	}
+
+	//The position holds from one sample till the next one. Microseconds, so the sum is exact
+	double sum = 0.0;
+	//The samples read after the latch stay for the next step
+	while (samples.peek(sample) && sample.time <= end) {
+		samples.pop(sample);
+		sf::Time time = std::max(sample.time, integrated_until);
+		sum += position * static_cast<double>((time - integrated_until).asMicroseconds());
+		integrated_until = time;
+		position = sample.position;
+
+		if (!snapshot.has_new_input || sample.time < snapshot.oldest_event_time) {
+			snapshot.has_new_input = true;
+			snapshot.oldest_event_time = sample.time;
+		}
+	}
+	sum += position * static_cast<double>((end - integrated_until).asMicroseconds());
+	integrated_until = end;
+
+	snapshot.stick = end > start ? static_cast<float>(sum / (end - start).asMicroseconds()) : position;
+}
+
+std::uint64_t JoystickSampler::get_read_count() const {
+	return read_count.load(std::memory_order_relaxed);
+}
+
+std::uint64_t JoystickSampler::get_dropped_samples() const {
+	return dropped_samples.load(std::memory_order_relaxed);
+}
+
+sf::Time JoystickSampler::get_max_read_interval() const {
+	return sf::microseconds(max_read_interval.load(std::memory_order_relaxed));
+}
+
+void JoystickSampler::run() {
+	const std::chrono::nanoseconds period(1000000000LL / std::max(settings.rate, 1U));
+	std::chrono::steady_clock::time_point next_read = std::chrono::steady_clock::now(), previous_read;
+	float sent_position = 0.0F;
+
+	while (!stop_requested.load(std::memory_order_relaxed)) {
+		//The disconnected stick is in the center
+		float raw_position, position = device->read(raw_position) ? shape(raw_position) : 0.0F;
+		sf::Time time = settings.clock();
+
+		std::chrono::steady_clock::time_point read_time = std::chrono::steady_clock::now();
+		if (read_count.fetch_add(1, std::memory_order_relaxed) != 0) {
+			std::int64_t interval =
+				std::chrono::duration_cast<std::chrono::microseconds>(read_time - previous_read).count();
+			read_interval_metric.record(static_cast<std::uint64_t>(interval));
+			if (interval > max_read_interval.load(std::memory_order_relaxed))
+				max_read_interval.store(interval, std::memory_order_relaxed);
+		}
+		previous_read = read_time;
+
+		//Only the changes are sent. The change that does not fit is sent again by the next read
+		if (position != sent_position) {
+			if (samples.push({ time, position })) {
+				sent_position = position;
+			} else {
+				dropped_samples.fetch_add(1, std::memory_order_release);
+				dropped_samples_metric.add();
+			}
+		}
+		last_position.store(position, std::memory_order_release);
+
+		//A late thread does not catch up with a burst of reads
+		next_read = std::max(next_read + period, read_time);
+		std::this_thread::sleep_until(next_read);
+	}
+}
+
+float JoystickSampler::shape(float raw_position) const {
+	float magnitude = std::min(std::abs(raw_position), 1.0F);
+	if (magnitude <= settings.dead_zone)
+		return 0.0F;
+	return std::copysign((magnitude - settings.dead_zone) / (1.0F - settings.dead_zone), raw_position);
+}
@@ -0,0 +1,130 @@
+/*
+ * PongX high-frequency analog stick sampling
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+
+#include <SFML/System/Time.hpp>
+
+#include "InputSampler.hpp"
+#include "JoystickDevice.hpp"
+
+///Position of the stick since the time
+struct JoystickSample {
+	sf::Time time;
+	float position;
+};
+
+///Single-producer single-consumer ring of the samples
+class JoystickSampleQueue {
+public:
+	///@param capacity most samples waiting for the simulation (rounded up to a power of 2)
+	JoystickSampleQueue(std::size_t capacity);
+
+	///Called only by the sampling thread
+	///@returns false if the queue is full
+	bool push(const JoystickSample& sample);
+	///Called only by the simulation thread
+	///@returns false if the queue is empty
+	bool pop(JoystickSample& sample);
+	///Get the oldest sample without taking it. Called only by the simulation thread
+	///@returns false if the queue is empty
+	bool peek(JoystickSample& sample) const;
+
+private:
+	std::unique_ptr<JoystickSample[]> samples;
+	std::size_t mask;
+	///Written by the sampler and the simulation, so they are on different cache lines
+	alignas(64) std::atomic<std::size_t> tail { 0 };
+	alignas(64) std::atomic<std::size_t> head { 0 };
+};
+
+struct JoystickSettings {
+	///Reads of the device per second
+	unsigned int rate = 1000;
+	///Positions closer to the center are 0, the rest is stretched to [-1;1]
+	float dead_zone = 0.1F;
+	///Most samples waiting for the simulation. More are dropped (e.g. while no match is played)
+	std::size_t queue_capacity = 1024;
+	///Clock of the timestamps, the same as the one of InputSnapshot::latch_time (default: time since start())
+	std::function<sf::Time()> clock;
+};
+
+///Reads the analog stick on its own thread with the high frequency and sends the changes of the position
+///with their timestamps through the lock-free queue. The simulation takes the position averaged over the time
+///since the previous step, so the control does not depend on the frame rate and the short moves are not lost
+class JoystickSampler {
+public:
+	///Start the sampling thread
+	///@returns nullptr if there is no device
+	static std::unique_ptr<JoystickSampler> start(std::unique_ptr<JoystickDevice> device,
+												  JoystickSettings settings = JoystickSettings());
+
+	JoystickSampler(const JoystickSampler&) = delete;
+	JoystickSampler& operator=(const JoystickSampler&) = delete;
+	///Stop the sampling thread
+	~JoystickSampler();
+
+	///Set InputSnapshot::stick to the average position since the previous latch() (till snapshot.latch_time).
+	///The samples count as new input for the latency (has_new_input, oldest_event_time).
+	///Called only by the simulation thread
+	void latch(InputSnapshot& snapshot);
+
+	///Get amount of the reads of the device
+	std::uint64_t get_read_count() const;
+	///Get amount of the samples dropped because the queue was full
+	std::uint64_t get_dropped_samples() const;
+	///Get the longest time between two reads of the device
+	sf::Time get_max_read_interval() const;
+
+private:
+	std::unique_ptr<JoystickDevice> device;
+	JoystickSettings settings;
+	JoystickSampleQueue samples;
+
+	//BEGIN Sampling thread
+	///Position of the last read, for the resync after the dropped samples
+	std::atomic<float> last_position { 0.0F };
+	std::atomic<std::uint64_t> read_count { 0 };
+	std::atomic<std::uint64_t> dropped_samples { 0 };
+	///Microseconds
+	std::atomic<std::int64_t> max_read_interval { 0 };
+	std::atomic<bool> stop_requested { false };
+	std::thread thread;
+	//END Sampling thread
+
+	//BEGIN Simulation thread
+	///Position since integrated_until
+	float position = 0.0F;
+	///End of the time averaged by the previous latch()
+	sf::Time integrated_until;
+	///Dropped samples seen by the previous latch()
+	std::uint64_t seen_dropped_samples = 0;
+	//END Simulation thread
+
+	JoystickSampler(std::unique_ptr<JoystickDevice> device, JoystickSettings settings);
+
+	void run();
+	///Apply the dead zone
+	float shape(float raw_position) const;
+};
@@ -0,0 +1,76 @@
+/*
+ * PongX input latency meter
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LatencyMeter.hpp"
+
+sf::Time FrameLatency::stage_duration(LatencyStage stage) const {
+	if (stage == InputReceived)
+		return sf::Time::Zero;
+	return stage_times[stage] - stage_times[stage - 1];
+}
+
+sf::Time FrameLatency::total() const {
+	return stage_times[Presented] - stage_times[InputReceived];
+}
+
+void LatencyMeter::mark(LatencyStage stage, sf::Time timestamp) {
+	current_frame.stage_times[stage] = timestamp;
+	if (stage == InputReceived)
+		current_frame.has_input = true;
+}
+
+void LatencyMeter::end_frame() {
+	//Frames without input say nothing about input latency
+	if (current_frame.has_input) {
+		last_frame = current_frame;
+
+		sf::Time total = current_frame.total();
+		if (total > worst_total)
+			worst_total = total;
+		sum_total += total;
+		frames_with_input++;
+	}
+
+	current_frame = FrameLatency();
+}
+
+const FrameLatency& LatencyMeter::get_last_frame() const {
+	return last_frame;
+}
+
+sf::Time LatencyMeter::get_worst_total() const {
+	return worst_total;
+}
+
+sf::Time LatencyMeter::get_average_total() const {
+	if (frames_with_input == 0)
+		return sf::Time::Zero;
+	return sf::microseconds(sum_total.asMicroseconds() / frames_with_input);
+}
+
+unsigned int LatencyMeter::get_frames_with_input() const {
+	return frames_with_input;
+}
+
+void LatencyMeter::reset() {
+	current_frame = FrameLatency();
+	last_frame = FrameLatency();
+	worst_total = sf::Time::Zero;
+	sum_total = sf::Time::Zero;
+	frames_with_input = 0;
+}
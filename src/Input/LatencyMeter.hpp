@@ -0,0 +1,79 @@
+/*
+ * PongX input latency meter
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <SFML/System/Time.hpp>
+
+///Stages of the frame that the input goes through, in order
+enum LatencyStage : unsigned char {
+	///Input event received by the main loop
+	InputReceived,
+	///Input latched for the simulation step
+	InputLatched,
+	///Simulation step with the input done
+	Simulated,
+	///Frame drawn
+	Rendered,
+	///Frame displayed (buffers swapped)
+	Presented,
+	LatencyStageCount
+};
+
+///Timeline of the input through the stages of one frame
+struct FrameLatency {
+	///Time of every stage
+	sf::Time stage_times[LatencyStageCount];
+	///Is there any input in this frame? If not, only the times from InputLatched are valid
+	bool has_input = false;
+
+	///Time spent between the previous stage and the specified one
+	sf::Time stage_duration(LatencyStage stage) const;
+	///Input-to-present latency
+	sf::Time total() const;
+};
+
+///Measures how stale the input is when the frame that uses it is presented
+class LatencyMeter {
+public:
+	///Mark the stage of the current frame
+	void mark(LatencyStage stage, sf::Time timestamp);
+
+	///Finish the current frame. Call it after the Presented stage
+	void end_frame();
+
+	///Get the latency of the last finished frame with input
+	const FrameLatency& get_last_frame() const;
+	///Get the maximal input-to-present latency since the last reset()
+	sf::Time get_worst_total() const;
+	///Get the average input-to-present latency since the last reset()
+	sf::Time get_average_total() const;
+	///Get amount of finished frames with input since the last reset()
+	unsigned int get_frames_with_input() const;
+
+	///Reset the statistics
+	void reset();
+
+private:
+	FrameLatency current_frame;
+	FrameLatency last_frame;
+
+	sf::Time worst_total;
+	sf::Time sum_total;
+	unsigned int frames_with_input = 0;
+};
@@ -0,0 +1,155 @@
+/*
+ * PongX exporter of the runtime metrics
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MetricsExporter.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <sstream>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "../Utils/Metrics.hpp"
+
+#if !defined(_WIN32) && defined(MSG_NOSIGNAL)
+///A client that closed the connection must not kill the process with SIGPIPE
+static constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+static constexpr int SEND_FLAGS = 0;
+#endif
+
+///How often the thread checks the stop request
+static constexpr int POLL_INTERVAL_MS = 100;
+///How often the file is rewritten
+static constexpr auto FILE_INTERVAL = std::chrono::seconds(1);
+
+std::unique_ptr<MetricsExporter> MetricsExporter::start(unsigned short port, const std::string& file_path) {
+	std::unique_ptr<MetricsExporter> exporter(new MetricsExporter());
+	exporter->file_path = file_path;
+
+	if (port != 0) {
+#ifndef _WIN32
+		exporter->socket = ::socket(AF_INET, SOCK_STREAM, 0);
+		if (exporter->socket < 0)
+			return nullptr;
+		int reuse = 1;
+		setsockopt(exporter->socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+		//Only this machine can read the metrics
+		sockaddr_in address = { };
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		address.sin_port = htons(port);
+		socklen_t address_size = sizeof(address);
+		if (bind(exporter->socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+			listen(exporter->socket, 8) != 0 ||
+			getsockname(exporter->socket, reinterpret_cast<sockaddr*>(&address), &address_size) != 0) {
+			close(exporter->socket);
+			return nullptr;
+		}
+		exporter->port = ntohs(address.sin_port);
+#else
+		return nullptr;
+#endif
+	}
+
+	MetricsExporter* thread_exporter = exporter.get();
+	exporter->thread = std::thread([thread_exporter]() { thread_exporter->run(); });
+	return exporter;
+}
+
+MetricsExporter::~MetricsExporter() {
+	stop_requested = true;
+	if (thread.joinable())
+		thread.join();
+#ifndef _WIN32
+	if (socket >= 0)
+		close(socket);
+#endif
+	if (!file_path.empty())
+		Metrics::write_file(file_path);
+}
+
+unsigned short MetricsExporter::get_port() const {
+	return port;
+}
+
+void MetricsExporter::run() {
+	auto next_write = std::chrono::steady_clock::now();
+	while (!stop_requested) {
+		if (!file_path.empty() && std::chrono::steady_clock::now() >= next_write) {
+			Metrics::write_file(file_path);
+			next_write += FILE_INTERVAL;
+		}
+
+#ifndef _WIN32
+		if (socket >= 0) {
+			pollfd listener = { socket, POLLIN, 0 };
+			if (poll(&listener, 1, POLL_INTERVAL_MS) > 0) {
+				int connection = accept(socket, nullptr, nullptr);
+				if (connection >= 0)
+					serve(connection);
+			}
+			continue;
+		}
+#endif
+		std::this_thread::sleep_for(std::chrono::milliseconds(POLL_INTERVAL_MS));
+	}
+}
+
+void MetricsExporter::serve(int connection) {
+#ifndef _WIN32
+	//Read the request line, the headers are not needed. A slow client does not block the exporter for long
+	timeval timeout = { 0, POLL_INTERVAL_MS * 1000 };
+	setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+	setsockopt(connection, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+	char request[1024];
+	long size = recv(connection, request, sizeof(request) - 1, 0);
+	request[size > 0 ? size : 0] = '\0';
+
+	std::ostringstream body;
+	const char* status = "200 OK";
+	if (std::strncmp(request, "GET /metrics ", 13) == 0 || std::strncmp(request, "GET / ", 6) == 0) {
+		Metrics::write_prometheus(body);
+	} else {
+		status = "404 Not Found";
+		body << "Not found, the metrics are at /metrics\n";
+	}
+
+	std::string text = body.str();
+	std::ostringstream response;
+	response << "HTTP/1.1 " << status << "\r\n"
+			 << "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+			 << "Content-Length: " << text.size() << "\r\n"
+			 << "Connection: close\r\n\r\n" << text;
+	std::string bytes = response.str();
+	for (std::size_t sent = 0; sent < bytes.size();) {
+		long result = send(connection, bytes.data() + sent, bytes.size() - sent, SEND_FLAGS);
+		if (result <= 0)
+			break;
+		sent += static_cast<std::size_t>(result);
+	}
+	close(connection);
+#endif
+}
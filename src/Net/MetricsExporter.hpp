@@ -0,0 +1,58 @@
+/*
+ * PongX exporter of the runtime metrics
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+///Exports the metrics (see Metrics) from a background thread: serves them over HTTP on 127.0.0.1 for Prometheus
+///and/or rewrites the text file every second (e.g. for the textfile collector of node_exporter).
+///HTTP is not available on Windows
+class MetricsExporter {
+public:
+	///Start the export
+	///@param port port of the HTTP endpoint /metrics (0 - no endpoint)
+	///@param file_path the file to rewrite (empty - no file)
+	///@returns nullptr if the port can not be listened
+	static std::unique_ptr<MetricsExporter> start(unsigned short port, const std::string& file_path);
+
+	MetricsExporter(const MetricsExporter&) = delete;
+	MetricsExporter& operator=(const MetricsExporter&) = delete;
+	///Stop the thread, the file is written for the last time
+	~MetricsExporter();
+
+	///Get the port of the endpoint (e.g. if any free port was requested)
+	unsigned short get_port() const;
+
+private:
+	///Listening socket (-1 - no endpoint)
+	int socket = -1;
+	unsigned short port = 0;
+	std::string file_path;
+	std::atomic<bool> stop_requested { false };
+	std::thread thread;
+
+	MetricsExporter() = default;
+
+	void run();
+	///Answer the request of the accepted connection and close it
+	void serve(int connection);
+};
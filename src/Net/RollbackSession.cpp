@@ -0,0 +1,129 @@
+/*
+ * PongX rollback session
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <climits>
+
+#include "RollbackSession.hpp"
+
+///Tick of the empty slot of the remote inputs
+constexpr unsigned int NO_TICK = UINT_MAX;
+
+RollbackSession::RollbackSession(ServerSettings settings, bool is_host, unsigned int max_rollback) {
+	settings.server_type = is_host ? LocalNetworkHost : LocalNetworkClient;
+	server.reset(Server::create(settings));
+	this->is_host = is_host;
+
+	frames.resize(std::max(max_rollback, 1U));
+	remote_inputs.resize(frames.size() * 2, { NO_TICK, 0 });
+}
+
+bool RollbackSession::advance(PeerInput local_input) {
+	//The savestate of the earliest unconfirmed tick must stay in the ring
+	if (tick - confirmed_tick >= frames.size())
+		return false;
+
+	resimulate();
+	simulate(tick, local_input);
+	tick++;
+	rollback_tick = tick;
+	return true;
+}
+
+bool RollbackSession::receive_remote_input(unsigned int input_tick, PeerInput input) {
+	if (input_tick < confirmed_tick)
+		return true; //Already confirmed
+	if (input_tick >= tick + frames.size())
+		return false;
+
+	RemoteInput& slot = remote_inputs[input_tick % remote_inputs.size()];
+	if (slot.tick == input_tick)
+		return true; //Duplicate
+	slot = { input_tick, input };
+
+	//Move the confirmed tick over the inputs received without gaps. That changes the prediction too
+	unsigned int previous_confirmed_tick = confirmed_tick;
+	while (remote_inputs[confirmed_tick % remote_inputs.size()].tick == confirmed_tick) {
+		last_confirmed_input = remote_inputs[confirmed_tick % remote_inputs.size()].input;
+		confirmed_tick++;
+	}
+
+	//Find the earliest simulated tick whose input turned out to be different
+	for (unsigned int cur_tick = previous_confirmed_tick; cur_tick < tick; cur_tick++) {
+		if (remote_input(cur_tick) != frames[cur_tick % frames.size()].used_remote_input) {
+			rollback_tick = std::min(rollback_tick, cur_tick);
+			break;
+		}
+	}
+	return true;
+}
+
+void RollbackSession::resimulate() {
+	if (rollback_tick >= tick)
+		return;
+
+	//Restore the state before the mispredicted tick and go through the ticks again with the new inputs
+	server->load_state(frames[rollback_tick % frames.size()].state);
+	for (unsigned int cur_tick = rollback_tick; cur_tick < tick; cur_tick++)
+		simulate(cur_tick, frames[cur_tick % frames.size()].local_input);
+
+	rollback_count++;
+	resimulated_ticks += tick - rollback_tick;
+	rollback_tick = tick;
+}
+
+void RollbackSession::simulate(unsigned int frame_tick, PeerInput local_input) {
+	Frame& frame = frames[frame_tick % frames.size()];
+	server->save_state(frame.state);
+	frame.local_input = local_input;
+	frame.used_remote_input = remote_input(frame_tick);
+
+	float local_speed = local_input / 127.0F, remote_speed = frame.used_remote_input / 127.0F;
+	server->player_relative_speed = is_host ? local_speed : remote_speed;
+	server->set_enemy_relative_speed(is_host ? remote_speed : local_speed);
+	server->update();
+}
+
+PeerInput RollbackSession::remote_input(unsigned int input_tick) {
+	const RemoteInput& slot = remote_inputs[input_tick % remote_inputs.size()];
+	if (slot.tick == input_tick)
+		return slot.input;
+
+	//Prediction: the remote peer keeps pressing the same keys
+	return last_confirmed_input;
+}
+
+Server& RollbackSession::get_server() {
+	return *server;
+}
+
+unsigned int RollbackSession::get_tick() {
+	return tick;
+}
+
+unsigned int RollbackSession::get_confirmed_tick() {
+	return confirmed_tick;
+}
+
+unsigned int RollbackSession::get_rollback_count() {
+	return rollback_count;
+}
+
+unsigned long long RollbackSession::get_resimulated_ticks() {
+	return resimulated_ticks;
+}
@@ -0,0 +1,105 @@
+/*
+ * PongX rollback session
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "../Server/Server.hpp"
+
+///Input of one peer for one tick: relative speed of its paddle multiplied by 127.
+///Integer, so both peers simulate bit-exactly the same speeds
+typedef std::int8_t PeerInput;
+
+///Rollback (GGPO-like) synchronization of the peer-to-peer match. Peers exchange only their inputs.
+///A missing remote input is predicted (the last confirmed one is repeated). When the real input differs
+///from the prediction, the server is restored to the savestate of that tick and the ticks since are simulated again
+class RollbackSession {
+public:
+	///@param settings settings of the match, the same on both peers (including the seed)
+	///@param is_host does the local peer control the player's paddle (otherwise the enemy's one)?
+	///@param max_rollback maximal amount of ticks the local peer can be ahead of the remote inputs
+	RollbackSession(ServerSettings settings, bool is_host, unsigned int max_rollback = 16);
+
+	///Simulate the next tick with the local input (send the input to the remote peer after that).
+	///Applies the pending rollback first
+	///@returns false if the remote peer is too far behind: nothing is done, try again later
+	bool advance(PeerInput local_input);
+
+	///Take the remote input of the tick. Inputs may come in any order and more than once
+	///@returns false if the tick is too far ahead (the remote peer does not stall when it has to)
+	bool receive_remote_input(unsigned int tick, PeerInput input);
+
+	///Restore the server to the earliest mispredicted tick and simulate the ticks since again.
+	///Called by advance(), call it to see the corrected state without advancing
+	void resimulate();
+
+	///Get the server in the state after the last simulated tick
+	Server& get_server();
+
+	///Get the number of the next tick to simulate
+	unsigned int get_tick();
+	///Get the number of the first tick whose remote input has not been received yet
+	unsigned int get_confirmed_tick();
+	///Get amount of the rollbacks
+	unsigned int get_rollback_count();
+	///Get amount of ticks simulated again by the rollbacks
+	unsigned long long get_resimulated_ticks();
+
+private:
+	///Everything about one simulated tick
+	struct Frame {
+		///State before the tick
+		ServerState state;
+		PeerInput local_input;
+		///Remote input the tick was simulated with (received or predicted)
+		PeerInput used_remote_input;
+	};
+
+	///Remote input received for the tick
+	struct RemoteInput {
+		unsigned int tick;
+		PeerInput input;
+	};
+
+	std::unique_ptr<Server> server;
+	bool is_host;
+
+	///Ring of the last max_rollback ticks, preallocated, the tick is at frames[tick % size]
+	std::vector<Frame> frames;
+	///Ring of the received remote inputs of 2 * max_rollback ticks. The remote peer is never more
+	///than max_rollback ticks ahead, so the inputs of the ticks in frames are never overwritten
+	std::vector<RemoteInput> remote_inputs;
+	///Remote input of the tick before confirmed_tick, it is the prediction
+	PeerInput last_confirmed_input = 0;
+
+	unsigned int tick = 0;
+	unsigned int confirmed_tick = 0;
+	///The earliest tick simulated with the wrong remote input (tick if none)
+	unsigned int rollback_tick = 0;
+
+	unsigned int rollback_count = 0;
+	unsigned long long resimulated_ticks = 0;
+
+	///Get the remote input of the tick: the received one or the prediction
+	PeerInput remote_input(unsigned int input_tick);
+	///Save the state, apply the inputs and simulate the tick
+	void simulate(unsigned int frame_tick, PeerInput local_input);
+};
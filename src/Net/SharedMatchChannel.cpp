@@ -0,0 +1,191 @@
+/*
+ * PongX shared memory channel between a simulation and a viewer
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SharedMatchChannel.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <new>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+static constexpr char MAGIC[4] = { 'P', 'X', 'S', 'M' };
+static constexpr std::uint32_t VERSION = 1;
+///Reads of the seqlock before the viewer gives up
+static constexpr unsigned int READ_ATTEMPTS = 64;
+///MatchSnapshot is copied in words of 8 bytes
+static constexpr std::size_t SNAPSHOT_WORDS = sizeof(MatchSnapshot) / sizeof(std::uint64_t);
+static_assert(sizeof(MatchSnapshot) % sizeof(std::uint64_t) == 0, "MatchSnapshot is copied in words");
+
+struct SharedMatchChannel::Region {
+	///Written by the simulation after the rest of the region is ready
+	std::atomic<std::uint32_t> magic;
+	std::uint32_t version;
+	///Sequence of the seqlock: odd while the snapshot is written, 0 - nothing is published yet
+	std::atomic<std::uint32_t> sequence;
+	std::uint32_t reserved;
+	std::atomic<std::uint64_t> snapshot[SNAPSHOT_WORDS];
+	///Time of the last publish
+	std::atomic<std::int64_t> publish_time;
+
+	//BEGIN Mailbox
+	///Bits of the float speed of the player's paddle
+	std::atomic<std::uint32_t> input;
+	///Time of the last input
+	std::atomic<std::int64_t> input_time;
+	//END Mailbox
+};
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free && std::atomic<std::int64_t>::is_always_lock_free,
+			  "Atomics of the shared memory must not use locks of the process");
+
+///Name of the shared memory object (it starts with a slash)
+static std::string object_name(const std::string& name) {
+	return name.empty() || name[0] != '/' ? '/' + name : name;
+}
+
+std::unique_ptr<SharedMatchChannel> SharedMatchChannel::create(const std::string& name) {
+#ifndef _WIN32
+	std::string path = object_name(name);
+	//Never take over (and later remove) the channel of the other running simulation
+	int file = shm_open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+	if (file < 0)
+		return nullptr;
+	if (ftruncate(file, sizeof(Region)) != 0) {
+		close(file);
+		shm_unlink(path.c_str());
+		return nullptr;
+	}
+	void* memory = mmap(nullptr, sizeof(Region), PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+	close(file);
+	if (memory == MAP_FAILED) {
+		shm_unlink(path.c_str());
+		return nullptr;
+	}
+
+	std::unique_ptr<SharedMatchChannel> channel(new SharedMatchChannel());
+	channel->region = new (memory) Region();
+	channel->name = path;
+	channel->is_owner = true;
+	channel->region->version = VERSION;
+	std::uint32_t magic;
+	std::memcpy(&magic, MAGIC, sizeof(magic));
+	channel->region->magic.store(magic, std::memory_order_release);
+	return channel;
+#else
+	return nullptr;
+#endif
+}
+
+std::unique_ptr<SharedMatchChannel> SharedMatchChannel::attach(const std::string& name) {
+#ifndef _WIN32
+	std::string path = object_name(name);
+	int file = shm_open(path.c_str(), O_RDWR, 0);
+	if (file < 0)
+		return nullptr;
+	struct stat status;
+	if (fstat(file, &status) != 0 || static_cast<std::size_t>(status.st_size) < sizeof(Region)) {
+		close(file);
+		return nullptr;
+	}
+	void* memory = mmap(nullptr, sizeof(Region), PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+	close(file);
+	if (memory == MAP_FAILED)
+		return nullptr;
+
+	std::unique_ptr<SharedMatchChannel> channel(new SharedMatchChannel());
+	channel->region = static_cast<Region*>(memory);
+	channel->name = path;
+	std::uint32_t magic = channel->region->magic.load(std::memory_order_acquire);
+	if (std::memcmp(&magic, MAGIC, sizeof(magic)) != 0 || channel->region->version != VERSION)
+		return nullptr;
+	return channel;
+#else
+	return nullptr;
+#endif
+}
+
+SharedMatchChannel::~SharedMatchChannel() {
+#ifndef _WIN32
+	if (region != nullptr)
+		munmap(region, sizeof(Region));
+	if (is_owner)
+		shm_unlink(name.c_str());
+#endif
+}
+
+void SharedMatchChannel::publish(const MatchSnapshot& snapshot) {
+	std::uint64_t words[SNAPSHOT_WORDS];
+	std::memcpy(words, &snapshot, sizeof(words));
+
+	//Odd sequence: the readers that see it or any of the new words retry
+	region->sequence.store(++sequence, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	for (std::size_t i = 0; i < SNAPSHOT_WORDS; i++)
+		region->snapshot[i].store(words[i], std::memory_order_relaxed);
+	region->sequence.store(++sequence, std::memory_order_release);
+	region->publish_time.store(now_ms(), std::memory_order_relaxed);
+}
+
+bool SharedMatchChannel::take_input(float& relative_speed) const {
+	if (now_ms() - region->input_time.load(std::memory_order_acquire) > INPUT_TIMEOUT_MS)
+		return false;
+	std::uint32_t bits = region->input.load(std::memory_order_relaxed);
+	std::memcpy(&relative_speed, &bits, sizeof(bits));
+	return true;
+}
+
+bool SharedMatchChannel::read(MatchSnapshot& snapshot) const {
+	std::uint64_t words[SNAPSHOT_WORDS];
+	for (unsigned int attempt = 0; attempt < READ_ATTEMPTS; attempt++) {
+		std::uint32_t before = region->sequence.load(std::memory_order_acquire);
+		if (before == 0)
+			return false;
+		if (before % 2 != 0)
+			continue;
+		for (std::size_t i = 0; i < SNAPSHOT_WORDS; i++)
+			words[i] = region->snapshot[i].load(std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (region->sequence.load(std::memory_order_relaxed) == before) {
+			std::memcpy(&snapshot, words, sizeof(words));
+			return true;
+		}
+	}
+	return false;
+}
+
+std::int64_t SharedMatchChannel::get_publish_age() const {
+	return now_ms() - region->publish_time.load(std::memory_order_relaxed);
+}
+
+void SharedMatchChannel::send_input(float relative_speed) {
+	std::uint32_t bits;
+	std::memcpy(&bits, &relative_speed, sizeof(bits));
+	region->input.store(bits, std::memory_order_relaxed);
+	region->input_time.store(now_ms(), std::memory_order_release);
+}
+
+std::int64_t SharedMatchChannel::now_ms() {
+	//steady_clock is CLOCK_MONOTONIC, it is shared by the processes
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
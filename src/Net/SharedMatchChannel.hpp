@@ -0,0 +1,86 @@
+/*
+ * PongX shared memory channel between a simulation and a viewer
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "../Server/MatchSnapshot.hpp"
+
+///Snapshots of a running match in POSIX shared memory, for a viewer process that attaches to the simulation.
+///The simulation publishes every tick under a seqlock: it never waits for the viewer, and the viewer retries
+///the read if it overlapped a write. The viewer sends its input back through a mailbox of one word.
+///Only lock-free atomics are shared, so a viewer that crashes at any moment leaves no broken state behind:
+///its input just expires. Viewers attach and detach at any time. Not available on Windows
+class SharedMatchChannel {
+public:
+	///Input older than this is ignored (the viewer is gone or does not control the paddle)
+	static constexpr std::int64_t INPUT_TIMEOUT_MS = 250;
+
+	///Create the channel of the simulation. It is removed when the object is destroyed
+	///@param name name of the shared memory object
+	///@returns nullptr if the shared memory can not be created or the name is taken (by the other simulation,
+	///or left by a crashed one: then remove /dev/shm/<name>)
+	static std::unique_ptr<SharedMatchChannel> create(const std::string& name);
+	///Attach the viewer to the channel of a running simulation
+	///@returns nullptr if there is no channel of this version with this name
+	static std::unique_ptr<SharedMatchChannel> attach(const std::string& name);
+
+	SharedMatchChannel(const SharedMatchChannel&) = delete;
+	SharedMatchChannel& operator=(const SharedMatchChannel&) = delete;
+	~SharedMatchChannel();
+
+	//BEGIN Simulation
+	///Publish the state of the tick. Wait-free
+	void publish(const MatchSnapshot& snapshot);
+	///Take the last input of the viewer
+	///@param relative_speed the result: speed of the player's paddle (reference)
+	///@returns false if no viewer sent input in the last INPUT_TIMEOUT_MS
+	bool take_input(float& relative_speed) const;
+	//END Simulation
+
+	//BEGIN Viewer
+	///Read the last published state
+	///@param snapshot the result (reference)
+	///@returns false if nothing is published yet or the simulation was writing all the time
+	bool read(MatchSnapshot& snapshot) const;
+	///Get the time since the last publish in milliseconds (e.g. to see that the simulation stopped)
+	std::int64_t get_publish_age() const;
+	///Put the input of the viewer into the mailbox
+	void send_input(float relative_speed);
+	//END Viewer
+
+private:
+	///The shared memory. Only lock-free atomics are written concurrently
+	struct Region;
+
+	Region* region = nullptr;
+	std::string name;
+	///Did this process create the channel? Only the simulation removes it
+	bool is_owner = false;
+	///Sequence of the seqlock, only the simulation writes it
+	std::uint32_t sequence = 0;
+
+	SharedMatchChannel() = default;
+
+	///Monotonic time in milliseconds, the same clock in every process of the machine
+	static std::int64_t now_ms();
+};
@@ -0,0 +1,221 @@
+/*
+ * PongX relay of a match to its spectators
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SpectatorRelay.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+SocketSpectatorConnection::SocketSpectatorConnection(int socket) {
+	this->socket = socket;
+}
+
+SocketSpectatorConnection::~SocketSpectatorConnection() {
+	close(socket);
+}
+
+long SocketSpectatorConnection::send(const SendChunk* chunks, unsigned int count) {
+	iovec vectors[MAX_CHUNKS];
+	count = std::min(count, MAX_CHUNKS);
+	for (unsigned int i = 0; i < count; i++) {
+		vectors[i].iov_base = const_cast<void*>(chunks[i].data);
+		vectors[i].iov_len = chunks[i].size;
+	}
+
+	msghdr message = { };
+	message.msg_iov = vectors;
+	message.msg_iovlen = count;
+#ifdef MSG_NOSIGNAL
+	ssize_t result = sendmsg(socket, &message, MSG_DONTWAIT | MSG_NOSIGNAL);
+#else
+	ssize_t result = sendmsg(socket, &message, MSG_DONTWAIT);
+#endif
+	if (result < 0)
+		return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ? 0 : -1;
+	return static_cast<long>(result);
+}
+#endif
+
+SpectatorRelay::SpectatorRelay(unsigned int max_delay, unsigned int max_backlog, unsigned int keyframe_interval) :
+	frames(max_delay + max_backlog + 1) {
+	this->max_delay = max_delay;
+	this->max_backlog = max_backlog;
+	this->keyframe_interval = std::max(keyframe_interval, 1U);
+}
+
+unsigned int SpectatorRelay::add_viewer(std::unique_ptr<SpectatorConnection> connection, unsigned int delay) {
+	delay = std::min(delay, max_delay);
+	//The first keyframe that is not due yet
+	std::uint64_t start = tick > delay ? tick - delay : 0;
+	start = (start + keyframe_interval - 1) / keyframe_interval * keyframe_interval;
+
+	viewers.push_back({ next_id, std::move(connection), delay, start, 0 });
+	return next_id++;
+}
+
+void SpectatorRelay::remove_viewer(unsigned int id) {
+	for (std::size_t i = 0; i < viewers.size(); i++)
+		if (viewers[i].id == id) {
+			viewers[i] = std::move(viewers.back());
+			viewers.pop_back();
+			return;
+		}
+}
+
+void SpectatorRelay::publish(const MatchSnapshot& snapshot) {
+	Frame& frame = frames[tick % frames.size()];
+	frame.tick = tick;
+
+	SpectatorFrameHeader header = { };
+	header.tick = static_cast<std::uint32_t>(tick);
+	char* payload = frame.bytes + sizeof(SpectatorFrameHeader);
+	if (tick % keyframe_interval == 0) {
+		header.keyframe = 1;
+		std::memcpy(payload, &snapshot, sizeof(MatchSnapshot));
+		frame.size = sizeof(SpectatorFrameHeader) + sizeof(MatchSnapshot);
+	} else {
+		QuantizedSnapshot quantized;
+		quantized.encode(snapshot);
+		std::memcpy(payload, &quantized, sizeof(QuantizedSnapshot));
+		frame.size = sizeof(SpectatorFrameHeader) + sizeof(QuantizedSnapshot);
+	}
+	header.size = static_cast<std::uint16_t>(frame.size);
+	std::memcpy(frame.bytes, &header, sizeof(header));
+
+	tick++;
+	encoded_frames++;
+	flush();
+}
+
+void SpectatorRelay::flush() {
+	for (std::size_t i = 0; i < viewers.size();) {
+		if (send_frames(viewers[i])) {
+			i++;
+			continue;
+		}
+		//Drop the spectator, the order of the spectators does not matter
+		viewers[i] = std::move(viewers.back());
+		viewers.pop_back();
+		dropped_viewers++;
+	}
+}
+
+bool SpectatorRelay::send_frames(Viewer& viewer) {
+	if (tick <= viewer.delay)
+		return true;
+	//Frames [next_tick; end) are due
+	std::uint64_t end = tick - viewer.delay;
+	if (end <= viewer.next_tick)
+		return true;
+	if (end - viewer.next_tick > max_backlog)
+		return false;
+
+	SendChunk chunks[SpectatorConnection::MAX_CHUNKS];
+	unsigned int count = 0;
+	for (std::uint64_t frame_tick = viewer.next_tick; frame_tick < end && count < SpectatorConnection::MAX_CHUNKS;
+		 frame_tick++) {
+		const Frame& frame = frames[frame_tick % frames.size()];
+		std::size_t skip = count == 0 ? viewer.sent : 0;
+		chunks[count++] = { frame.bytes + skip, frame.size - skip };
+	}
+
+	long result = viewer.connection->send(chunks, count);
+	if (result < 0)
+		return false;
+
+	//Move over the sent frames, the last one may be sent partially
+	std::size_t sent = static_cast<std::size_t>(result);
+	for (unsigned int i = 0; i < count && sent >= chunks[i].size; i++) {
+		sent -= chunks[i].size;
+		viewer.next_tick++;
+		viewer.sent = 0;
+	}
+	viewer.sent += sent;
+	sent_bytes += static_cast<unsigned long long>(result);
+	return true;
+}
+
+std::size_t SpectatorRelay::get_viewer_count() const {
+	return viewers.size();
+}
+
+unsigned long long SpectatorRelay::get_dropped_viewers() const {
+	return dropped_viewers;
+}
+
+unsigned long long SpectatorRelay::get_sent_bytes() const {
+	return sent_bytes;
+}
+
+unsigned long long SpectatorRelay::get_encoded_frames() const {
+	return encoded_frames;
+}
+
+void SpectatorDecoder::feed(const void* data, std::size_t size) {
+	//Forget the decoded bytes before growing the buffer
+	if (position > 0 && position * 2 >= buffer.size()) {
+		buffer.erase(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(position));
+		position = 0;
+	}
+	const char* bytes = static_cast<const char*>(data);
+	buffer.insert(buffer.end(), bytes, bytes + size);
+}
+
+bool SpectatorDecoder::next(MatchSnapshot& snapshot) {
+	while (buffer.size() - position >= sizeof(SpectatorFrameHeader)) {
+		SpectatorFrameHeader header;
+		std::memcpy(&header, buffer.data() + position, sizeof(header));
+		if (header.size < sizeof(SpectatorFrameHeader)) {
+			//The stream is broken, nothing after it can be decoded
+			errors++;
+			position = buffer.size();
+			return false;
+		}
+		if (buffer.size() - position < header.size)
+			return false;
+
+		const char* payload = buffer.data() + position + sizeof(SpectatorFrameHeader);
+		std::size_t payload_size = header.size - sizeof(SpectatorFrameHeader);
+		position += header.size;
+
+		bool decoded = false;
+		if (header.keyframe != 0) {
+			decoded = MatchSnapshot::read(payload, payload_size, keyframe_snapshot);
+			has_keyframe = has_keyframe || decoded;
+			snapshot = keyframe_snapshot;
+		} else if (has_keyframe && payload_size == sizeof(QuantizedSnapshot)) {
+			QuantizedSnapshot quantized;
+			std::memcpy(&quantized, payload, sizeof(quantized));
+			decoded = quantized.decode(keyframe_snapshot, snapshot);
+		}
+		if (decoded)
+			return true;
+		errors++;
+	}
+	return false;
+}
+
+unsigned int SpectatorDecoder::get_errors() const {
+	return errors;
+}
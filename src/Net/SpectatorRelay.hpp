@@ -0,0 +1,163 @@
+/*
+ * PongX relay of a match to its spectators
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "../Server/MatchSnapshot.hpp"
+
+///Part of a message sent without copying it (an element of the scatter-gather list)
+struct SendChunk {
+	const void* data;
+	std::size_t size;
+};
+
+///Connection of one spectator: a stream of bytes
+class SpectatorConnection {
+public:
+	///Most chunks passed to send() at once
+	static constexpr unsigned int MAX_CHUNKS = 16;
+
+	virtual ~SpectatorConnection() = default;
+
+	///Send the chunks one after another without blocking
+	///@returns amount of the sent bytes (less than all of them if the connection is congested, -1 if it is closed)
+	virtual long send(const SendChunk* chunks, unsigned int count) = 0;
+};
+
+#ifndef _WIN32
+///Spectator connected through a stream socket. The chunks are sent by one sendmsg() call
+class SocketSpectatorConnection : public SpectatorConnection {
+public:
+	///@param socket connected socket, it is closed with the connection
+	SocketSpectatorConnection(int socket);
+	~SocketSpectatorConnection();
+
+	long send(const SendChunk* chunks, unsigned int count) override;
+
+private:
+	int socket;
+};
+#endif
+
+///Header of every frame of the spectator stream. The frame of the tick is a full MatchSnapshot (a keyframe)
+///or a QuantizedSnapshot which is decoded with the last keyframe
+struct SpectatorFrameHeader {
+	///Size of the frame including the header
+	std::uint16_t size;
+	///1 - keyframe, 0 - quantized
+	std::uint8_t keyframe;
+	std::uint8_t reserved;
+	///Low 32 bits of the tick
+	std::uint32_t tick;
+};
+
+///Sends the running match to its spectators. The state of every tick is encoded once into a frame of the ring
+///shared by all spectators; a spectator is only a position in the ring, so its delay and its backlog cost
+///no copies. The ring keeps max_delay + max_backlog frames, so a frame lives as long as any spectator may need it
+///without counting the references. The due frames are sent in one scatter-gather call per spectator.
+///A spectator that falls behind by more than max_backlog frames (or whose connection is closed) is dropped
+class SpectatorRelay {
+public:
+	///@param max_delay maximal delay of a spectator in ticks
+	///@param max_backlog maximal amount of due frames a spectator has not received yet
+	///@param keyframe_interval a full snapshot is sent every keyframe_interval ticks, the rest are quantized
+	SpectatorRelay(unsigned int max_delay = 600, unsigned int max_backlog = 120,
+				   unsigned int keyframe_interval = 60);
+
+	///Add the spectator. It receives the stream from the next keyframe at its delay
+	///@param delay delay of the spectator in ticks (not more than max_delay)
+	///@returns id of the spectator
+	unsigned int add_viewer(std::unique_ptr<SpectatorConnection> connection, unsigned int delay);
+	void remove_viewer(unsigned int id);
+
+	///Encode the state of the next tick and send the due frames to every spectator
+	void publish(const MatchSnapshot& snapshot);
+	///Send the due frames to every spectator (e.g. after their connections are not congested anymore)
+	void flush();
+
+	std::size_t get_viewer_count() const;
+	///Get amount of the spectators dropped because they were too slow or their connections were closed
+	unsigned long long get_dropped_viewers() const;
+	///Get amount of the bytes sent to all spectators
+	unsigned long long get_sent_bytes() const;
+	///Get amount of the encoded frames (every frame is encoded once for all spectators)
+	unsigned long long get_encoded_frames() const;
+
+private:
+	///Encoded state of one tick
+	struct Frame {
+		std::uint64_t tick;
+		std::size_t size;
+		alignas(8) char bytes[sizeof(SpectatorFrameHeader) + sizeof(MatchSnapshot)];
+	};
+
+	struct Viewer {
+		unsigned int id;
+		std::unique_ptr<SpectatorConnection> connection;
+		unsigned int delay;
+		///Tick of the next frame to send. The stream starts from a keyframe
+		std::uint64_t next_tick;
+		///Bytes of the frame next_tick that were sent (a congested connection may take a part of it)
+		std::size_t sent;
+	};
+
+	unsigned int max_delay, max_backlog, keyframe_interval;
+
+	///Ring of the last frames, preallocated, the frame of the tick is at frames[tick % size]
+	std::vector<Frame> frames;
+	///Amount of the published ticks
+	std::uint64_t tick = 0;
+
+	std::vector<Viewer> viewers;
+	unsigned int next_id = 0;
+
+	unsigned long long dropped_viewers = 0;
+	unsigned long long sent_bytes = 0;
+	unsigned long long encoded_frames = 0;
+
+	///Send the due frames to the spectator
+	///@returns false if the spectator has to be dropped
+	bool send_frames(Viewer& viewer);
+};
+
+///Turns the bytes of the spectator stream back into snapshots
+class SpectatorDecoder {
+public:
+	///Append the received bytes
+	void feed(const void* data, std::size_t size);
+	///Decode the next frame
+	///@param snapshot the result (reference)
+	///@returns false if the frame is not received completely yet or it is invalid
+	bool next(MatchSnapshot& snapshot);
+
+	///Get amount of the invalid frames (they are skipped)
+	unsigned int get_errors() const;
+
+private:
+	std::vector<char> buffer;
+	///Bytes of the buffer that are decoded already
+	std::size_t position = 0;
+	MatchSnapshot keyframe_snapshot;
+	bool has_keyframe = false;
+	unsigned int errors = 0;
+};
@@ -16,8 +16,12 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <cmath>
 
+#include "../Audio/AudioEngine.hpp"
+#include "../Audio/GameSounds.hpp"
+#include "../fast_trig.hpp"
 #include "../Server/ServerSettings.hpp"
 #include "GamePage.hpp"
 
@@ -26,32 +30,61 @@ GamePage::GamePage(sf::RenderWindow* window, ServerSettings settings) {
 
 	settings.window_size = window->getSize();
 
-	switch (settings.server_type) {
-		case LocalMultiplayer: {
-			settings.enemy_up_key = sf::Keyboard::Up;
-			settings.enemy_down_key = sf::Keyboard::Down;
-			break;
-		}
-		default: {
-			//TODO: 09.06.2021: Singleplayer, LocalNetworkHost, LocalNetworkClient
-		}
+	server = Server::create(settings);
+	match_events.reset(new GameEventSubscriber(server->enable_events(256)));
+	init_shapes();
+	//Obstacles do not move
+	if (settings.arena)
+		MatchPainter::build_arena_vertices(*settings.arena, arena_vertices);
+}
+
+GamePage::GamePage(sf::RenderWindow* window, std::unique_ptr<SharedMatchChannel> channel) {
+	this->window = window;
+	this->channel = std::move(channel);
+	init_shapes();
+}
+
+GamePage::~GamePage() {
+	delete server;
+}
+
+void GamePage::update(const InputSnapshot& input) {
+	float player_relative_speed = input.axis(sf::Keyboard::W, sf::Keyboard::S);
+	//The keys win over the stick
+	if (player_relative_speed == 0.0F)
+		player_relative_speed = input.stick;
+	if (channel) {
+		//The match is simulated by the other process, it only gets the input.
+		//The last snapshot is drawn again if the simulation is writing the new one right now
+		channel->send_input(player_relative_speed);
+		has_snapshot = channel->read(snapshot) || has_snapshot;
+	} else {
+		server->player_relative_speed = player_relative_speed;
+		server->apply_local_input(input);
+
+		//Update server
+		server->update();
+		//Everything to draw in one flat copy instead of a call per value
+		server->write_snapshot(snapshot);
+		has_snapshot = true;
+		//Right after the step, so the sounds are late only by the audio period
+		handle_match_events();
 	}
+}
 
-	server = Server::create(settings);
+void GamePage::render() {
+	if (has_snapshot)
+		render_match();
+}
 
-	//Initialize player shape
-	player_shape.setSize({ settings.player_rect.width, settings.player_rect.height });
-	player_shape.setPosition({ settings.player_rect.left, settings.player_rect.top });
+void GamePage::init_shapes() {
 	player_shape.setFillColor(sf::Color::White);
-	//Initialize enemy shape
-	enemy_shape.setSize({ settings.enemy_rect.width, settings.enemy_rect.height });
-	enemy_shape.setPosition({ settings.enemy_rect.left, settings.enemy_rect.top });
 	enemy_shape.setFillColor(sf::Color::White);
-
-	//Initialize ball shape
-	ball_shape.setOrigin(settings.ball_radius, settings.ball_radius);
 	ball_shape.setFillColor(sf::Color::White);
-	ball_shape.setRadius(settings.ball_radius);
+
+	//Balls of the chaos mode are drawn at once
+	multi_ball_vertices.setPrimitiveType(sf::Triangles);
+	arena_vertices.setPrimitiveType(sf::Triangles);
 
     //Initialize separator
     separator.setSize({ 6, static_cast<float>(window->getSize().y) });
@@ -63,38 +96,144 @@ GamePage::GamePage(sf::RenderWindow* window, ServerSettings settings) {
     enemy_score_text.init(window, "0", { 10, 10 }, UIControl::CenterTop, UIControl::LeftTop, 150);
 }
 
-void GamePage::render() {
-	server->player_relative_speed =
-		sf::Keyboard::isKeyPressed(sf::Keyboard::S) - sf::Keyboard::isKeyPressed(sf::Keyboard::W);
+void GamePage::handle_match_events() {
+	AudioEngine* audio = GameManager::get_audio();
+	GameEvent events[32];
+	std::size_t count;
+	while ((count = match_events->poll(events, 32)) != 0) {
+		for (std::size_t i = 0; i < count; i++) {
+			if (audio != nullptr)
+				GameManager::get_game_sounds()->play(*audio, events[i], static_cast<float>(snapshot.window_width));
+			emit_event_particles(events[i]);
+		}
+	}
+}
+
+void GamePage::emit_event_particles(const GameEvent& event) {
+	ParticleBurst burst;
+	burst.position = { event.x, event.y };
+	switch (event.type) {
+		case PaddleHit: { //Sparks fly away from the paddle
+			burst.count = 40;
+			burst.min_speed = 150;
+			burst.max_speed = 450;
+			burst.direction = event.player ? 0 : 3.14159265F;
+			burst.spread = 3.14159265F;
+			burst.life = 0.35F;
+			burst.size = 2.5F;
+			break;
+		}
+		case WallBounce: { //Sparks fly away from the wall
+			burst.count = 15;
+			burst.min_speed = 100;
+			burst.max_speed = 300;
+			burst.direction = event.detail == 1 ? 1.57079632F : -1.57079632F;
+			burst.spread = 3.14159265F;
+			burst.life = 0.25F;
+			burst.size = 2;
+			break;
+		}
+		case Score: {
+			burst.count = 300;
+			burst.min_speed = 100;
+			burst.max_speed = 600;
+			burst.life = 0.8F;
+			burst.size = 3;
+			burst.color = sf::Color(255, 220, 120);
+			break;
+		}
+		default: {
+			return;
+		}
+	}
+	particles.emit(burst);
+}
 
-	//Update server
-	server->update();
+void GamePage::render_particles() {
+	float delta_time = std::min(particle_clock.restart().asSeconds(), 0.1F);
+	//The trail is left by the ball of the snapshot, so the attached viewer has it too
+	ParticleBurst trail;
+	trail.position = snapshot.get_ball_pos();
+	trail.count = 3;
+	trail.max_speed = 30;
+	trail.life = 0.3F;
+	trail.size = snapshot.ball_radius * 0.5F;
+	trail.color = sf::Color(180, 180, 180, 160);
+	particles.emit(trail);
+
+	particles.update(delta_time);
+	particles.build_vertices(particle_vertices);
+	if (!particle_vertices.empty())
+		window->draw(particle_vertices.data(), particle_vertices.size(), sf::Triangles);
+}
 
+void GamePage::render_match() {
 	//Set position of the player
-	player_shape.setPosition({ server->get_player_rect().left, server->get_player_rect().top }); //Set position
+	player_shape.setSize({ snapshot.player_width, snapshot.player_height });
+	player_shape.setPosition({ snapshot.player_left, snapshot.player_top });
 
 	//Set position of the enemy
-	enemy_shape.setPosition({ server->get_enemy_rect().left, server->get_enemy_rect().top });
+	enemy_shape.setSize({ snapshot.enemy_width, snapshot.enemy_height });
+	enemy_shape.setPosition({ snapshot.enemy_left, snapshot.enemy_top });
 
 	//Syncronize ball_shape and ball_pos
-	ball_shape.setPosition(server->get_ball_pos());
+	if (ball_shape.getRadius() != snapshot.ball_radius) {
+		ball_shape.setOrigin(snapshot.ball_radius, snapshot.ball_radius);
+		ball_shape.setRadius(snapshot.ball_radius);
+	}
+	ball_shape.setPosition(snapshot.get_ball_pos());
 
 	//Syncronize scores
-	player_score_text.set_text(std::to_string(server->get_player_score()));
-	enemy_score_text.set_text(std::to_string(server->get_enemy_score()));
+	player_score_text.set_text(std::to_string(snapshot.player_score));
+	enemy_score_text.set_text(std::to_string(snapshot.enemy_score));
 
 	//Render
+	window->draw(arena_vertices);
+	render_particles();
 	window->draw(player_shape);
 	window->draw(enemy_shape);
-	window->draw(ball_shape);
+	//The attached viewer gets only the first ball of the chaos mode
+	if (snapshot.has_flag(SnapshotMultiBall) && server != nullptr)
+		render_multi_ball();
+	else
+		window->draw(ball_shape);
     window->draw(separator);
     player_score_text.render();
     enemy_score_text.render();
 
 	//Show direction
 	sf::VertexArray line(sf::LineStrip, 2);
-	line[0] = server->get_ball_pos();
-	line[1] = server->get_ball_pos() +
-		sf::Vector2f(std::cos(server->get_ball_dir()) * 5000, std::sin(server->get_ball_dir()) * 5000);
+	sf::Vector2f direction;
+	gm::fast_sin_cos(snapshot.ball_direction, direction.y, direction.x);
+	line[0] = snapshot.get_ball_pos();
+	line[1] = snapshot.get_ball_pos() + direction * 5000.0F;
 	window->draw(line);
 }
+
+void GamePage::render_multi_ball() {
+	//Every ball is a polygon of triangles, all of them are in one vertex array (one draw call)
+	constexpr unsigned int SIDES = 8;
+	const MultiBallWorld& balls = *server->get_multi_ball();
+	float radius = balls.get_ball_radius();
+
+	//Corners of the polygon around (0, 0)
+	sf::Vector2f corners[SIDES + 1];
+	for (unsigned int i = 0; i <= SIDES; i++) {
+		float angle = 2.0F * 3.14159265359F * i / SIDES;
+		gm::fast_sin_cos(angle, corners[i].y, corners[i].x);
+		corners[i] *= radius;
+	}
+
+	multi_ball_vertices.resize(balls.size() * SIDES * 3);
+	for (std::size_t ball = 0; ball < balls.size(); ball++) {
+		sf::Vector2f center = balls.get_position(ball);
+		sf::Vertex* triangle = &multi_ball_vertices[ball * SIDES * 3];
+		for (unsigned int i = 0; i < SIDES; i++) {
+			triangle[0] = sf::Vertex(center, sf::Color::White);
+			triangle[1] = sf::Vertex(center + corners[i], sf::Color::White);
+			triangle[2] = sf::Vertex(center + corners[i + 1], sf::Color::White);
+			triangle += 3;
+		}
+	}
+	window->draw(multi_ball_vertices);
+}
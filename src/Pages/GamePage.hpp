@@ -18,6 +18,11 @@
 
 #pragma once
 
+#include <memory>
+
+#include "../Net/SharedMatchChannel.hpp"
+#include "../Render/MatchPainter.hpp"
+#include "../Render/ParticleSystem.hpp"
 #include "../Server/Server.hpp"
 #include "../GameManager.hpp"
 #include "../UI/Label.hpp"
@@ -27,20 +32,55 @@
 class GamePage : public Page {
 public:
 	GamePage(sf::RenderWindow* window, ServerSettings settings);
+	///Watch the match simulated by the other process, the keyboard controls its player
+	GamePage(sf::RenderWindow* window, std::unique_ptr<SharedMatchChannel> channel);
+	~GamePage() override;
 
+	void update(const InputSnapshot& input) override;
 	void render() override;
 
 private:
-	Server* server;
+	///The local match (nullptr if the page watches the other process)
+	Server* server = nullptr;
+	///Channel of the match simulated by the other process (nullptr for the local match)
+	std::unique_ptr<SharedMatchChannel> channel;
+	///Events of the local match that make sounds and sparks (nullptr if the page watches the other process)
+	std::unique_ptr<GameEventSubscriber> match_events;
+	///State of the match to draw
+	MatchSnapshot snapshot;
+	bool has_snapshot = false;
 	///Shape only for render. Syncronized with the player_rect ot enemy_rect
 	sf::RectangleShape player_shape, enemy_shape;
 
 	///Shape only for render. Syncronized with ball_pos and radius
 	sf::CircleShape ball_shape;
+	///Trail of the ball and sparks of the hits
+	ParticleSystem particles { 16384, 0, 3 };
+	///Triangles of the particles, rebuilt every frame in the same storage
+	std::vector<sf::Vertex> particle_vertices;
+	///Time since the previous update of the particles
+	sf::Clock particle_clock;
+	///Balls of the chaos mode, one triangle fan (as triangles) per ball
+	sf::VertexArray multi_ball_vertices;
+	///Static obstacles of the field, built once
+	sf::VertexArray arena_vertices;
     ///Halfs of screen verticol separator
     sf::RectangleShape separator;
     ///Player's score text
     Label player_score_text;
     ///Enemy's score text
     Label enemy_score_text;
+
+	///Set the colors of the shapes, the separator and the score labels
+	void init_shapes();
+	///Play the sounds and emit the sparks of the new events of the local match
+	void handle_match_events();
+	///Emit the particles of the event
+	void emit_event_particles(const GameEvent& event);
+	///Update the particles and draw them in one call
+	void render_particles();
+	///Draw the match from the snapshot
+	void render_match();
+	///Draw the balls of the chaos mode
+	void render_multi_ball();
 };
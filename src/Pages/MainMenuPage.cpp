@@ -21,42 +21,36 @@
 #include "StartGamePage.hpp"
 #include "MainMenuPage.hpp"
 
-MainMenuPage::MainMenuPage(sf::RenderWindow* window) {
-	this->window = window;
-
+MainMenuPage::MainMenuPage(sf::RenderWindow* window) : UIPage(window) {
 	//BEGIN UI
 	//Initialize the logo label
-	Label* logo_label = new Label(window, "PongX", { 0, 20 }, UIControl::CenterTop, UIControl::CenterTop, 170);
+	Label* logo_label = new (arena) Label(window, "PongX", { 0, 20 }, UIControl::CenterTop, UIControl::CenterTop,
+										  170);
+	//Initialize the singleplayer button
+	Button* singleplayer_button = new (arena) Button(window, { 0, -120 }, UIControl::CenterCenter,
+													 UIControl::CenterCenter, { 500, 100 }, "Singleplayer", 72);
+	singleplayer_button->set_callback([this]() { singleplayer_click(); });
 	//Initialize the local multiplayer button
-	Button* local_multiplayer_button = new Button(window, { 0, 0 }, UIControl::CenterCenter,
-												  UIControl::CenterCenter, { 500, 100 },
-												  "Local multiplayer", 72);
-	local_multiplayer_clicked = &local_multiplayer_button->clicked;
-
-	//Add controls to the list
-	ui_list.push_back(logo_label);
-	ui_list.push_back(local_multiplayer_button);
+	Button* local_multiplayer_button = new (arena) Button(window, { 0, 0 }, UIControl::CenterCenter,
+														  UIControl::CenterCenter, { 500, 100 },
+														  "Local multiplayer", 72);
+	local_multiplayer_button->set_callback([this]() { local_multiplayer_click(); });
+
+	//Add controls to the page
+	add_control(logo_label);
+	add_control(singleplayer_button);
+	add_control(local_multiplayer_button);
 	//END UI
 }
 
-MainMenuPage::~MainMenuPage() {
-	for (unsigned int i = 0; i < ui_list.size(); i++)
-		delete ui_list[i];
-}
-
-void MainMenuPage::render() {
-	//Render UI
-	for (unsigned int i = 0; i < ui_list.size(); i++)
-		ui_list[i]->render();
-
-	//Handle events
-	if (*local_multiplayer_clicked)
-		local_multiplayer_click();
+void MainMenuPage::singleplayer_click() {
+	//Build a new StartGamePage in the background and switch to it
+	sf::RenderWindow* window = this->window;
+	GameManager::switch_page_async([window]() { return new StartGamePage(window, Singleplayer); });
 }
 
 void MainMenuPage::local_multiplayer_click() {
-	//Create a new StartGamePage
-	StartGamePage* new_page = new StartGamePage(window, LocalMultiplayer);
-	//Switch to this page
-	GameManager::switch_page(new_page);
+	//Build a new StartGamePage in the background and switch to it
+	sf::RenderWindow* window = this->window;
+	GameManager::switch_page_async([window]() { return new StartGamePage(window, LocalMultiplayer); });
 }
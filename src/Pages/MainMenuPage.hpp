@@ -18,25 +18,15 @@
 
 #pragma once
 
-#include <vector>
+#include "UIPage.hpp"
 
-#include "../UI/UIControl.hpp"
-#include "Page.hpp"
-
-class MainMenuPage : public Page {
+class MainMenuPage : public UIPage {
 public:
 	MainMenuPage(sf::RenderWindow* window);
-	~MainMenuPage() override;
-
-	void render() override;
 
 private:
-	///UI controls list for this page
-	std::vector<UIControl*> ui_list;
-
-	///Pointer to the "clicked" filed of the "local multiplayer" button
-	bool* local_multiplayer_clicked;
-
+	///When "Singleplayer" button clicked
+	void singleplayer_click();
 	///When "Local multiplayer" button clicked
 	void local_multiplayer_click();
 };
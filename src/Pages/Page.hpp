@@ -21,6 +21,12 @@
 #include <SFML/Graphics.hpp>
 
 #include <functional>
+#include <new>
+#include <vector>
+
+#include "../Utils/BlockPool.hpp"
+
+struct InputSnapshot;
 
 class Page {
 public:
@@ -28,8 +34,39 @@ public:
 
 	virtual ~Page() { };
 
+	///Pages are allocated from the BlockPool, so switching between pages reuses the memory
+	static void* operator new(std::size_t size) {
+		return size <= BlockPool::BLOCK_SIZE ? BlockPool::acquire() : ::operator new(size);
+	}
+	static void operator delete(void* pointer, std::size_t size) {
+		if (size <= BlockPool::BLOCK_SIZE)
+			BlockPool::release(pointer);
+		else
+			::operator delete(pointer);
+	}
+
+	///Step the simulation by the input latched right before it. Called every frame before render()
+	///if the page is redrawn every frame
+	virtual void update(const InputSnapshot&) { };
 	virtual void render() = 0;
 
+	///Handle the window event (mouse, keyboard etc). Called from the main loop before render()
+	virtual void handle_event(const sf::Event&) { };
+
+	///If true, the page is redrawn only when it reports damage (see take_damage()),
+	///and the main loop sleeps while nothing is damaged. Otherwise it is redrawn every frame
+	virtual bool render_on_demand() const { return false; };
+	///Append the regions (in window coordinates) damaged since the last call
+	virtual void take_damage(std::vector<sf::FloatRect>&) { };
+	///Redraw the specified region of the page only. The caller clips drawing by the region
+	virtual void render_region(sf::FloatRect) { render(); };
+	///Can the page be deleted on a background thread after a switch? Only if its destructor touches nothing
+	///that the render thread uses. Otherwise (e.g. the match, the sounds) it is deleted on the render thread
+	virtual bool delete_in_background() const { return false; };
+	///How long the main loop may sleep waiting for events if nothing is damaged.
+	///sf::Time::Zero means until the next event
+	virtual sf::Time idle_timeout() const { return sf::Time::Zero; };
+
 protected:
 	sf::RenderWindow* window;
 };
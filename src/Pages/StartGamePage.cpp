@@ -21,26 +21,25 @@
 #include "MainMenuPage.hpp"
 #include "StartGamePage.hpp"
 
-StartGamePage::StartGamePage(sf::RenderWindow* window, GameType game_type) {
-	this->window = window;
+StartGamePage::StartGamePage(sf::RenderWindow* window, GameType game_type) : UIPage(window) {
 	this->game_type = game_type;
 
 	//BEGIN UI
 	//Initialize start game button
-	Button* start_button = new Button(window, { -25, -25 }, UIControl::RightBottom, UIControl::RightBottom,
-									  { 400, 100 }, "Start", 72);
-	start_clicked = &start_button->clicked;
+	Button* start_button = new (arena) Button(window, { -25, -25 }, UIControl::RightBottom,
+											  UIControl::RightBottom, { 400, 100 }, "Start", 72);
+	start_button->set_callback([this]() { start_click(); });
 
 	//Initialize back button
-	Button* back_button = new Button(window, { 25, -25 }, UIControl::LeftBottom, UIControl::LeftBottom,
-									 { 400, 100 }, "Back", 72);
-	back_clicked = &back_button->clicked;
+	Button* back_button = new (arena) Button(window, { 25, -25 }, UIControl::LeftBottom,
+											 UIControl::LeftBottom, { 400, 100 }, "Back", 72);
+	back_button->set_callback([this]() { back_click(); });
 
 	//Initialize the ball size spinbox and it's label
-	Label* ball_size_label = new Label(window, "Ball size", { 25, 25 }, UIControl::LeftTop, UIControl::LeftTop,
-									   36);
-	ball_size_spinbox = new SpinBox(window, { 25, 60 }, UIControl::LeftTop, UIControl::LeftTop,
-											 { 200, 75 }, 40);
+	Label* ball_size_label = new (arena) Label(window, "Ball size", { 25, 25 }, UIControl::LeftTop,
+											   UIControl::LeftTop, 36);
+	ball_size_spinbox = new (arena) SpinBox(window, { 25, 60 }, UIControl::LeftTop, UIControl::LeftTop,
+											{ 200, 75 }, 40);
 	ball_size_spinbox->set_minimal(10.0F);
 	ball_size_spinbox->set_maximum(300.0F);
 	ball_size_spinbox->set_step(10.0F);
@@ -49,10 +48,10 @@ StartGamePage::StartGamePage(sf::RenderWindow* window, GameType game_type) {
 	ball_size_spinbox->update_text();
 
 	//Initialize speed of the ball spinbox
-	Label* ball_speed_label = new Label(window, "Ball speed", { 25, 145 }, UIControl::LeftTop, UIControl::LeftTop,
-										36);
-	ball_speed_spinbox = new SpinBox(window, { 25, 180 }, UIControl::LeftTop, UIControl::LeftTop, { 200, 75 },
-									 40);
+	Label* ball_speed_label = new (arena) Label(window, "Ball speed", { 25, 145 }, UIControl::LeftTop,
+												UIControl::LeftTop, 36);
+	ball_speed_spinbox = new (arena) SpinBox(window, { 25, 180 }, UIControl::LeftTop, UIControl::LeftTop,
+											 { 200, 75 }, 40);
 	ball_speed_spinbox->set_minimal(1.0F);
 	ball_speed_spinbox->set_maximum(50.0F);
 	ball_speed_spinbox->set_step(1.0F);
@@ -60,30 +59,45 @@ StartGamePage::StartGamePage(sf::RenderWindow* window, GameType game_type) {
 	ball_speed_spinbox->set_precision(0);
 	ball_speed_spinbox->update_text();
 
-	ui_list.push_back(start_button);
-	ui_list.push_back(back_button);
-	ui_list.push_back(ball_size_label);
-	ui_list.push_back(ball_size_spinbox);
-	ui_list.push_back(ball_speed_label);
-	ui_list.push_back(ball_speed_spinbox);
-	//END UI
-}
+	add_control(start_button);
+	add_control(back_button);
+	add_control(ball_size_label);
+	add_control(ball_size_spinbox);
+	add_control(ball_speed_label);
+	add_control(ball_speed_spinbox);
 
-StartGamePage::~StartGamePage() {
-	for (unsigned int i = 0; i < ui_list.size(); i++)
-		delete ui_list[i];
-}
+	//Initialize the amount of balls of the chaos mode
+	Label* chaos_balls_label = new (arena) Label(window, "Chaos balls", { 250, 25 }, UIControl::LeftTop,
+												 UIControl::LeftTop, 36);
+	chaos_balls_spinbox = new (arena) SpinBox(window, { 250, 60 }, UIControl::LeftTop, UIControl::LeftTop,
+											  { 200, 75 }, 40);
+	chaos_balls_spinbox->set_minimal(0.0F);
+	chaos_balls_spinbox->set_maximum(2000.0F);
+	chaos_balls_spinbox->set_step(100.0F);
+	chaos_balls_spinbox->set_value(0.0F);
+	chaos_balls_spinbox->set_precision(0);
+	chaos_balls_spinbox->update_text();
+
+	add_control(chaos_balls_label);
+	add_control(chaos_balls_spinbox);
 
-void StartGamePage::render() {
-	//Render UI
-	for (unsigned int i = 0; i < ui_list.size(); i++)
-		ui_list[i]->render();
+	//Initialize the AI difficulty spinbox
+	if (game_type == Singleplayer) {
+		Label* difficulty_label = new (arena) Label(window, "Difficulty", { 25, 265 }, UIControl::LeftTop,
+													UIControl::LeftTop, 36);
+		difficulty_spinbox = new (arena) SpinBox(window, { 25, 300 }, UIControl::LeftTop, UIControl::LeftTop,
+												 { 200, 75 }, 40);
+		difficulty_spinbox->set_minimal(1.0F);
+		difficulty_spinbox->set_maximum(10.0F);
+		difficulty_spinbox->set_step(1.0F);
+		difficulty_spinbox->set_value(5.0F);
+		difficulty_spinbox->set_precision(0);
+		difficulty_spinbox->update_text();
 
-	//Handle events
-	if (*start_clicked)
-		start_click();
-	if (*back_clicked)
-		back_click();
+		add_control(difficulty_label);
+		add_control(difficulty_spinbox);
+	}
+	//END UI
 }
 
 void StartGamePage::start_click() {
@@ -92,14 +106,21 @@ void StartGamePage::start_click() {
 	settings.ball_radius = ball_size_spinbox->get_value();
     settings.ball_speed = ball_speed_spinbox->get_value();
 	settings.server_type = game_type;
-	Page* new_page = new GamePage(window, settings);
-	//Switch to this page
-	GameManager::switch_page(new_page);
+	settings.chaos_balls = static_cast<unsigned int>(chaos_balls_spinbox->get_value());
+	settings.arena = GameManager::get_arena();
+	if (difficulty_spinbox != nullptr) {
+		//The harder, the faster and the more accurate the AI is. 10 - no mistakes at all
+		float easiness = 10.0F - difficulty_spinbox->get_value();
+		settings.ai_reaction_delay = static_cast<unsigned int>(easiness * 3.0F);
+		settings.ai_error = easiness * 20.0F;
+	}
+	//Build the game page in the background (server, shapes, labels) and switch to it
+	sf::RenderWindow* window = this->window;
+	GameManager::switch_page_async([window, settings]() { return new GamePage(window, settings); });
 }
 
 void StartGamePage::back_click() {
-	//Create a new "Main menu page"
-	Page* new_page = new MainMenuPage(window);
-	//Switch to this page
-	GameManager::switch_page(new_page);
+	//Build a new "Main menu page" in the background and switch to it
+	sf::RenderWindow* window = this->window;
+	GameManager::switch_page_async([window]() { return new MainMenuPage(window); });
 }
@@ -19,29 +19,20 @@
 #pragma once
 
 #include "GamePage.hpp"
-#include "../UI/UIControl.hpp"
 #include "../UI/SpinBox.hpp"
-#include "Page.hpp"
+#include "UIPage.hpp"
 
-class StartGamePage : public Page {
+class StartGamePage : public UIPage {
 public:
 	StartGamePage(sf::RenderWindow* window, GameType game_type);
-	~StartGamePage() override;
-
-	void render() override;
 
 private:
-	///UI controls list for this page
-	std::vector<UIControl*> ui_list;
-	SpinBox* ball_size_spinbox, *ball_speed_spinbox;
+	SpinBox* ball_size_spinbox, *ball_speed_spinbox, *chaos_balls_spinbox;
+	///Only for singleplayer
+	SpinBox* difficulty_spinbox = nullptr;
 
 	GameType game_type;
 
-	///Pointer to the "clicked" filed of the "Start" button
-	bool* start_clicked;
-	///Pointer to the "clicked" filed of the "Back" button
-	bool* back_clicked;
-
 	///When "Start" button clicked
 	void start_click();
 	///When "Back" button clicked
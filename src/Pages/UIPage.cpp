@@ -0,0 +1,79 @@
+/*
+ * PongX UI page
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "UIPage.hpp"
+
+///Outlines of the controls are drawn outside of their bounds, so damaged regions are expanded by this
+constexpr float DAMAGE_MARGIN = 4.0F;
+
+///Get the control bounds expanded by DAMAGE_MARGIN
+static sf::FloatRect damage_bounds(const UIControl* control) {
+	sf::FloatRect bounds = control->bounds();
+	return { bounds.left - DAMAGE_MARGIN, bounds.top - DAMAGE_MARGIN,
+			 bounds.width + DAMAGE_MARGIN * 2.0F, bounds.height + DAMAGE_MARGIN * 2.0F };
+}
+
+UIPage::UIPage(sf::RenderWindow* window) {
+	this->window = window;
+	dispatcher.init(window);
+}
+
+UIPage::~UIPage() {
+	//Controls are in the arena, so only destroy them. The memory is freed by the arena in one go
+	for (unsigned int i = ui_list.size(); i > 0; i--)
+		ui_list[i - 1]->~UIControl();
+}
+
+void UIPage::render() {
+	//Render UI
+	for (unsigned int i = 0; i < ui_list.size(); i++)
+		ui_list[i]->render();
+}
+
+void UIPage::handle_event(const sf::Event& event) {
+	dispatcher.dispatch(event);
+}
+
+void UIPage::take_damage(std::vector<sf::FloatRect>& regions) {
+	for (unsigned int i = 0; i < ui_list.size(); i++) {
+		if (!ui_list[i]->take_damage())
+			continue;
+
+		//Erase the old image and draw the new one
+		sf::FloatRect new_bounds = damage_bounds(ui_list[i]);
+		if (new_bounds != drawn_bounds[i])
+			regions.push_back(drawn_bounds[i]);
+		regions.push_back(new_bounds);
+		drawn_bounds[i] = new_bounds;
+	}
+}
+
+void UIPage::render_region(sf::FloatRect region) {
+	//Render only the controls that are visible in the region
+	for (unsigned int i = 0; i < ui_list.size(); i++) {
+		if (drawn_bounds[i].intersects(region))
+			ui_list[i]->render();
+	}
+}
+
+void UIPage::add_control(UIControl* control) {
+	ui_list.push_back(control);
+	drawn_bounds.push_back(damage_bounds(control));
+	if (control->is_interactive())
+		dispatcher.add(control);
+}
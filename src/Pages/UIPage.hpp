@@ -0,0 +1,62 @@
+/*
+ * PongX UI page
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <memory_resource>
+
+#include "../UI/InputDispatcher.hpp"
+#include "../Utils/Arena.hpp"
+#include "../UI/UIControl.hpp"
+#include "Page.hpp"
+
+///Page that consists of UI controls only (menus, settings etc).
+///Owns the controls and routes the window events to them
+class UIPage : public Page {
+public:
+	UIPage(sf::RenderWindow* window);
+	~UIPage() override;
+
+	void render() override;
+
+	void handle_event(const sf::Event& event) override;
+
+	bool render_on_demand() const override { return true; };
+	///The controls and their arena belong to the page only, the page memory goes back to the thread-safe BlockPool
+	bool delete_in_background() const override { return true; };
+	void take_damage(std::vector<sf::FloatRect>& regions) override;
+	void render_region(sf::FloatRect region) override;
+
+protected:
+	///Memory for the controls of the page and lists below. Everything is freed at once with the page.
+	///Create controls of the page like this: new (arena) Button(...)
+	Arena arena;
+
+	///Add the control created in the arena to the page. The page takes ownership of the control.
+	///The control has to be already positioned
+	void add_control(UIControl* control);
+
+private:
+	///UI controls list for this page
+	std::pmr::vector<UIControl*> ui_list { &arena };
+	///Regions where the controls from ui_list were drawn last time (with outline).
+	///Needed to erase the old image when the control is resized
+	std::pmr::vector<sf::FloatRect> drawn_bounds { &arena };
+	///Routes events to the interactive controls from ui_list
+	InputDispatcher dispatcher;
+};
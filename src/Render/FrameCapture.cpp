@@ -0,0 +1,260 @@
+/*
+ * PongX frame capture and video export
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FrameCapture.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/OpenGL.hpp>
+
+std::unique_ptr<FrameCapture> FrameCapture::start(const FrameCaptureSettings& settings) {
+	std::unique_ptr<FrameCapture> capture(new FrameCapture());
+	capture->settings = settings;
+	if (settings.format == Y4mVideo) {
+		capture->video.open(settings.path, std::ios::binary | std::ios::trunc);
+		if (!capture->video)
+			return nullptr;
+	} else {
+		std::error_code error;
+		std::filesystem::create_directories(settings.path, error);
+		if (!std::filesystem::is_directory(settings.path, error))
+			return nullptr;
+	}
+
+	//The buffers get their size with the first frame and keep it
+	for (unsigned int i = 0; i < std::max(1U, settings.buffers); i++) {
+		capture->frames.emplace_back(new Frame());
+		capture->free_frames.push_back(capture->frames.back().get());
+	}
+	unsigned int encoder_count = settings.format == Y4mVideo ? 1 : std::max(1U, settings.encoder_threads);
+	FrameCapture* thread_capture = capture.get();
+	for (unsigned int i = 0; i < encoder_count; i++)
+		capture->encoders.emplace_back([thread_capture]() { thread_capture->encoder_loop(); });
+	return capture;
+}
+
+FrameCapture::~FrameCapture() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	//The encoders write the waiting frames before they stop
+	frame_ready.notify_all();
+	for (std::thread& encoder : encoders)
+		encoder.join();
+}
+
+bool FrameCapture::capture(const std::uint8_t* pixels, unsigned int width, unsigned int height) {
+	std::unique_lock<std::mutex> lock(mutex);
+	Frame* frame = acquire(lock);
+	if (frame == nullptr)
+		return false;
+	frame->number = captured_frames++;
+	lock.unlock();
+
+	//Nobody else touches the buffer till it is ready
+	frame->pixels.assign(pixels, pixels + 4 * static_cast<std::size_t>(width) * height);
+	frame->width = width;
+	frame->height = height;
+
+	publish(frame, lock);
+	return true;
+}
+
+bool FrameCapture::capture(const sf::RenderWindow& window) {
+	if (!window.setActive())
+		return false;
+	std::unique_lock<std::mutex> lock(mutex);
+	//A dropped frame costs no readback
+	Frame* frame = acquire(lock);
+	if (frame == nullptr)
+		return false;
+	frame->number = captured_frames++;
+	lock.unlock();
+
+	//The buffer keeps its capacity, so only the first frames allocate
+	sf::Vector2u size = window.getSize();
+	std::size_t row_size = 4 * static_cast<std::size_t>(size.x);
+	frame->pixels.resize(row_size * size.y);
+	frame->width = size.x;
+	frame->height = size.y;
+	glReadPixels(0, 0, static_cast<GLsizei>(size.x), static_cast<GLsizei>(size.y), GL_RGBA, GL_UNSIGNED_BYTE,
+				 frame->pixels.data());
+	//OpenGL gives the rows bottom to top
+	std::uint8_t* pixels = frame->pixels.data();
+	for (std::size_t top = 0; top < size.y / 2; top++)
+		std::swap_ranges(pixels + top * row_size, pixels + (top + 1) * row_size,
+						 pixels + (size.y - 1 - top) * row_size);
+
+	publish(frame, lock);
+	return true;
+}
+
+bool FrameCapture::capture(const sf::Texture& texture) {
+	sf::Image image = texture.copyToImage();
+	if (image.getPixelsPtr() == nullptr)
+		return false;
+	return capture(image.getPixelsPtr(), image.getSize().x, image.getSize().y);
+}
+
+void FrameCapture::flush() {
+	std::unique_lock<std::mutex> lock(mutex);
+	frame_done.wait(lock, [this]() { return ready_frames.empty() && encoding_frames == 0; });
+}
+
+std::uint64_t FrameCapture::get_captured_frames() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return captured_frames;
+}
+
+std::uint64_t FrameCapture::get_dropped_frames() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return dropped_frames;
+}
+
+std::uint64_t FrameCapture::get_written_frames() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return written_frames;
+}
+
+std::uint64_t FrameCapture::get_failed_frames() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return failed_frames;
+}
+
+void FrameCapture::publish(Frame* frame, std::unique_lock<std::mutex>& lock) {
+	lock.lock();
+	ready_frames.push_back(frame);
+	lock.unlock();
+	frame_ready.notify_one();
+}
+
+FrameCapture::Frame* FrameCapture::acquire(std::unique_lock<std::mutex>& lock) {
+	if (free_frames.empty()) {
+		switch (settings.policy) {
+			case DropOldFrames: {
+				if (!ready_frames.empty()) {
+					Frame* frame = ready_frames.front();
+					ready_frames.pop_front();
+					dropped_frames++;
+					return frame;
+				}
+				dropped_frames++;
+				return nullptr;
+			}
+			case BlockRenderer: {
+				frame_done.wait(lock, [this]() { return !free_frames.empty(); });
+				break;
+			}
+			default: {
+				dropped_frames++;
+				return nullptr;
+			}
+		}
+	}
+
+	Frame* frame = free_frames.back();
+	free_frames.pop_back();
+	return frame;
+}
+
+void FrameCapture::encoder_loop() {
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		frame_ready.wait(lock, [this]() { return stopping || !ready_frames.empty(); });
+		if (ready_frames.empty())
+			return;
+		Frame* frame = ready_frames.front();
+		ready_frames.pop_front();
+		encoding_frames++;
+		lock.unlock();
+
+		bool written = settings.format == Y4mVideo ? write_video_frame(*frame) : write_png(*frame);
+
+		lock.lock();
+		encoding_frames--;
+		(written ? written_frames : failed_frames)++;
+		free_frames.push_back(frame);
+		frame_done.notify_all();
+	}
+}
+
+bool FrameCapture::write_video_frame(const Frame& frame) {
+	//The size of the video is the size of the first frame
+	if (video_width == 0) {
+		video_width = frame.width;
+		video_height = frame.height;
+		video << "YUV4MPEG2 W" << video_width << " H" << video_height << " F" << settings.frame_rate
+			  << ":1 Ip A1:1 C420jpeg\n";
+	}
+	if (frame.width != video_width || frame.height != video_height || video_width == 0)
+		return false;
+
+	//BT.601 in the studio range: the full-size Y plane and the U and V planes of the 2x2 blocks
+	unsigned int chroma_width = (video_width + 1) / 2, chroma_height = (video_height + 1) / 2;
+	std::size_t luma_size = static_cast<std::size_t>(video_width) * video_height;
+	std::size_t chroma_size = static_cast<std::size_t>(chroma_width) * chroma_height;
+	video_planes.resize(luma_size + 2 * chroma_size);
+	std::uint8_t* luma = video_planes.data();
+	std::uint8_t* u_plane = luma + luma_size;
+	std::uint8_t* v_plane = u_plane + chroma_size;
+
+	const std::uint8_t* pixels = frame.pixels.data();
+	for (std::size_t i = 0; i < luma_size; i++) {
+		int r = pixels[4 * i], g = pixels[4 * i + 1], b = pixels[4 * i + 2];
+		luma[i] = static_cast<std::uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+	}
+	for (unsigned int y = 0; y < chroma_height; y++) {
+		for (unsigned int x = 0; x < chroma_width; x++) {
+			//Average of the block (the last row and column of odd sizes are repeated)
+			int r = 0, g = 0, b = 0;
+			for (unsigned int corner = 0; corner < 4; corner++) {
+				unsigned int pixel_x = std::min(2 * x + corner % 2, video_width - 1);
+				unsigned int pixel_y = std::min(2 * y + corner / 2, video_height - 1);
+				std::size_t pixel_index = static_cast<std::size_t>(pixel_y) * video_width + pixel_x;
+				const std::uint8_t* pixel = pixels + 4 * pixel_index;
+				r += pixel[0];
+				g += pixel[1];
+				b += pixel[2];
+			}
+			r /= 4;
+			g /= 4;
+			b /= 4;
+			std::size_t index = static_cast<std::size_t>(y) * chroma_width + x;
+			u_plane[index] = static_cast<std::uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+			v_plane[index] = static_cast<std::uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+		}
+	}
+
+	video << "FRAME\n";
+	video.write(reinterpret_cast<const char*>(video_planes.data()),
+				static_cast<std::streamsize>(video_planes.size()));
+	video.flush();
+	return static_cast<bool>(video);
+}
+
+bool FrameCapture::write_png(const Frame& frame) const {
+	char name[32];
+	std::snprintf(name, sizeof(name), "frame_%06llu.png", static_cast<unsigned long long>(frame.number));
+	sf::Image image;
+	image.create(frame.width, frame.height, frame.pixels.data());
+	return image.saveToFile((std::filesystem::path(settings.path) / name).string());
+}
@@ -0,0 +1,138 @@
+/*
+ * PongX frame capture and video export
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <SFML/Graphics/RenderWindow.hpp>
+#include <SFML/Graphics/Texture.hpp>
+
+enum CaptureFormat : unsigned char {
+	///One .y4m video file (raw YUV 4:2:0, e.g. for ffmpeg)
+	Y4mVideo,
+	///Directory of numbered .png files
+	PngSequence
+};
+
+///What capture() does when every buffer is taken by the frames that wait for the encoders
+enum CapturePolicy : unsigned char {
+	///Skip the new frame, the renderer never waits
+	DropNewFrames,
+	///Replace the oldest frame that is not being encoded yet (skip the new one if all are being encoded),
+	///the renderer never waits
+	DropOldFrames,
+	///Wait for a free buffer, so no frame is lost (for the offline rendering)
+	BlockRenderer
+};
+
+struct FrameCaptureSettings {
+	///.y4m file or the directory of the .png files
+	std::string path;
+	CaptureFormat format = Y4mVideo;
+	CapturePolicy policy = DropNewFrames;
+	///Frames that may wait for the encoders
+	unsigned int buffers = 8;
+	///Threads that encode the .png files (the video is written by one thread, the frames are in order)
+	unsigned int encoder_threads = 2;
+	///Frame rate written into the video header
+	unsigned int frame_rate = 60;
+};
+
+///Takes the presented frames and writes them on background threads. The frames are copied into a bounded pool
+///of reusable buffers, so the renderer pays only for the copy (and the readback of the window)
+class FrameCapture {
+public:
+	///Create the output and start the encoders
+	///@returns nullptr if the file (or the directory) can not be created
+	static std::unique_ptr<FrameCapture> start(const FrameCaptureSettings& settings);
+
+	FrameCapture(const FrameCapture&) = delete;
+	FrameCapture& operator=(const FrameCapture&) = delete;
+	///Write the waiting frames and stop the encoders
+	~FrameCapture();
+
+	///Take the frame from memory (e.g. SoftwareCanvas::get_pixels())
+	///@param pixels rows of pixels top to bottom, every pixel is 4 bytes R, G, B, A
+	///@returns false if the frame is dropped
+	bool capture(const std::uint8_t* pixels, unsigned int width, unsigned int height);
+	///Read the current contents of the window back straight into a buffer (call before display())
+	bool capture(const sf::RenderWindow& window);
+	bool capture(const sf::Texture& texture);
+	///Wait until every taken frame is written
+	void flush();
+
+	///Get amount of the frames taken by capture()
+	std::uint64_t get_captured_frames() const;
+	///Get amount of the frames dropped by the policy
+	std::uint64_t get_dropped_frames() const;
+	std::uint64_t get_written_frames() const;
+	///Get amount of the frames that could not be written (e.g. the size of a video frame changed)
+	std::uint64_t get_failed_frames() const;
+
+private:
+	struct Frame {
+		std::vector<std::uint8_t> pixels;
+		unsigned int width = 0, height = 0;
+		///Number among the captured frames
+		std::uint64_t number = 0;
+	};
+
+	FrameCaptureSettings settings;
+	std::vector<std::unique_ptr<Frame>> frames;
+	///Buffers that are not used
+	std::vector<Frame*> free_frames;
+	///Frames that wait for the encoders, oldest first
+	std::deque<Frame*> ready_frames;
+	///Frames that are encoded now
+	unsigned int encoding_frames = 0;
+
+	mutable std::mutex mutex;
+	///Notified when a frame is ready, a buffer is free or the capture stops
+	std::condition_variable frame_ready, frame_done;
+	bool stopping = false;
+	std::vector<std::thread> encoders;
+
+	std::uint64_t captured_frames = 0, dropped_frames = 0, written_frames = 0, failed_frames = 0;
+
+	//BEGIN Video
+	std::ofstream video;
+	unsigned int video_width = 0, video_height = 0;
+	///Planes of the frame being converted
+	std::vector<std::uint8_t> video_planes;
+	//END Video
+
+	FrameCapture() = default;
+
+	///Take a free buffer according to the policy
+	///@returns nullptr if the frame has to be dropped
+	Frame* acquire(std::unique_lock<std::mutex>& lock);
+	///Pass the filled buffer to the encoders
+	void publish(Frame* frame, std::unique_lock<std::mutex>& lock);
+	void encoder_loop();
+	bool write_video_frame(const Frame& frame);
+	bool write_png(const Frame& frame) const;
+};
@@ -0,0 +1,115 @@
+/*
+ * PongX match drawing without OpenGL
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <string>
+
+#include "../fast_trig.hpp"
+#include "MatchPainter.hpp"
+
+MatchPainter::MatchPainter(std::shared_ptr<const ArenaMap> arena) {
+	arena_vertices.setPrimitiveType(sf::Triangles);
+	if (arena)
+		build_arena_vertices(*arena, arena_vertices);
+}
+
+void MatchPainter::paint(SoftwareCanvas& canvas, const MatchSnapshot& snapshot,
+						 const std::vector<sf::Vertex>* particles) const {
+	//The same layers as GamePage::render_match()
+	canvas.clear(sf::Color::Black);
+	if (arena_vertices.getVertexCount() != 0)
+		canvas.fill_triangles(&arena_vertices[0], arena_vertices.getVertexCount());
+	if (particles != nullptr && !particles->empty())
+		canvas.fill_triangles(particles->data(), particles->size());
+
+	canvas.fill_rect(snapshot.get_player_rect(), sf::Color::White);
+	canvas.fill_rect(snapshot.get_enemy_rect(), sf::Color::White);
+	canvas.fill_circle(snapshot.get_ball_pos(), snapshot.ball_radius, sf::Color::White);
+
+	//Halfs of the screen separator
+	float width = static_cast<float>(snapshot.window_width), height = static_cast<float>(snapshot.window_height);
+	canvas.fill_rect({ (width - 6.0F) * 0.5F, 0.0F, 6.0F, height }, sf::Color::White);
+
+	//Scores at the top, on both sides of the separator
+	constexpr float SCORE_SIZE = 150.0F;
+	std::string player_score = std::to_string(snapshot.player_score);
+	float player_score_left = width * 0.5F - 10.0F - SoftwareCanvas::get_text_width(player_score, SCORE_SIZE);
+	canvas.draw_text(player_score, { player_score_left, 10.0F }, SCORE_SIZE, sf::Color::White);
+	canvas.draw_text(std::to_string(snapshot.enemy_score), { width * 0.5F + 10.0F, 10.0F }, SCORE_SIZE,
+					 sf::Color::White);
+
+	//Direction of the ball
+	sf::Vector2f direction;
+	gm::fast_sin_cos(snapshot.ball_direction, direction.y, direction.x);
+	canvas.draw_line(snapshot.get_ball_pos(), snapshot.get_ball_pos() + direction * 5000.0F, sf::Color::White);
+}
+
+void MatchPainter::build_arena_vertices(const ArenaMap& arena, sf::VertexArray& vertices) {
+	//Every obstacle is convex, so its outline is a fan of triangles around the center
+	constexpr unsigned int ARC_SIDES = 8;
+	constexpr float PI = 3.14159265359F;
+	const sf::Color color(128, 128, 128);
+	std::vector<sf::Vector2f> outline;
+
+	for (unsigned int i = 0; i < arena.get_obstacle_count(); i++) {
+		const ArenaMap::Obstacle& obstacle = arena.get_obstacle(i);
+		outline.clear();
+
+		//Arc of the outline around the center from the angle to the angle + PI / 2 * quarters
+		auto add_arc = [&outline](sf::Vector2f center, float radius, float angle, unsigned int quarters) {
+			for (unsigned int j = 0; j <= ARC_SIDES * quarters; j++) {
+				float cur_angle = angle + 0.5F * PI * j / ARC_SIDES;
+				sf::Vector2f direction;
+				gm::fast_sin_cos(cur_angle, direction.y, direction.x);
+				outline.push_back(center + direction * radius);
+			}
+		};
+
+		switch (obstacle.type) {
+			case ArenaMap::Circle: {
+				add_arc({ obstacle.x1, obstacle.y1 }, obstacle.radius, 0.0F, 4);
+				break;
+			}
+			case ArenaMap::Segment: { //Half circles around the ends
+				float angle = gm::fast_atan2(obstacle.y2 - obstacle.y1, obstacle.x2 - obstacle.x1);
+				add_arc({ obstacle.x2, obstacle.y2 }, obstacle.radius, angle - 0.5F * PI, 2);
+				add_arc({ obstacle.x1, obstacle.y1 }, obstacle.radius, angle + 0.5F * PI, 2);
+				break;
+			}
+			default: { //Quarter circles in the corners (of zero radius for the sharp corners)
+				float left = std::min(obstacle.x1, obstacle.x2), right = std::max(obstacle.x1, obstacle.x2);
+				float top = std::min(obstacle.y1, obstacle.y2), bottom = std::max(obstacle.y1, obstacle.y2);
+				float radius = std::clamp(obstacle.radius, 0.0F, std::min(right - left, bottom - top) * 0.5F);
+				add_arc({ right - radius, bottom - radius }, radius, 0.0F, 1);
+				add_arc({ left + radius, bottom - radius }, radius, 0.5F * PI, 1);
+				add_arc({ left + radius, top + radius }, radius, PI, 1);
+				add_arc({ right - radius, top + radius }, radius, 1.5F * PI, 1);
+			}
+		}
+
+		sf::Vector2f center;
+		for (sf::Vector2f point : outline)
+			center += point;
+		center /= static_cast<float>(outline.size());
+		for (std::size_t j = 0; j < outline.size(); j++) {
+			vertices.append(sf::Vertex(center, color));
+			vertices.append(sf::Vertex(outline[j], color));
+			vertices.append(sf::Vertex(outline[(j + 1) % outline.size()], color));
+		}
+	}
+}
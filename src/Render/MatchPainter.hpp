@@ -0,0 +1,48 @@
+/*
+ * PongX match drawing without OpenGL
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <SFML/Graphics/VertexArray.hpp>
+
+#include "../Server/ArenaMap.hpp"
+#include "../Server/MatchSnapshot.hpp"
+#include "SoftwareCanvas.hpp"
+
+///Draws the match like GamePage does, but on the SoftwareCanvas (for the frames of the headless matches)
+class MatchPainter {
+public:
+	///@param arena static obstacles of the field (nullptr - the empty field)
+	MatchPainter(std::shared_ptr<const ArenaMap> arena = nullptr);
+
+	///Record the frame of the match into the canvas (it is cleared first)
+	///@param particles triangles of the particles (see ParticleSystem::build_vertices()), nullptr - none
+	void paint(SoftwareCanvas& canvas, const MatchSnapshot& snapshot,
+			   const std::vector<sf::Vertex>* particles = nullptr) const;
+
+	///Build the triangles of the static obstacles
+	///@param vertices the result: the triangles are appended (reference)
+	static void build_arena_vertices(const ArenaMap& arena, sf::VertexArray& vertices);
+
+private:
+	///Triangles of the obstacles, built once
+	sf::VertexArray arena_vertices;
+};
@@ -0,0 +1,170 @@
+/*
+ * PongX particle effects
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PONGX_PARTICLES_SSE2
+#include <emmintrin.h>
+#endif
+
+#include "../fast_trig.hpp"
+#include "ParticleSystem.hpp"
+
+///Offsets of the corners of the triangle of a particle from its center (in radiuses)
+static constexpr float CORNER_X = 0.8660254F;
+static constexpr float CORNER_Y = 0.5F;
+
+ParticleSystem::ParticleSystem(std::size_t capacity, float gravity, float drag, unsigned int seed)
+	: capacity(capacity), gravity(gravity), drag(drag), randomizer(seed) {
+	//The passes take 4 particles at a time, so the arrays have room for the last incomplete group
+	std::size_t padded = (capacity + 3) / 4 * 4;
+	for (std::vector<float>* array : { &x, &y, &velocity_x, &velocity_y, &life, &fade, &alpha, &particle_size })
+		array->resize(padded);
+	color.resize(padded);
+}
+
+void ParticleSystem::emit(const ParticleBurst& burst) {
+	std::size_t emitted = std::min<std::size_t>(burst.count, capacity - count);
+	dropped += burst.count - emitted;
+
+	float life_fade = 1.0F / burst.life;
+	std::uint32_t packed_color = burst.color.r | burst.color.g << 8 | burst.color.b << 16 |
+		static_cast<std::uint32_t>(burst.color.a) << 24;
+	for (std::size_t i = count; i < count + emitted; i++) {
+		float direction = burst.direction + gm::random_number(randomizer, -0.5F, 0.5F) * burst.spread;
+		float speed = burst.min_speed + gm::random_number(randomizer, 0, 1) * (burst.max_speed - burst.min_speed);
+		float sin, cos;
+		gm::fast_sin_cos(direction, sin, cos);
+		x[i] = burst.position.x;
+		y[i] = burst.position.y;
+		velocity_x[i] = cos * speed;
+		velocity_y[i] = sin * speed;
+		life[i] = burst.life;
+		fade[i] = life_fade;
+		alpha[i] = 1;
+		particle_size[i] = burst.size;
+		color[i] = packed_color;
+	}
+	count += emitted;
+}
+
+void ParticleSystem::update(float delta_time) {
+	//Exact solution of dv/dt = -drag * v for the step
+	float damping = std::exp(-drag * delta_time);
+	integrate(delta_time, damping);
+	fade_out(delta_time);
+	cull();
+}
+
+void ParticleSystem::integrate(float delta_time, float damping) {
+	std::size_t i = 0;
+	float gravity_step = gravity * delta_time;
+#if defined(PONGX_PARTICLES_SSE2)
+	const __m128 dt = _mm_set1_ps(delta_time), damping_4 = _mm_set1_ps(damping);
+	const __m128 gravity_4 = _mm_set1_ps(gravity_step);
+	for (; i < count; i += 4) {
+		__m128 vx = _mm_mul_ps(_mm_loadu_ps(&velocity_x[i]), damping_4);
+		__m128 vy = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&velocity_y[i]), damping_4), gravity_4);
+		_mm_storeu_ps(&velocity_x[i], vx);
+		_mm_storeu_ps(&velocity_y[i], vy);
+		_mm_storeu_ps(&x[i], _mm_add_ps(_mm_loadu_ps(&x[i]), _mm_mul_ps(vx, dt)));
+		_mm_storeu_ps(&y[i], _mm_add_ps(_mm_loadu_ps(&y[i]), _mm_mul_ps(vy, dt)));
+	}
+#endif
+	for (; i < count; i++) {
+		velocity_x[i] *= damping;
+		velocity_y[i] = velocity_y[i] * damping + gravity_step;
+		x[i] += velocity_x[i] * delta_time;
+		y[i] += velocity_y[i] * delta_time;
+	}
+}
+
+void ParticleSystem::fade_out(float delta_time) {
+	std::size_t i = 0;
+#if defined(PONGX_PARTICLES_SSE2)
+	const __m128 dt = _mm_set1_ps(delta_time), zero = _mm_setzero_ps();
+	for (; i < count; i += 4) {
+		__m128 new_life = _mm_sub_ps(_mm_loadu_ps(&life[i]), dt);
+		_mm_storeu_ps(&life[i], new_life);
+		_mm_storeu_ps(&alpha[i], _mm_max_ps(_mm_mul_ps(new_life, _mm_loadu_ps(&fade[i])), zero));
+	}
+#endif
+	for (; i < count; i++) {
+		life[i] -= delta_time;
+		alpha[i] = std::max(life[i] * fade[i], 0.0F);
+	}
+}
+
+void ParticleSystem::cull() {
+	//Every particle is copied to the end of the alive ones, which advances only if the particle is alive.
+	//There are no branches to mispredict, the particles die in random order
+	//The particles before the first dead one stay where they are
+	std::size_t alive = 0;
+	while (alive < count && life[alive] > 0)
+		alive++;
+	for (std::size_t i = alive; i < count; i++) {
+		x[alive] = x[i];
+		y[alive] = y[i];
+		velocity_x[alive] = velocity_x[i];
+		velocity_y[alive] = velocity_y[i];
+		life[alive] = life[i];
+		fade[alive] = fade[i];
+		alpha[alive] = alpha[i];
+		particle_size[alive] = particle_size[i];
+		color[alive] = color[i];
+		alive += life[i] > 0 ? 1 : 0;
+	}
+	count = alive;
+}
+
+void ParticleSystem::build_vertices(std::vector<sf::Vertex>& vertices) const {
+	vertices.resize(3 * count);
+	sf::Vertex* vertex = vertices.data();
+	for (std::size_t i = 0; i < count; i++, vertex += 3) {
+		sf::Color particle_color(static_cast<sf::Uint8>(color[i]), static_cast<sf::Uint8>(color[i] >> 8),
+								 static_cast<sf::Uint8>(color[i] >> 16),
+								 static_cast<sf::Uint8>(static_cast<float>(color[i] >> 24) * alpha[i]));
+		float size = particle_size[i];
+		vertex[0].position = { x[i], y[i] - size };
+		vertex[1].position = { x[i] + CORNER_X * size, y[i] + CORNER_Y * size };
+		vertex[2].position = { x[i] - CORNER_X * size, y[i] + CORNER_Y * size };
+		vertex[0].color = vertex[1].color = vertex[2].color = particle_color;
+	}
+}
+
+std::size_t ParticleSystem::size() const {
+	return count;
+}
+
+std::size_t ParticleSystem::get_capacity() const {
+	return capacity;
+}
+
+std::uint64_t ParticleSystem::get_dropped() const {
+	return dropped;
+}
+
+sf::Vector2f ParticleSystem::get_position(std::size_t particle) const {
+	return { x[particle], y[particle] };
+}
+
+float ParticleSystem::get_alpha(std::size_t particle) const {
+	return alpha[particle];
+}
@@ -0,0 +1,99 @@
+/*
+ * PongX particle effects
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+
+#include "../game_math.hpp"
+
+///Particles flying out of one point
+struct ParticleBurst {
+	sf::Vector2f position;
+	unsigned int count = 1;
+	///Speed of every particle is random in [min_speed;max_speed) (pixels per second)
+	float min_speed = 0, max_speed = 0;
+	///Middle direction of the particles (radians)
+	float direction = 0;
+	///Directions are random in [direction - spread / 2;direction + spread / 2) (2 * PI - all around)
+	float spread = 6.2831853F;
+	///Time till the particle disappears (seconds). It fades out all this time
+	float life = 1;
+	///Radius of the particle (pixels)
+	float size = 2;
+	sf::Color color = sf::Color::White;
+};
+
+///Fixed pool of short-living particles (ball trails, sparks). The particles are stored as arrays of their
+///values (not as array of structures), so the update is a few passes over the arrays 4 particles at a time.
+///Alive particles are kept at the beginning of the arrays and are drawn as one array of triangles
+class ParticleSystem {
+public:
+	///@param capacity most particles alive at once (new particles are dropped when it is full)
+	///@param gravity vertical acceleration (pixels per second^2)
+	///@param drag how fast the particles slow down (1 / seconds)
+	ParticleSystem(std::size_t capacity, float gravity = 0, float drag = 0, unsigned int seed = 0);
+
+	void emit(const ParticleBurst& burst);
+	///Move the particles, fade them out and remove the dead ones
+	///@param delta_time seconds since the previous update
+	void update(float delta_time);
+	///Write a triangle (3 vertices) per alive particle. The vector keeps its storage between the frames
+	///@param vertices the result (reference)
+	void build_vertices(std::vector<sf::Vertex>& vertices) const;
+
+	///Get amount of alive particles
+	std::size_t size() const;
+	std::size_t get_capacity() const;
+	///Get amount of particles that were not emitted because the pool was full
+	std::uint64_t get_dropped() const;
+	sf::Vector2f get_position(std::size_t particle) const;
+	///Get the opacity of the particle (0 - 1)
+	float get_alpha(std::size_t particle) const;
+
+private:
+	std::size_t capacity;
+	std::size_t count = 0;
+	std::uint64_t dropped = 0;
+	float gravity, drag;
+	gm::Randomizer randomizer;
+
+	//BEGIN Particles
+	std::vector<float> x, y;
+	std::vector<float> velocity_x, velocity_y;
+	///Seconds left
+	std::vector<float> life;
+	///1 / the whole life, so life * fade is the opacity
+	std::vector<float> fade;
+	std::vector<float> alpha;
+	std::vector<float> particle_size;
+	std::vector<std::uint32_t> color;
+	//END Particles
+
+	///Apply the velocities and the forces
+	void integrate(float delta_time, float damping);
+	///Age the particles and compute their opacity
+	void fade_out(float delta_time);
+	///Move the alive particles to the beginning of the arrays (in the same order)
+	void cull();
+};
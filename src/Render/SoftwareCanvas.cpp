@@ -0,0 +1,340 @@
+/*
+ * PongX software rasterizer
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PONGX_CANVAS_SSE2
+#include <emmintrin.h>
+#endif
+
+#include "SoftwareCanvas.hpp"
+
+///Glyph of the bitmap font: 7 rows of 5 pixels, the highest of the 5 bits is the left pixel
+struct BitmapGlyph {
+	char character;
+	std::uint8_t rows[7];
+};
+
+static const BitmapGlyph FONT[] = {
+	{ '0', { 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E } }, { '1', { 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E } },
+	{ '2', { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F } }, { '3', { 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E } },
+	{ '4', { 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 } }, { '5', { 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E } },
+	{ '6', { 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E } }, { '7', { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 } },
+	{ '8', { 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E } }, { '9', { 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C } },
+	{ 'A', { 0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11 } }, { 'B', { 0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E } },
+	{ 'C', { 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E } }, { 'D', { 0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C } },
+	{ 'E', { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F } }, { 'F', { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 } },
+	{ 'G', { 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F } }, { 'H', { 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 } },
+	{ 'I', { 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E } }, { 'J', { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C } },
+	{ 'K', { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 } }, { 'L', { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F } },
+	{ 'M', { 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 } }, { 'N', { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 } },
+	{ 'O', { 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E } }, { 'P', { 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 } },
+	{ 'Q', { 0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D } }, { 'R', { 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 } },
+	{ 'S', { 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E } }, { 'T', { 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 } },
+	{ 'U', { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E } }, { 'V', { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 } },
+	{ 'W', { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A } }, { 'X', { 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 } },
+	{ 'Y', { 0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04 } }, { 'Z', { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F } },
+	{ ':', { 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00 } }, { '.', { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C } },
+	{ '-', { 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00 } }, { '/', { 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00 } },
+	{ '%', { 0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03 } }
+};
+///A character takes 6 x 8 pixels of the font: the glyph and the space after it
+static constexpr unsigned int CELL_WIDTH = 6, CELL_HEIGHT = 8;
+static constexpr unsigned int GLYPH_WIDTH = 5, GLYPH_HEIGHT = 7;
+
+///@returns nullptr if the font has no such character
+static const BitmapGlyph* find_glyph(char character) {
+	if (character >= 'a' && character <= 'z')
+		character = static_cast<char>(character - 'a' + 'A');
+	for (const BitmapGlyph& glyph : FONT) {
+		if (glyph.character == character)
+			return &glyph;
+	}
+	return nullptr;
+}
+
+///Pack the color as an opaque pixel
+static std::uint32_t pack_color(sf::Color color) {
+	std::uint8_t bytes[4] = { color.r, color.g, color.b, 255 };
+	std::uint32_t pixel;
+	std::memcpy(&pixel, bytes, sizeof(pixel));
+	return pixel;
+}
+
+///First pixel whose center is not before the coordinate
+static int first_pixel(float coordinate) {
+	return static_cast<int>(std::ceil(coordinate - 0.5F));
+}
+
+SoftwareCanvas::SoftwareCanvas(unsigned int width, unsigned int height, unsigned int threads) :
+	width(width), height(height), pixels(static_cast<std::size_t>(width) * height) {
+	tile_columns = (width + TILE_SIZE - 1) / TILE_SIZE;
+	tile_rows = (height + TILE_SIZE - 1) / TILE_SIZE;
+	bins.resize(static_cast<std::size_t>(tile_columns) * tile_rows);
+
+	thread_count = threads != 0 ? threads : std::max(1U, std::thread::hardware_concurrency());
+	//One thread renders the tiles itself
+	if (thread_count > 1)
+		pool.reset(new WorkStealingPool(thread_count));
+	clear();
+}
+
+void SoftwareCanvas::clear(sf::Color color) {
+	clear_color = pack_color(color);
+	commands.clear();
+	//The bins keep their storage for the next frame
+	for (std::vector<std::uint32_t>& bin : bins)
+		bin.clear();
+}
+
+void SoftwareCanvas::fill_rect(sf::FloatRect rect, sf::Color color) {
+	Command command = { RectCommand, color.a, pack_color(color), 0, 0, 0, 0, { } };
+	add(command, rect.left, rect.top, rect.left + rect.width, rect.top + rect.height);
+}
+
+void SoftwareCanvas::fill_circle(sf::Vector2f center, float radius, sf::Color color) {
+	Command command = { CircleCommand, color.a, pack_color(color), 0, 0, 0, 0, { center.x, center.y, radius } };
+	add(command, center.x - radius, center.y - radius, center.x + radius, center.y + radius);
+}
+
+void SoftwareCanvas::fill_triangle(sf::Vector2f a, sf::Vector2f b, sf::Vector2f c, sf::Color color) {
+	Command command = { TriangleCommand, color.a, pack_color(color), 0, 0, 0, 0, { a.x, a.y, b.x, b.y, c.x, c.y } };
+	add(command, std::min({ a.x, b.x, c.x }), std::min({ a.y, b.y, c.y }),
+		std::max({ a.x, b.x, c.x }), std::max({ a.y, b.y, c.y }));
+}
+
+void SoftwareCanvas::fill_triangles(const sf::Vertex* vertices, std::size_t count) {
+	for (std::size_t i = 0; i + 2 < count; i += 3)
+		fill_triangle(vertices[i].position, vertices[i + 1].position, vertices[i + 2].position, vertices[i].color);
+}
+
+void SoftwareCanvas::draw_line(sf::Vector2f a, sf::Vector2f b, sf::Color color, float thickness) {
+	sf::Vector2f direction = b - a;
+	float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+	if (length == 0.0F)
+		return;
+	//The line is a rectangle around the segment, as 2 triangles
+	sf::Vector2f side(-direction.y / length * thickness * 0.5F, direction.x / length * thickness * 0.5F);
+	fill_triangle(a + side, b + side, b - side, color);
+	fill_triangle(a + side, b - side, a - side, color);
+}
+
+void SoftwareCanvas::draw_text(const std::string& text, sf::Vector2f position, float character_size,
+							   sf::Color color) {
+	float scale = character_size / CELL_HEIGHT;
+	for (std::size_t i = 0; i < text.size(); i++) {
+		const BitmapGlyph* glyph = find_glyph(text[i]);
+		if (glyph == nullptr)
+			continue;
+		float left = position.x + static_cast<float>(i * CELL_WIDTH) * scale;
+		Command command = { GlyphCommand, color.a, pack_color(color), 0, 0, 0, 0,
+							{ left, position.y, scale, static_cast<float>(glyph - FONT) } };
+		add(command, left, position.y, left + GLYPH_WIDTH * scale, position.y + GLYPH_HEIGHT * scale);
+	}
+}
+
+float SoftwareCanvas::get_text_width(const std::string& text, float character_size) {
+	if (text.empty())
+		return 0.0F;
+	//Without the space after the last character
+	return static_cast<float>(text.size() * CELL_WIDTH - 1) * character_size / CELL_HEIGHT;
+}
+
+void SoftwareCanvas::add(Command& command, float min_x, float min_y, float max_x, float max_y) {
+	//The pixels whose centers are in the bounds, clamped to the framebuffer
+	auto clamp = [](float value, unsigned int size) {
+		return static_cast<int>(std::max(0.0F, std::min(static_cast<float>(size), std::ceil(value - 0.5F))));
+	};
+	command.min_x = clamp(min_x, width);
+	command.min_y = clamp(min_y, height);
+	command.max_x = clamp(max_x, width);
+	command.max_y = clamp(max_y, height);
+	if (command.min_x >= command.max_x || command.min_y >= command.max_y || command.alpha == 0)
+		return;
+
+	std::uint32_t index = static_cast<std::uint32_t>(commands.size());
+	commands.push_back(command);
+	for (unsigned int row = command.min_y / TILE_SIZE; row <= (command.max_y - 1) / TILE_SIZE; row++) {
+		for (unsigned int column = command.min_x / TILE_SIZE; column <= (command.max_x - 1) / TILE_SIZE; column++)
+			bins[row * tile_columns + column].push_back(index);
+	}
+}
+
+void SoftwareCanvas::render() {
+	unsigned int tile_count = tile_columns * tile_rows;
+	if (!pool) {
+		for (unsigned int tile = 0; tile < tile_count; tile++)
+			render_tile(tile);
+		return;
+	}
+
+	//Every thread takes the next tile till they end, so the busy tiles do not hold the others
+	std::atomic<unsigned int> next_tile { 0 };
+	for (unsigned int i = 0; i < thread_count; i++) {
+		pool->submit([this, &next_tile, tile_count]() {
+			unsigned int tile;
+			while ((tile = next_tile.fetch_add(1, std::memory_order_relaxed)) < tile_count)
+				render_tile(tile);
+		});
+	}
+	pool->wait();
+}
+
+void SoftwareCanvas::render_tile(unsigned int tile) {
+	int tile_x = static_cast<int>(tile % tile_columns * TILE_SIZE);
+	int tile_y = static_cast<int>(tile / tile_columns * TILE_SIZE);
+	int tile_max_x = std::min(tile_x + static_cast<int>(TILE_SIZE), static_cast<int>(width));
+	int tile_max_y = std::min(tile_y + static_cast<int>(TILE_SIZE), static_cast<int>(height));
+	for (int y = tile_y; y < tile_max_y; y++)
+		fill_span(&pixels[static_cast<std::size_t>(y) * width], tile_x, tile_max_x, clear_color, 255);
+
+	for (std::uint32_t index : bins[tile]) {
+		const Command& command = commands[index];
+		int min_x = std::max(command.min_x, tile_x), max_x = std::min(command.max_x, tile_max_x);
+		int min_y = std::max(command.min_y, tile_y), max_y = std::min(command.max_y, tile_max_y);
+		const float* values = command.values;
+
+		for (int y = min_y; y < max_y; y++) {
+			std::uint32_t* row = &pixels[static_cast<std::size_t>(y) * width];
+			float center_y = static_cast<float>(y) + 0.5F;
+			//Span of the row covered by the shape
+			float span_x_1, span_x_2;
+			switch (command.type) {
+				case RectCommand: {
+					fill_span(row, min_x, max_x, command.color, command.alpha);
+					continue;
+				}
+				case CircleCommand: {
+					float dy = center_y - values[1];
+					float squared = values[2] * values[2] - dy * dy;
+					if (squared <= 0.0F)
+						continue;
+					float half = std::sqrt(squared);
+					span_x_1 = values[0] - half;
+					span_x_2 = values[0] + half;
+					break;
+				}
+				case TriangleCommand: {
+					//The row crosses 2 edges of the triangle or none
+					span_x_1 = 1e30F;
+					span_x_2 = -1e30F;
+					for (unsigned int edge = 0; edge < 3; edge++) {
+						float a_x = values[2 * edge], a_y = values[2 * edge + 1];
+						float b_x = values[(2 * edge + 2) % 6], b_y = values[(2 * edge + 3) % 6];
+						if ((a_y <= center_y) == (b_y <= center_y))
+							continue;
+						float x = a_x + (center_y - a_y) * (b_x - a_x) / (b_y - a_y);
+						span_x_1 = std::min(span_x_1, x);
+						span_x_2 = std::max(span_x_2, x);
+					}
+					if (span_x_1 > span_x_2)
+						continue;
+					break;
+				}
+				case GlyphCommand: {
+					float scale = values[2];
+					int glyph_row = static_cast<int>(std::floor((center_y - values[1]) / scale));
+					if (glyph_row < 0 || glyph_row >= static_cast<int>(GLYPH_HEIGHT))
+						continue;
+					//Every run of the set pixels of the glyph row is one span
+					std::uint8_t bits = FONT[static_cast<std::size_t>(values[3])].rows[glyph_row];
+					for (unsigned int column = 0; column < GLYPH_WIDTH; column++) {
+						if ((bits & (0x10U >> column)) == 0)
+							continue;
+						unsigned int end = column;
+						while (end < GLYPH_WIDTH && (bits & (0x10U >> end)) != 0)
+							end++;
+						fill_span(row, std::max(min_x, first_pixel(values[0] + static_cast<float>(column) * scale)),
+								  std::min(max_x, first_pixel(values[0] + static_cast<float>(end) * scale)),
+								  command.color, command.alpha);
+						column = end;
+					}
+					continue;
+				}
+				default: {
+					continue;
+				}
+			}
+			fill_span(row, std::max(min_x, first_pixel(span_x_1)), std::min(max_x, first_pixel(span_x_2)),
+					  command.color, command.alpha);
+		}
+	}
+}
+
+void SoftwareCanvas::fill_span(std::uint32_t* row, int x_1, int x_2, std::uint32_t color, std::uint8_t alpha) {
+	int x = x_1;
+	if (alpha == 255) {
+#if defined(PONGX_CANVAS_SSE2)
+		const __m128i color_4 = _mm_set1_epi32(static_cast<int>(color));
+		for (; x + 4 <= x_2; x += 4)
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(row + x), color_4);
+#endif
+		for (; x < x_2; x++)
+			row[x] = color;
+		return;
+	}
+
+	//result = (color * a + pixel * (256 - a)) / 256, where a is 0 - 256. Both products fit into 16 bits
+	unsigned int a = alpha + (alpha >> 7), inverse = 256 - a;
+#if defined(PONGX_CANVAS_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i source = _mm_mullo_epi16(_mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(color)), zero),
+										   _mm_set1_epi16(static_cast<short>(a)));
+	const __m128i inverse_8 = _mm_set1_epi16(static_cast<short>(inverse));
+	for (; x + 4 <= x_2; x += 4) {
+		__m128i pixels_4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x));
+		__m128i low = _mm_unpacklo_epi8(pixels_4, zero), high = _mm_unpackhi_epi8(pixels_4, zero);
+		low = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(low, inverse_8), source), 8);
+		high = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(high, inverse_8), source), 8);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(row + x), _mm_packus_epi16(low, high));
+	}
+#endif
+	for (; x < x_2; x++) {
+		std::uint8_t source[4], target[4];
+		std::memcpy(source, &color, 4);
+		std::memcpy(target, &row[x], 4);
+		for (unsigned int channel = 0; channel < 4; channel++)
+			target[channel] = static_cast<std::uint8_t>((source[channel] * a + target[channel] * inverse) >> 8);
+		std::memcpy(&row[x], target, 4);
+	}
+}
+
+unsigned int SoftwareCanvas::get_width() const {
+	return width;
+}
+
+unsigned int SoftwareCanvas::get_height() const {
+	return height;
+}
+
+const std::uint8_t* SoftwareCanvas::get_pixels() const {
+	return reinterpret_cast<const std::uint8_t*>(pixels.data());
+}
+
+sf::Color SoftwareCanvas::get_pixel(unsigned int x, unsigned int y) const {
+	const std::uint8_t* pixel = get_pixels() + 4 * (static_cast<std::size_t>(y) * width + x);
+	return sf::Color(pixel[0], pixel[1], pixel[2], pixel[3]);
+}
+
+std::size_t SoftwareCanvas::get_command_count() const {
+	return commands.size();
+}
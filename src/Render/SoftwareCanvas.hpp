@@ -0,0 +1,104 @@
+/*
+ * PongX software rasterizer
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+
+#include "../Utils/WorkStealingPool.hpp"
+
+///Draws into an RGBA framebuffer in memory without OpenGL (e.g. on a server without GPU).
+///The draw calls are recorded and binned into square tiles, render() rasterizes the tiles on all cores:
+///every tile takes its commands in order and fills the rows of the shapes by spans (4 pixels at a time).
+///A pixel is covered if its center is in the shape, the colors are blended over the opaque framebuffer
+class SoftwareCanvas {
+public:
+	///Side of a tile (pixels)
+	static constexpr unsigned int TILE_SIZE = 64;
+
+	///@param threads amount of threads of render(), 0 - one per hardware thread
+	SoftwareCanvas(unsigned int width, unsigned int height, unsigned int threads = 0);
+
+	///Drop the recorded commands, the next render() starts with the color
+	void clear(sf::Color color = sf::Color::Black);
+
+	void fill_rect(sf::FloatRect rect, sf::Color color);
+	void fill_circle(sf::Vector2f center, float radius, sf::Color color);
+	void fill_triangle(sf::Vector2f a, sf::Vector2f b, sf::Vector2f c, sf::Color color);
+	///Fill the triangles (3 vertices each), every triangle has the color of its first vertex
+	void fill_triangles(const sf::Vertex* vertices, std::size_t count);
+	void draw_line(sf::Vector2f a, sf::Vector2f b, sf::Color color, float thickness = 1.0F);
+	///Draw the text with the built-in bitmap font (digits, latin capitals and a few signs; others are blank)
+	///@param position left top corner of the text
+	///@param character_size height of a line (pixels)
+	void draw_text(const std::string& text, sf::Vector2f position, float character_size, sf::Color color);
+	///Get the width of the text drawn by draw_text()
+	static float get_text_width(const std::string& text, float character_size);
+
+	///Rasterize the recorded commands into the framebuffer. The commands are kept till clear()
+	void render();
+
+	unsigned int get_width() const;
+	unsigned int get_height() const;
+	///Get the framebuffer: rows of pixels top to bottom, every pixel is 4 bytes R, G, B, A
+	const std::uint8_t* get_pixels() const;
+	sf::Color get_pixel(unsigned int x, unsigned int y) const;
+	std::size_t get_command_count() const;
+
+private:
+	enum CommandType : std::uint8_t {
+		RectCommand, CircleCommand, TriangleCommand, GlyphCommand
+	};
+
+	struct Command {
+		CommandType type;
+		std::uint8_t alpha;
+		///Color with the alpha of 255 (the framebuffer is opaque), packed as the pixels
+		std::uint32_t color;
+		///Pixels that may be covered: [min_x;max_x) x [min_y;max_y), inside the framebuffer
+		int min_x, min_y, max_x, max_y;
+		///Circle: x, y, radius. Triangle: 3 points. Glyph: left, top, size of a font pixel, the character
+		float values[6];
+	};
+
+	unsigned int width, height;
+	unsigned int tile_columns, tile_rows;
+	std::vector<std::uint32_t> pixels;
+	std::uint32_t clear_color;
+
+	std::vector<Command> commands;
+	///Indices of the commands that touch every tile, in order
+	std::vector<std::vector<std::uint32_t>> bins;
+
+	std::unique_ptr<WorkStealingPool> pool;
+	unsigned int thread_count;
+
+	///Clip the bounds of the command and put it into the bins of the tiles it touches
+	void add(Command& command, float min_x, float min_y, float max_x, float max_y);
+	void render_tile(unsigned int tile);
+	///Fill the pixels [x_1;x_2) of the row of the framebuffer
+	static void fill_span(std::uint32_t* row, int x_1, int x_2, std::uint32_t color, std::uint8_t alpha);
+};
@@ -0,0 +1,325 @@
+/*
+ * PongX arena with static obstacles
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+#if defined(_WIN32)
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "ArenaMap.hpp"
+
+//The file is the memory image, so the layout must not depend on the compiler
+static_assert(std::is_trivially_copyable<ArenaMap::Obstacle>::value && sizeof(ArenaMap::Obstacle) == 24,
+			  "Obstacle is a part of the file layout");
+static_assert(std::is_trivially_copyable<ArenaMap::Node>::value && sizeof(ArenaMap::Node) == 24,
+			  "Node is a part of the file layout");
+static_assert(std::is_trivially_copyable<ArenaMap::Header>::value && sizeof(ArenaMap::Header) == 16,
+			  "Header is a part of the file layout");
+
+///Magic of the arena file
+static const char MAGIC[4] = { 'P', 'X', 'A', 'R' };
+///Maximal amount of obstacles in a leaf of the BVH
+constexpr std::size_t LEAF_SIZE = 2;
+///Maximal depth of the BVH traversal. The baked BVH is balanced, so it is never reached
+constexpr unsigned int MAX_DEPTH = 64;
+
+///Compute the bounding box of the obstacle
+static void obstacle_bounds(const ArenaMap::Obstacle& obstacle, ArenaMap::Node& bounds) {
+	switch (obstacle.type) {
+		case ArenaMap::Circle: {
+			bounds = { obstacle.x1 - obstacle.radius, obstacle.y1 - obstacle.radius,
+					   obstacle.x1 + obstacle.radius, obstacle.y1 + obstacle.radius, 0, 0 };
+			break;
+		}
+		case ArenaMap::Segment: { //The capsule
+			bounds = { std::min(obstacle.x1, obstacle.x2) - obstacle.radius,
+					   std::min(obstacle.y1, obstacle.y2) - obstacle.radius,
+					   std::max(obstacle.x1, obstacle.x2) + obstacle.radius,
+					   std::max(obstacle.y1, obstacle.y2) + obstacle.radius, 0, 0 };
+			break;
+		}
+		default: { //Corners of the rect are rounded inside of it
+			bounds = { std::min(obstacle.x1, obstacle.x2), std::min(obstacle.y1, obstacle.y2),
+					   std::max(obstacle.x1, obstacle.x2), std::max(obstacle.y1, obstacle.y2), 0, 0 };
+		}
+	}
+}
+
+ArenaMap::ArenaMap(const std::vector<Obstacle>& obstacles) {
+	std::vector<Obstacle> items = obstacles;
+	std::vector<Obstacle> baked;
+	std::vector<Node> baked_nodes;
+	baked.reserve(items.size());
+	if (!items.empty())
+		build_node(items, 0, items.size(), baked, baked_nodes);
+
+	//Header, obstacles and nodes one after another, every part is a multiple of 4 bytes
+	Header baked_header;
+	std::memcpy(baked_header.magic, MAGIC, sizeof(MAGIC));
+	baked_header.version = VERSION;
+	baked_header.obstacle_count = static_cast<std::uint32_t>(baked.size());
+	baked_header.node_count = static_cast<std::uint32_t>(baked_nodes.size());
+
+	std::size_t obstacles_bytes = baked.size() * sizeof(Obstacle);
+	std::size_t nodes_bytes = baked_nodes.size() * sizeof(Node);
+	buffer.resize((sizeof(Header) + obstacles_bytes + nodes_bytes) / sizeof(std::uint32_t));
+	char* bytes = reinterpret_cast<char*>(buffer.data());
+	std::memcpy(bytes, &baked_header, sizeof(Header));
+	if (obstacles_bytes != 0)
+		std::memcpy(bytes + sizeof(Header), baked.data(), obstacles_bytes);
+	if (nodes_bytes != 0)
+		std::memcpy(bytes + sizeof(Header) + obstacles_bytes, baked_nodes.data(), nodes_bytes);
+
+	attach(bytes, buffer.size() * sizeof(std::uint32_t));
+}
+
+ArenaMap::~ArenaMap() {
+#if !defined(_WIN32)
+	if (mapping != nullptr)
+		munmap(mapping, mapping_size);
+#endif
+}
+
+std::uint32_t ArenaMap::build_node(std::vector<Obstacle>& items, std::size_t begin, std::size_t end,
+								   std::vector<Obstacle>& baked, std::vector<Node>& baked_nodes) {
+	std::uint32_t index = static_cast<std::uint32_t>(baked_nodes.size());
+
+	//Bounds of the obstacles and of their centers
+	Node node;
+	obstacle_bounds(items[begin], node);
+	float center_min_x = (node.min_x + node.max_x) * 0.5F, center_max_x = center_min_x;
+	float center_min_y = (node.min_y + node.max_y) * 0.5F, center_max_y = center_min_y;
+	for (std::size_t i = begin + 1; i < end; i++) {
+		Node bounds;
+		obstacle_bounds(items[i], bounds);
+		node.min_x = std::min(node.min_x, bounds.min_x);
+		node.min_y = std::min(node.min_y, bounds.min_y);
+		node.max_x = std::max(node.max_x, bounds.max_x);
+		node.max_y = std::max(node.max_y, bounds.max_y);
+		center_min_x = std::min(center_min_x, (bounds.min_x + bounds.max_x) * 0.5F);
+		center_max_x = std::max(center_max_x, (bounds.min_x + bounds.max_x) * 0.5F);
+		center_min_y = std::min(center_min_y, (bounds.min_y + bounds.max_y) * 0.5F);
+		center_max_y = std::max(center_max_y, (bounds.min_y + bounds.max_y) * 0.5F);
+	}
+	baked_nodes.push_back(node);
+
+	if (end - begin <= LEAF_SIZE) {
+		baked_nodes[index].first = static_cast<std::uint32_t>(baked.size());
+		baked_nodes[index].count = static_cast<std::uint32_t>(end - begin);
+		baked.insert(baked.end(), items.begin() + begin, items.begin() + end);
+		return index;
+	}
+
+	//Split by the median of the centers along the longer side, so the tree is balanced
+	bool split_x = center_max_x - center_min_x >= center_max_y - center_min_y;
+	std::size_t middle = begin + (end - begin) / 2;
+	std::nth_element(items.begin() + begin, items.begin() + middle, items.begin() + end,
+					 [split_x](const Obstacle& a, const Obstacle& b) {
+		Node a_bounds, b_bounds;
+		obstacle_bounds(a, a_bounds);
+		obstacle_bounds(b, b_bounds);
+		if (split_x)
+			return a_bounds.min_x + a_bounds.max_x < b_bounds.min_x + b_bounds.max_x;
+		return a_bounds.min_y + a_bounds.max_y < b_bounds.min_y + b_bounds.max_y;
+	});
+
+	//The left child is the next node
+	build_node(items, begin, middle, baked, baked_nodes);
+	std::uint32_t right = build_node(items, middle, end, baked, baked_nodes);
+	baked_nodes[index].first = right;
+	baked_nodes[index].count = 0;
+	return index;
+}
+
+bool ArenaMap::attach(const void* data, std::size_t size) {
+	if (size < sizeof(Header))
+		return false;
+	const Header* file_header = static_cast<const Header*>(data);
+	if (std::memcmp(file_header->magic, MAGIC, sizeof(MAGIC)) != 0 || file_header->version != VERSION)
+		return false;
+
+	//Only the sizes are checked here, indices of the nodes are checked by query()
+	unsigned long long expected_size = sizeof(Header) +
+		static_cast<unsigned long long>(file_header->obstacle_count) * sizeof(Obstacle) +
+		static_cast<unsigned long long>(file_header->node_count) * sizeof(Node);
+	if (expected_size != size)
+		return false;
+
+	header = file_header;
+	obstacles = reinterpret_cast<const Obstacle*>(static_cast<const char*>(data) + sizeof(Header));
+	nodes = reinterpret_cast<const Node*>(obstacles + header->obstacle_count);
+	return true;
+}
+
+std::shared_ptr<ArenaMap> ArenaMap::load(const std::string& path) {
+	std::shared_ptr<ArenaMap> arena(new ArenaMap());
+
+#if defined(_WIN32)
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+		return nullptr;
+	std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	if (bytes.size() % sizeof(std::uint32_t) != 0)
+		return nullptr;
+	arena->buffer.resize(bytes.size() / sizeof(std::uint32_t));
+	std::memcpy(arena->buffer.data(), bytes.data(), bytes.size());
+	if (!arena->attach(arena->buffer.data(), bytes.size()))
+		return nullptr;
+#else
+	int file = open(path.c_str(), O_RDONLY);
+	if (file < 0)
+		return nullptr;
+	struct stat file_stat;
+	if (fstat(file, &file_stat) != 0 || file_stat.st_size < static_cast<off_t>(sizeof(Header))) {
+		close(file);
+		return nullptr;
+	}
+
+	//The pages are read on demand, the obstacles far from the ball may never be read at all
+	std::size_t size = static_cast<std::size_t>(file_stat.st_size);
+	void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+	if (mapping == MAP_FAILED)
+		return nullptr;
+	arena->mapping = mapping;
+	arena->mapping_size = size;
+	if (!arena->attach(mapping, size))
+		return nullptr;
+#endif
+
+	return arena;
+}
+
+bool ArenaMap::save(const std::string& path) const {
+	std::ofstream file(path, std::ios::binary);
+	if (!file)
+		return false;
+	std::size_t size = sizeof(Header) + header->obstacle_count * sizeof(Obstacle) +
+		header->node_count * sizeof(Node);
+	file.write(reinterpret_cast<const char*>(header), static_cast<std::streamsize>(size));
+	return static_cast<bool>(file);
+}
+
+unsigned int ArenaMap::get_obstacle_count() const {
+	return header->obstacle_count;
+}
+
+const ArenaMap::Obstacle& ArenaMap::get_obstacle(unsigned int index) const {
+	return obstacles[index];
+}
+
+bool ArenaMap::query(sf::Vector2f ball_pos, float ball_radius, Contact& contact) const {
+	if (header->node_count == 0)
+		return false;
+
+	bool found = false;
+	contact.depth = 0.0F;
+
+	//Depth-first traversal of the nodes whose boxes overlap the box of the ball
+	std::uint32_t stack[MAX_DEPTH];
+	unsigned int stack_size = 0;
+	stack[stack_size++] = 0;
+	while (stack_size != 0) {
+		std::uint32_t index = stack[--stack_size];
+		const Node& node = nodes[index];
+		if (ball_pos.x + ball_radius < node.min_x || ball_pos.x - ball_radius > node.max_x ||
+			ball_pos.y + ball_radius < node.min_y || ball_pos.y - ball_radius > node.max_y)
+			continue;
+
+		if (node.count != 0) {
+			//A damaged file must not make us read outside of it
+			if (node.first > header->obstacle_count || node.count > header->obstacle_count - node.first)
+				continue;
+			for (std::uint32_t i = node.first; i < node.first + node.count; i++) {
+				sf::Vector2f normal;
+				float depth = ball_radius - obstacle_distance(obstacles[i], ball_pos, normal);
+				if (depth > contact.depth) {
+					contact = { normal, depth, i };
+					found = true;
+				}
+			}
+			continue;
+		}
+
+		//Children are always after the parent, so even a damaged file can not loop the traversal
+		std::uint32_t right = node.first;
+		if (right <= index + 1 || right >= header->node_count || stack_size + 2 > MAX_DEPTH)
+			continue;
+		stack[stack_size++] = right;
+		stack[stack_size++] = index + 1;
+	}
+
+	return found;
+}
+
+float ArenaMap::obstacle_distance(const Obstacle& obstacle, sf::Vector2f point, sf::Vector2f& normal) {
+	if (obstacle.type == Circle || obstacle.type == Segment) {
+		//Closest point of the segment (the circle is a segment of zero length)
+		sf::Vector2f a(obstacle.x1, obstacle.y1);
+		sf::Vector2f b = obstacle.type == Circle ? a : sf::Vector2f(obstacle.x2, obstacle.y2);
+		sf::Vector2f ab = b - a;
+		float length_squared = ab.x * ab.x + ab.y * ab.y;
+		float t = 0.0F;
+		if (length_squared > 0.0F)
+			t = std::clamp(((point.x - a.x) * ab.x + (point.y - a.y) * ab.y) / length_squared, 0.0F, 1.0F);
+		sf::Vector2f offset = point - (a + ab * t);
+		float length = std::sqrt(offset.x * offset.x + offset.y * offset.y);
+
+		if (length > 0.0F)
+			normal = offset / length;
+		else if (length_squared > 0.0F) //On the segment itself: out through a side of it
+			normal = sf::Vector2f(-ab.y, ab.x) / std::sqrt(length_squared);
+		else
+			normal = { 0.0F, -1.0F };
+		return length - obstacle.radius;
+	}
+
+	//Rounded rect is the inner rect grown by the radius
+	float half_width = std::abs(obstacle.x2 - obstacle.x1) * 0.5F;
+	float half_height = std::abs(obstacle.y2 - obstacle.y1) * 0.5F;
+	float radius = std::clamp(obstacle.radius, 0.0F, std::min(half_width, half_height));
+	sf::Vector2f local(point.x - (obstacle.x1 + obstacle.x2) * 0.5F, point.y - (obstacle.y1 + obstacle.y2) * 0.5F);
+	float sign_x = local.x < 0.0F ? -1.0F : 1.0F, sign_y = local.y < 0.0F ? -1.0F : 1.0F;
+	//Distances outside the inner rect along the axes
+	float outside_x = std::abs(local.x) - (half_width - radius);
+	float outside_y = std::abs(local.y) - (half_height - radius);
+
+	if (outside_x > 0.0F || outside_y > 0.0F) {
+		sf::Vector2f offset(std::max(outside_x, 0.0F) * sign_x, std::max(outside_y, 0.0F) * sign_y);
+		float length = std::sqrt(offset.x * offset.x + offset.y * offset.y);
+		normal = offset / length;
+		return length - radius;
+	}
+
+	//Inside the inner rect: out through the nearest side
+	if (outside_x > outside_y)
+		normal = { sign_x, 0.0F };
+	else
+		normal = { 0.0F, sign_y };
+	return std::max(outside_x, outside_y) - radius;
+}
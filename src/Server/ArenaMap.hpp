@@ -0,0 +1,125 @@
+/*
+ * PongX arena with static obstacles
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <SFML/System/Vector2.hpp>
+
+///Static obstacles of the field baked into a bounding volume hierarchy (BVH).
+///The file has the same bytes as the memory: the header, the obstacles in the order of the BVH leaves
+///and the BVH nodes. So the file is mapped into memory and used as is, without parsing
+class ArenaMap {
+public:
+	enum ObstacleType : std::uint32_t {
+		///Rect from (x1, y1) to (x2, y2), its corners are rounded by the radius (0 - sharp corners)
+		RoundedRect,
+		///Circle with the center (x1, y1)
+		Circle,
+		///Segment from (x1, y1) to (x2, y2) thickened by the radius (a capsule)
+		Segment
+	};
+
+	struct Obstacle {
+		std::uint32_t type;
+		float x1, y1, x2, y2;
+		float radius;
+	};
+
+	///Node of the BVH. The children of an inner node are the next node and the node "first".
+	///Obstacles of a leaf are [first;first + count)
+	struct Node {
+		float min_x, min_y, max_x, max_y;
+		std::uint32_t first;
+		///Amount of obstacles (0 - inner node)
+		std::uint32_t count;
+	};
+
+	///Beginning of the file
+	struct Header {
+		char magic[4];
+		std::uint32_t version;
+		std::uint32_t obstacle_count;
+		std::uint32_t node_count;
+	};
+
+	///Overlap of the ball and an obstacle
+	struct Contact {
+		///Unit direction from the obstacle to the ball
+		sf::Vector2f normal;
+		///How deep the ball is in the obstacle
+		float depth;
+		///Index of the obstacle, see get_obstacle()
+		unsigned int obstacle;
+	};
+
+	///Version of the file layout
+	static constexpr std::uint32_t VERSION = 1;
+
+	///Bake the obstacles. Their order changes, see get_obstacle()
+	ArenaMap(const std::vector<Obstacle>& obstacles);
+	ArenaMap(const ArenaMap&) = delete;
+	ArenaMap& operator=(const ArenaMap&) = delete;
+	~ArenaMap();
+
+	///Map the arena file into memory
+	///@returns nullptr if the file can not be read or it is not an arena of this version
+	static std::shared_ptr<ArenaMap> load(const std::string& path);
+
+	///Write the baked arena to the file
+	///@returns false if the file can not be written
+	bool save(const std::string& path) const;
+
+	unsigned int get_obstacle_count() const;
+	///Get the obstacle in the baked order
+	const Obstacle& get_obstacle(unsigned int index) const;
+
+	///Find the obstacle that the ball overlaps the most. Costs O(log n) for n obstacles
+	///@param contact the result (reference)
+	///@returns false if the ball does not touch any obstacle
+	bool query(sf::Vector2f ball_pos, float ball_radius, Contact& contact) const;
+
+	///Signed distance from the point to the obstacle (negative inside)
+	///@param normal the result: unit direction out of the obstacle at the point (reference)
+	static float obstacle_distance(const Obstacle& obstacle, sf::Vector2f point, sf::Vector2f& normal);
+
+private:
+	ArenaMap() = default;
+
+	///Bytes of the baked arena, if it is not mapped from the file
+	std::vector<std::uint32_t> buffer;
+	///Mapped file (nullptr if the arena is in the buffer)
+	void* mapping = nullptr;
+	std::size_t mapping_size = 0;
+
+	const Header* header = nullptr;
+	const Obstacle* obstacles = nullptr;
+	const Node* nodes = nullptr;
+
+	///Point header, obstacles and nodes to the bytes of the arena
+	///@returns false if the bytes are not an arena of this version
+	bool attach(const void* data, std::size_t size);
+	///Build the BVH node of the obstacles [begin;end), the obstacles are appended in the order of the leaves
+	///@returns index of the node
+	static std::uint32_t build_node(std::vector<Obstacle>& items, std::size_t begin, std::size_t end,
+									std::vector<Obstacle>& baked, std::vector<Node>& baked_nodes);
+};
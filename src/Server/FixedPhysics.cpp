@@ -0,0 +1,216 @@
+/*
+ * PongX fixed-point physics
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "../fast_trig.hpp"
+#include "FixedPhysics.hpp"
+
+///Angle in degrees to Q16.16 radians
+constexpr fx::Fixed degrees(int angle) {
+	return static_cast<fx::Fixed>(static_cast<std::int64_t>(fx::PI) * angle / 180);
+}
+
+///Directions of the first serve, the same as of the float physics
+static const fx::Fixed FIRST_SERVE_MIN[3] = { degrees(0), degrees(115), degrees(295) };
+static const fx::Fixed FIRST_SERVE_MAX[3] = { degrees(75), degrees(255), degrees(360) };
+///Directions of the serve after the point
+static const fx::Fixed SERVE_MIN[2] = { degrees(10), degrees(190) };
+static const fx::Fixed SERVE_MAX[2] = { degrees(170), degrees(350) };
+///Maximal movement of the paddle per tick
+constexpr fx::Fixed PADDLE_SPEED = fx::from_int(10);
+
+FixedPhysics::FixedPhysics(sf::Vector2u window_size, float ball_radius, float ball_speed,
+						   sf::FloatRect player_rect, sf::FloatRect enemy_rect) {
+	//Settings are converted once, the same floats give the same numbers everywhere
+	window_width = fx::from_int(static_cast<int>(window_size.x));
+	window_height = fx::from_int(static_cast<int>(window_size.y));
+	this->ball_radius = fx::from_float(ball_radius);
+	this->ball_speed = fx::from_float(ball_speed);
+
+	player_left = fx::from_float(player_rect.left);
+	player_width = fx::from_float(player_rect.width);
+	player_height = fx::from_float(player_rect.height);
+	start_player_top = fx::from_float(player_rect.top);
+	enemy_left = fx::from_float(enemy_rect.left);
+	enemy_width = fx::from_float(enemy_rect.width);
+	enemy_height = fx::from_float(enemy_rect.height);
+	start_enemy_top = fx::from_float(enemy_rect.top);
+
+	state = { window_width / 2, window_height / 2, 0, 0, start_player_top, start_enemy_top };
+}
+
+void FixedPhysics::reset(gm::Randomizer& randomizer) {
+	state.player_top = start_player_top;
+	state.enemy_top = start_enemy_top;
+	launch(randomizer, FIRST_SERVE_MIN, FIRST_SERVE_MAX, 3);
+}
+
+void FixedPhysics::serve(gm::Randomizer& randomizer) {
+	launch(randomizer, SERVE_MIN, SERVE_MAX, 2);
+}
+
+void FixedPhysics::launch(gm::Randomizer& randomizer, const fx::Fixed* min, const fx::Fixed* max,
+						  unsigned int count) {
+	state.ball_x = window_width / 2;
+	state.ball_y = window_height / 2;
+
+	fx::Fixed sin, cos;
+	fx::sin_cos(fx::random_number_ranges(randomizer, min, max, count), sin, cos);
+	state.velocity_x = fx::mul(cos, ball_speed);
+	state.velocity_y = fx::mul(sin, ball_speed);
+}
+
+void FixedPhysics::move_paddles(fx::Fixed player_speed, fx::Fixed enemy_speed) {
+	state.player_top = std::clamp(state.player_top + fx::mul(player_speed, PADDLE_SPEED),
+								  0, window_height - player_height);
+	state.enemy_top = std::clamp(state.enemy_top + fx::mul(enemy_speed, PADDLE_SPEED),
+								 0, window_height - enemy_height);
+}
+
+FixedBallEvents FixedPhysics::move_ball(bool collided_before) {
+	FixedBallEvents events;
+	state.ball_x += state.velocity_x;
+	state.ball_y += state.velocity_y;
+
+	//Left and right bounds
+	if (state.ball_x + ball_radius < 0) {
+		events.enemy_scored = true;
+		return events;
+	}
+	if (state.ball_x - ball_radius > window_width) {
+		events.player_scored = true;
+		return events;
+	}
+
+	//Top and bottom bounds: mirror the part of the path behind the bound
+	if (state.ball_y - ball_radius <= 0 && state.velocity_y < 0) {
+		state.ball_y = 2 * ball_radius - state.ball_y;
+		state.velocity_y = -state.velocity_y;
+		events.wall = 1;
+	} else if (state.ball_y + ball_radius >= window_height && state.velocity_y > 0) {
+		state.ball_y = 2 * (window_height - ball_radius) - state.ball_y;
+		state.velocity_y = -state.velocity_y;
+		events.wall = 2;
+	}
+
+	events.collision = collide_paddle(player_left, state.player_top, player_width, player_height, collided_before);
+	events.player_paddle = events.collision != 0;
+	if (events.collision == 0)
+		events.collision = collide_paddle(enemy_left, state.enemy_top, enemy_width, enemy_height, collided_before);
+	return events;
+}
+
+unsigned char FixedPhysics::collide_paddle(fx::Fixed left, fx::Fixed top, fx::Fixed width, fx::Fixed height,
+										   bool collided_before) {
+	fx::Fixed right = left + width, bottom = top + height;
+	fx::Fixed& x = state.ball_x;
+	fx::Fixed& y = state.ball_y;
+
+	//Rounded rect - point model, as in the float physics. Products are in 64 bits, so nothing overflows
+	std::int64_t outside_x = x - std::clamp(x, left, right), outside_y = y - std::clamp(y, top, bottom);
+	if (outside_x * outside_x + outside_y * outside_y > static_cast<std::int64_t>(ball_radius) * ball_radius)
+		return 0;
+
+	//Segment of the rounded rect: corners, then the triangles between the diagonals
+	unsigned char segment;
+	if (x < left && y < top)
+		segment = 5;
+	else if (x > right && y < top)
+		segment = 6;
+	else if (x > right && y > bottom)
+		segment = 7;
+	else if (x < left && y > bottom)
+		segment = 8;
+	else {
+		//Compare the slope from the center with the slopes of the diagonals without division
+		std::int64_t along_y = static_cast<std::int64_t>(2 * y - top - bottom) * width;
+		std::int64_t along_x = static_cast<std::int64_t>(2 * x - left - right) * height;
+		bool higher_1 = along_y > along_x, higher_2 = along_y > -along_x;
+		if (!higher_1 && !higher_2)
+			segment = 1;
+		else if (higher_1 && !higher_2)
+			segment = 4;
+		else if (!higher_1 && higher_2)
+			segment = 2;
+		else
+			segment = 3;
+	}
+
+	//Reflect: flip the component of the velocity across the surface (both of them for the corners)
+	if (!collided_before) {
+		if (segment == 1 || segment == 3 || segment >= 5)
+			state.velocity_y = -state.velocity_y;
+		if (segment == 2 || segment == 4 || segment >= 5)
+			state.velocity_x = -state.velocity_x;
+	}
+
+	//Get out the ball
+	switch (segment) {
+		case 1: {
+			y = top - ball_radius;
+			break;
+		}
+		case 2: {
+			x = right + ball_radius;
+			break;
+		}
+		case 3: {
+			y = bottom + ball_radius;
+			break;
+		}
+		case 4: {
+			x = left - ball_radius;
+			break;
+		}
+		default: { //To the circle of the corner along the line from its center
+			fx::Fixed corner_x = segment == 5 || segment == 8 ? left : right;
+			fx::Fixed corner_y = segment == 5 || segment == 6 ? top : bottom;
+			fx::Fixed length = fx::sqrt(fx::mul(x - corner_x, x - corner_x) + fx::mul(y - corner_y, y - corner_y));
+			if (length == 0)
+				break;
+			x = corner_x + static_cast<fx::Fixed>(static_cast<std::int64_t>(x - corner_x) * ball_radius / length);
+			y = corner_y + static_cast<fx::Fixed>(static_cast<std::int64_t>(y - corner_y) * ball_radius / length);
+		}
+	}
+	return segment;
+}
+
+sf::Vector2f FixedPhysics::get_ball_pos() const {
+	return { fx::to_float(state.ball_x), fx::to_float(state.ball_y) };
+}
+
+float FixedPhysics::get_ball_direction() {
+	if (state.velocity_x != direction_velocity_x || state.velocity_y != direction_velocity_y) {
+		direction = gm::fast_atan2(fx::to_float(state.velocity_y), fx::to_float(state.velocity_x));
+		direction_velocity_x = state.velocity_x;
+		direction_velocity_y = state.velocity_y;
+	}
+	return direction;
+}
+
+sf::FloatRect FixedPhysics::get_player_rect() const {
+	return { fx::to_float(player_left), fx::to_float(state.player_top),
+			 fx::to_float(player_width), fx::to_float(player_height) };
+}
+
+sf::FloatRect FixedPhysics::get_enemy_rect() const {
+	return { fx::to_float(enemy_left), fx::to_float(state.enemy_top),
+			 fx::to_float(enemy_width), fx::to_float(enemy_height) };
+}
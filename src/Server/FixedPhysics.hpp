@@ -0,0 +1,88 @@
+/*
+ * PongX fixed-point physics
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+
+#include "../fixed_math.hpp"
+
+///State of the fixed-point physics, a part of ServerState
+struct FixedPhysicsState {
+	fx::Fixed ball_x, ball_y;
+	///Movement of the ball per tick. The direction is kept as a vector, so no trigonometry is needed
+	fx::Fixed velocity_x, velocity_y;
+	fx::Fixed player_top, enemy_top;
+};
+
+///What happened during FixedPhysics::move_ball()
+struct FixedBallEvents {
+	///Segment of the paddle the ball touches (see gm::rounded_rect_segment_contains(), 0 - none)
+	unsigned char collision = 0;
+	///Is the touched paddle the player's one?
+	bool player_paddle = false;
+	///Bound the ball bounced off (0 - none, 1 - top, 2 - bottom)
+	unsigned char wall = 0;
+	///Did the ball leave the field behind the enemy?
+	bool player_scored = false;
+	///Did the ball leave the field behind the player?
+	bool enemy_scored = false;
+};
+
+///Ball, paddles and collisions of the server in Q16.16 numbers. The same rules as the float physics of Server,
+///but only integer operations, so the match is bit-exactly the same on every machine (for the lockstep)
+class FixedPhysics {
+public:
+	FixedPhysics(sf::Vector2u window_size, float ball_radius, float ball_speed,
+				 sf::FloatRect player_rect, sf::FloatRect enemy_rect);
+
+	FixedPhysicsState state;
+
+	///Paddles to the start, the ball to the center with a random direction of the first serve
+	void reset(gm::Randomizer& randomizer);
+	///The ball to the center with a random direction after the point
+	void serve(gm::Randomizer& randomizer);
+
+	///Move the paddles by the relative speeds (1 - max down, 0 - static, -1 - max up)
+	void move_paddles(fx::Fixed player_speed, fx::Fixed enemy_speed);
+	///Move the ball, reflect it off the bounds and the paddles
+	///@param collided_before did the ball touch a paddle on the last tick? It is not reflected again then
+	FixedBallEvents move_ball(bool collided_before);
+
+	sf::Vector2f get_ball_pos() const;
+	///Get the direction of the ball in radians (only for the view, it is not exact)
+	float get_ball_direction();
+	sf::FloatRect get_player_rect() const;
+	sf::FloatRect get_enemy_rect() const;
+
+private:
+	fx::Fixed window_width, window_height;
+	fx::Fixed ball_radius, ball_speed;
+	fx::Fixed player_left, player_width, player_height, start_player_top;
+	fx::Fixed enemy_left, enemy_width, enemy_height, start_enemy_top;
+	///The last direction returned by get_ball_direction() and its velocity, it changes only on collisions
+	float direction = 0.0F;
+	fx::Fixed direction_velocity_x = 0, direction_velocity_y = 0;
+
+	///Place the ball to the center and give it a random direction from the ranges of angles
+	void launch(gm::Randomizer& randomizer, const fx::Fixed* min, const fx::Fixed* max, unsigned int count);
+	///Collide the ball with the paddle: reflect and get out the ball
+	///@returns segment of the paddle (0 - no collision)
+	unsigned char collide_paddle(fx::Fixed left, fx::Fixed top, fx::Fixed width, fx::Fixed height,
+								 bool collided_before);
+};
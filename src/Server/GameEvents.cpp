@@ -0,0 +1,90 @@
+/*
+ * PongX stream of the game events
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "GameEvents.hpp"
+
+#include <cstring>
+
+GameEventBus::GameEventBus(std::size_t capacity) {
+	std::size_t size = 1;
+	while (size < capacity)
+		size *= 2;
+	slots.reset(new Slot[size]);
+	mask = size - 1;
+}
+
+void GameEventBus::publish(const GameEvent& event) {
+	std::uint64_t words[3];
+	std::memcpy(words, &event, sizeof(words));
+
+	std::uint64_t number = head.load(std::memory_order_relaxed);
+	Slot& slot = slots[number & mask];
+	//Odd sequence: the subscribers that see it or any of the new words know that the old event is gone
+	slot.sequence.store(2 * number + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	for (unsigned int i = 0; i < 3; i++)
+		slot.words[i].store(words[i], std::memory_order_relaxed);
+	slot.sequence.store(2 * number + 2, std::memory_order_release);
+	head.store(number + 1, std::memory_order_release);
+}
+
+std::uint64_t GameEventBus::get_head() const {
+	return head.load(std::memory_order_acquire);
+}
+
+std::size_t GameEventBus::get_capacity() const {
+	return mask + 1;
+}
+
+GameEventSubscriber::GameEventSubscriber(std::shared_ptr<const GameEventBus> bus) : bus(std::move(bus)) {
+	cursor = this->bus->get_head();
+}
+
+std::size_t GameEventSubscriber::poll(GameEvent* events, std::size_t max_count) {
+	std::size_t count = 0;
+	std::uint64_t head = bus->get_head();
+	while (count < max_count && cursor < head) {
+		//The events behind the ring are overwritten for sure
+		if (head - cursor > bus->mask + 1) {
+			lost += head - cursor - (bus->mask + 1);
+			cursor = head - (bus->mask + 1);
+		}
+
+		const GameEventBus::Slot& slot = bus->slots[cursor & bus->mask];
+		std::uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+		std::uint64_t words[3];
+		for (unsigned int i = 0; i < 3; i++)
+			words[i] = slot.words[i].load(std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		if (sequence != 2 * cursor + 2 || slot.sequence.load(std::memory_order_relaxed) != sequence) {
+			//The server lapped the subscriber while it was reading
+			lost++;
+			cursor++;
+			head = bus->get_head();
+			continue;
+		}
+		std::memcpy(&events[count++], words, sizeof(words));
+		cursor++;
+	}
+	return count;
+}
+
+std::uint64_t GameEventSubscriber::get_lost() const {
+	return lost;
+}
@@ -0,0 +1,102 @@
+/*
+ * PongX stream of the game events
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+enum GameEventType : std::uint8_t {
+	///The ball touched a paddle (a new collision, not the same one on the next tick)
+	PaddleHit,
+	///The ball bounced off the top or bottom bound of the field
+	WallBounce,
+	///Someone got a point
+	Score,
+	///The ball was launched by Server::serve()
+	Serve,
+	///The ball stopped waiting for the input, because a paddle moved
+	Resume
+};
+
+struct GameEvent {
+	///Value of ServerStats::ticks when it happened
+	std::uint64_t tick;
+	///Position of the ball
+	float x, y;
+	GameEventType type;
+	///PaddleHit: segment id (see gm::rounded_rect_segment_contains()). WallBounce: 1 - top, 2 - bottom
+	std::uint8_t detail;
+	///PaddleHit: is it the player's paddle? Score: did the player score?
+	bool player;
+};
+static_assert(std::is_trivially_copyable<GameEvent>::value && sizeof(GameEvent) == 24,
+			  "GameEvent is copied as 3 words");
+
+///Bounded ring of the events of one server. The server (one thread) publishes without locks and allocations:
+///it never waits for the subscribers and overwrites the oldest events. Any amount of subscribers on any threads
+///read the ring through their own GameEventSubscriber, a subscriber that is too slow skips the overwritten events
+class GameEventBus {
+public:
+	///@param capacity amount of the last events kept for the subscribers (rounded up to a power of 2)
+	GameEventBus(std::size_t capacity = 1024);
+
+	///Put the event into the ring. Only one thread publishes
+	void publish(const GameEvent& event);
+	///Get the number of the next published event
+	std::uint64_t get_head() const;
+	std::size_t get_capacity() const;
+
+private:
+	friend class GameEventSubscriber;
+
+	///Event in the ring. The words are atomic, so a subscriber may read them while they are overwritten
+	struct Slot {
+		///2 * number + 1 while the event number is written, 2 * number + 2 after that
+		std::atomic<std::uint64_t> sequence { 0 };
+		std::atomic<std::uint64_t> words[3];
+	};
+
+	std::unique_ptr<Slot[]> slots;
+	std::size_t mask;
+	///Number of the next event. On its own cache line, the subscribers read it all the time
+	alignas(64) std::atomic<std::uint64_t> head { 0 };
+};
+
+///Reader of the events of the bus. Every subscriber has its own position, so it is used by one thread
+class GameEventSubscriber {
+public:
+	///Subscribe to the events published from now on
+	GameEventSubscriber(std::shared_ptr<const GameEventBus> bus);
+
+	///Take the new events in order
+	///@param events the result: the array of max_count events
+	///@returns amount of the taken events (0 if there are no new events)
+	std::size_t poll(GameEvent* events, std::size_t max_count);
+	///Get amount of the events overwritten before this subscriber took them
+	std::uint64_t get_lost() const;
+
+private:
+	std::shared_ptr<const GameEventBus> bus;
+	///Number of the next event to take
+	std::uint64_t cursor;
+	std::uint64_t lost = 0;
+};
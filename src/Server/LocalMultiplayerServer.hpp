@@ -18,16 +18,8 @@
 
 #pragma once
 
-#include "Server.hpp"
+#include "ServerCore.hpp"
 
-class LocalMultiplayerServer : public Server {
-public:
-	LocalMultiplayerServer(sf::Vector2u window_size);
-
-	void update() override;
-
-	///Key which has to be pressed to move the enemy up
-	sf::Keyboard::Key enemy_up_key;
-	///Key which has to be pressed to move the enemy up
-	sf::Keyboard::Key enemy_down_key;
-};
+///Server where the enemy is controlled by the second player on the same keyboard
+template <typename Collision = PaddleCollision, typename Real = float>
+using LocalMultiplayerServer = ServerCore<SharedKeyboardInput, InputOpponent, Collision, Real>;
@@ -0,0 +1,132 @@
+/*
+ * PongX flat versioned snapshot of the match
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MatchSnapshot.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+static constexpr char MAGIC[4] = { 'P', 'X', 'S', 'N' };
+
+///Quantize the coordinate from [-0.5;1.5] of the length
+static std::uint16_t quantize_coordinate(float value, float length) {
+	float fraction = (value / length + 0.5F) * 0.5F;
+	return static_cast<std::uint16_t>(std::lround(std::min(std::max(fraction, 0.0F), 1.0F) * 65535.0F));
+}
+
+static float dequantize_coordinate(std::uint16_t value, float length) {
+	return (static_cast<float>(value) / 65535.0F * 2.0F - 0.5F) * length;
+}
+
+void MatchSnapshot::init_header() {
+	std::memcpy(magic, MAGIC, sizeof(magic));
+	version = VERSION;
+	size = sizeof(MatchSnapshot);
+}
+
+const MatchSnapshot* MatchSnapshot::view(const void* data, std::size_t size) {
+	if (size < sizeof(MatchSnapshot) || reinterpret_cast<std::uintptr_t>(data) % alignof(MatchSnapshot) != 0)
+		return nullptr;
+
+	const MatchSnapshot* snapshot = static_cast<const MatchSnapshot*>(data);
+	if (std::memcmp(snapshot->magic, MAGIC, sizeof(MAGIC)) != 0 || snapshot->version < VERSION ||
+		snapshot->size < sizeof(MatchSnapshot) || snapshot->size > size)
+		return nullptr;
+	return snapshot;
+}
+
+bool MatchSnapshot::read(const void* data, std::size_t size, MatchSnapshot& snapshot) {
+	//The header is copied, because the bytes may be misaligned
+	char header[8];
+	if (size < FIRST_VERSION_SIZE)
+		return false;
+	std::memcpy(header, data, sizeof(header));
+
+	std::uint16_t snapshot_size;
+	std::memcpy(&snapshot_size, header + 6, sizeof(snapshot_size));
+	if (std::memcmp(header, MAGIC, sizeof(MAGIC)) != 0 || snapshot_size < FIRST_VERSION_SIZE ||
+		snapshot_size > size)
+		return false;
+
+	std::size_t known_size = std::min<std::size_t>(snapshot_size, sizeof(MatchSnapshot));
+	std::memset(&snapshot, 0, sizeof(MatchSnapshot));
+	std::memcpy(&snapshot, data, known_size);
+	snapshot.init_header();
+	return true;
+}
+
+sf::Vector2f MatchSnapshot::get_ball_pos() const {
+	return { ball_x, ball_y };
+}
+
+sf::FloatRect MatchSnapshot::get_player_rect() const {
+	return { player_left, player_top, player_width, player_height };
+}
+
+sf::FloatRect MatchSnapshot::get_enemy_rect() const {
+	return { enemy_left, enemy_top, enemy_width, enemy_height };
+}
+
+bool MatchSnapshot::has_flag(MatchSnapshotFlags flag) const {
+	return (flags & flag) != 0;
+}
+
+void QuantizedSnapshot::encode(const MatchSnapshot& snapshot) {
+	float width = static_cast<float>(snapshot.window_width), height = static_cast<float>(snapshot.window_height);
+	constexpr float TURN = 2.0F * 3.14159265359F;
+
+	tick = static_cast<std::uint32_t>(snapshot.tick);
+	ball_x = quantize_coordinate(snapshot.ball_x, width);
+	ball_y = quantize_coordinate(snapshot.ball_y, height);
+	float turns = snapshot.ball_direction / TURN;
+	ball_direction = static_cast<std::uint16_t>(std::lround((turns - std::floor(turns)) * 65536.0F) & 0xFFFF);
+	player_top = quantize_coordinate(snapshot.player_top, height);
+	enemy_top = quantize_coordinate(snapshot.enemy_top, height);
+	player_score = static_cast<std::uint16_t>(std::min(snapshot.player_score, 0xFFFFU));
+	enemy_score = static_cast<std::uint16_t>(std::min(snapshot.enemy_score, 0xFFFFU));
+	player_relative_speed = static_cast<std::int8_t>(std::lround(std::min(std::max(snapshot.player_relative_speed,
+																				   -1.0F), 1.0F) * 127.0F));
+	enemy_relative_speed = static_cast<std::int8_t>(std::lround(std::min(std::max(snapshot.enemy_relative_speed,
+																				  -1.0F), 1.0F) * 127.0F));
+	version_flags = static_cast<std::uint8_t>(VERSION | (snapshot.flags & 0xF) << 4);
+	std::memset(reserved, 0, sizeof(reserved));
+}
+
+bool QuantizedSnapshot::decode(const MatchSnapshot& base, MatchSnapshot& snapshot) const {
+	if ((version_flags & 0xF) != VERSION)
+		return false;
+
+	float width = static_cast<float>(base.window_width), height = static_cast<float>(base.window_height);
+	constexpr float TURN = 2.0F * 3.14159265359F;
+
+	snapshot = base;
+	snapshot.tick = (base.tick & ~0xFFFFFFFFULL) | tick;
+	snapshot.ball_x = dequantize_coordinate(ball_x, width);
+	snapshot.ball_y = dequantize_coordinate(ball_y, height);
+	float direction = static_cast<float>(ball_direction) / 65536.0F * TURN;
+	snapshot.ball_direction = direction > TURN * 0.5F ? direction - TURN : direction;
+	snapshot.player_top = dequantize_coordinate(player_top, height);
+	snapshot.enemy_top = dequantize_coordinate(enemy_top, height);
+	snapshot.player_score = player_score;
+	snapshot.enemy_score = enemy_score;
+	snapshot.player_relative_speed = player_relative_speed / 127.0F;
+	snapshot.enemy_relative_speed = enemy_relative_speed / 127.0F;
+	snapshot.flags = version_flags >> 4;
+	return true;
+}
@@ -0,0 +1,120 @@
+/*
+ * PongX flat versioned snapshot of the match
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include <SFML/Graphics/Rect.hpp>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "Snapshots are stored in the little-endian byte order"
+#endif
+
+///Bits of MatchSnapshot::flags
+enum MatchSnapshotFlags : std::uint32_t {
+	///The ball waits for the input of the player or the enemy
+	SnapshotWaitingForInput = 1,
+	///The match uses the fixed-point physics
+	SnapshotFixedPhysics = 2,
+	///The match is in the chaos mode, the ball is the first of the balls
+	SnapshotMultiBall = 4
+};
+
+///Everything the consumers of the match (the view, the recorders, the observers) read from the server, in one
+///flat struct. The layout is fixed: fields of exact sizes, little-endian, no implicit padding. So the snapshot is
+///written straight into a send buffer or a mapped file and read in place, without parsing.
+///New versions only append fields and increase the size. A newer snapshot is read in place by older code
+///(it knows only the prefix), an older one is copied by read() with the missing fields set to zero
+struct MatchSnapshot {
+	//BEGIN Header
+	///"PXSN"
+	char magic[4];
+	std::uint16_t version;
+	///Size of the snapshot in bytes, including the header
+	std::uint16_t size;
+	//END Header
+
+	///Amount of updates with the moving ball since the start of the match
+	std::uint64_t tick;
+	std::uint32_t window_width, window_height;
+	float ball_x, ball_y;
+	///Direction of the ball in radians
+	float ball_direction;
+	float ball_radius;
+	float player_left, player_top, player_width, player_height;
+	float enemy_left, enemy_top, enemy_width, enemy_height;
+	///Relative speeds of the paddles (1 - max down, 0 - static, -1 - max up)
+	float player_relative_speed, enemy_relative_speed;
+	std::uint32_t player_score, enemy_score;
+	///MatchSnapshotFlags
+	std::uint32_t flags;
+	std::uint32_t reserved;
+
+	static constexpr std::uint16_t VERSION = 1;
+	///Size of the first version, older snapshots do not exist
+	static constexpr std::size_t FIRST_VERSION_SIZE = 96;
+
+	///Fill the header of the current version
+	void init_header();
+
+	///Use the bytes as a snapshot without copying
+	///@returns nullptr if the bytes are not a snapshot of this or a newer version or they are misaligned
+	static const MatchSnapshot* view(const void* data, std::size_t size);
+	///Copy a snapshot of any version to the current layout, the fields unknown to the version are zero
+	///@param snapshot the result (reference)
+	///@returns false if the bytes are not a snapshot
+	static bool read(const void* data, std::size_t size, MatchSnapshot& snapshot);
+
+	sf::Vector2f get_ball_pos() const;
+	sf::FloatRect get_player_rect() const;
+	sf::FloatRect get_enemy_rect() const;
+	bool has_flag(MatchSnapshotFlags flag) const;
+};
+static_assert(std::is_trivially_copyable<MatchSnapshot>::value && std::is_standard_layout<MatchSnapshot>::value,
+			  "MatchSnapshot is copied as bytes");
+static_assert(sizeof(MatchSnapshot) == MatchSnapshot::FIRST_VERSION_SIZE, "Layout of the version 1 is fixed");
+
+///MatchSnapshot in 24 bytes for the network. The sizes of the field, the paddles and the ball do not change
+///during the match, so they are not sent: decode() takes them from a full snapshot of the same match.
+///Coordinates are 16-bit fractions of [-0.5;1.5] of the field (0.025 pixels for the field of 800 pixels),
+///the direction is a 16-bit fraction of the turn, the speeds are 8-bit
+struct QuantizedSnapshot {
+	///Low 32 bits of MatchSnapshot::tick
+	std::uint32_t tick;
+	std::uint16_t ball_x, ball_y;
+	std::uint16_t ball_direction;
+	std::uint16_t player_top, enemy_top;
+	std::uint16_t player_score, enemy_score;
+	std::int8_t player_relative_speed, enemy_relative_speed;
+	///Version of the encoding in the low 4 bits, MatchSnapshotFlags in the high 4 bits
+	std::uint8_t version_flags;
+	std::uint8_t reserved[3];
+
+	static constexpr std::uint8_t VERSION = 1;
+
+	void encode(const MatchSnapshot& snapshot);
+	///@param base a full snapshot of the same match for the constant fields
+	///@param snapshot the result (reference)
+	///@returns false if the encoding is of another version
+	bool decode(const MatchSnapshot& base, MatchSnapshot& snapshot) const;
+};
+static_assert(std::is_trivially_copyable<QuantizedSnapshot>::value && sizeof(QuantizedSnapshot) == 24,
+			  "Layout of QuantizedSnapshot is fixed");
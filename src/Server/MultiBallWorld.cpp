@@ -0,0 +1,324 @@
+/*
+ * PongX multi-ball world
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "../fast_trig.hpp"
+#include "MultiBallWorld.hpp"
+
+///PI constant
+constexpr float PI = 3.14159265359F;
+///If multiply this constant by an angle in degrees, result is in radians
+constexpr float DEG2RAD = PI / 180.0F;
+
+MultiBallWorld::MultiBallWorld(sf::Vector2u window_size, unsigned int ball_count, float ball_radius,
+							   float ball_speed, unsigned int seed) {
+	this->window_size = window_size;
+	this->ball_radius = ball_radius;
+	this->ball_speed = ball_speed;
+
+	x.resize(ball_count);
+	y.resize(ball_count);
+	velocity_x.resize(ball_count);
+	velocity_y.resize(ball_count);
+
+	//Grid over the field. Balls outside it are clamped into the border cells
+	cell_size = std::max(2.0F * ball_radius, 1.0F);
+	columns = static_cast<unsigned int>(std::ceil(window_size.x / cell_size)) + 1;
+	rows = static_cast<unsigned int>(std::ceil(window_size.y / cell_size)) + 1;
+	ball_cells.resize(ball_count);
+	cell_starts.resize(columns * rows + 1);
+	sorted_balls.resize(ball_count);
+
+	reset(seed);
+}
+
+void MultiBallWorld::reset(unsigned int seed) {
+	randomizer.seed(seed);
+	for (std::size_t i = 0; i < size(); i++)
+		respawn(i);
+}
+
+std::size_t MultiBallWorld::size() const {
+	return x.size();
+}
+
+float MultiBallWorld::get_ball_radius() const {
+	return ball_radius;
+}
+
+sf::Vector2f MultiBallWorld::get_position(std::size_t ball) const {
+	return { x[ball], y[ball] };
+}
+
+sf::Vector2f MultiBallWorld::get_velocity(std::size_t ball) const {
+	return { velocity_x[ball], velocity_y[ball] };
+}
+
+void MultiBallWorld::set_velocity(std::size_t ball, sf::Vector2f velocity) {
+	velocity_x[ball] = velocity.x;
+	velocity_y[ball] = velocity.y;
+}
+
+void MultiBallWorld::set_position(std::size_t ball, sf::Vector2f position) {
+	x[ball] = position.x;
+	y[ball] = position.y;
+}
+
+unsigned int MultiBallWorld::get_last_contacts() const {
+	return last_contacts;
+}
+
+void MultiBallWorld::respawn(std::size_t ball) {
+	//Somewhere in the middle part of the field, so the ball does not score at once
+	x[ball] = gm::random_number(randomizer, window_size.x * 0.25F, window_size.x * 0.75F);
+	y[ball] = gm::random_number(randomizer, ball_radius, std::max(window_size.y - ball_radius, ball_radius + 1.0F));
+
+	//The same directions as the serve of the server: not too vertical
+	float direction = gm::random_number_triple_range(randomizer, 0.0F * DEG2RAD, 75.0F * DEG2RAD,
+													 115.0F * DEG2RAD, 255.0F * DEG2RAD,
+													 295.0F * DEG2RAD, 360.0F * DEG2RAD);
+	float direction_sin, direction_cos;
+	gm::fast_sin_cos(direction, direction_sin, direction_cos);
+	velocity_x[ball] = direction_cos * ball_speed;
+	velocity_y[ball] = direction_sin * ball_speed;
+}
+
+void MultiBallWorld::update(sf::FloatRect player_rect, sf::FloatRect enemy_rect,
+							unsigned int& player_points, unsigned int& enemy_points) {
+	player_points = enemy_points = 0;
+	move_balls(player_points, enemy_points);
+	build_grid();
+	collide_balls();
+	collide_paddle(player_rect);
+	collide_paddle(enemy_rect);
+}
+
+void MultiBallWorld::move_balls(unsigned int& player_points, unsigned int& enemy_points) {
+	const float top = ball_radius, bottom = window_size.y - ball_radius;
+	for (std::size_t i = 0; i < size(); i++) {
+		x[i] += velocity_x[i];
+		y[i] += velocity_y[i];
+
+		//Mirror the part of the path behind the bound (like Server::update_ball_movement)
+		if (y[i] < top && velocity_y[i] < 0.0F) {
+			y[i] = 2.0F * top - y[i];
+			velocity_y[i] = -velocity_y[i];
+		} else if (y[i] > bottom && velocity_y[i] > 0.0F) {
+			y[i] = 2.0F * bottom - y[i];
+			velocity_y[i] = -velocity_y[i];
+		}
+
+		//Left the field: a point, and the ball starts again
+		if (x[i] + ball_radius < 0.0F) {
+			enemy_points++;
+			respawn(i);
+		} else if (x[i] - ball_radius > window_size.x) {
+			player_points++;
+			respawn(i);
+		}
+	}
+}
+
+unsigned int MultiBallWorld::cell_of(float ball_x, float ball_y) const {
+	int column = std::clamp(static_cast<int>(ball_x / cell_size), 0, static_cast<int>(columns) - 1);
+	int row = std::clamp(static_cast<int>(ball_y / cell_size), 0, static_cast<int>(rows) - 1);
+	return row * columns + column;
+}
+
+void MultiBallWorld::build_grid() {
+	//Counting sort: count the balls of every cell, compute where every cell starts, then place the balls
+	std::fill(cell_starts.begin(), cell_starts.end(), 0);
+	for (std::size_t i = 0; i < size(); i++) {
+		ball_cells[i] = cell_of(x[i], y[i]);
+		cell_starts[ball_cells[i] + 1]++;
+	}
+	for (std::size_t cell = 1; cell < cell_starts.size(); cell++)
+		cell_starts[cell] += cell_starts[cell - 1];
+
+	//cell_starts[cell] is used as the insertion point and ends up at the start of the next cell,
+	//so it is shifted back afterwards
+	for (std::size_t i = 0; i < size(); i++)
+		sorted_balls[cell_starts[ball_cells[i]]++] = static_cast<unsigned int>(i);
+	for (std::size_t cell = cell_starts.size() - 1; cell > 0; cell--)
+		cell_starts[cell] = cell_starts[cell - 1];
+	cell_starts[0] = 0;
+}
+
+bool MultiBallWorld::touching(unsigned int ball_1, unsigned int ball_2, sf::Vector2f& normal,
+							  float& distance) const {
+	float delta_x = x[ball_2] - x[ball_1];
+	float delta_y = y[ball_2] - y[ball_1];
+	float distance_squared = delta_x * delta_x + delta_y * delta_y;
+	float diameter = 2.0F * ball_radius;
+	if (distance_squared >= diameter * diameter || distance_squared == 0.0F)
+		return false;
+
+	distance = std::sqrt(distance_squared);
+	normal = { delta_x / distance, delta_y / distance };
+	return true;
+}
+
+bool MultiBallWorld::collide_pair(unsigned int ball_1, unsigned int ball_2) {
+	sf::Vector2f normal;
+	float distance;
+	if (!touching(ball_1, ball_2, normal, distance))
+		return false;
+
+	//Equal masses: the balls exchange the normal parts of their velocities, if they approach
+	float approach = (velocity_x[ball_1] - velocity_x[ball_2]) * normal.x +
+		(velocity_y[ball_1] - velocity_y[ball_2]) * normal.y;
+	if (approach > 0.0F) {
+		velocity_x[ball_1] -= approach * normal.x;
+		velocity_y[ball_1] -= approach * normal.y;
+		velocity_x[ball_2] += approach * normal.x;
+		velocity_y[ball_2] += approach * normal.y;
+	}
+
+	//Push them apart, so they do not stick
+	float push = (2.0F * ball_radius - distance) * 0.5F;
+	x[ball_1] -= normal.x * push;
+	y[ball_1] -= normal.y * push;
+	x[ball_2] += normal.x * push;
+	y[ball_2] += normal.y * push;
+	return true;
+}
+
+template <typename Function>
+void MultiBallWorld::for_each_close_pair(Function function) {
+	//Every pair of cells is visited once: the cell itself and the 4 "forward" neighbours
+	//  +---+---+---+
+	//  |   | * | 1 |
+	//  +---+---+---+
+	//  | 2 | 3 | 4 |
+	//  +---+---+---+
+	const int neighbours[4][2] = { { 1, 0 }, { -1, 1 }, { 0, 1 }, { 1, 1 } };
+
+	for (unsigned int row = 0; row < rows; row++) {
+		for (unsigned int column = 0; column < columns; column++) {
+			unsigned int cell = row * columns + column;
+			unsigned int begin = cell_starts[cell], end = cell_starts[cell + 1];
+			if (begin == end)
+				continue;
+
+			//Inside the cell
+			for (unsigned int i = begin; i < end; i++) {
+				for (unsigned int j = i + 1; j < end; j++)
+					function(sorted_balls[i], sorted_balls[j]);
+			}
+
+			//With the neighbours
+			for (const int* offset : neighbours) {
+				int neighbour_column = static_cast<int>(column) + offset[0];
+				unsigned int neighbour_row = row + offset[1];
+				if (neighbour_column < 0 || neighbour_column >= static_cast<int>(columns) || neighbour_row >= rows)
+					continue;
+
+				unsigned int neighbour = neighbour_row * columns + neighbour_column;
+				for (unsigned int i = begin; i < end; i++) {
+					for (unsigned int j = cell_starts[neighbour]; j < cell_starts[neighbour + 1]; j++)
+						function(sorted_balls[i], sorted_balls[j]);
+				}
+			}
+		}
+	}
+}
+
+void MultiBallWorld::collide_balls() {
+	last_contacts = 0;
+	for_each_close_pair([this](unsigned int ball_1, unsigned int ball_2) {
+		last_contacts += collide_pair(ball_1, ball_2);
+	});
+}
+
+unsigned int MultiBallWorld::count_contacts() {
+	build_grid();
+
+	unsigned int contacts = 0;
+	for_each_close_pair([this, &contacts](unsigned int ball_1, unsigned int ball_2) {
+		sf::Vector2f normal;
+		float distance;
+		contacts += touching(ball_1, ball_2, normal, distance);
+	});
+	return contacts;
+}
+
+void MultiBallWorld::collide_paddle(sf::FloatRect rect) {
+	//Only the cells under the paddle grown by the ball radius
+	unsigned int first_cell = cell_of(rect.left - ball_radius, rect.top - ball_radius);
+	unsigned int last_cell = cell_of(rect.left + rect.width + ball_radius, rect.top + rect.height + ball_radius);
+	unsigned int first_column = first_cell % columns, last_column = last_cell % columns;
+	unsigned int first_row = first_cell / columns, last_row = last_cell / columns;
+
+	for (unsigned int row = first_row; row <= last_row; row++) {
+		for (unsigned int column = first_column; column <= last_column; column++) {
+			unsigned int cell = row * columns + column;
+			for (unsigned int k = cell_starts[cell]; k < cell_starts[cell + 1]; k++) {
+				unsigned int i = sorted_balls[k];
+				sf::Vector2f position(x[i], y[i]);
+
+				//The same "rounded rect - point" model as the server uses
+				unsigned char segment = gm::rounded_rect_segment_contains(rect, ball_radius, position);
+				switch (segment) {
+					case 1: { //Top side
+						velocity_y[i] = -std::abs(velocity_y[i]);
+						y[i] = rect.top - ball_radius;
+						break;
+					}
+					case 2: { //Right side
+						velocity_x[i] = std::abs(velocity_x[i]);
+						x[i] = rect.left + rect.width + ball_radius;
+						break;
+					}
+					case 3: { //Bottom side
+						velocity_y[i] = std::abs(velocity_y[i]);
+						y[i] = rect.top + rect.height + ball_radius;
+						break;
+					}
+					case 4: { //Left side
+						velocity_x[i] = -std::abs(velocity_x[i]);
+						x[i] = rect.left - ball_radius;
+						break;
+					}
+					case 5:
+					case 6:
+					case 7:
+					case 8: { //Rounded corners: reflect off the tangent of the corner circle
+						sf::Vector2f corner(segment == 5 || segment == 8 ? rect.left : rect.left + rect.width,
+											segment == 5 || segment == 6 ? rect.top : rect.top + rect.height);
+						sf::Vector2f normal = position - corner;
+						float length = std::hypot(normal.x, normal.y);
+						if (length == 0.0F)
+							break;
+						normal /= length;
+
+						float into = velocity_x[i] * normal.x + velocity_y[i] * normal.y;
+						if (into < 0.0F) {
+							velocity_x[i] -= 2.0F * into * normal.x;
+							velocity_y[i] -= 2.0F * into * normal.y;
+						}
+						x[i] = corner.x + normal.x * ball_radius;
+						y[i] = corner.y + normal.y * ball_radius;
+						break;
+					}
+				}
+			}
+		}
+	}
+}
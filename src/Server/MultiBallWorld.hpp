@@ -0,0 +1,105 @@
+/*
+ * PongX multi-ball world
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <SFML/Graphics/Rect.hpp>
+
+#include "../game_math.hpp"
+
+///Many balls of the chaos mode: they bounce off the walls, the paddles and each other.
+///Balls are stored as arrays of coordinates (not as array of structures) and are sorted into
+///a uniform grid every tick by the counting sort, so only the balls in neighbouring cells are
+///tested against each other
+class MultiBallWorld {
+public:
+	///@param ball_speed pixels per tick
+	///@param seed seed of the start positions and directions
+	MultiBallWorld(sf::Vector2u window_size, unsigned int ball_count, float ball_radius, float ball_speed,
+				   unsigned int seed);
+
+	///Place every ball again
+	void reset(unsigned int seed);
+
+	///Move the balls one tick
+	///@param player_points the result: amount of balls that left the field behind the enemy (reference)
+	///@param enemy_points the result: amount of balls that left the field behind the player (reference)
+	void update(sf::FloatRect player_rect, sf::FloatRect enemy_rect,
+				unsigned int& player_points, unsigned int& enemy_points);
+
+	std::size_t size() const;
+	float get_ball_radius() const;
+	sf::Vector2f get_position(std::size_t ball) const;
+	sf::Vector2f get_velocity(std::size_t ball) const;
+	///Set the velocity of the ball (in pixels per tick)
+	void set_velocity(std::size_t ball, sf::Vector2f velocity);
+	///Place the ball
+	void set_position(std::size_t ball, sf::Vector2f position);
+
+	///Get amount of ball-ball collisions on the last tick
+	unsigned int get_last_contacts() const;
+	///Count the pairs of touching balls now, without resolving them
+	unsigned int count_contacts();
+
+private:
+	sf::Vector2u window_size;
+	float ball_radius, ball_speed;
+	gm::Randomizer randomizer;
+
+	//BEGIN Balls
+	std::vector<float> x, y;
+	std::vector<float> velocity_x, velocity_y;
+	//END Balls
+
+	//BEGIN Grid
+	///Side of a cell. Not less than the diameter of a ball, so colliding balls are in neighbouring cells
+	float cell_size;
+	unsigned int columns, rows;
+	///Cell of every ball
+	std::vector<unsigned int> ball_cells;
+	///Index of the first ball of every cell in sorted_balls (one more for the end of the last cell)
+	std::vector<unsigned int> cell_starts;
+	///Indices of the balls sorted by cell
+	std::vector<unsigned int> sorted_balls;
+	//END Grid
+
+	unsigned int last_contacts = 0;
+
+	///Place the ball into the middle of the field and give it a random direction
+	void respawn(std::size_t ball);
+	///Move the balls and reflect them off the top and bottom bounds, count the balls that left the field
+	void move_balls(unsigned int& player_points, unsigned int& enemy_points);
+	///Sort the balls into the grid
+	void build_grid();
+	unsigned int cell_of(float ball_x, float ball_y) const;
+	///Call the function for every pair of balls in the same or neighbouring cells
+	template <typename Function>
+	void for_each_close_pair(Function function);
+	///Collide every pair of touching balls
+	void collide_balls();
+	///Collide the balls in the cells under the paddle with it
+	void collide_paddle(sf::FloatRect rect);
+	///Are the balls touching?
+	///@param normal the result: direction from the first ball to the second (reference)
+	///@param distance the result: distance between the centers (reference)
+	bool touching(unsigned int ball_1, unsigned int ball_2, sf::Vector2f& normal, float& distance) const;
+	///Elastic collision of two balls of equal mass
+	bool collide_pair(unsigned int ball_1, unsigned int ball_2);
+};
@@ -0,0 +1,104 @@
+/*
+ * PongX paddle AI
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "PaddleAI.hpp"
+
+///Maximal speed of the paddle in pixels per tick (see Server::update_player_movement)
+constexpr float PADDLE_SPEED = 10.0F;
+///The paddle does not move if it is closer to the target (so it does not shake)
+constexpr float DEAD_ZONE = 2.0F;
+
+PaddleAI::PaddleAI(unsigned int seed) : randomizer(seed) {
+
+}
+
+void PaddleAI::set_difficulty(unsigned int reaction_delay, float max_error) {
+	this->reaction_delay = reaction_delay;
+	this->max_error = max_error;
+}
+
+void PaddleAI::reset() {
+	has_prediction = false;
+	reaction_ticks_left = 0;
+}
+
+void PaddleAI::seed(unsigned int seed) {
+	randomizer.seed(seed);
+}
+
+bool PaddleAI::predict_intercept(sf::Vector2f ball_pos, float ball_direction, float ball_radius,
+								 sf::Vector2u window_size, float target_x, float& intercept) {
+	//Only the place matters, so the speed is any positive number
+	gm::BallPath path;
+	if (!gm::predict_ball_path(ball_pos, ball_direction, 1.0F, ball_radius, window_size, target_x, path))
+		return false;
+
+	intercept = path.intercept.y;
+	return true;
+}
+
+void PaddleAI::predict(sf::FloatRect paddle, sf::Vector2f ball_pos, float ball_direction, float ball_radius,
+					   sf::Vector2u window_size) {
+	//A wall bounce keeps the horizontal direction and the predicted point (except float error),
+	//so the AI reacts and makes a new mistake only when the ball is hit or served
+	bool new_rally = !has_prediction ||
+		(std::cos(ball_direction) > 0.0F) != (std::cos(predicted_direction) > 0.0F);
+	if (new_rally) {
+		error = max_error > 0.0F ? gm::random_number(randomizer, -max_error, max_error) : 0.0F;
+		reaction_ticks_left = reaction_delay;
+	}
+
+	//The ball hits the side of the paddle that faces the center of the field
+	float paddle_center_x = paddle.left + paddle.width * 0.5F;
+	float target_x = paddle_center_x > window_size.x * 0.5F ?
+		paddle.left - ball_radius : paddle.left + paddle.width + ball_radius;
+
+	float intercept;
+	if (predict_intercept(ball_pos, ball_direction, ball_radius, window_size, target_x, intercept))
+		pending_target_y = intercept + error; //Error injection
+	else
+		pending_target_y = window_size.y * 0.5F; //The ball moves away, return to the center
+
+	predicted_direction = ball_direction;
+	has_prediction = true;
+}
+
+float PaddleAI::update(sf::FloatRect paddle, sf::Vector2f ball_pos, float ball_direction, float ball_radius,
+					   sf::Vector2u window_size) {
+	//Predict again only if the direction changed (bounce, collision or serve)
+	if (!has_prediction)
+		target_y = paddle.top + paddle.height * 0.5F; //Stay until the reaction
+	if (!has_prediction || ball_direction != predicted_direction)
+		predict(paddle, ball_pos, ball_direction, ball_radius, window_size);
+
+	//React after the delay
+	if (reaction_ticks_left == 0)
+		target_y = pending_target_y;
+	else
+		reaction_ticks_left--;
+
+	//Proportional speed, so the paddle stops exactly at the target
+	float distance = target_y - (paddle.top + paddle.height * 0.5F);
+	if (std::abs(distance) < DEAD_ZONE)
+		return 0.0F;
+
+	return std::clamp(distance / PADDLE_SPEED, -1.0F, 1.0F);
+}
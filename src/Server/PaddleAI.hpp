@@ -0,0 +1,86 @@
+/*
+ * PongX paddle AI
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+
+#include "../game_math.hpp"
+
+///Controls a paddle: predicts where the ball will cross the paddle and moves there.
+///The prediction is analytic and is recomputed only when the direction of the ball changes,
+///so one AI costs a few comparisons per tick. It has no shared state, every server owns its AI
+class PaddleAI {
+public:
+	///@param seed seed of the error injection (same seed - same game)
+	PaddleAI(unsigned int seed);
+
+	///Set the difficulty
+	///@param reaction_delay ticks between the change of the ball direction and the reaction to it
+	///@param max_error maximal error of the predicted intercept point in pixels
+	void set_difficulty(unsigned int reaction_delay, float max_error);
+
+	///Compute the speed of the paddle for the next tick
+	///@param paddle current rect of the controlled paddle
+	///@param ball_pos current position of the ball
+	///@param ball_direction current direction of the ball in radians
+	///@param ball_radius radius of the ball
+	///@param window_size size of the field
+	///@returns speed of the paddle relative to max (1 - max down, 0 - static, -1 - max up)
+	float update(sf::FloatRect paddle, sf::Vector2f ball_pos, float ball_direction, float ball_radius,
+				 sf::Vector2u window_size);
+
+	///Forget the prediction (e.g. when the ball is served again)
+	void reset();
+
+	///Restart the sequence of mistakes
+	void seed(unsigned int seed);
+
+	///Compute where the center of the ball will cross the vertical line x = target_x,
+	///considering reflections off the top and bottom bounds of the field (see gm::predict_ball_path())
+	///@param intercept the result: Y coordinate of the center of the ball (reference)
+	///@returns false if the ball moves away from the line
+	static bool predict_intercept(sf::Vector2f ball_pos, float ball_direction, float ball_radius,
+								  sf::Vector2u window_size, float target_x, float& intercept);
+
+private:
+	///Small and cheap generator, there may be thousands of AIs at once
+	gm::Randomizer randomizer;
+
+	unsigned int reaction_delay = 0;
+	float max_error = 0.0F;
+
+	///Direction of the ball for which the prediction was made
+	float predicted_direction;
+	///Is there a prediction?
+	bool has_prediction = false;
+	///Ticks left until the AI reacts to the new prediction
+	unsigned int reaction_ticks_left = 0;
+	///Error of the prediction in the current rally
+	float error = 0.0F;
+
+	///Y coordinate where the center of the paddle goes now
+	float target_y = 0.0F;
+	///Y coordinate where the center of the paddle will go after the reaction delay
+	float pending_target_y;
+
+	///Make a new prediction for the current ball. New error and reaction delay are taken
+	///only when the ball turns to the other side
+	void predict(sf::FloatRect paddle, sf::Vector2f ball_pos, float ball_direction, float ball_radius,
+				 sf::Vector2u window_size);
+};
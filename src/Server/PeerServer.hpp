@@ -0,0 +1,27 @@
+/*
+ * PongX peer-to-peer server
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "ServerCore.hpp"
+
+///Server of the peer-to-peer game. Both peers simulate the same match, the player's paddle is controlled
+///by the host and the enemy's paddle by the client. The inputs come from RollbackSession
+///(see Server::set_enemy_relative_speed())
+template <typename Collision = PaddleCollision, typename Real = float>
+using PeerServer = ServerCore<PlayerOnlyInput, InputOpponent, Collision, Real>;
@@ -16,47 +16,253 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cassert>
+#include <cstring>
+#include <optional>
+
 #include "LocalMultiplayerServer.hpp"
+#include "PeerServer.hpp"
+#include "SingleplayerServer.hpp"
+#include "../fast_trig.hpp"
+#include "../fixed_math.hpp"
 #include "../game_math.hpp"
+#include "../Utils/Metrics.hpp"
 #include "Server.hpp"
+#include "ServerPolicies.hpp"
 
 ///PI constant
 constexpr float PI = 3.14159265359F;
 ///If multiply this constant by an angle in degrees, result is in radians
 constexpr float DEG2RAD = PI / 180.0F;
 
-Server::Server(sf::Vector2u window_size) {
+static MetricCounter ticks_metric("pongx_ticks_total", "Updates of the servers with the moving ball");
+static MetricHistogram ball_update_metric("pongx_ball_update_seconds",
+										  "Time of the update of the single ball (every 64th update is measured)",
+										  { 50, 100, 200, 400, 800, 1600, 3200, 6400, 12800 }, 1e-9);
+static MetricCounter collision_metrics[8] = {
+	{ "pongx_paddle_collisions_total", "New collisions with the paddles by segment id", "segment=\"1\"" },
+	{ "pongx_paddle_collisions_total", "New collisions with the paddles by segment id", "segment=\"2\"" },
+	{ "pongx_paddle_collisions_total", "New collisions with the paddles by segment id", "segment=\"3\"" },
+	{ "pongx_paddle_collisions_total", "New collisions with the paddles by segment id", "segment=\"4\"" },
+	{ "pongx_paddle_collisions_total", "New collisions with the paddles by segment id", "segment=\"5\"" },
+	{ "pongx_paddle_collisions_total", "New collisions with the paddles by segment id", "segment=\"6\"" },
+	{ "pongx_paddle_collisions_total", "New collisions with the paddles by segment id", "segment=\"7\"" },
+	{ "pongx_paddle_collisions_total", "New collisions with the paddles by segment id", "segment=\"8\"" }
+};
+static MetricCounter tunneling_metric("pongx_tunneling_events_total",
+									  "Times the ball passed through a paddle between two updates");
+
+Server::Server(sf::Vector2u window_size) : randomizer(std::random_device()()) {
 	//Initialize some parameters
 	this->window_size = window_size;
 	ball_pos = { window_size.x * 0.5F, window_size.y * 0.5F }; //Place the ball to the center of the window
 	//ball_direction = gm::random_number_double_range(0.0F * DEG2RAD, 75.0F * DEG2RAD, //Random direction
 	//												100.0F * DEG2RAD, 260.0F * DEG2RAD);
-	ball_direction = gm::random_number_triple_range(0.0F * DEG2RAD, 75.0F * DEG2RAD,
-													115.0F * DEG2RAD, 255.0F * DEG2RAD,
-													295.0F * DEG2RAD, 360.0F * DEG2RAD);
+	ball_direction = random_serve_direction();
 }
 
-Server* Server::create(ServerSettings settings) {
+///Create the server of the type of the game with the numbers and the collision model of its physics
+template <typename Real, typename Collision>
+static Server* create_core(const ServerSettings& settings) {
 	switch (settings.server_type) {
 		case LocalMultiplayer: {
-			LocalMultiplayerServer* cur_server =
-				new LocalMultiplayerServer(settings.window_size); //Construct a new server
-
-			///Set settings
-			cur_server->server_type = LocalMultiplayer;
-			cur_server->ball_radius = settings.ball_radius;
-			cur_server->ball_speed = settings.ball_speed;
-			cur_server->player_rect = settings.player_rect;
-			cur_server->enemy_rect = settings.enemy_rect;
-			cur_server->enemy_up_key = settings.enemy_up_key;
-			cur_server->enemy_down_key = settings.enemy_down_key;
-
-			return cur_server;
+			return new LocalMultiplayerServer<Collision, Real>(settings);
+		}
+		case Singleplayer: {
+			return new SingleplayerServer<Collision, Real>(settings);
 		}
-		default: {
-			return nullptr; //TODO other types
+		case LocalNetworkHost:
+		case LocalNetworkClient: { //The same match on both peers
+			return new PeerServer<Collision, Real>(settings);
+		}
+	}
+	assert(false && "Every GameType is handled above");
+	return nullptr;
+}
+
+Server* Server::create(ServerSettings settings) {
+	//The chaos mode and the obstacles are float only
+	if (settings.physics == FixedPointPhysics)
+		return create_core<fx::Fixed, PaddleCollision>(settings);
+	if (settings.chaos_balls != 0)
+		return create_core<float, MultiBallCollision>(settings);
+	if (settings.arena)
+		return create_core<float, ArenaCollision>(settings);
+	return create_core<float, PaddleCollision>(settings);
+}
+
+unsigned int Server::apply_settings(const ServerSettings& settings) {
+	unsigned int seed = settings.seed != 0 ? settings.seed : std::random_device()();
+
+	ball_radius = settings.ball_radius;
+	ball_speed = settings.ball_speed;
+	start_player_rect = settings.player_rect;
+	start_enemy_rect = settings.enemy_rect;
+	arena = settings.arena;
+	if (settings.physics == FixedPointPhysics) {
+		fixed_physics.reset(new FixedPhysics(settings.window_size, settings.ball_radius, settings.ball_speed,
+											 settings.player_rect, settings.enemy_rect));
+	} else if (settings.chaos_balls != 0) {
+		multi_ball.reset(new MultiBallWorld(settings.window_size, settings.chaos_balls, settings.ball_radius,
+											settings.ball_speed, seed));
+	}
+	return seed;
+}
+
+void Server::reset(unsigned int seed) {
+	randomizer.seed(seed);
+
+	player_score = enemy_score = 0;
+	player_rect = start_player_rect;
+	enemy_rect = start_enemy_rect;
+	player_relative_speed = enemy_relative_speed = 0.0F;
+
+	if (fixed_physics) {
+		fixed_physics->reset(randomizer);
+		update_fixed_physics_view();
+	} else {
+		ball_pos = { window_size.x * 0.5F, window_size.y * 0.5F }; //Place the ball to the center of the window
+		ball_direction = random_serve_direction();
+	}
+	waiting_for_input = true; //Suspend
+	collided_before = false;
+	stats = ServerStats();
+
+	if (multi_ball) {
+		multi_ball->reset(seed);
+		update_multi_ball_view();
+	}
+}
+
+void Server::save_state(ServerState& state) const {
+	state.ball_pos = ball_pos;
+	state.ball_direction = ball_direction;
+	state.player_rect = player_rect;
+	state.enemy_rect = enemy_rect;
+	state.player_relative_speed = player_relative_speed;
+	state.enemy_relative_speed = enemy_relative_speed;
+	state.player_score = player_score;
+	state.enemy_score = enemy_score;
+	state.waiting_for_input = waiting_for_input;
+	state.collided_before = collided_before;
+	state.randomizer = randomizer;
+	state.stats = stats;
+	if (fixed_physics)
+		state.fixed = fixed_physics->state;
+}
+
+void Server::load_state(const ServerState& state) {
+	ball_pos = state.ball_pos;
+	ball_direction = state.ball_direction;
+	player_rect = state.player_rect;
+	enemy_rect = state.enemy_rect;
+	player_relative_speed = state.player_relative_speed;
+	enemy_relative_speed = state.enemy_relative_speed;
+	player_score = state.player_score;
+	enemy_score = state.enemy_score;
+	waiting_for_input = state.waiting_for_input;
+	collided_before = state.collided_before;
+	randomizer = state.randomizer;
+	stats = state.stats;
+	if (fixed_physics) {
+		fixed_physics->state = state.fixed;
+		update_fixed_physics_view();
+	}
+}
+
+std::uint64_t Server::state_hash() {
+	//FNV-1a of the numbers of the state, floats by their bits
+	std::uint64_t hash = 14695981039346656037ULL;
+	auto add = [&hash](std::uint32_t value) {
+		for (unsigned int i = 0; i < 4; i++) {
+			hash ^= (value >> (i * 8)) & 0xFF;
+			hash *= 1099511628211ULL;
 		}
+	};
+	auto add_float = [&add](float value) {
+		std::uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		add(bits);
+	};
+
+	if (fixed_physics) {
+		const FixedPhysicsState& fixed = fixed_physics->state;
+		for (fx::Fixed value : { fixed.ball_x, fixed.ball_y, fixed.velocity_x, fixed.velocity_y,
+								 fixed.player_top, fixed.enemy_top })
+			add(static_cast<std::uint32_t>(value));
+	} else {
+		for (float value : { ball_pos.x, ball_pos.y, ball_direction, player_rect.top, enemy_rect.top })
+			add_float(value);
 	}
+	add(player_score);
+	add(enemy_score);
+	add(waiting_for_input);
+	add(collided_before);
+	return hash;
+}
+
+void Server::set_enemy_relative_speed(float speed) {
+	enemy_relative_speed = speed;
+}
+
+void Server::serve() {
+	waiting_for_input = false;
+	publish_event(Serve);
+}
+
+void Server::write_snapshot(MatchSnapshot& snapshot) const {
+	snapshot.init_header();
+	snapshot.tick = stats.ticks;
+	snapshot.window_width = window_size.x;
+	snapshot.window_height = window_size.y;
+	snapshot.ball_x = ball_pos.x;
+	snapshot.ball_y = ball_pos.y;
+	snapshot.ball_direction = ball_direction;
+	snapshot.ball_radius = ball_radius;
+	snapshot.player_left = player_rect.left;
+	snapshot.player_top = player_rect.top;
+	snapshot.player_width = player_rect.width;
+	snapshot.player_height = player_rect.height;
+	snapshot.enemy_left = enemy_rect.left;
+	snapshot.enemy_top = enemy_rect.top;
+	snapshot.enemy_width = enemy_rect.width;
+	snapshot.enemy_height = enemy_rect.height;
+	snapshot.player_relative_speed = player_relative_speed;
+	snapshot.enemy_relative_speed = enemy_relative_speed;
+	snapshot.player_score = player_score;
+	snapshot.enemy_score = enemy_score;
+	snapshot.flags = (waiting_for_input ? std::uint32_t(SnapshotWaitingForInput) : 0U) |
+					 (fixed_physics ? std::uint32_t(SnapshotFixedPhysics) : 0U) |
+					 (multi_ball ? std::uint32_t(SnapshotMultiBall) : 0U);
+	snapshot.reserved = 0;
+}
+
+bool Server::is_waiting_for_input() {
+	return waiting_for_input;
+}
+
+const ServerStats& Server::get_stats() {
+	return stats;
+}
+
+const MultiBallWorld* Server::get_multi_ball() {
+	return multi_ball.get();
+}
+
+std::shared_ptr<const GameEventBus> Server::enable_events(std::size_t capacity) {
+	if (!events)
+		events = std::make_shared<GameEventBus>(capacity);
+	return events;
+}
+
+const ArenaMap* Server::get_arena() {
+	return arena.get();
+}
+
+float Server::random_serve_direction() {
+	return gm::random_number_triple_range(randomizer, 0.0F * DEG2RAD, 75.0F * DEG2RAD,
+										  115.0F * DEG2RAD, 255.0F * DEG2RAD,
+										  295.0F * DEG2RAD, 360.0F * DEG2RAD);
 }
 
 sf::Vector2f Server::get_ball_pos() {
@@ -67,6 +273,14 @@ float Server::get_ball_dir(){
 	return ball_direction;
 }
 
+float Server::get_ball_radius() {
+	return ball_radius;
+}
+
+sf::Vector2u Server::get_window_size() {
+	return window_size;
+}
+
 sf::FloatRect Server::get_player_rect() {
 	return player_rect;
 }
@@ -84,10 +298,11 @@ unsigned int Server::get_enemy_score() {
 }
 
 void Server::update_player_movement() {
-	if (player_relative_speed != 0 || enemy_relative_speed != 0)
-		waiting_for_input = false;
-	else
+	if (player_relative_speed == 0 && enemy_relative_speed == 0)
 		return;
+	if (waiting_for_input)
+		publish_event(Resume);
+	waiting_for_input = false;
 
 	player_rect.top += player_relative_speed * 10.0F;
 	enemy_rect.top += enemy_relative_speed * 10.0F;
@@ -96,21 +311,44 @@ void Server::update_player_movement() {
 	enemy_rect.top = std::clamp(enemy_rect.top, 0.0F, window_size.y - enemy_rect.height);
 }
 
+template <bool Obstacles>
 void Server::update_ball_movement() {
     //Do not move if the ball suspended
 	if (waiting_for_input)
 		return;
 
+	stats.ticks++;
+	ticks_metric.add();
+	//The clock costs more than the movement itself, so only a sample of the updates is measured
+	std::optional<MetricTimer> timer;
+	if ((stats.ticks & 63) == 0)
+		timer.emplace(ball_update_metric);
+
 	//Move ball by direction
-	ball_pos +=
-		sf::Vector2f(std::cos(ball_direction) * ball_speed, std::sin(ball_direction) * ball_speed);
+	sf::Vector2f previous_ball_pos = ball_pos;
+	float direction_sin, direction_cos;
+	gm::fast_sin_cos(ball_direction, direction_sin, direction_cos);
+	ball_pos += sf::Vector2f(direction_cos * ball_speed, direction_sin * ball_speed);
+
+	//The ball that jumped over a paddle ends up behind it, so it is never a collision
+	if (check_tunneling(previous_ball_pos)) {
+		stats.tunneling_events++;
+		tunneling_metric.add();
+	}
+
+	if (check_score())
+		return;
 
 	//BEGIN check collision of next ball with bounds of window
-	bool top_win_bound = ball_pos.y - ball_radius <= 0; //Top global bound
-	bool bottom_win_bound = ball_pos.y + ball_radius >= window_size.y; //Bottom global bound
+	bool top_win_bound = ball_pos.y - ball_radius <= 0 && direction_sin < 0; //Top global bound
+	bool bottom_win_bound = ball_pos.y + ball_radius >= window_size.y && direction_sin > 0; //Bottom
 
-	//Clamp the position of the ball
-	std::clamp(ball_pos.y, ball_radius, window_size.y - ball_radius);
+	//Mirror the part of the path behind the bound, so the ball moves exactly as if it was
+	//reflected in the middle of the tick (and gm::predict_ball_path() matches the server)
+	if (top_win_bound)
+		ball_pos.y = 2.0F * ball_radius - ball_pos.y;
+	else if (bottom_win_bound)
+		ball_pos.y = 2.0F * (window_size.y - ball_radius) - ball_pos.y;
 
 	//Change the direction of the ball considering the collisions with horizontal window bounds
 	if (top_win_bound || bottom_win_bound) {
@@ -119,8 +357,13 @@ void Server::update_ball_movement() {
 		// |    Before -> / | \ <- After       |
 		// |             /  |  \               |
 		ball_direction = 360.0F * DEG2RAD - ball_direction;
+		publish_event(WallBounce, top_win_bound ? 1 : 2);
 	}
 	//END check collision with bounds of window
+	//Static obstacles of the field
+	if constexpr (Obstacles)
+		collide_arena();
+
 	//We will use "rounded rect - point" model, because it is identical but simplier than "rect - circle"
 	//           +=========+
 	//        ---|         |---
@@ -152,6 +395,13 @@ void Server::update_ball_movement() {
 	if (cur_rect != nullptr)
 		collision = gm::rounded_rect_segment_contains(*cur_rect, ball_radius, ball_pos);
 
+	if (!collided_before && collision != 0) {
+		stats.segment_collisions[collision]++;
+		collision_metrics[collision - 1].add();
+		stats.current_rally_hits++;
+		publish_event(PaddleHit, collision, cur_rect == &player_rect);
+	}
+
 	if (!collided_before) {
 		//Also, change the direction of the ball
 		switch (collision) {
@@ -247,8 +497,10 @@ void Server::update_ball_movement() {
 			//Compute angle of line
 			float angle = gm::line_angle_from_points(circle_center, ball_pos);
 			//Place ball in the correct place
-			ball_pos.x = circle_center.x + std::cos(angle) * ball_radius;
-			ball_pos.y = circle_center.y + std::sin(angle) * ball_radius;
+			float angle_sin, angle_cos;
+			gm::fast_sin_cos(angle, angle_sin, angle_cos);
+			ball_pos.x = circle_center.x + angle_cos * ball_radius;
+			ball_pos.y = circle_center.y + angle_sin * ball_radius;
 		}
 	}
 	//END prevent collision again (get out the ball)
@@ -257,21 +509,182 @@ void Server::update_ball_movement() {
 	collided_before = collision != 0;
 }
 
+void Server::collide_arena() {
+	ArenaMap::Contact contact;
+	if (!arena->query(ball_pos, ball_radius, contact))
+		return;
+
+	//Get out the ball
+	ball_pos += contact.normal * contact.depth;
+
+	//Mirror the velocity by the surface, only if the ball moves into the obstacle (it may be already reflected)
+	sf::Vector2f velocity;
+	gm::fast_sin_cos(ball_direction, velocity.y, velocity.x);
+	float along_normal = velocity.x * contact.normal.x + velocity.y * contact.normal.y;
+	if (along_normal < 0.0F) {
+		velocity -= contact.normal * (2.0F * along_normal);
+		ball_direction = gm::fast_atan2(velocity.y, velocity.x);
+	}
+}
+
+bool Server::check_tunneling(sf::Vector2f previous_ball_pos) {
+	for (const sf::FloatRect* rect : { &player_rect, &enemy_rect }) {
+		//Rect grown by the radius of the ball, so the ball is a point
+		float left = rect->left - ball_radius, right = rect->left + rect->width + ball_radius;
+		float top = rect->top - ball_radius, bottom = rect->top + rect->height + ball_radius;
+
+		//The step jumped over the paddle from one side to the other
+		bool jumped = (previous_ball_pos.x < left && ball_pos.x > right) ||
+			(previous_ball_pos.x > right && ball_pos.x < left);
+		if (!jumped)
+			continue;
+
+		//Where the step crossed the middle of the paddle
+		float middle_x = rect->left + rect->width * 0.5F;
+		float progress = (middle_x - previous_ball_pos.x) / (ball_pos.x - previous_ball_pos.x);
+		float middle_y = previous_ball_pos.y + (ball_pos.y - previous_ball_pos.y) * progress;
+		if (middle_y >= top && middle_y <= bottom)
+			return true;
+	}
+	return false;
+}
+
+bool Server::check_score() {
+	if (ball_pos.x + ball_radius < 0.0F) { //Left bound, behind the player
+		scored(false);
+		return true;
+	}
+	if (ball_pos.x - ball_radius > window_size.x) { //Right bound, behind the enemy
+		scored(true);
+		return true;
+	}
+	return false;
+}
+
 void Server::scored(bool is_player) {
+	//Finish the rally
+	stats.rallies++;
+	stats.rally_hits += stats.current_rally_hits;
+	stats.longest_rally = std::max(stats.longest_rally, stats.current_rally_hits);
+	stats.current_rally_hits = 0;
+
 	//Add 1 point to one of the scores
 	if (is_player)
 		player_score++;
 	else
 		enemy_score++;
+	publish_event(Score, 0, is_player);
 
-	ball_pos = { window_size.x * 0.5F, window_size.y * 0.5F }; //Place the ball to the center of the window
-	ball_direction = gm::random_number_double_range(10.0F * DEG2RAD, 170.0F * DEG2RAD, //Random direction
-												190.0F * DEG2RAD, 350.0F * DEG2RAD);
+	if (fixed_physics) {
+		fixed_physics->serve(randomizer);
+		update_fixed_physics_view();
+	} else {
+		ball_pos = { window_size.x * 0.5F, window_size.y * 0.5F }; //Place the ball to the center of the window
+		ball_direction = gm::random_number_double_range(randomizer, //Random direction
+														10.0F * DEG2RAD, 170.0F * DEG2RAD,
+														190.0F * DEG2RAD, 350.0F * DEG2RAD);
+	}
 
 	waiting_for_input = true; //Suspend
 }
 
+void Server::update_multi_ball() {
+	//Do not move if the balls suspended
+	if (waiting_for_input)
+		return;
+
+	stats.ticks++;
+	ticks_metric.add();
+
+	//Every ball that leaves the field is a point, the game goes on without the pause
+	unsigned int player_points, enemy_points;
+	multi_ball->update(player_rect, enemy_rect, player_points, enemy_points);
+	player_score += player_points;
+	enemy_score += enemy_points;
+	for (unsigned int i = 0; i < player_points + enemy_points; i++)
+		publish_event(Score, 0, i < player_points);
+
+	update_multi_ball_view();
+}
+
+void Server::update_multi_ball_view() {
+	//The first ball stands for the single ball (e.g. the AI follows it)
+	if (multi_ball->size() == 0)
+		return;
+	sf::Vector2f velocity = multi_ball->get_velocity(0);
+	ball_pos = multi_ball->get_position(0);
+	ball_direction = gm::fast_atan2(velocity.y, velocity.x);
+}
+
+void Server::update_fixed_physics() {
+	//The same as update_player_movement(), the float inputs are converted exactly
+	if (player_relative_speed != 0 || enemy_relative_speed != 0) {
+		if (waiting_for_input)
+			publish_event(Resume);
+		waiting_for_input = false;
+		fixed_physics->move_paddles(fx::from_float(player_relative_speed), fx::from_float(enemy_relative_speed));
+	}
+
+	if (!waiting_for_input) {
+		stats.ticks++;
+		ticks_metric.add();
+		FixedBallEvents ball_events = fixed_physics->move_ball(collided_before);
+		if (ball_events.player_scored || ball_events.enemy_scored) {
+			scored(ball_events.player_scored);
+		} else {
+			if (ball_events.wall != 0 && events) {
+				update_fixed_physics_view();
+				publish_event(WallBounce, ball_events.wall);
+			}
+			if (!collided_before && ball_events.collision != 0) {
+				stats.segment_collisions[ball_events.collision]++;
+				collision_metrics[ball_events.collision - 1].add();
+				stats.current_rally_hits++;
+				if (events) {
+					update_fixed_physics_view();
+					publish_event(PaddleHit, ball_events.collision, ball_events.player_paddle);
+				}
+			}
+			collided_before = ball_events.collision != 0;
+		}
+	}
+
+	update_fixed_physics_view();
+}
+
+void Server::update_fixed_physics_view() {
+	ball_pos = fixed_physics->get_ball_pos();
+	ball_direction = fixed_physics->get_ball_direction();
+	player_rect = fixed_physics->get_player_rect();
+	enemy_rect = fixed_physics->get_enemy_rect();
+}
+
+template <typename Real, typename Collision>
+void Server::physics_step() {
+	if constexpr (std::is_same<Real, fx::Fixed>::value) {
+		update_fixed_physics();
+	} else {
+		update_player_movement();
+		if constexpr (Collision::MULTI_BALL)
+			update_multi_ball();
+		else
+			update_ball_movement<Collision::OBSTACLES>();
+	}
+}
+
+//Every physics of ServerCore
+template void Server::physics_step<float, PaddleCollision>();
+template void Server::physics_step<float, ArenaCollision>();
+template void Server::physics_step<float, MultiBallCollision>();
+template void Server::physics_step<fx::Fixed, PaddleCollision>();
+
 void Server::internal_update() {
-	update_player_movement();
-	update_ball_movement();
+	if (fixed_physics)
+		physics_step<fx::Fixed, PaddleCollision>();
+	else if (multi_ball)
+		physics_step<float, MultiBallCollision>();
+	else if (arena)
+		physics_step<float, ArenaCollision>();
+	else
+		physics_step<float, PaddleCollision>();
 }
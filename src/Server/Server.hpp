@@ -18,27 +18,110 @@
 
 #pragma once
 
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
 #include <SFML/Graphics/Rect.hpp>
 
 #include "../GameManager.hpp"
+#include "../game_math.hpp"
+#include "../Input/InputSampler.hpp"
+#include "ArenaMap.hpp"
+#include "FixedPhysics.hpp"
+#include "GameEvents.hpp"
+#include "MatchSnapshot.hpp"
+#include "MultiBallWorld.hpp"
 #include "ServerSettings.hpp"
 
+///Counters of the events of the match, for analytics
+struct ServerStats {
+	///Amount of updates with the moving ball
+	unsigned long long ticks = 0;
+	///New collisions with the paddles per segment id (see gm::rounded_rect_segment_contains(), 0 is unused)
+	unsigned int segment_collisions[9] = { };
+	///Times the ball passed through a paddle between two updates without a collision
+	unsigned int tunneling_events = 0;
+	///Amount of finished rallies (points)
+	unsigned int rallies = 0;
+	///Paddle hits in all finished rallies
+	unsigned long long rally_hits = 0;
+	///Maximal amount of paddle hits in one rally
+	unsigned int longest_rally = 0;
+	///Paddle hits in the current rally
+	unsigned int current_rally_hits = 0;
+};
+
+///Everything that changes during the match (see Server::save_state()). Copied with a plain memcpy,
+///so the savestates of many ticks are cheap to keep. The balls of the chaos mode are not included
+struct ServerState {
+	sf::Vector2f ball_pos;
+	float ball_direction;
+	sf::FloatRect player_rect, enemy_rect;
+	float player_relative_speed, enemy_relative_speed;
+	unsigned int player_score, enemy_score;
+	bool waiting_for_input, collided_before;
+	gm::Randomizer randomizer;
+	ServerStats stats;
+	///The authoritative state in the fixed-point mode
+	FixedPhysicsState fixed;
+};
+static_assert(std::is_trivially_copyable<ServerState>::value, "ServerState is copied as bytes");
+
 ///Server takes input like player's moves and
 ///returns data about player's, enemy's and ball's position.
 ///Management of player movement (changing speed) is on GamePage.
-///Management of enemy movement (changing speed) is on inherited Server.
+///Management of enemy movement (changing speed) is on the opponent policy of ServerCore.
 class Server {
 public:
-	///Create a new server using the specified settings
+	///Create a new server using the specified settings. The ServerCore of the type of the game and the physics
+	///is chosen here once, the caller only sees the Server
+	///@returns nullptr if the type of the game has no server
 	static Server* create(ServerSettings setting);
 
 	Server(sf::Vector2u window_size);
 
+	virtual ~Server() = default;
+
 	///Update server's state: ball, collisions, movement etc
 	virtual void update() = 0;
 
+	///Start a new match: zero scores, paddles at the start, the ball waits in the center
+	///@param seed seed of the random ball directions (same seed - same match for the same input)
+	virtual void reset(unsigned int seed);
+
+	///Save the state of the match (e.g. for the rollback)
+	void save_state(ServerState& state) const;
+	///Restore the state of the match saved by save_state() on the server with the same settings
+	void load_state(const ServerState& state);
+
+	///Hash of the state of the match (FNV-1a). In the fixed-point mode it is the same on every machine
+	///for the same inputs, so the peers of the lockstep compare it to detect desyncs
+	std::uint64_t state_hash();
+
+	///Start publishing the events of the match (collisions, points, serves) into the bus.
+	///Ticks simulated again after load_state() publish their events again
+	///@param capacity amount of the last events kept for the slow subscribers
+	///@returns the bus, subscribe to it with GameEventSubscriber
+	std::shared_ptr<const GameEventBus> enable_events(std::size_t capacity = 1024);
+
+	///Write the state of the match visible to its consumers into the flat snapshot
+	///(it may point into a send buffer or a mapped file)
+	void write_snapshot(MatchSnapshot& snapshot) const;
+
+	///Launch the ball without waiting for the input of the player or the enemy
+	void serve();
+
+	///Apply the local input latched for the next update().
+	///Servers whose enemy is controlled from this computer take the enemy input from here
+	virtual void apply_local_input(const InputSnapshot&) { };
+
 	///Speed of player that relative to max (1 - max down, 0 - static, -1 - max up)
-	float player_relative_speed;
+	float player_relative_speed = 0.0F;
+
+	///Set the speed of the enemy for the next update() (1 - max down, 0 - static, -1 - max up).
+	///The AI opponent overrides it
+	void set_enemy_relative_speed(float speed);
 
 	///Get the current rect of the player
 	sf::FloatRect get_player_rect();
@@ -48,14 +131,24 @@ public:
 	sf::Vector2f get_ball_pos();
 	///Get the current direction of the ball in radians
 	float get_ball_dir();
+	///Get the radius of the ball
+	float get_ball_radius();
+	///Get the size of the field
+	sf::Vector2u get_window_size();
     ///Get current player's score
     unsigned int get_player_score();
     ///Get current enemy's score
     unsigned int get_enemy_score();
+	///Is the ball suspended until the input of the player or the enemy?
+	bool is_waiting_for_input();
+	///Get the counters of the events since the last reset()
+	const ServerStats& get_stats();
+	///Get the balls of the chaos mode (nullptr in the normal game with one ball)
+	const MultiBallWorld* get_multi_ball();
+	///Get the static obstacles of the field (nullptr if the field is empty)
+	const ArenaMap* get_arena();
 
 protected:
-	GameType server_type;
-
 	sf::Vector2f ball_pos;
 	///Ball's radius in pixels
 	float ball_radius;
@@ -65,7 +158,7 @@ protected:
 	float ball_speed;
 
 	///Speed of enemy that relative to max (1 - max down, 0 - static, -1 - max up)
-	float enemy_relative_speed;
+	float enemy_relative_speed = 0.0F;
 
     unsigned int player_score = 0, enemy_score = 0;
     ///If true, ball suspended until input from player or enemy incomes
@@ -76,10 +169,46 @@ protected:
 	sf::Vector2u window_size;
 
 	sf::FloatRect player_rect, enemy_rect;
+	///Rects of the player and the enemy at the start of the match
+	sf::FloatRect start_player_rect, start_enemy_rect;
+
+	///Generator of the ball directions, seeded by reset()
+	gm::Randomizer randomizer;
+
+	ServerStats stats;
 
-	///Update ball movement, check player (enemy) movement and other stuff
+	///Balls of the chaos mode, they replace the single ball
+	std::unique_ptr<MultiBallWorld> multi_ball;
+	///Fixed-point physics that replaces the float one (nullptr in the float mode)
+	std::unique_ptr<FixedPhysics> fixed_physics;
+
+	///Static obstacles of the field, shared by the servers of the same arena
+	std::shared_ptr<const ArenaMap> arena;
+	///Events of the match (nullptr until enable_events())
+	std::shared_ptr<GameEventBus> events;
+
+	///Apply the settings of every server: the ball, the paddles, the arena and the physics.
+	///The physics has to match the policies of the server (Server::create() chooses them by the settings)
+	///@returns seed of the match (random if the settings have none)
+	unsigned int apply_settings(const ServerSettings& settings);
+
+	///Update ball movement, check player (enemy) movement and other stuff.
+	///Instantiated in Server.cpp for the numbers and the collision models of ServerCore
+	template <typename Real, typename Collision>
+	void physics_step();
+
+	///physics_step() chosen by the members at runtime, for the servers set up by hand
 	void internal_update();
 
+	///Generate a random direction of the ball at the start
+	float random_serve_direction();
+
+	///Publish the event at the current position of the ball, if the events are enabled
+	void publish_event(GameEventType type, unsigned char detail = 0, bool player = false) {
+		if (events)
+			events->publish({ stats.ticks, ball_pos.x, ball_pos.y, type, detail, player });
+	}
+
 	///When someone scores
 	///@param is_player who scored?
 	void scored(bool is_player);
@@ -88,5 +217,22 @@ private:
 	///Update player and enemy movement, check collision with window borders
 	void update_player_movement();
 	///Update ball movement, check for collisions and change direction
+	///@tparam Obstacles collide with the static obstacles of the arena too
+	template <bool Obstacles>
 	void update_ball_movement();
+	///Reflect the ball off the static obstacle it overlaps the most and move it out of the obstacle
+	void collide_arena();
+	///Update the balls of the chaos mode
+	void update_multi_ball();
+	///Set ball_pos and ball_direction from the balls of the chaos mode
+	void update_multi_ball_view();
+	///Update the paddles and the ball with the fixed-point physics
+	void update_fixed_physics();
+	///Set the float positions and the direction from the fixed-point physics
+	void update_fixed_physics_view();
+	///Check if the ball passed through a paddle between the positions without touching it
+	bool check_tunneling(sf::Vector2f previous_ball_pos);
+	///Check if the ball left the field through the left or right bound
+	///@returns true if someone scored
+	bool check_score();
 };
@@ -0,0 +1,70 @@
+/*
+ * PongX server specialized at compile time
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <type_traits>
+
+#include "../fixed_math.hpp"
+#include "Server.hpp"
+#include "ServerPolicies.hpp"
+
+///Server made of the policies (see ServerPolicies.hpp):
+///Input - the input source (PlayerOnlyInput, SharedKeyboardInput),
+///Opponent - who moves the enemy (InputOpponent, AiOpponent),
+///Collision - the collision model (PaddleCollision, ArenaCollision, MultiBallCollision),
+///Real - the numbers of the physics (float or fx::Fixed, see PhysicsBackend).
+///The loops that know the type call step() without a virtual call or a switch on the settings,
+///the others use the Server made by Server::create()
+template <typename Input, typename Opponent, typename Collision, typename Real>
+class ServerCore final : public Server {
+	static_assert(std::is_same<Real, float>::value || std::is_same<Real, fx::Fixed>::value,
+				  "the physics is either float or fixed-point");
+	static_assert(std::is_same<Real, float>::value || std::is_same<Collision, PaddleCollision>::value,
+				  "the fixed-point physics has the walls and the paddles only");
+
+public:
+	///The type of the game in the settings is ignored, it is set by the policies
+	ServerCore(const ServerSettings& settings)
+		: Server(settings.window_size), input(settings), opponent(settings) {
+		ServerCore::reset(apply_settings(settings));
+	}
+
+	void update() override {
+		step();
+	}
+
+	///The same as update(), but without the virtual call
+	void step() {
+		enemy_relative_speed = opponent.update(enemy_relative_speed, waiting_for_input, enemy_rect, ball_pos,
+											   ball_direction, ball_radius, window_size);
+		physics_step<Real, Collision>();
+	}
+
+	void reset(unsigned int seed) override {
+		Server::reset(seed);
+		opponent.reset(seed);
+	}
+
+	void apply_local_input(const InputSnapshot& snapshot) override {
+		input.apply(snapshot, enemy_relative_speed);
+	}
+
+	Input input;
+	Opponent opponent;
+};
@@ -0,0 +1,113 @@
+/*
+ * PongX compile-time policies of the server
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Window/Keyboard.hpp>
+
+#include "../Input/InputSampler.hpp"
+#include "PaddleAI.hpp"
+#include "ServerSettings.hpp"
+
+//Policies of ServerCore. Every policy is a plain class, its calls are inlined into the step of the server
+
+//BEGIN input sources: what the local input moves besides the player (the player is moved by the page)
+
+///Only the player is controlled from this computer
+struct PlayerOnlyInput {
+	PlayerOnlyInput(const ServerSettings&) { }
+
+	void apply(const InputSnapshot&, float&) { }
+};
+
+///The enemy is controlled by the second player on the same keyboard
+struct SharedKeyboardInput {
+	SharedKeyboardInput(const ServerSettings& settings)
+		: enemy_up_key(settings.enemy_up_key), enemy_down_key(settings.enemy_down_key) { }
+
+	void apply(const InputSnapshot& input, float& enemy_relative_speed) {
+		enemy_relative_speed = input.axis(enemy_up_key, enemy_down_key);
+	}
+
+	///Key which has to be pressed to move the enemy up
+	sf::Keyboard::Key enemy_up_key;
+	///Key which has to be pressed to move the enemy down
+	sf::Keyboard::Key enemy_down_key;
+};
+//END input sources
+
+//BEGIN opponents: who sets the speed of the enemy before every step
+
+///The enemy keeps the speed set by the input (the second player or the remote peer)
+struct InputOpponent {
+	InputOpponent(const ServerSettings&) { }
+
+	void reset(unsigned int) { }
+
+	float update(float enemy_relative_speed, bool, const sf::FloatRect&, sf::Vector2f, float, float, sf::Vector2u) {
+		return enemy_relative_speed;
+	}
+};
+
+///The enemy is controlled by PaddleAI
+struct AiOpponent {
+	AiOpponent(const ServerSettings& settings) : ai(0) {
+		ai.set_difficulty(settings.ai_reaction_delay, settings.ai_error);
+	}
+
+	void reset(unsigned int seed) {
+		//Different sequence from the ball directions, but the same for the same seed
+		ai.seed(seed ^ 0x9E3779B9U);
+		ai.reset();
+	}
+
+	float update(float, bool waiting_for_input, const sf::FloatRect& enemy_rect, sf::Vector2f ball_pos,
+				 float ball_direction, float ball_radius, sf::Vector2u window_size) {
+		//The player serves, the AI waits for the ball
+		if (waiting_for_input) {
+			ai.reset();
+			return 0.0F;
+		}
+		return ai.update(enemy_rect, ball_pos, ball_direction, ball_radius, window_size);
+	}
+
+	PaddleAI ai;
+};
+//END opponents
+
+//BEGIN collision models: what the ball collides with. Tags, the physics of Server is instantiated for each
+
+///One ball, the walls and the paddles
+struct PaddleCollision {
+	static constexpr bool OBSTACLES = false;
+	static constexpr bool MULTI_BALL = false;
+};
+
+///One ball, the walls, the paddles and the static obstacles of ArenaMap
+struct ArenaCollision {
+	static constexpr bool OBSTACLES = true;
+	static constexpr bool MULTI_BALL = false;
+};
+
+///Balls of the chaos mode (MultiBallWorld): the walls, the paddles and each other
+struct MultiBallCollision {
+	static constexpr bool OBSTACLES = false;
+	static constexpr bool MULTI_BALL = true;
+};
+//END collision models
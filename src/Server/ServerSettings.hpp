@@ -18,14 +18,25 @@
 
 #pragma once
 
+#include <memory>
+
 #include <SFML/Graphics/Rect.hpp>
 #include <SFML/Window/Keyboard.hpp>
 
 #include "../GameManager.hpp"
+#include "ArenaMap.hpp"
+
+///Numbers of the simulation
+enum PhysicsBackend : unsigned char {
+	///float and the standard math library: fast, but the results may differ between machines
+	FloatPhysics,
+	///Q16.16 numbers without the standard math library: bit-exactly the same on every machine (see FixedPhysics)
+	FixedPointPhysics
+};
 
 struct ServerSettings {
-	///Necessary setting
-	GameType server_type;
+	///Type of the game (RollbackSession sets its own)
+	GameType server_type = Singleplayer;
 	///Necessary setting
 	float ball_radius = 10.0F, ball_speed = 5.0F;
 	///Necessary setting
@@ -33,7 +44,20 @@ struct ServerSettings {
         enemy_rect = sf::FloatRect( { 1225, 0 }, { 45, 225 } );
 	///Necessary setting
 	sf::Vector2u window_size;
+	///Seed of the ball directions and the AI mistakes (0 - random)
+	unsigned int seed = 0;
+	///Amount of balls of the chaos mode (0 - the normal game with one ball)
+	unsigned int chaos_balls = 0;
+	///Numbers of the simulation. The chaos mode and the arena obstacles need FloatPhysics
+	PhysicsBackend physics = FloatPhysics;
+	///Static obstacles of the field (nullptr - the empty field)
+	std::shared_ptr<const ArenaMap> arena;
 
 	///Only for local multiplayer
 	sf::Keyboard::Key enemy_up_key = sf::Keyboard::Up, enemy_down_key = sf::Keyboard::Down;
+
+	///Only for singleplayer: ticks before the AI reacts to the ball
+	unsigned int ai_reaction_delay = 10;
+	///Only for singleplayer: maximal error of the AI in pixels
+	float ai_error = 60.0F;
 };
@@ -1,5 +1,5 @@
 /*
- * PongX local multiplayer server
+ * PongX singleplayer server
  * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
  *
  * This program is free software: you can redistribute it and/or modify
@@ -16,16 +16,10 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include "LocalMultiplayerServer.hpp"
+#pragma once
 
-LocalMultiplayerServer::LocalMultiplayerServer(sf::Vector2u window_size) : Server(window_size) {
+#include "ServerCore.hpp"
 
-}
-
-void LocalMultiplayerServer::update() {
-	//Move the enemy if the specified keys are pressed
-	enemy_relative_speed = sf::Keyboard::isKeyPressed(enemy_down_key) - sf::Keyboard::isKeyPressed(enemy_up_key);
-
-	//Internal update of the abstract server
-	internal_update();
-}
+///Server where the enemy is controlled by PaddleAI
+template <typename Collision = PaddleCollision, typename Real = float>
+using SingleplayerServer = ServerCore<PlayerOnlyInput, AiOpponent, Collision, Real>;
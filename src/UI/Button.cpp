@@ -51,15 +51,46 @@ void Button::init(sf::RenderWindow* window, sf::Vector2f relative_position, UICo
 	label.init(window, title, { 0, 0 }, UIControl::CenterCenter, UIControl::CenterCenter, font_size, color, font);
 }
 
+void Button::set_callback(std::function<void()> on_click) {
+	this->on_click = on_click;
+}
+
 void Button::render() {
-	//Set that not clicked
-	clicked = false;
+	//Render label and rectangle
+	window->draw(main_rect);
+	label.render();
+}
+
+void Button::handle_event(const sf::Event& event) {
+	switch (event.type) {
+		case sf::Event::MouseMoved: {
+			set_hovered(contains(event.mouseMove.x, event.mouseMove.y));
+			break;
+		}
+		case sf::Event::MouseLeft: {
+			set_hovered(false);
+			break;
+		}
+		case sf::Event::MouseButtonPressed: {
+			set_hovered(contains(event.mouseButton.x, event.mouseButton.y));
+
+			//Accept click
+			if (hovered && event.mouseButton.button == sf::Mouse::Button::Left && on_click)
+				on_click();
+			break;
+		}
+		default: {
+			break;
+		}
+	}
+}
 
-	//Check if mouse pressed
-	bool pressed = sf::Mouse::isButtonPressed(sf::Mouse::Button::Left);
+void Button::set_hovered(bool hovered) {
+	if (hovered == this->hovered)
+		return;
+	this->hovered = hovered;
 
-	//If in area
-	if (is_mouse_in_area()) {
+	if (hovered) {
 		main_rect.setFillColor(color); //Swap colors
 		label.set_color(bg_color);
 	}
@@ -67,25 +98,9 @@ void Button::render() {
 		main_rect.setFillColor(bg_color); //Normal state of colors
 		label.set_color(color);
 	}
-
-	//Render label and rectangle
-	window->draw(main_rect);
-	label.render();
-
-	//Accept click
-	if (pressed && is_mouse_in_area() && !pressed_before)
-		clicked = true;
-
-	//Handle pressed_before
-	if (pressed)
-		pressed_before = true;
-	else
-		pressed_before = false;
+	damage();
 }
 
-inline bool Button::is_mouse_in_area() const {
-	//Get mouse position in ints and convert it in floats
-	auto mouse_pos_i = sf::Mouse::getPosition(*window);
-	sf::Vector2f mouse_pos = { static_cast<float>(mouse_pos_i.x), static_cast<float>(mouse_pos_i.y) };
-	return main_rect.getGlobalBounds().contains(mouse_pos);
+bool Button::contains(int x, int y) const {
+	return main_rect.getGlobalBounds().contains(static_cast<float>(x), static_cast<float>(y));
 }
@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <functional>
+
 #include "../GameManager.hpp"
 #include "Label.hpp"
 #include "UIControl.hpp"
@@ -35,11 +37,14 @@ public:
 			  sf::Color color = sf::Color::White, sf::Color bg_color = sf::Color::Black,
 			  sf::Font* font = GameManager::get_default_font());
 
+	///Set the function that will be called when the button is clicked
 	void set_callback(std::function<void()> on_click);
 
 	void render() override;
 
-	bool clicked = false;
+	void handle_event(const sf::Event& event) override;
+
+	bool is_interactive() const override { return true; };
 
 private:
 	sf::RectangleShape main_rect;
@@ -50,9 +55,15 @@ private:
 	///Means the color of background of the button
 	sf::Color bg_color;
 
-	///Is mouse was pressed on the last frame?
-	bool pressed_before = false;
+	///Called when the button is clicked
+	std::function<void()> on_click;
+
+	///Is mouse pointer in the area of the button?
+	bool hovered = false;
+
+	///Set hovered state and swap colors if it is changed
+	void set_hovered(bool hovered);
 
-	///Check is mouse pointer in the area of the button
-	inline bool is_mouse_in_area() const;
+	///Check if the specified point (in window coordinates) is in the area of the button
+	bool contains(int x, int y) const;
 };
@@ -15,6 +15,7 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include "../Input/LatencyMeter.hpp"
 #include "FPSMeter.hpp"
 
 FPSMeter::FPSMeter(sf::RenderWindow* window, sf::Vector2f relative_position, UIControl::Relativity relative_to,
@@ -38,7 +39,13 @@ void FPSMeter::render() {
 	//Calculate FPS
 	unsigned short fps = 1.0F / elapsed.asSeconds();
 
-	//Display
-	text.setString(std::to_string(fps) + " FPS");
+	//Display, with the input-to-present latency of the last frame with input
+	std::string string = std::to_string(fps) + " FPS";
+	const LatencyMeter& latency_meter = GameManager::get_latency_meter();
+	if (latency_meter.get_frames_with_input() != 0)
+		string += ", input " + std::to_string(latency_meter.get_last_frame().total().asMilliseconds()) + " ms";
+	//The layout and the drawing may load the glyphs into the font
+	std::lock_guard<std::recursive_mutex> lock(GameManager::get_resource_mutex());
+	text.setString(string);
 	window->draw(text);
 }
@@ -28,6 +28,8 @@ public:
 			 sf::Font* font = GameManager::get_default_font());
 
 	void render() override;
+	///The rate changes every frame, and on the pages rendered on demand it means nothing
+	bool render_on_demand() const override { return false; };
 
 private:
 	///Text for render
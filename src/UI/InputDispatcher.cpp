@@ -0,0 +1,139 @@
+/*
+ * PongX UI input dispatcher
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "InputDispatcher.hpp"
+
+void InputDispatcher::init(sf::RenderWindow* window, unsigned int cell_size) {
+	this->cell_size = static_cast<float>(cell_size);
+
+	//Cover the whole window with cells
+	columns = (window->getSize().x + cell_size - 1) / cell_size;
+	rows = (window->getSize().y + cell_size - 1) / cell_size;
+	clear();
+}
+
+void InputDispatcher::add(UIControl* control) {
+	if (columns == 0 || rows == 0)
+		return;
+
+	sf::FloatRect bounds = control->bounds();
+	unsigned int index = controls.size();
+	controls.push_back(control);
+	if (index >= GRID_CAPACITY)
+		return;
+
+	//Compute the range of cells overlapped by the control (clamped by the grid)
+	int first_column = std::clamp(static_cast<int>(std::floor(bounds.left / cell_size)), 0, int(columns) - 1);
+	int last_column = std::clamp(static_cast<int>(std::floor((bounds.left + bounds.width) / cell_size)),
+								 0, int(columns) - 1);
+	int first_row = std::clamp(static_cast<int>(std::floor(bounds.top / cell_size)), 0, int(rows) - 1);
+	int last_row = std::clamp(static_cast<int>(std::floor((bounds.top + bounds.height) / cell_size)),
+							  0, int(rows) - 1);
+
+	for (int row = first_row; row <= last_row; row++)
+		for (int column = first_column; column <= last_column; column++)
+			cells[row * columns + column] |= std::uint64_t(1) << index;
+}
+
+void InputDispatcher::clear() {
+	controls.clear();
+	cells.assign(columns * rows, 0);
+	hovered = nullptr;
+	focused = nullptr;
+}
+
+UIControl* InputDispatcher::hit_test(sf::Vector2f point) const {
+	//Controls added later are rendered on top, so check them first. Controls out of the grid are the latest
+	for (unsigned int i = controls.size(); i > GRID_CAPACITY; i--) {
+		if (controls[i - 1]->bounds().contains(point))
+			return controls[i - 1];
+	}
+
+	if (point.x < 0 || point.y < 0)
+		return nullptr;
+
+	unsigned int column = point.x / cell_size;
+	unsigned int row = point.y / cell_size;
+	if (column >= columns || row >= rows)
+		return nullptr;
+
+	//Check the controls of the cell from the highest bit
+	std::uint64_t cell = cells[row * columns + column];
+	for (unsigned int i = std::min<unsigned int>(controls.size(), GRID_CAPACITY); i > 0 && cell != 0; i--) {
+		if ((cell >> (i - 1) & 1) != 0 && controls[i - 1]->bounds().contains(point))
+			return controls[i - 1];
+	}
+
+	return nullptr;
+}
+
+void InputDispatcher::dispatch(const sf::Event& event) {
+	switch (event.type) {
+		case sf::Event::MouseMoved: {
+			UIControl* control = hit_test({ static_cast<float>(event.mouseMove.x),
+										   static_cast<float>(event.mouseMove.y) });
+			set_hovered(control);
+			if (control != nullptr)
+				control->handle_event(event);
+			break;
+		}
+		case sf::Event::MouseButtonPressed:
+		case sf::Event::MouseButtonReleased: {
+			UIControl* control = hit_test({ static_cast<float>(event.mouseButton.x),
+										   static_cast<float>(event.mouseButton.y) });
+			//Pointer may have not moved since the previous page was shown
+			set_hovered(control);
+			if (event.type == sf::Event::MouseButtonPressed)
+				focused = control;
+			if (control != nullptr)
+				control->handle_event(event);
+			break;
+		}
+		case sf::Event::MouseLeft: { //Pointer left the window
+			set_hovered(nullptr);
+			break;
+		}
+		case sf::Event::KeyPressed:
+		case sf::Event::KeyReleased:
+		case sf::Event::TextEntered: {
+			if (focused != nullptr)
+				focused->handle_event(event);
+			break;
+		}
+		default: { //Other
+			break; //Ignore
+		}
+	}
+}
+
+void InputDispatcher::set_hovered(UIControl* control) {
+	if (control == hovered)
+		return;
+
+	//Tell the previous control that the pointer is not over it anymore
+	if (hovered != nullptr) {
+		sf::Event left_event;
+		left_event.type = sf::Event::MouseLeft;
+		hovered->handle_event(left_event);
+	}
+
+	hovered = control;
+}
@@ -0,0 +1,65 @@
+/*
+ * PongX UI input dispatcher
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "UIControl.hpp"
+
+///Routes window events to the UI controls. Mouse events are routed using a uniform grid of cells,
+///so only the controls under the pointer are checked. Keyboard events go to the focused control
+///(the one that was clicked last)
+class InputDispatcher {
+public:
+	///Initialize the grid
+	///@param cell_size size of the grid cell in pixels
+	void init(sf::RenderWindow* window, unsigned int cell_size = 64);
+
+	///Register the control in the grid. Control must be already positioned
+	void add(UIControl* control);
+	///Unregister all controls
+	void clear();
+
+	///Route the event to the corresponding controls
+	void dispatch(const sf::Event& event);
+
+	///Find the topmost control that contains the specified point
+	///@returns nullptr if there is no such control
+	UIControl* hit_test(sf::Vector2f point) const;
+
+private:
+	///Maximal amount of controls in the grid. Controls above the limit are checked one by one
+	static constexpr unsigned int GRID_CAPACITY = 64;
+
+	///All registered controls in the order of addition (render order)
+	std::vector<UIControl*> controls;
+	///Bit masks of the controls (bit N - controls[N]) that overlap the cell. Cells are stored row by row
+	std::vector<std::uint64_t> cells;
+	unsigned int columns = 0, rows = 0;
+	float cell_size = 64.0F;
+
+	///Control under the pointer
+	UIControl* hovered = nullptr;
+	///Control that receives keyboard events
+	UIControl* focused = nullptr;
+
+	///Move the hover to the specified control, notifying the previous one
+	void set_hovered(UIControl* control);
+};
@@ -37,6 +37,9 @@ void Label::init(sf::RenderWindow* window, sf::String string, sf::Vector2f relat
 	this->alignment = alignment;
 	this->original_rel_pos = relative_position;
 
+	//Layout of the text uses the font, which may be used by the render thread at the same time
+	std::lock_guard<std::recursive_mutex> lock(GameManager::get_resource_mutex());
+
 	//Initialize text
 	text.setString(string);
 	text.setCharacterSize(font_size);
@@ -47,14 +50,19 @@ void Label::init(sf::RenderWindow* window, sf::String string, sf::Vector2f relat
 }
 
 void Label::set_color(sf::Color color) {
-	text.setFillColor(color);
+	if (color != text.getFillColor()) {
+		text.setFillColor(color);
+		damage();
+	}
 }
 
 void Label::set_text(sf::String string) {
 	//Set text only if current text and provided text differs (optimization)
 	if (string != text.getString()) {
+		std::lock_guard<std::recursive_mutex> lock(GameManager::get_resource_mutex());
 		text.setString(string);
 		refresh_pos();
+		damage();
 	}
 }
 
@@ -80,6 +88,8 @@ void Label::refresh_pos() {
 }
 
 void Label::render() {
+	//Drawing may load the glyphs into the font
+	std::lock_guard<std::recursive_mutex> lock(GameManager::get_resource_mutex());
 	//Render text
 	window->draw(text);
 }
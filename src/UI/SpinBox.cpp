@@ -52,6 +52,9 @@ SpinBox::SpinBox(sf::RenderWindow* window, sf::Vector2f relative_position, UICon
 	button_down.init(window, { -buttons_width, size.y * 0.5F }, UIControl::RightTop, UIControl::LeftTop,
 					 { buttons_width, size.y * 0.5F }, "-", 24);
 
+	button_up.set_callback([this]() { step_up(); });
+	button_down.set_callback([this]() { step_down(); });
+
 	//Initialize the main rect
 	main_rect.setSize(size);
 	main_rect.setPosition(position());
@@ -105,18 +108,24 @@ void SpinBox::render() {
 	button_up.render();
 	button_down.render();
 	label.render();
+}
+
+void SpinBox::handle_event(const sf::Event& event) {
+	//Buttons check by themselves if the event is in their area
+	button_up.handle_event(event);
+	button_down.handle_event(event);
+}
 
-	if (button_up.clicked) { //Check if the up button is clicked
-		value += step; //Add step to the value
-		if (value > max) //Clamp the value
-			value = max;
-	}
-	if (button_down.clicked) { //Check if the down button is clicked
-		value -= step; //Substract step from the value
-		if (value < min) //Clamp the value
-			value = min;
-	}
-	if (button_down.clicked || button_up.clicked) {
-		update_text();
-	}
+void SpinBox::step_up() {
+	value += step; //Add step to the value
+	if (value > max) //Clamp the value
+		value = max;
+	update_text();
+}
+
+void SpinBox::step_down() {
+	value -= step; //Substract step from the value
+	if (value < min) //Clamp the value
+		value = min;
+	update_text();
 }
@@ -32,6 +32,10 @@ public:
 
 	void render() override;
 
+	void handle_event(const sf::Event& event) override;
+
+	bool is_interactive() const override { return true; };
+
 	///Set the minimal allowable value.
 	///WARNING: visible effect only after the render() function
 	void set_minimal(float min);
@@ -74,4 +78,9 @@ private:
 	Label label;
 	///Main shape of the spinbox (background)
 	sf::RectangleShape main_rect;
+
+	///Add the step to the value (when the up button clicked)
+	void step_up();
+	///Substract the step from the value (when the down button clicked)
+	void step_down();
 };
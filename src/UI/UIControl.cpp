@@ -109,6 +109,22 @@ sf::Vector2f UIControl::position() const {
 	return { pos_x(), pos_y() };
 }
 
+sf::FloatRect UIControl::bounds() const {
+	return { position(), size };
+}
+
+void UIControl::damage() {
+	damaged = true;
+	if (parent != nullptr)
+		parent->damage();
+}
+
+bool UIControl::take_damage() {
+	bool was_damaged = damaged;
+	damaged = false;
+	return was_damaged;
+}
+
 sf::Vector2f UIControl::parent_size() const {
 	if (parent == nullptr) {
 		auto size_i = window->getSize(); //Window size and convert it to float
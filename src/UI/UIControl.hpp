@@ -18,8 +18,12 @@
 
 #pragma once
 
+#include <new>
+
 #include <SFML/Graphics.hpp>
 
+#include "../Utils/Arena.hpp"
+
 class UIControl {
 
 public:
@@ -31,21 +35,51 @@ public:
 
 	virtual ~UIControl() { };
 
+	static void* operator new(std::size_t size) { return ::operator new(size); };
+	static void operator delete(void* pointer) { ::operator delete(pointer); };
+	///Place the control in the arena: new (arena) Button(...).
+	///Such control has to be destroyed by calling the destructor, not by delete
+	static void* operator new(std::size_t size, Arena& arena) {
+		return arena.allocate(size, alignof(std::max_align_t));
+	};
+	///Called only if the constructor throws, arena memory is freed with the arena
+	static void operator delete(void*, Arena&) { };
+
 	float pos_x() const;
 	float pos_y() const;
 	sf::Vector2f position() const;
 	sf::Vector2f parent_size() const;
 	sf::Vector2f parent_pos() const;
 
+	///Get the rect occupied by the control in window coordinates
+	sf::FloatRect bounds() const;
+
 	UIControl* parent = nullptr;
 
 	virtual void render() = 0;
 
+	///Handle the mouse or keyboard event routed to this control by the InputDispatcher.
+	///Mouse events are delivered only when the pointer is (or just was) in bounds() of the control
+	virtual void handle_event(const sf::Event&) { };
+
+	///Should the InputDispatcher route events to this control?
+	virtual bool is_interactive() const { return false; };
+	///If true, the control reports its changes by damage(). Otherwise it changes every frame,
+	///so it is drawn only over the pages that are redrawn every frame
+	virtual bool render_on_demand() const { return true; };
+
+	///Mark the control as changed, so it has to be redrawn. Also damages the parent
+	void damage();
+	///Check if the control was damaged since the last call and reset the damage
+	bool take_damage();
+
 protected:
 	Relativity relative_to, alignment;
 	sf::Vector2f relative_position = { 0, 0 };
 	sf::Vector2f size = { 0, 0 };
 	sf::RenderWindow* window = nullptr;
+	///Is the control changed since the last take_damage()? New controls are damaged
+	bool damaged = true;
 
 	float align_offset_x() const;
 	float align_offset_y() const;
@@ -0,0 +1,93 @@
+/*
+ * PongX arena allocator
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <new>
+
+#include "BlockPool.hpp"
+#include "Arena.hpp"
+
+///Round the size up to the alignment of the block header, so the payload after it is aligned well
+constexpr std::size_t HEADER_SIZE = (sizeof(void*) * 2 + alignof(std::max_align_t) - 1) /
+	alignof(std::max_align_t) * alignof(std::max_align_t);
+
+Arena::~Arena() {
+	reset();
+}
+
+void Arena::reset() {
+	//Return all blocks
+	while (blocks != nullptr) {
+		BlockHeader* next = blocks->next;
+		if (blocks->pooled)
+			BlockPool::release(blocks);
+		else
+			::operator delete(blocks);
+		blocks = next;
+	}
+
+	current = nullptr;
+	end = nullptr;
+	used = 0;
+}
+
+std::size_t Arena::used_bytes() const {
+	return used;
+}
+
+void* Arena::do_allocate(std::size_t bytes, std::size_t alignment) {
+	//Try to place in the current block
+	std::uintptr_t address = reinterpret_cast<std::uintptr_t>(current);
+	std::uintptr_t aligned = (address + alignment - 1) / alignment * alignment;
+	if (current != nullptr && aligned + bytes <= reinterpret_cast<std::uintptr_t>(end)) {
+		used += aligned + bytes - address;
+		current = reinterpret_cast<char*>(aligned + bytes);
+		return reinterpret_cast<void*>(aligned);
+	}
+
+	//Too big for any block, allocate it separately, but keep the current block
+	if (HEADER_SIZE + bytes + alignment > BlockPool::BLOCK_SIZE) {
+		void* memory = ::operator new(HEADER_SIZE + bytes + alignment);
+		BlockHeader* header = new (memory) BlockHeader { nullptr, false };
+		//Insert after the current block
+		if (blocks != nullptr) {
+			header->next = blocks->next;
+			blocks->next = header;
+		}
+		else {
+			blocks = header;
+		}
+
+		address = reinterpret_cast<std::uintptr_t>(memory) + HEADER_SIZE;
+		aligned = (address + alignment - 1) / alignment * alignment;
+		used += bytes;
+		return reinterpret_cast<void*>(aligned);
+	}
+
+	//Take a new block from the pool
+	void* memory = BlockPool::acquire();
+	blocks = new (memory) BlockHeader { blocks, true };
+	current = static_cast<char*>(memory) + HEADER_SIZE;
+	end = static_cast<char*>(memory) + BlockPool::BLOCK_SIZE;
+
+	address = reinterpret_cast<std::uintptr_t>(current);
+	aligned = (address + alignment - 1) / alignment * alignment;
+	used += aligned + bytes - address;
+	current = reinterpret_cast<char*>(aligned + bytes);
+	return reinterpret_cast<void*>(aligned);
+}
@@ -0,0 +1,58 @@
+/*
+ * PongX arena allocator
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <memory_resource>
+
+///Monotonic allocator for objects with the same lifetime (e.g. UI controls of a page).
+///Takes memory from the BlockPool block by block and places allocations one after another.
+///Deallocation does nothing, all the memory is returned at once by reset() or by the destructor.
+///The owner is responsible for calling destructors of the objects placed in the arena
+class Arena : public std::pmr::memory_resource {
+public:
+	Arena() = default;
+	Arena(const Arena&) = delete;
+	Arena& operator=(const Arena&) = delete;
+	~Arena() override;
+
+	///Return all the memory to the BlockPool. Objects in the arena have to be already destroyed
+	void reset();
+
+	///Get amount of bytes allocated in the arena (including alignment)
+	std::size_t used_bytes() const;
+
+private:
+	///Header of every block (or oversized allocation) owned by the arena
+	struct BlockHeader {
+		BlockHeader* next;
+		///Was the block taken from the BlockPool (or allocated separately because it's too big)?
+		bool pooled;
+	};
+
+	///Blocks owned by the arena, the current one is first
+	BlockHeader* blocks = nullptr;
+	///Free space in the current block
+	char* current = nullptr;
+	char* end = nullptr;
+	std::size_t used = 0;
+
+	void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+	void do_deallocate(void*, std::size_t, std::size_t) override { };
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; };
+};
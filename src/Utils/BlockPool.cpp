@@ -0,0 +1,70 @@
+/*
+ * PongX memory block pool
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <new>
+
+#include "BlockPool.hpp"
+#include "Metrics.hpp"
+
+static MetricCounter cached_block_metric("pongx_block_pool_acquires_total", "Blocks taken from the block pool",
+										 "source=\"cache\"");
+static MetricCounter system_block_metric("pongx_block_pool_acquires_total", "Blocks taken from the block pool",
+										 "source=\"system\"");
+
+//Define static variables
+BlockPool::FreeBlock* BlockPool::free_list = nullptr;
+std::size_t BlockPool::free_count = 0;
+std::mutex BlockPool::mutex;
+
+void* BlockPool::acquire() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (free_list != nullptr) { //Reuse the cached block
+			FreeBlock* block = free_list;
+			free_list = block->next;
+			free_count--;
+			cached_block_metric.add();
+			return block;
+		}
+	}
+
+	//No cached blocks, allocate a new one
+	system_block_metric.add();
+	return ::operator new(BLOCK_SIZE);
+}
+
+void BlockPool::release(void* block) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (free_count < MAX_CACHED_BLOCKS) { //Cache the block
+			FreeBlock* free_block = static_cast<FreeBlock*>(block);
+			free_block->next = free_list;
+			free_list = free_block;
+			free_count++;
+			return;
+		}
+	}
+
+	//Too many cached blocks
+	::operator delete(block);
+}
+
+std::size_t BlockPool::cached_blocks() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return free_count;
+}
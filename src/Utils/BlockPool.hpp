@@ -0,0 +1,51 @@
+/*
+ * PongX memory block pool
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+
+///Static class. Thread-safe pool of fixed-size memory blocks. Released blocks are cached for reuse
+///instead of returning them to the system, so objects that are created and destroyed often
+///(pages, UI controls) don't go to the system allocator after the warmup
+class BlockPool {
+public:
+	///Size of every block in bytes
+	static constexpr std::size_t BLOCK_SIZE = 16384;
+	///Maximal amount of cached free blocks. Blocks released above this limit are freed
+	static constexpr std::size_t MAX_CACHED_BLOCKS = 64;
+
+	///Get a block of BLOCK_SIZE bytes (aligned as max_align_t)
+	static void* acquire();
+	///Return the block obtained by acquire() to the pool
+	static void release(void* block);
+
+	///Get amount of cached free blocks
+	static std::size_t cached_blocks();
+
+private:
+	struct FreeBlock {
+		FreeBlock* next;
+	};
+
+	///Singly linked list of free blocks
+	static FreeBlock* free_list;
+	static std::size_t free_count;
+	static std::mutex mutex;
+};
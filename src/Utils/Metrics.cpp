@@ -0,0 +1,260 @@
+/*
+ * PongX runtime metrics
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Metrics.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+///Slots at the end of the shards for the metrics that did not get their own slots, they are never exported
+static constexpr unsigned int SPARE_SLOTS = MetricHistogram::MAX_BUCKETS + 2;
+
+///Everything the exporter needs. Never destroyed, so the threads that finish after main() can still
+///give their shards back
+struct MetricRegistry {
+	std::mutex mutex;
+	///Shards of the running threads
+	std::vector<MetricShard*> shards;
+	///Sums of the shards of the finished threads
+	std::uint64_t finished[MetricShard::MAX_SLOTS] = { };
+	unsigned int used_slots = 0;
+	std::vector<const Metric*> metrics;
+};
+
+static MetricRegistry& registry() {
+	static MetricRegistry* instance = new MetricRegistry();
+	return *instance;
+}
+
+///Gives the shard of the thread to the registry when the thread finishes
+struct MetricShardOwner {
+	MetricShard* shard;
+
+	~MetricShardOwner() {
+		MetricRegistry& metrics = registry();
+		std::lock_guard<std::mutex> lock(metrics.mutex);
+		for (unsigned int i = 0; i < MetricShard::MAX_SLOTS; i++)
+			metrics.finished[i] += shard->slots[i].load(std::memory_order_relaxed);
+		metrics.shards.erase(std::find(metrics.shards.begin(), metrics.shards.end(), shard));
+		delete shard;
+		//The later records of the thread go to the sums of the finished threads
+		Metrics::shard = nullptr;
+		Metrics::shard_released = true;
+	}
+};
+
+MetricShard* Metrics::register_thread() {
+	if (shard_released)
+		return nullptr;
+	MetricShard* new_shard = new MetricShard();
+	for (std::atomic<std::uint64_t>& slot : new_shard->slots)
+		slot.store(0, std::memory_order_relaxed);
+	{
+		MetricRegistry& metrics = registry();
+		std::lock_guard<std::mutex> lock(metrics.mutex);
+		metrics.shards.push_back(new_shard);
+	}
+
+	thread_local MetricShardOwner owner;
+	owner.shard = new_shard;
+	shard = new_shard;
+	return new_shard;
+}
+
+void Metrics::add_finished(unsigned int slot, std::uint64_t value) {
+	MetricRegistry& metrics = registry();
+	std::lock_guard<std::mutex> lock(metrics.mutex);
+	metrics.finished[slot] += value;
+}
+
+std::uint64_t Metrics::read(unsigned int slot) {
+	MetricRegistry& metrics = registry();
+	std::lock_guard<std::mutex> lock(metrics.mutex);
+	std::uint64_t sum = metrics.finished[slot];
+	for (const MetricShard* thread_shard : metrics.shards)
+		sum += thread_shard->slots[slot].load(std::memory_order_relaxed);
+	return sum;
+}
+
+unsigned int Metrics::reserve_slots(unsigned int count) {
+	MetricRegistry& metrics = registry();
+	std::lock_guard<std::mutex> lock(metrics.mutex);
+	if (metrics.used_slots + count > MetricShard::MAX_SLOTS - SPARE_SLOTS)
+		return MetricShard::MAX_SLOTS - SPARE_SLOTS;
+	metrics.used_slots += count;
+	return metrics.used_slots - count;
+}
+
+void Metrics::register_metric(const Metric* metric) {
+	MetricRegistry& metrics = registry();
+	std::lock_guard<std::mutex> lock(metrics.mutex);
+	metrics.metrics.push_back(metric);
+}
+
+void Metrics::write_prometheus(std::ostream& stream) {
+	std::vector<const Metric*> metrics;
+	{
+		MetricRegistry& metric_registry = registry();
+		std::lock_guard<std::mutex> lock(metric_registry.mutex);
+		metrics = metric_registry.metrics;
+	}
+	//Samples of the same name are written together, under one HELP and TYPE
+	std::stable_sort(metrics.begin(), metrics.end(), [](const Metric* first, const Metric* second) {
+		return std::string(first->get_name()) < second->get_name();
+	});
+
+	std::streamsize precision = stream.precision(12);
+	for (std::size_t i = 0; i < metrics.size(); i++) {
+		if (i == 0 || std::string(metrics[i - 1]->get_name()) != metrics[i]->get_name()) {
+			stream << "# HELP " << metrics[i]->get_name() << ' ' << metrics[i]->get_help() << '\n';
+			stream << "# TYPE " << metrics[i]->get_name() << ' ' << metrics[i]->get_type() << '\n';
+		}
+		metrics[i]->write_samples(stream);
+	}
+	stream.precision(precision);
+}
+
+bool Metrics::write_file(const std::string& path) {
+	std::string temporary_path = path + ".tmp";
+	{
+		std::ofstream file(temporary_path);
+		if (!file)
+			return false;
+		write_prometheus(file);
+		if (!file)
+			return false;
+	}
+	return std::rename(temporary_path.c_str(), path.c_str()) == 0;
+}
+
+Metric::Metric(const char* name, const char* help, const char* labels) {
+	this->name = name;
+	this->help = help;
+	this->labels = labels;
+}
+
+const char* Metric::get_name() const {
+	return name;
+}
+
+const char* Metric::get_help() const {
+	return help;
+}
+
+void Metric::write_sample_name(std::ostream& stream, const char* suffix, const char* label,
+							   const std::string& value) const {
+	stream << name << suffix;
+	bool has_labels = labels[0] != '\0';
+	if (!has_labels && label == nullptr)
+		return;
+
+	stream << '{' << labels;
+	if (label != nullptr)
+		stream << (has_labels ? "," : "") << label << "=\"" << value << '"';
+	stream << '}';
+}
+
+MetricCounter::MetricCounter(const char* name, const char* help, const char* labels) : Metric(name, help, labels) {
+	slot = Metrics::reserve_slots(1);
+	Metrics::register_metric(this);
+}
+
+std::uint64_t MetricCounter::get() const {
+	return Metrics::read(slot);
+}
+
+const char* MetricCounter::get_type() const {
+	return "counter";
+}
+
+void MetricCounter::write_samples(std::ostream& stream) const {
+	write_sample_name(stream, "", nullptr, "");
+	stream << ' ' << get() << '\n';
+}
+
+MetricGauge::MetricGauge(const char* name, const char* help, const char* labels) : Metric(name, help, labels) {
+	Metrics::register_metric(this);
+}
+
+void MetricGauge::add(double difference) {
+	double current = value.load(std::memory_order_relaxed);
+	while (!value.compare_exchange_weak(current, current + difference, std::memory_order_relaxed)) { }
+}
+
+double MetricGauge::get() const {
+	return value.load(std::memory_order_relaxed);
+}
+
+const char* MetricGauge::get_type() const {
+	return "gauge";
+}
+
+void MetricGauge::write_samples(std::ostream& stream) const {
+	write_sample_name(stream, "", nullptr, "");
+	stream << ' ' << get() << '\n';
+}
+
+MetricHistogram::MetricHistogram(const char* name, const char* help, std::initializer_list<std::uint64_t> bounds,
+								 double scale, const char* labels) : Metric(name, help, labels) {
+	bucket_count = 0;
+	for (std::uint64_t bound : bounds)
+		if (bucket_count < MAX_BUCKETS)
+			this->bounds[bucket_count++] = bound;
+	this->scale = scale;
+	first_slot = Metrics::reserve_slots(bucket_count + 2);
+	Metrics::register_metric(this);
+}
+
+std::uint64_t MetricHistogram::get_count() const {
+	std::uint64_t count = 0;
+	for (unsigned int i = 0; i <= bucket_count; i++)
+		count += Metrics::read(first_slot + i);
+	return count;
+}
+
+std::uint64_t MetricHistogram::get_sum() const {
+	return Metrics::read(first_slot + bucket_count + 1);
+}
+
+const char* MetricHistogram::get_type() const {
+	return "histogram";
+}
+
+void MetricHistogram::write_samples(std::ostream& stream) const {
+	//Buckets of the exposition are cumulative
+	std::uint64_t count = 0;
+	for (unsigned int i = 0; i <= bucket_count; i++) {
+		count += Metrics::read(first_slot + i);
+		std::ostringstream bound;
+		bound.precision(12);
+		if (i < bucket_count)
+			bound << static_cast<double>(bounds[i]) * scale;
+		else
+			bound << "+Inf";
+		write_sample_name(stream, "_bucket", "le", bound.str());
+		stream << ' ' << count << '\n';
+	}
+	write_sample_name(stream, "_sum", nullptr, "");
+	stream << ' ' << static_cast<double>(get_sum()) * scale << '\n';
+	write_sample_name(stream, "_count", nullptr, "");
+	stream << ' ' << count << '\n';
+}
@@ -0,0 +1,191 @@
+/*
+ * PongX runtime metrics
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+#include <ostream>
+#include <string>
+
+///Slots of the metrics of one thread. Only the owner thread writes them, so recording is a plain
+///load and store (relaxed atomics only to let the exporter read them at the same time)
+struct MetricShard {
+	///Most slots of all metrics
+	static constexpr unsigned int MAX_SLOTS = 1024;
+
+	std::atomic<std::uint64_t> slots[MAX_SLOTS];
+};
+
+///Static class. Registry of the runtime metrics (counters, gauges and histograms) exported in the Prometheus
+///text format. Every thread records into its own shard, the shards are summed only by the exporter:
+///recording takes a few nanoseconds without locks or shared cache lines, so the metrics are always on
+class Metrics {
+public:
+	///Write every metric in the Prometheus text exposition format (version 0.0.4)
+	static void write_prometheus(std::ostream& stream);
+	///Write the metrics to the file: a temporary file is renamed, so the readers never see a part of it
+	///@returns false if the file can not be written
+	static bool write_file(const std::string& path);
+
+	///Add the value to the slot of the current thread
+	static void add(unsigned int slot, std::uint64_t value) {
+		MetricShard* current = shard;
+		if (current == nullptr && (current = register_thread()) == nullptr) {
+			//The thread is finishing (e.g. a thread_local destructor records) and its shard is given back
+			add_finished(slot, value);
+			return;
+		}
+		std::atomic<std::uint64_t>& counter = current->slots[slot];
+		counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+	}
+
+	///Get the sum of the slot of every thread (including the finished ones)
+	static std::uint64_t read(unsigned int slot);
+
+	///Reserve the slots of the new metric
+	///@returns the first slot (if the slots are over, the slots at the end that nobody reads)
+	static unsigned int reserve_slots(unsigned int count);
+	///Add the metric to the exposition. The metric lives until the end of the program
+	static void register_metric(const class Metric* metric);
+
+private:
+	friend struct MetricShardOwner;
+
+	///Shard of the current thread (nullptr until the thread records something and after it is given back)
+	inline static thread_local MetricShard* shard = nullptr;
+	///Is the shard of the current thread given back to the registry (the thread is finishing)?
+	inline static thread_local bool shard_released = false;
+
+	///Create the shard of the current thread
+	///@returns nullptr if the thread is finishing and its shard is already given back
+	static MetricShard* register_thread();
+	///Add the value straight to the sums of the finished threads
+	static void add_finished(unsigned int slot, std::uint64_t value);
+};
+
+///Base of the metrics: one sample or a group of samples with the same name and labels
+class Metric {
+public:
+	///@param name name of the metric (e.g. pongx_ticks_total). Metrics with the same name differ by the labels
+	///@param help description of the metric
+	///@param labels labels of the sample in the Prometheus format without braces (e.g. segment="4")
+	Metric(const char* name, const char* help, const char* labels);
+	virtual ~Metric() = default;
+
+	const char* get_name() const;
+	const char* get_help() const;
+	///Get the Prometheus type (counter, gauge or histogram)
+	virtual const char* get_type() const = 0;
+	///Write the samples of the metric
+	virtual void write_samples(std::ostream& stream) const = 0;
+
+protected:
+	const char* name;
+	const char* help;
+	const char* labels;
+
+	///Write the name with the labels and one more label (nullptr - no more labels)
+	void write_sample_name(std::ostream& stream, const char* suffix, const char* label,
+						   const std::string& value) const;
+};
+
+///Value that only grows (e.g. ticks, collisions)
+class MetricCounter : public Metric {
+public:
+	MetricCounter(const char* name, const char* help, const char* labels = "");
+
+	void add(std::uint64_t value = 1) {
+		Metrics::add(slot, value);
+	}
+	std::uint64_t get() const;
+
+	const char* get_type() const override;
+	void write_samples(std::ostream& stream) const override;
+
+private:
+	unsigned int slot;
+};
+
+///Value that goes up and down (e.g. amount of spectators). It is set, not summed, so it is one shared atomic
+class MetricGauge : public Metric {
+public:
+	MetricGauge(const char* name, const char* help, const char* labels = "");
+
+	void set(double value) {
+		this->value.store(value, std::memory_order_relaxed);
+	}
+	void add(double difference);
+	double get() const;
+
+	const char* get_type() const override;
+	void write_samples(std::ostream& stream) const override;
+
+private:
+	std::atomic<double> value { 0.0 };
+};
+
+///Distribution of integer values (e.g. durations in nanoseconds) in buckets
+class MetricHistogram : public Metric {
+public:
+	///Most buckets (without the +Inf one)
+	static constexpr unsigned int MAX_BUCKETS = 24;
+
+	///@param bounds upper bounds of the buckets in ascending order
+	///@param scale multiplier of the values in the exposition (e.g. 1e-9 to show nanoseconds as seconds)
+	MetricHistogram(const char* name, const char* help, std::initializer_list<std::uint64_t> bounds,
+					double scale = 1.0, const char* labels = "");
+
+	void record(std::uint64_t value) {
+		unsigned int bucket = 0;
+		while (bucket < bucket_count && value > bounds[bucket])
+			bucket++;
+		Metrics::add(first_slot + bucket, 1);
+		Metrics::add(first_slot + bucket_count + 1, value);
+	}
+	///Get amount of the recorded values
+	std::uint64_t get_count() const;
+	///Get the sum of the recorded values (not scaled)
+	std::uint64_t get_sum() const;
+
+	const char* get_type() const override;
+	void write_samples(std::ostream& stream) const override;
+
+private:
+	std::uint64_t bounds[MAX_BUCKETS];
+	unsigned int bucket_count;
+	double scale;
+	///Slots: a bucket per bound, the +Inf bucket, the sum
+	unsigned int first_slot;
+};
+
+///Records the time from the construction to the destruction into the histogram in nanoseconds
+class MetricTimer {
+public:
+	MetricTimer(MetricHistogram& histogram) : histogram(histogram), start(std::chrono::steady_clock::now()) { }
+	~MetricTimer() {
+		histogram.record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - start).count()));
+	}
+
+private:
+	MetricHistogram& histogram;
+	std::chrono::steady_clock::time_point start;
+};
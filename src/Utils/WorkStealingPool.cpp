@@ -0,0 +1,129 @@
+/*
+ * PongX work-stealing thread pool
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "WorkStealingPool.hpp"
+
+///Pool and index of the worker that runs on the current thread (nullptr if it is not a worker)
+static thread_local const WorkStealingPool* current_pool = nullptr;
+static thread_local unsigned int current_worker = 0;
+
+WorkStealingPool::WorkStealingPool(unsigned int threads) {
+	if (threads == 0)
+		threads = std::max(std::thread::hardware_concurrency(), 1U);
+
+	for (unsigned int i = 0; i < threads; i++)
+		queues.emplace_back(new WorkerQueue());
+	for (unsigned int i = 0; i < threads; i++)
+		workers.emplace_back(&WorkStealingPool::worker_loop, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool() {
+	wait();
+	{
+		std::lock_guard<std::mutex> lock(sleep_mutex);
+		stopping = true;
+	}
+	jobs_added.notify_all();
+	for (std::thread& worker : workers)
+		worker.join();
+}
+
+void WorkStealingPool::submit(std::function<void()> job) {
+	//Own queue for the jobs from the workers, so the related jobs stay on one core
+	unsigned int index = current_pool == this ? current_worker : next_queue++ % queues.size();
+
+	//Counted before the push, so the worker that takes the job at once never decrements below zero
+	pending_jobs++;
+	queued_jobs++;
+	{
+		std::lock_guard<std::mutex> lock(queues[index]->mutex);
+		queues[index]->jobs.push_back(std::move(job));
+	}
+	{
+		std::lock_guard<std::mutex> lock(sleep_mutex); //Not between the check and the sleep of the worker
+	}
+	jobs_added.notify_one();
+}
+
+void WorkStealingPool::wait() {
+	std::unique_lock<std::mutex> lock(sleep_mutex);
+	jobs_done.wait(lock, [this]() { return pending_jobs == 0; });
+}
+
+unsigned int WorkStealingPool::get_thread_count() const {
+	return static_cast<unsigned int>(workers.size());
+}
+
+std::size_t WorkStealingPool::get_steal_count() const {
+	return steal_count;
+}
+
+bool WorkStealingPool::take_job(unsigned int index, std::function<void()>& job) {
+	//The newest job of the own queue: its data is most likely still in the cache
+	{
+		WorkerQueue& queue = *queues[index];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.jobs.empty()) {
+			job = std::move(queue.jobs.back());
+			queue.jobs.pop_back();
+			queued_jobs--;
+			return true;
+		}
+	}
+
+	//The oldest job of another queue, starting from the neighbour so the thieves spread out
+	for (std::size_t offset = 1; offset < queues.size(); offset++) {
+		WorkerQueue& queue = *queues[(index + offset) % queues.size()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.jobs.empty()) {
+			job = std::move(queue.jobs.front());
+			queue.jobs.pop_front();
+			queued_jobs--;
+			steal_count++;
+			return true;
+		}
+	}
+	return false;
+}
+
+void WorkStealingPool::worker_loop(unsigned int index) {
+	current_pool = this;
+	current_worker = index;
+
+	std::function<void()> job;
+	while (true) {
+		if (take_job(index, job)) {
+			job();
+			job = nullptr;
+
+			if (--pending_jobs == 0) {
+				std::lock_guard<std::mutex> lock(sleep_mutex);
+				jobs_done.notify_all();
+			}
+			continue;
+		}
+
+		//Nothing to do: sleep until new jobs come
+		std::unique_lock<std::mutex> lock(sleep_mutex);
+		jobs_added.wait(lock, [this]() { return stopping || queued_jobs != 0; });
+		if (stopping && queued_jobs == 0)
+			return;
+	}
+}
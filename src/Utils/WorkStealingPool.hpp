@@ -0,0 +1,81 @@
+/*
+ * PongX work-stealing thread pool
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+///Thread pool for many independent jobs of different length (e.g. headless matches).
+///Every worker has its own queue: it takes the newest job from it and, when it is empty,
+///steals the oldest job from the queue of another worker. So workers do not fight for one
+///queue and the ones that got short jobs help the others at the end
+class WorkStealingPool {
+public:
+	///@param threads amount of workers, 0 - one per hardware thread
+	WorkStealingPool(unsigned int threads = 0);
+	///Waits for all submitted jobs
+	~WorkStealingPool();
+
+	WorkStealingPool(const WorkStealingPool&) = delete;
+	WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+	///Add the job. Jobs submitted from the workers go to the queue of that worker,
+	///other jobs are spread over the workers round-robin
+	void submit(std::function<void()> job);
+
+	///Wait until every submitted job is done
+	void wait();
+
+	unsigned int get_thread_count() const;
+	///Get amount of jobs taken from the queue of another worker
+	std::size_t get_steal_count() const;
+
+private:
+	struct WorkerQueue {
+		std::mutex mutex;
+		std::deque<std::function<void()>> jobs;
+	};
+
+	std::vector<std::unique_ptr<WorkerQueue>> queues;
+	std::vector<std::thread> workers;
+
+	///Submitted but not finished jobs
+	std::atomic<std::size_t> pending_jobs { 0 };
+	///Jobs that wait in the queues
+	std::atomic<std::size_t> queued_jobs { 0 };
+	std::atomic<std::size_t> steal_count { 0 };
+	std::atomic<unsigned int> next_queue { 0 };
+
+	///Wakes up sleeping workers when there are new jobs, and wait() when all jobs are done
+	std::mutex sleep_mutex;
+	std::condition_variable jobs_added;
+	std::condition_variable jobs_done;
+	bool stopping = false;
+
+	void worker_loop(unsigned int index);
+	///Take a job from the own queue or steal one
+	bool take_job(unsigned int index, std::function<void()>& job);
+};
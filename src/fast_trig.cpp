@@ -0,0 +1,172 @@
+/*
+ * PongX fast trigonometry
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PONGX_FAST_TRIG_SSE2
+#include <emmintrin.h>
+#endif
+
+#include "fast_trig.hpp"
+
+///2 / PI
+constexpr float TWO_OVER_PI = 0.636619772F;
+///PI / 2 split into 3 parts (Cody-Waite), k * PIO2_1 is exact, so the reduction keeps the precision
+constexpr float PIO2_1 = 1.5703125F;
+constexpr float PIO2_2 = 4.837512969970703125e-4F;
+constexpr float PIO2_3 = 7.54978995489188216e-8F;
+constexpr float HALF_PI = 1.57079632679F;
+constexpr float PI = 3.14159265359F;
+
+//Minimax polynomials of sin and cos on [-PI/4;PI/4] (Cephes)
+constexpr float SIN_1 = -1.9515295891e-4F, SIN_2 = 8.3321608736e-3F, SIN_3 = -1.6666654611e-1F;
+constexpr float COS_1 = 2.443315711809948e-5F, COS_2 = -1.388731625493765e-3F, COS_3 = 4.166664568298827e-2F;
+//Least squares polynomial of atan(a) / a by a^2 on [0;1] on the Chebyshev nodes, |error| < 5e-8
+constexpr float ATAN_0 = 0.999999438F, ATAN_1 = -0.333301127F, ATAN_2 = 0.199485769F, ATAN_3 = -0.139161316F;
+constexpr float ATAN_4 = 0.0965706947F, ATAN_5 = -0.0560738817F, ATAN_6 = 0.0219537726F, ATAN_7 = -0.00407522325F;
+
+///Flip the sign of the value if the bit 31 of the mask is set
+static float flip_sign(float value, std::uint32_t mask) {
+	std::uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	bits ^= mask & 0x80000000U;
+	std::memcpy(&value, &bits, sizeof(bits));
+	return value;
+}
+
+void gm::fast_sin_cos(float angle, float& sin, float& cos) {
+	//Nearest multiple of PI/2. Out of the range of int it is INT_MIN, like in SSE2
+	float quarters = angle * TWO_OVER_PI;
+	quarters += quarters < 0.0F ? -0.5F : 0.5F;
+	std::int32_t k = std::abs(quarters) < 2147483648.0F ? static_cast<std::int32_t>(quarters) : INT_MIN;
+	float k_float = static_cast<float>(k);
+
+	//The angle in [-PI/4;PI/4] and the polynomials
+	float r = ((angle - k_float * PIO2_1) - k_float * PIO2_2) - k_float * PIO2_3;
+	float z = r * r;
+	float r_sin = ((SIN_1 * z + SIN_2) * z + SIN_3) * z * r + r;
+	float r_cos = ((COS_1 * z + COS_2) * z + COS_3) * z * z - 0.5F * z + 1.0F;
+
+	//Rotate back by k quarters
+	std::uint32_t quadrant = static_cast<std::uint32_t>(k);
+	bool swap = (quadrant & 1) != 0;
+	sin = flip_sign(swap ? r_cos : r_sin, (quadrant & 2) << 30);
+	cos = flip_sign(swap ? r_sin : r_cos, ((quadrant + 1) & 2) << 30);
+}
+
+float gm::fast_atan2(float y, float x) {
+	float abs_x = std::abs(x), abs_y = std::abs(y);
+	float max = abs_y > abs_x ? abs_y : abs_x;
+	float min = abs_y < abs_x ? abs_y : abs_x;
+	float a = max > 0.0F ? min / max : 0.0F;
+
+	//atan in [0;PI/4] by the polynomial, then to the octant of the vector
+	float s = a * a;
+	float angle = (((((((ATAN_7 * s + ATAN_6) * s + ATAN_5) * s + ATAN_4) * s + ATAN_3) * s + ATAN_2) * s +
+					ATAN_1) * s + ATAN_0) * a;
+	if (abs_y > abs_x)
+		angle = HALF_PI - angle;
+	if (x < 0.0F)
+		angle = PI - angle;
+	std::uint32_t y_bits;
+	std::memcpy(&y_bits, &y, sizeof(y_bits));
+	return flip_sign(angle, y_bits);
+}
+
+#if defined(PONGX_FAST_TRIG_SSE2)
+///Select a where the mask is set, otherwise b
+static __m128 select_mask(__m128 mask, __m128 a, __m128 b) {
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+void gm::fast_sin_cos(const float* angles, float* sin, float* cos, std::size_t count) {
+	const __m128 sign_mask = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(0x80000000U)));
+	const __m128i one = _mm_set1_epi32(1), two = _mm_set1_epi32(2);
+
+	std::size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		//The same operations as the scalar one, lane by lane
+		__m128 angle = _mm_loadu_ps(angles + i);
+		__m128 quarters = _mm_mul_ps(angle, _mm_set1_ps(TWO_OVER_PI));
+		quarters = _mm_add_ps(quarters, _mm_or_ps(_mm_and_ps(quarters, sign_mask), _mm_set1_ps(0.5F)));
+		__m128i k = _mm_cvttps_epi32(quarters);
+		__m128 k_float = _mm_cvtepi32_ps(k);
+
+		__m128 r = _mm_sub_ps(angle, _mm_mul_ps(k_float, _mm_set1_ps(PIO2_1)));
+		r = _mm_sub_ps(r, _mm_mul_ps(k_float, _mm_set1_ps(PIO2_2)));
+		r = _mm_sub_ps(r, _mm_mul_ps(k_float, _mm_set1_ps(PIO2_3)));
+		__m128 z = _mm_mul_ps(r, r);
+
+		__m128 r_sin = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(SIN_1), z), _mm_set1_ps(SIN_2));
+		r_sin = _mm_add_ps(_mm_mul_ps(r_sin, z), _mm_set1_ps(SIN_3));
+		r_sin = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(r_sin, z), r), r);
+		__m128 r_cos = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(COS_1), z), _mm_set1_ps(COS_2));
+		r_cos = _mm_add_ps(_mm_mul_ps(r_cos, z), _mm_set1_ps(COS_3));
+		r_cos = _mm_sub_ps(_mm_mul_ps(_mm_mul_ps(r_cos, z), z), _mm_mul_ps(_mm_set1_ps(0.5F), z));
+		r_cos = _mm_add_ps(r_cos, _mm_set1_ps(1.0F));
+
+		__m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(k, one), one));
+		__m128 sin_sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(k, two), 30));
+		__m128 cos_sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(k, one), two), 30));
+		_mm_storeu_ps(sin + i, _mm_xor_ps(select_mask(swap, r_cos, r_sin), sin_sign));
+		_mm_storeu_ps(cos + i, _mm_xor_ps(select_mask(swap, r_sin, r_cos), cos_sign));
+	}
+	for (; i < count; i++)
+		fast_sin_cos(angles[i], sin[i], cos[i]);
+}
+
+void gm::fast_atan2(const float* y, const float* x, float* angles, std::size_t count) {
+	const __m128 sign_mask = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(0x80000000U)));
+	const __m128 zero = _mm_setzero_ps();
+
+	std::size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m128 cur_y = _mm_loadu_ps(y + i), cur_x = _mm_loadu_ps(x + i);
+		__m128 abs_x = _mm_andnot_ps(sign_mask, cur_x), abs_y = _mm_andnot_ps(sign_mask, cur_y);
+		__m128 max = _mm_max_ps(abs_y, abs_x), min = _mm_min_ps(abs_y, abs_x);
+		__m128 a = _mm_and_ps(_mm_cmpgt_ps(max, zero), _mm_div_ps(min, max));
+
+		__m128 s = _mm_mul_ps(a, a);
+		__m128 angle = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(ATAN_7), s), _mm_set1_ps(ATAN_6));
+		for (float coefficient : { ATAN_5, ATAN_4, ATAN_3, ATAN_2, ATAN_1, ATAN_0 })
+			angle = _mm_add_ps(_mm_mul_ps(angle, s), _mm_set1_ps(coefficient));
+		angle = _mm_mul_ps(angle, a);
+
+		angle = select_mask(_mm_cmpgt_ps(abs_y, abs_x), _mm_sub_ps(_mm_set1_ps(HALF_PI), angle), angle);
+		angle = select_mask(_mm_cmplt_ps(cur_x, zero), _mm_sub_ps(_mm_set1_ps(PI), angle), angle);
+		_mm_storeu_ps(angles + i, _mm_xor_ps(angle, _mm_and_ps(cur_y, sign_mask)));
+	}
+	for (; i < count; i++)
+		angles[i] = fast_atan2(y[i], x[i]);
+}
+#else
+void gm::fast_sin_cos(const float* angles, float* sin, float* cos, std::size_t count) {
+	for (std::size_t i = 0; i < count; i++)
+		fast_sin_cos(angles[i], sin[i], cos[i]);
+}
+
+void gm::fast_atan2(const float* y, const float* x, float* angles, std::size_t count) {
+	for (std::size_t i = 0; i < count; i++)
+		angles[i] = fast_atan2(y[i], x[i]);
+}
+#endif
@@ -0,0 +1,40 @@
+/*
+ * PongX fast trigonometry header
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+///Polynomial trigonometry. Only +, *, / and comparisons in the fixed order (the file is built without
+///-ffast-math and fused multiply-add), so the results are the same on every platform, unlike std::sin().
+///The array functions compute 4 values at once with SSE2 and give exactly the same results as the scalar ones
+namespace gm {
+	///Sine and cosine of the angle in radians. |error| < 1e-7 for |angle| < 8192
+	///@param sin the result (reference)
+	///@param cos the result (reference)
+	void fast_sin_cos(float angle, float& sin, float& cos);
+
+	///Sines and cosines of the array of angles in radians
+	void fast_sin_cos(const float* angles, float* sin, float* cos, std::size_t count);
+
+	///Angle of the vector (x, y) in radians [-PI;PI]. |error| < 3e-7. fast_atan2(0, 0) is 0
+	float fast_atan2(float y, float x);
+
+	///Angles of the arrays of vectors in radians
+	void fast_atan2(const float* y, const float* x, float* angles, std::size_t count);
+}
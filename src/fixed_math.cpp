@@ -0,0 +1,129 @@
+/*
+ * PongX fixed-point math
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+
+#include "fixed_math.hpp"
+
+//Signed right shifts are arithmetic on every supported compiler, CORDIC relies on that
+static_assert((-8 >> 1) == -4, "Arithmetic right shift is required");
+
+///atan(2^-i) in Q16.16, the rotations of CORDIC
+static const fx::Fixed CORDIC_ANGLES[16] = {
+	51472, 30386, 16055, 8150, 4091, 2047, 1024, 512, 256, 128, 64, 32, 16, 8, 4, 2
+};
+///Product of cos(atan(2^-i)): CORDIC grows the vector by its inverse, so the vector starts shorter
+constexpr fx::Fixed CORDIC_GAIN = 39797;
+
+fx::Fixed fx::from_float(float value) {
+	return static_cast<Fixed>(std::lround(value * static_cast<float>(ONE)));
+}
+
+float fx::to_float(Fixed value) {
+	return static_cast<float>(value) / static_cast<float>(ONE);
+}
+
+fx::Fixed fx::mul(Fixed a, Fixed b) {
+	std::int64_t product = static_cast<std::int64_t>(a) * b;
+	return static_cast<Fixed>((product + (ONE >> 1)) >> FRACTION_BITS);
+}
+
+fx::Fixed fx::div(Fixed a, Fixed b) {
+	return static_cast<Fixed>(static_cast<std::int64_t>(a) * ONE / b);
+}
+
+fx::Fixed fx::sqrt(Fixed value) {
+	if (value <= 0)
+		return 0;
+
+	//Integer square root of value * 2^16 is the square root in Q16.16, bit by bit
+	std::uint64_t number = static_cast<std::uint64_t>(value) << FRACTION_BITS;
+	std::uint64_t result = 0;
+	std::uint64_t bit = std::uint64_t(1) << 62;
+	while (bit > number)
+		bit >>= 2;
+	while (bit != 0) {
+		if (number >= result + bit) {
+			number -= result + bit;
+			result = (result >> 1) + bit;
+		} else {
+			result >>= 1;
+		}
+		bit >>= 2;
+	}
+	return static_cast<Fixed>(result);
+}
+
+void fx::sin_cos(Fixed angle, Fixed& sin, Fixed& cos) {
+	//Reduce the angle to [-PI;PI], then to [-PI/2;PI/2] where CORDIC converges
+	angle %= 2 * PI;
+	if (angle > PI)
+		angle -= 2 * PI;
+	else if (angle < -PI)
+		angle += 2 * PI;
+	bool negate = false;
+	if (angle > PI / 2) {
+		angle -= PI;
+		negate = true;
+	} else if (angle < -PI / 2) {
+		angle += PI;
+		negate = true;
+	}
+
+	//Rotate the vector (gain, 0) by the angle with the rotations by atan(2^-i)
+	Fixed x = CORDIC_GAIN, y = 0;
+	for (int i = 0; i < 16; i++) {
+		Fixed next_x;
+		if (angle >= 0) {
+			next_x = x - (y >> i);
+			y += x >> i;
+			angle -= CORDIC_ANGLES[i];
+		} else {
+			next_x = x + (y >> i);
+			y -= x >> i;
+			angle += CORDIC_ANGLES[i];
+		}
+		x = next_x;
+	}
+
+	cos = negate ? -x : x;
+	sin = negate ? -y : y;
+}
+
+fx::Fixed fx::random_number(gm::Randomizer& randomizer, Fixed min, Fixed max) {
+	if (max <= min)
+		return min;
+	//The generator gives 31 bits, the range of the field is less than 2^31 / 2^16
+	std::uint32_t range = static_cast<std::uint32_t>(max - min);
+	return min + static_cast<Fixed>(static_cast<std::uint32_t>(randomizer() - gm::Randomizer::min()) % range);
+}
+
+fx::Fixed fx::random_number_ranges(gm::Randomizer& randomizer, const Fixed* min, const Fixed* max,
+								   unsigned int count) {
+	//One number in the sum of the ranges, then find its range
+	Fixed total = 0;
+	for (unsigned int i = 0; i < count; i++)
+		total += max[i] - min[i];
+	Fixed raw_random = random_number(randomizer, 0, total);
+	for (unsigned int i = 0; i < count; i++) {
+		if (raw_random < max[i] - min[i])
+			return min[i] + raw_random;
+		raw_random -= max[i] - min[i];
+	}
+	return min[count - 1];
+}
@@ -0,0 +1,68 @@
+/*
+ * PongX fixed-point math header
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "game_math.hpp"
+
+///Fixed-point math namespace. Only integer operations, so the results are the same on every machine,
+///compiler and optimization level (unlike std::sin() and friends)
+namespace fx {
+	///Q16.16 number: 16 bits of the integer part and 16 bits of the fraction
+	typedef std::int32_t Fixed;
+
+	constexpr int FRACTION_BITS = 16;
+	constexpr Fixed ONE = 1 << FRACTION_BITS;
+	///PI in Q16.16
+	constexpr Fixed PI = 205887;
+
+	constexpr Fixed from_int(int value) {
+		return static_cast<Fixed>(value) * ONE;
+	}
+
+	///Convert the float (e.g. a setting) to the nearest fixed-point number.
+	///Exact for the same float on every machine
+	Fixed from_float(float value);
+
+	///Convert to float, e.g. for rendering
+	float to_float(Fixed value);
+
+	///Multiply rounding to the nearest
+	Fixed mul(Fixed a, Fixed b);
+
+	///Divide truncating towards zero
+	///@param b divisor (not 0)
+	Fixed div(Fixed a, Fixed b);
+
+	///Square root of the non-negative number (0 for the negative one)
+	Fixed sqrt(Fixed value);
+
+	///Sine and cosine of the angle in radians by CORDIC
+	///@param sin the result (reference)
+	///@param cos the result (reference)
+	void sin_cos(Fixed angle, Fixed& sin, Fixed& cos);
+
+	///Generate a random number in the range [min;max) from the integers of the generator
+	Fixed random_number(gm::Randomizer& randomizer, Fixed min, Fixed max);
+
+	///Generate a random number in the ranges [min;max) of the arrays, every number is equally likely
+	///@param count amount of the ranges
+	Fixed random_number_ranges(gm::Randomizer& randomizer, const Fixed* min, const Fixed* max, unsigned int count);
+}
@@ -16,14 +16,16 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <cmath>
 
+#include "fast_trig.hpp"
 #include "game_math.hpp"
 
-///Thing that takes seed and produces random numbers
-std::mt19937 randomizer;
+///Thing that takes seed and produces random numbers (one per thread, servers may run in parallel)
+thread_local std::mt19937 randomizer;
 ///Is randomizer already initialized?
-bool randomizer_initialized;
+thread_local bool randomizer_initialized = false;
 
 float gm::distance(sf::Vector2f point_1, sf::Vector2f point_2) {
 	return std::sqrt((point_1.x - point_2.x) * (point_1.x - point_2.x) +
@@ -85,23 +87,108 @@ float gm::line_k_from_points(sf::Vector2f point_1, sf::Vector2f point_2) {
 float gm::line_angle_from_points(sf::Vector2f point_1, sf::Vector2f point_2) {
 	float delta_x = point_2.x - point_1.x;
 	float delta_y = point_2.y - point_1.y;
-	return std::atan2(delta_y, delta_x);
+	return fast_atan2(delta_y, delta_x);
 }
 
-float gm::random_number(float min, float max) {
-	if (!randomizer_initialized) { //Initialize randomizer if it is not initialized yet
+float gm::fold_into_range(float value, float min, float max) {
+	// max +---/\----/\---+
+	//     |  /  \  /  \  |  <- Unfolded coordinate goes on, folded one bounces between min and max
+	// min +-/----\/----\-+
+	float span = max - min;
+	if (span <= 0.0F)
+		return min;
+
+	float period = 2.0F * span;
+	float offset = std::fmod(value - min, period);
+	if (offset < 0.0F)
+		offset += period;
+
+	return min + (offset <= span ? offset : period - offset);
+}
+
+///Cosine of the direction below which the ball is considered moving vertically
+constexpr float VERTICAL_EPSILON = 1e-4F;
+///PI constant
+constexpr float PI = 3.14159265359F;
+
+bool gm::predict_ball_path(sf::Vector2f ball_pos, float ball_direction, float ball_speed, float ball_radius,
+						   sf::Vector2u window_size, float target_x, BallPath& path) {
+	float velocity_x, velocity_y;
+	fast_sin_cos(ball_direction, velocity_y, velocity_x);
+
+	float distance_x = target_x - ball_pos.x;
+	if (std::abs(velocity_x) < VERTICAL_EPSILON || (distance_x > 0.0F) != (velocity_x > 0.0F) ||
+		ball_speed <= 0.0F)
+		return false;
+
+	//The ball moves along the straight line as if there are no walls. Every time the unfolded
+	//offset from the top bound passes a multiple of the span, the real ball is reflected
+	float top = ball_radius;
+	float span = window_size.y - 2.0F * ball_radius;
+	float unfolded_offset = ball_pos.y - top + velocity_y * (distance_x / velocity_x);
+
+	path.intercept = { target_x, fold_into_range(unfolded_offset + top, top, top + span) };
+	path.time = distance_x / (velocity_x * ball_speed);
+	path.bounces = span > 0.0F ? static_cast<unsigned int>(std::abs(std::floor(unfolded_offset / span))) : 0;
+	//Every reflection mirrors the direction (see Server::update_ball_movement)
+	path.direction = path.bounces % 2 == 0 ? ball_direction : 2.0F * PI - ball_direction;
+	return true;
+}
+
+unsigned int gm::ball_path_bounce_points(sf::Vector2f ball_pos, float ball_direction, float ball_radius,
+										 sf::Vector2u window_size, float target_x,
+										 sf::Vector2f* points, unsigned int max_points) {
+	BallPath path;
+	if (!predict_ball_path(ball_pos, ball_direction, 1.0F, ball_radius, window_size, target_x, path))
+		return 0;
+
+	float velocity_x, velocity_y;
+	fast_sin_cos(ball_direction, velocity_y, velocity_x);
+	float top = ball_radius;
+	float span = window_size.y - 2.0F * ball_radius;
+	float start_offset = ball_pos.y - top;
+
+	unsigned int count = std::min(path.bounces, max_points);
+	for (unsigned int i = 0; i < count; i++) {
+		//Unfolded offset of the (i + 1)-th reflection: next multiples of the span in the direction of movement
+		float bounce_offset = velocity_y > 0.0F ? (std::floor(start_offset / span) + 1.0F + i) * span :
+												  (std::ceil(start_offset / span) - 1.0F - i) * span;
+		//Starts exactly on the bound and moves into it: the first reflection is here
+		if (velocity_y > 0.0F && start_offset == span)
+			bounce_offset -= span;
+		if (velocity_y < 0.0F && start_offset == 0.0F)
+			bounce_offset += span;
+		float distance = (bounce_offset - start_offset) / velocity_y;
+
+		points[i] = { ball_pos.x + velocity_x * distance, fold_into_range(bounce_offset + top, top, top + span) };
+	}
+	return count;
+}
+
+///Get the global randomizer of this thread, initialize it if it is not initialized yet
+static std::mt19937& global_randomizer() {
+	if (!randomizer_initialized) {
 		std::random_device true_gen; //Get the true random number which used for seed
 		randomizer = std::mt19937(true_gen()); //Seed and initialize our randomizer
+		randomizer_initialized = true;
 	}
+	return randomizer;
+}
+
+///Generate random number in [min;max) with any generator
+template <typename Generator>
+static float random_number_impl(Generator& generator, float min, float max) {
 	//This thing handles raw number from randomizer and turns it into the float in range [min;max)
 	std::uniform_real_distribution<float> distribution(min, max);
-	return distribution(randomizer); //Use distribution and randomizer to generate the number
+	return distribution(generator); //Use distribution and randomizer to generate the number
 }
 
-float gm::random_number_double_range(const float min_1, const float max_1,
-									 const float min_2, const float max_2) {
+///Generate random number in the range [min_1;max_1]&[min_2;max_2) with any generator
+template <typename Generator>
+static float random_number_double_range_impl(Generator& generator, const float min_1, const float max_1,
+											 const float min_2, const float max_2) {
 	float max = (max_1 - min_1) + (max_2 - min_2); //Prepare for number generation
-	float raw_random = random_number(0.0F, max); //Generate raw number
+	float raw_random = random_number_impl(generator, 0.0F, max); //Generate raw number
 
 	//If in first half of the range
 	if (raw_random <= max_1 - min_1)
@@ -110,21 +197,53 @@ float gm::random_number_double_range(const float min_1, const float max_1,
 		return min_2 + raw_random - (max_1 - min_1);
 }
 
-float gm::random_number_triple_range(const float min_1, const float max_1,
-									 const float min_2, const float max_2,
-									 const float min_3, const float max_3) {
+///Generate random number in the range [min_1;max_1]&[min_2;max_2]&[min_3;max_3) with any generator
+template <typename Generator>
+static float random_number_triple_range_impl(Generator& generator, const float min_1, const float max_1,
+											 const float min_2, const float max_2,
+											 const float min_3, const float max_3) {
 	//Compute the sum of deltas
 	float max = (max_1 - min_1) + (max_2 - min_2) + (max_3 - min_3);
 
 	//Generate raw random number
-	float raw_random = random_number(0.0F, max);
+	float raw_random = random_number_impl(generator, 0.0F, max);
 
 	if (raw_random <= max_1 - min_1)
 		return min_1 + raw_random;
 	else if (raw_random <= (max_1 - min_1) + (max_2 - min_2))
-		return min_2 + raw_random;
+		return min_2 + raw_random - (max_1 - min_1);
 	else
-		return min_3 + raw_random;
+		return min_3 + raw_random - (max_1 - min_1) - (max_2 - min_2);
+}
+
+float gm::random_number(float min, float max) {
+	return random_number_impl(global_randomizer(), min, max);
+}
+
+float gm::random_number_double_range(const float min_1, const float max_1,
+									 const float min_2, const float max_2) {
+	return random_number_double_range_impl(global_randomizer(), min_1, max_1, min_2, max_2);
+}
+
+float gm::random_number_triple_range(const float min_1, const float max_1,
+									 const float min_2, const float max_2,
+									 const float min_3, const float max_3) {
+	return random_number_triple_range_impl(global_randomizer(), min_1, max_1, min_2, max_2, min_3, max_3);
+}
+
+float gm::random_number(Randomizer& randomizer, float min, float max) {
+	return random_number_impl(randomizer, min, max);
+}
+
+float gm::random_number_double_range(Randomizer& randomizer, const float min_1, const float max_1,
+									 const float min_2, const float max_2) {
+	return random_number_double_range_impl(randomizer, min_1, max_1, min_2, max_2);
+}
+
+float gm::random_number_triple_range(Randomizer& randomizer, const float min_1, const float max_1,
+									 const float min_2, const float max_2,
+									 const float min_3, const float max_3) {
+	return random_number_triple_range_impl(randomizer, min_1, max_1, min_2, max_2, min_3, max_3);
 }
 
 bool gm::ver_segment_line_intersection(float line_k, float line_b,
@@ -58,6 +58,38 @@ namespace gm {
 	///Compute angle between 0 rad and line from points that lying on it
 	float line_angle_from_points(sf::Vector2f point_1, sf::Vector2f point_2);
 
+	///Reflect the coordinate into the range [min;max] as if it bounced off both bounds.
+	///It is the modular folding with period 2 * (max - min), so any amount of bounces costs the same
+	float fold_into_range(float value, float min, float max);
+
+	///Where and when the ball reaches a vertical line, see predict_ball_path()
+	struct BallPath {
+		///Position of the center of the ball on the line
+		sf::Vector2f intercept;
+		///Direction of the ball on the line in radians
+		float direction;
+		///Time to arrival in ticks (one tick moves the ball by its speed)
+		float time;
+		///Amount of reflections off the top and bottom bounds on the way
+		unsigned int bounces;
+	};
+
+	///Compute in O(1) where and when the ball reaches the vertical line x = target_x,
+	///considering reflections off the top (y = 0) and bottom (y = window_size.y) bounds.
+	///Paddles are not considered
+	///@param path the result (reference)
+	///@returns false if the ball never reaches the line (moves away, vertically or does not move)
+	bool predict_ball_path(sf::Vector2f ball_pos, float ball_direction, float ball_speed, float ball_radius,
+						   sf::Vector2u window_size, float target_x, BallPath& path);
+
+	///Enumerate the points where the center of the ball is reflected on the way to the line x = target_x
+	///@param points the result: array of at least max_points points
+	///@param max_points maximal amount of points to write
+	///@returns amount of written points
+	unsigned int ball_path_bounce_points(sf::Vector2f ball_pos, float ball_direction, float ball_radius,
+										 sf::Vector2u window_size, float target_x,
+										 sf::Vector2f* points, unsigned int max_points);
+
 	///Generates a random number in range [min;max)
 	float random_number(float min, float max);
 
@@ -65,10 +97,27 @@ namespace gm {
 	float random_number_double_range(const float min_1, const float max_1,
 									 const float min_2, const float max_2);
 
+	///Generate random number in the range [min_1;max_1]&[min_2;max_2]&[min_3;max_3)
 	float random_number_triple_range(const float min_1, const float max_1,
 									 const float min_2, const float max_2,
 									 const float min_3, const float max_3);
 
+	///Small and fast generator for things that need their own reproducible sequence (servers, AI).
+	///Functions above use the global generator of the thread that is seeded randomly
+	typedef std::minstd_rand Randomizer;
+
+	///Generates a random number in range [min;max) using the specified generator
+	float random_number(Randomizer& randomizer, float min, float max);
+
+	///Generate random number in the range [min_1;max_1]&[min_2;max_2) using the specified generator
+	float random_number_double_range(Randomizer& randomizer, const float min_1, const float max_1,
+									 const float min_2, const float max_2);
+
+	///Generate random number in the range [min_1;max_1]&[min_2;max_2]&[min_3;max_3) using the specified generator
+	float random_number_triple_range(Randomizer& randomizer, const float min_1, const float max_1,
+									 const float min_2, const float max_2,
+									 const float min_3, const float max_3);
+
 	///Get the intersection point of the specified vertical line segment and line
 	///@param line_k k of the line. k = tan(angle)
 	///@param line_point random point on line
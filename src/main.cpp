@@ -16,8 +16,230 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
 #include "GameManager.hpp"
+#include "Input/JoystickDevice.hpp"
+#include "Input/JoystickSampler.hpp"
+#include "Net/MetricsExporter.hpp"
+#include "Net/SharedMatchChannel.hpp"
+#include "Render/FrameCapture.hpp"
+#include "Render/MatchPainter.hpp"
+#include "Server/PaddleAI.hpp"
+#include "Server/Server.hpp"
+
+static const char* const USAGE =
+	"Usage: pongx_run [options] [arena file]\n"
+	"\n"
+	"Options:\n"
+	"  --headless NAME     simulate a singleplayer match without a window and share it\n"
+	"  --attach NAME       watch the shared match, W and S control its player\n"
+	"  --metrics PORT      serve the metrics at http://127.0.0.1:PORT/metrics\n"
+	"  --metrics-file PATH rewrite the file with the metrics every second\n"
+	"  --no-audio          play without sound\n"
+	"  --joystick DEVICE   move the player by the stick of the joystick\n"
+	"                      (default: /dev/input/js0 if it exists)\n"
+	"  --no-joystick       play with the keyboard only\n"
+	"  --record PATH       write the frames into the .y4m video or the directory of .png files\n"
+	"  --record-policy P   when the encoders are behind: drop (the new frames), drop-old or block\n"
+	"                      (default: drop for the window, block for --headless)\n";
+
+///Set by SIGINT and SIGTERM to stop the headless simulation
+static volatile std::sig_atomic_t stop_requested = 0;
+
+static void request_stop(int) {
+	stop_requested = 1;
+}
+
+///Start reading the stick on its own thread. Its timestamps are on the clock of the window input
+///@param device joystick device, e.g. /dev/input/js0
+///@returns nullptr if there is no such joystick
+static std::unique_ptr<JoystickSampler> start_joystick(const std::string& device) {
+	JoystickSettings settings;
+	settings.clock = GameManager::now;
+	return JoystickSampler::start(LinuxJoystickDevice::open(device), settings);
+}
+
+///Start writing the frames
+///@param path .y4m file or the directory of .png files
+///@returns nullptr if the output can not be created
+static std::unique_ptr<FrameCapture> start_recording(const std::string& path, CapturePolicy policy) {
+	FrameCaptureSettings settings;
+	settings.path = path;
+	bool is_video = path.size() >= 4 && path.compare(path.size() - 4, 4, ".y4m") == 0;
+	settings.format = is_video ? Y4mVideo : PngSequence;
+	settings.policy = policy;
+	std::unique_ptr<FrameCapture> capture = FrameCapture::start(settings);
+	if (!capture)
+		std::cerr << "pongx: can not write " << path << '\n';
+	return capture;
+}
+
+///Simulate the match at 60 ticks per second and publish every tick to the channel. The player is controlled
+///by the attached viewer, or by the AI while there is no viewer
+///@param capture writes every tick drawn by the software renderer (nullptr - no recording)
+static int run_headless(const std::string& name, std::shared_ptr<const ArenaMap> arena,
+						std::unique_ptr<FrameCapture> capture) {
+	std::unique_ptr<SharedMatchChannel> channel = SharedMatchChannel::create(name);
+	if (!channel) {
+		std::cerr << "pongx: can not create the shared memory " << name
+				  << " (is it used by the other simulation?)\n";
+		return 1;
+	}
+
+	ServerSettings settings;
+	settings.server_type = Singleplayer;
+	settings.window_size = { 1280, 720 };
+	settings.arena = std::move(arena);
+	std::unique_ptr<Server> server(Server::create(settings));
+	PaddleAI player_ai(settings.seed + 1);
+	player_ai.set_difficulty(settings.ai_reaction_delay, settings.ai_error);
+	//There is no window, so the frames are drawn in memory
+	std::unique_ptr<SoftwareCanvas> canvas;
+	MatchPainter painter(settings.arena);
+	if (capture)
+		canvas.reset(new SoftwareCanvas(settings.window_size.x, settings.window_size.y));
+
+	std::signal(SIGINT, request_stop);
+	std::signal(SIGTERM, request_stop);
+	MatchSnapshot snapshot;
+	auto next_tick = std::chrono::steady_clock::now();
+	while (stop_requested == 0) {
+		float viewer_speed;
+		if (channel->take_input(viewer_speed)) {
+			server->player_relative_speed = viewer_speed;
+		} else {
+			//Nobody has to press a key to start the rally
+			if (server->is_waiting_for_input())
+				server->serve();
+			server->player_relative_speed = player_ai.update(server->get_player_rect(), server->get_ball_pos(),
+															 server->get_ball_dir(), server->get_ball_radius(),
+															 server->get_window_size());
+		}
+		server->update();
+		server->write_snapshot(snapshot);
+		channel->publish(snapshot);
+		if (capture) {
+			painter.paint(*canvas, snapshot);
+			canvas->render();
+			capture->capture(canvas->get_pixels(), canvas->get_width(), canvas->get_height());
+		}
+
+		next_tick += std::chrono::microseconds(16667);
+		std::this_thread::sleep_until(next_tick);
+	}
+	return 0;
+}
+
+int main(int argc, char** argv) {
+	//pongx [options] [arena file]
+	std::string headless_name, attach_name, metrics_path, arena_path, record_path, record_policy;
+	std::string joystick_device;
+	bool joystick_disabled = false;
+	unsigned long metrics_port = 0;
+	for (int i = 1; i < argc; i++) {
+		bool has_value = i + 1 < argc;
+		if (std::strcmp(argv[i], "--headless") == 0 && has_value) {
+			headless_name = argv[++i];
+		} else if (std::strcmp(argv[i], "--attach") == 0 && has_value) {
+			attach_name = argv[++i];
+		} else if (std::strcmp(argv[i], "--metrics") == 0 && has_value) {
+			metrics_port = std::strtoul(argv[++i], nullptr, 10);
+			if (metrics_port == 0 || metrics_port > 65535) {
+				std::cerr << "pongx: wrong port " << argv[i] << "\n\n" << USAGE;
+				return 1;
+			}
+		} else if (std::strcmp(argv[i], "--metrics-file") == 0 && has_value) {
+			metrics_path = argv[++i];
+		} else if (std::strcmp(argv[i], "--record") == 0 && has_value) {
+			record_path = argv[++i];
+		} else if (std::strcmp(argv[i], "--record-policy") == 0 && has_value) {
+			record_policy = argv[++i];
+			if (record_policy != "drop" && record_policy != "drop-old" && record_policy != "block") {
+				std::cerr << "pongx: unknown policy " << record_policy << "\n\n" << USAGE;
+				return 1;
+			}
+		} else if (std::strcmp(argv[i], "--no-audio") == 0) {
+			GameManager::disable_audio();
+		} else if (std::strcmp(argv[i], "--joystick") == 0 && has_value) {
+			joystick_device = argv[++i];
+		} else if (std::strcmp(argv[i], "--no-joystick") == 0) {
+			joystick_disabled = true;
+		} else if (argv[i][0] != '-' && arena_path.empty()) {
+			arena_path = argv[i];
+		} else {
+			std::cerr << USAGE;
+			return 1;
+		}
+	}
+	if (!headless_name.empty() && !attach_name.empty()) {
+		std::cerr << "pongx: --headless and --attach can not be used together\n\n" << USAGE;
+		return 1;
+	}
+
+	std::unique_ptr<MetricsExporter> metrics_exporter;
+	if (metrics_port != 0 || !metrics_path.empty()) {
+		metrics_exporter = MetricsExporter::start(static_cast<unsigned short>(metrics_port), metrics_path);
+		if (!metrics_exporter) {
+			std::cerr << "pongx: can not listen the port " << metrics_port << '\n';
+			return 1;
+		}
+	}
+
+	std::unique_ptr<FrameCapture> capture;
+	if (!record_path.empty()) {
+		//Nobody waits for the headless frames, so by default none of them is lost
+		CapturePolicy policy = headless_name.empty() ? DropNewFrames : BlockRenderer;
+		if (record_policy == "drop")
+			policy = DropNewFrames;
+		else if (record_policy == "drop-old")
+			policy = DropOldFrames;
+		else if (record_policy == "block")
+			policy = BlockRenderer;
+		capture = start_recording(record_path, policy);
+		if (!capture)
+			return 1;
+	}
+
+	//The window is played with the stick too, if there is one
+	if (headless_name.empty() && !joystick_disabled) {
+		std::unique_ptr<JoystickSampler> joystick =
+			start_joystick(joystick_device.empty() ? "/dev/input/js0" : joystick_device);
+		if (!joystick && !joystick_device.empty()) {
+			std::cerr << "pongx: no joystick " << joystick_device << '\n';
+			return 1;
+		}
+		GameManager::use_joystick(std::move(joystick));
+	}
+
+	if (!attach_name.empty()) {
+		std::unique_ptr<SharedMatchChannel> channel = SharedMatchChannel::attach(attach_name);
+		if (!channel) {
+			std::cerr << "pongx: no shared match " << attach_name << '\n';
+			return 1;
+		}
+		GameManager::attach(std::move(channel));
+		GameManager::record(std::move(capture));
+		return GameManager::start();
+	}
+
+	std::shared_ptr<ArenaMap> arena;
+	if (!arena_path.empty()) {
+		arena = ArenaMap::load(arena_path);
+		if (!arena) {
+			std::cerr << "pongx: " << arena_path << " is not an arena file\n";
+			return 1;
+		}
+	}
+	if (!headless_name.empty())
+		return run_headless(headless_name, arena, std::move(capture));
 
-int main() {
+	GameManager::set_arena(arena);
+	GameManager::record(std::move(capture));
 	return GameManager::start();
 }
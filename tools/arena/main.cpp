@@ -0,0 +1,88 @@
+/*
+ * PongX arena baker
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "../../src/Server/ArenaMap.hpp"
+
+static const char* const USAGE =
+	"Usage: pongx_arena SOURCE OUTPUT\n"
+	"Bakes the text description of the obstacles into the arena file of the game.\n"
+	"\n"
+	"One obstacle per line, # starts a comment:\n"
+	"  rect X1 Y1 X2 Y2 [RADIUS]   rect between the corners, corners rounded by the radius\n"
+	"  circle X Y RADIUS\n"
+	"  segment X1 Y1 X2 Y2 RADIUS  segment thickened by the radius\n";
+
+int main(int argc, char** argv) {
+	if (argc != 3) {
+		std::cerr << USAGE;
+		return 1;
+	}
+
+	std::ifstream source(argv[1]);
+	if (!source) {
+		std::cerr << "pongx_arena: can not open " << argv[1] << '\n';
+		return 1;
+	}
+
+	std::vector<ArenaMap::Obstacle> obstacles;
+	std::string line;
+	for (unsigned int line_number = 1; std::getline(source, line); line_number++) {
+		line = line.substr(0, line.find('#'));
+		std::istringstream stream(line);
+		std::string type;
+		if (!(stream >> type))
+			continue; //Empty line
+
+		ArenaMap::Obstacle obstacle = { };
+		bool valid;
+		if (type == "rect") {
+			obstacle.type = ArenaMap::RoundedRect;
+			valid = static_cast<bool>(stream >> obstacle.x1 >> obstacle.y1 >> obstacle.x2 >> obstacle.y2);
+			if (valid && !(stream >> obstacle.radius))
+				obstacle.radius = 0.0F;
+		} else if (type == "circle") {
+			obstacle.type = ArenaMap::Circle;
+			valid = static_cast<bool>(stream >> obstacle.x1 >> obstacle.y1 >> obstacle.radius);
+			obstacle.x2 = obstacle.x1;
+			obstacle.y2 = obstacle.y1;
+		} else if (type == "segment") {
+			obstacle.type = ArenaMap::Segment;
+			valid = static_cast<bool>(stream >> obstacle.x1 >> obstacle.y1 >> obstacle.x2 >> obstacle.y2
+									  >> obstacle.radius);
+		} else {
+			valid = false;
+		}
+
+		if (!valid || obstacle.radius < 0.0F) {
+			std::cerr << "pongx_arena: " << argv[1] << ':' << line_number << ": invalid obstacle\n\n" << USAGE;
+			return 1;
+		}
+		obstacles.push_back(obstacle);
+	}
+
+	ArenaMap arena(obstacles);
+	if (!arena.save(argv[2])) {
+		std::cerr << "pongx_arena: can not write " << argv[2] << '\n';
+		return 1;
+	}
+	return 0;
+}
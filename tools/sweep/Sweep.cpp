@@ -0,0 +1,384 @@
+/*
+ * PongX parameter sweep
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+
+#include "../../src/Server/PaddleAI.hpp"
+#include "../../src/Utils/WorkStealingPool.hpp"
+#include "Sweep.hpp"
+
+const char* const SWEEP_PARAMETER_NAMES[SweepParameterCount] = {
+	"ball_radius", "ball_speed", "paddle_width", "paddle_height", "ai_reaction_delay", "ai_error"
+};
+
+///Size of the field of the headless matches
+static const sf::Vector2u WINDOW_SIZE(1280, 720);
+///Distance between the paddle and the side of the window
+constexpr float PADDLE_MARGIN = 10.0F;
+
+///Parse the float, the whole string must be the number
+static bool parse_float(const std::string& string, float& value) {
+	char* end = nullptr;
+	value = std::strtof(string.c_str(), &end);
+	return !string.empty() && end == string.c_str() + string.size();
+}
+
+///Parse the unsigned integer, the whole string must be the number
+static bool parse_unsigned(const std::string& string, unsigned long long& value) {
+	char* end = nullptr;
+	value = std::strtoull(string.c_str(), &end, 10);
+	return !string.empty() && string[0] != '-' && end == string.c_str() + string.size();
+}
+
+///Split the string by the separator
+static std::vector<std::string> split(const std::string& string, char separator) {
+	std::vector<std::string> parts;
+	std::size_t begin = 0;
+	while (true) {
+		std::size_t end = string.find(separator, begin);
+		parts.push_back(string.substr(begin, end - begin));
+		if (end == std::string::npos)
+			return parts;
+		begin = end + 1;
+	}
+}
+
+///Mix the numbers into the seed (splitmix64)
+static unsigned int mix_seed(std::uint64_t seed, std::uint64_t a, std::uint64_t b) {
+	std::uint64_t value = seed + a * 0x9E3779B97F4A7C15ULL + b * 0xD1B54A32D192ED03ULL;
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+	value ^= value >> 31;
+	return static_cast<unsigned int>(value);
+}
+
+bool SweepSpec::parse(int argc, const char* const* argv, std::string& error) {
+	//Defaults are the defaults of ServerSettings
+	ServerSettings defaults;
+	const float default_values[SweepParameterCount] = {
+		defaults.ball_radius, defaults.ball_speed, defaults.player_rect.width, defaults.player_rect.height,
+		static_cast<float>(defaults.ai_reaction_delay), defaults.ai_error
+	};
+
+	for (int i = 1; i < argc; i++) {
+		std::string argument = argv[i];
+		//Options with a value
+		bool has_value = i + 1 < argc;
+		std::string value = has_value ? argv[i + 1] : "";
+		unsigned long long number;
+
+		if (argument == "--grid") {
+			random_search = false;
+		} else if (argument == "--random") {
+			if (!has_value || !parse_unsigned(value, number) || number == 0) {
+				error = "--random needs the amount of configurations";
+				return false;
+			}
+			random_search = true;
+			random_count = static_cast<unsigned int>(number);
+			i++;
+		} else if (argument == "--matches" || argument == "--ticks" || argument == "--threads" ||
+				   argument == "--seed") {
+			if (!has_value || !parse_unsigned(value, number)) {
+				error = argument + " needs a number";
+				return false;
+			}
+			if (argument == "--matches")
+				matches = static_cast<unsigned int>(number);
+			else if (argument == "--ticks")
+				ticks = static_cast<unsigned int>(number);
+			else if (argument == "--threads")
+				threads = static_cast<unsigned int>(number);
+			else
+				seed = number;
+			i++;
+		} else if (argument == "--input") {
+			if (value != "ai" && value != "scripted") {
+				error = "--input is ai or scripted";
+				return false;
+			}
+			input = value == "ai" ? AIInput : ScriptedInput;
+			i++;
+		} else if (argument == "--format") {
+			if (value != "csv" && value != "jsonl") {
+				error = "--format is csv or jsonl";
+				return false;
+			}
+			format = value == "csv" ? CSV : JSONL;
+			i++;
+		} else if (argument == "--output") {
+			if (!has_value) {
+				error = "--output needs the path";
+				return false;
+			}
+			output_path = value;
+			i++;
+		} else if (argument == "--arena") {
+			arena = has_value ? ArenaMap::load(value) : nullptr;
+			if (!arena) {
+				error = "--arena needs the path of an arena file";
+				return false;
+			}
+			i++;
+		} else {
+			//parameter=values
+			std::size_t equals = argument.find('=');
+			unsigned int parameter = SweepParameterCount;
+			for (unsigned int j = 0; j < SweepParameterCount; j++) {
+				if (equals != std::string::npos && argument.compare(0, equals, SWEEP_PARAMETER_NAMES[j]) == 0 &&
+					equals == std::string(SWEEP_PARAMETER_NAMES[j]).size())
+					parameter = j;
+			}
+			if (parameter == SweepParameterCount) {
+				error = "unknown argument: " + argument;
+				return false;
+			}
+
+			//min:max[:step] or v1,v2,v3
+			std::string list = argument.substr(equals + 1);
+			std::vector<float>& parameter_values = values[parameter];
+			parameter_values.clear();
+			std::vector<std::string> range = split(list, ':');
+			if (range.size() == 2 || range.size() == 3) {
+				float min, max, step = 0.0F;
+				if (!parse_float(range[0], min) || !parse_float(range[1], max) || max < min ||
+					(range.size() == 3 && (!parse_float(range[2], step) || step <= 0.0F))) {
+					error = "invalid range: " + argument;
+					return false;
+				}
+				if (range.size() == 3) {
+					//Grid values of the range
+					for (unsigned int k = 0; min + k * step <= max + step * 1e-3F; k++)
+						parameter_values.push_back(min + k * step);
+				} else {
+					parameter_values = { min, max };
+				}
+			} else {
+				for (const std::string& part : split(list, ',')) {
+					float number_value;
+					if (!parse_float(part, number_value)) {
+						error = "invalid value: " + argument;
+						return false;
+					}
+					parameter_values.push_back(number_value);
+				}
+			}
+		}
+	}
+
+	//Not specified parameters are fixed
+	for (unsigned int i = 0; i < SweepParameterCount; i++) {
+		if (values[i].empty())
+			values[i] = { default_values[i] };
+	}
+
+	//Values that make no match
+	for (unsigned int i = 0; i < SweepParameterCount; i++) {
+		for (float value : values[i]) {
+			bool valid;
+			switch (i) {
+				case AIReactionDelay:
+				case AIError: {
+					valid = value >= 0.0F;
+					break;
+				}
+				case PaddleHeight: {
+					valid = value > 0.0F && value <= WINDOW_SIZE.y;
+					break;
+				}
+				default: {
+					valid = value > 0.0F;
+					break;
+				}
+			}
+			if (!valid) {
+				error = std::string(SWEEP_PARAMETER_NAMES[i]) + " is out of range: " + std::to_string(value);
+				return false;
+			}
+		}
+	}
+
+	if (matches == 0 || ticks == 0) {
+		error = "--matches and --ticks must be positive";
+		return false;
+	}
+	return true;
+}
+
+std::vector<SweepConfig> SweepSpec::configs() const {
+	std::vector<SweepConfig> result;
+
+	if (random_search) {
+		//Uniform in [first;last] of the values of every parameter
+		gm::Randomizer randomizer(mix_seed(seed, 0, 0));
+		for (unsigned int i = 0; i < random_count; i++) {
+			SweepConfig config;
+			for (unsigned int j = 0; j < SweepParameterCount; j++) {
+				float min = values[j].front(), max = values[j].back();
+				config.values[j] = min < max ? gm::random_number(randomizer, min, max) : min;
+			}
+			result.push_back(config);
+		}
+		return result;
+	}
+
+	//Every combination, the last parameter changes the fastest
+	std::size_t count = 1;
+	for (unsigned int i = 0; i < SweepParameterCount; i++)
+		count *= values[i].size();
+	for (std::size_t index = 0; index < count; index++) {
+		SweepConfig config;
+		std::size_t rest = index;
+		for (unsigned int j = SweepParameterCount; j-- > 0;) {
+			config.values[j] = values[j][rest % values[j].size()];
+			rest /= values[j].size();
+		}
+		result.push_back(config);
+	}
+	return result;
+}
+
+void SweepResult::add(Server& server) {
+	const ServerStats& stats = server.get_stats();
+	matches++;
+	ticks += stats.ticks;
+	player_points += server.get_player_score();
+	enemy_points += server.get_enemy_score();
+	rallies += stats.rallies;
+	rally_hits += stats.rally_hits;
+	longest_rally = std::max(longest_rally, stats.longest_rally);
+	for (unsigned int i = 0; i < 9; i++)
+		segment_collisions[i] += stats.segment_collisions[i];
+	tunneling_events += stats.tunneling_events;
+}
+
+SweepRunner::SweepRunner(const SweepSpec& spec, std::ostream& output) : spec(spec), output(output) {
+
+}
+
+void SweepRunner::run() {
+	std::vector<SweepConfig> configs = spec.configs();
+	std::unique_ptr<ConfigState[]> states(new ConfigState[configs.size()]);
+
+	write_header();
+
+	//One job per match: jobs of one configuration may be played by different workers
+	WorkStealingPool pool(spec.threads);
+	for (unsigned int i = 0; i < configs.size(); i++) {
+		states[i].config = configs[i];
+		states[i].matches_left = spec.matches;
+		for (unsigned int j = 0; j < spec.matches; j++) {
+			ConfigState* state = &states[i];
+			pool.submit([this, state, i, j]() { play_match(*state, i, j); });
+		}
+	}
+	pool.wait();
+}
+
+void SweepRunner::play_match(ConfigState& state, unsigned int config_index, unsigned int match_index) {
+	const float* values = state.config.values;
+
+	ServerSettings settings;
+	settings.server_type = Singleplayer;
+	settings.window_size = WINDOW_SIZE;
+	settings.ball_radius = values[BallRadius];
+	settings.ball_speed = values[BallSpeed];
+	settings.ai_reaction_delay = static_cast<unsigned int>(values[AIReactionDelay]);
+	settings.ai_error = values[AIError];
+	settings.seed = mix_seed(spec.seed, config_index + 1, match_index);
+	settings.arena = spec.arena;
+	//Paddles at the sides, in the middle
+	sf::Vector2f paddle_size(values[PaddleWidth], values[PaddleHeight]);
+	float paddle_top = (WINDOW_SIZE.y - paddle_size.y) * 0.5F;
+	settings.player_rect = sf::FloatRect({ PADDLE_MARGIN, paddle_top }, paddle_size);
+	settings.enemy_rect = sf::FloatRect({ WINDOW_SIZE.x - PADDLE_MARGIN - paddle_size.x, paddle_top }, paddle_size);
+
+	std::unique_ptr<Server> server(Server::create(settings));
+	PaddleAI player_ai(settings.seed + 1);
+	player_ai.set_difficulty(settings.ai_reaction_delay, settings.ai_error);
+	float phase = static_cast<float>(settings.seed % 628) * 0.01F;
+
+	for (unsigned int tick = 0; tick < spec.ticks; tick++) {
+		if (spec.input == AIInput) {
+			server->player_relative_speed = player_ai.update(server->get_player_rect(), server->get_ball_pos(),
+															 server->get_ball_dir(), server->get_ball_radius(),
+															 server->get_window_size());
+		} else {
+			server->player_relative_speed = std::sin(tick * 0.02F + phase);
+		}
+
+		//Nobody waits for the input in the headless match
+		if (server->is_waiting_for_input()) {
+			server->serve();
+			player_ai.reset();
+		}
+		server->update();
+	}
+
+	//Add the match to the configuration, the last match writes the result
+	{
+		std::lock_guard<std::mutex> lock(state.mutex);
+		state.result.add(*server);
+	}
+	if (--state.matches_left == 0)
+		write_result(config_index, state);
+}
+
+void SweepRunner::write_header() {
+	if (spec.format != CSV)
+		return;
+
+	output << "config";
+	for (const char* name : SWEEP_PARAMETER_NAMES)
+		output << ',' << name;
+	output << ",matches,ticks,player_points,enemy_points,rallies,mean_rally_hits,longest_rally";
+	for (unsigned int i = 1; i < 9; i++)
+		output << ",segment_" << i;
+	output << ",tunneling_events" << std::endl;
+}
+
+void SweepRunner::write_result(unsigned int config_index, const ConfigState& state) {
+	const SweepResult& result = state.result;
+	double mean_rally_hits = result.rallies != 0 ? static_cast<double>(result.rally_hits) / result.rallies : 0.0;
+
+	std::lock_guard<std::mutex> lock(output_mutex);
+	if (spec.format == CSV) {
+		output << config_index;
+		for (float value : state.config.values)
+			output << ',' << value;
+		output << ',' << result.matches << ',' << result.ticks << ',' << result.player_points << ','
+			<< result.enemy_points << ',' << result.rallies << ',' << mean_rally_hits << ','
+			<< result.longest_rally;
+		for (unsigned int i = 1; i < 9; i++)
+			output << ',' << result.segment_collisions[i];
+		output << ',' << result.tunneling_events << std::endl;
+	} else {
+		output << "{\"config\":" << config_index << ",\"parameters\":{";
+		for (unsigned int i = 0; i < SweepParameterCount; i++)
+			output << (i != 0 ? "," : "") << '"' << SWEEP_PARAMETER_NAMES[i] << "\":" << state.config.values[i];
+		output << "},\"matches\":" << result.matches << ",\"ticks\":" << result.ticks
+			<< ",\"player_points\":" << result.player_points << ",\"enemy_points\":" << result.enemy_points
+			<< ",\"rallies\":" << result.rallies << ",\"mean_rally_hits\":" << mean_rally_hits
+			<< ",\"longest_rally\":" << result.longest_rally << ",\"segment_collisions\":[";
+		for (unsigned int i = 1; i < 9; i++)
+			output << (i != 1 ? "," : "") << result.segment_collisions[i];
+		output << "],\"tunneling_events\":" << result.tunneling_events << '}' << std::endl;
+	}
+}
@@ -0,0 +1,127 @@
+/*
+ * PongX parameter sweep
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "../../src/Server/Server.hpp"
+
+///Parameters of the match that can be swept
+enum SweepParameter : unsigned char {
+	BallRadius, BallSpeed, PaddleWidth, PaddleHeight, AIReactionDelay, AIError, SweepParameterCount
+};
+
+///Names of the parameters on the command line and in the output
+extern const char* const SWEEP_PARAMETER_NAMES[SweepParameterCount];
+
+///One configuration of the matches
+struct SweepConfig {
+	float values[SweepParameterCount];
+};
+
+///What the player does in the headless matches
+enum SweepInput : unsigned char {
+	///The player is controlled by PaddleAI with the same difficulty as the enemy
+	AIInput,
+	///The player moves up and down by a fixed pattern
+	ScriptedInput
+};
+
+enum SweepFormat : unsigned char {
+	CSV, JSONL
+};
+
+///What to sweep and how, parsed from the command line
+struct SweepSpec {
+	///Values of every parameter: the list of values for the grid search,
+	///or the range [first;second] for the random search
+	std::vector<float> values[SweepParameterCount];
+	///Is it the random search? Otherwise every combination of the values is played
+	bool random_search = false;
+	///Amount of configurations of the random search
+	unsigned int random_count = 0;
+
+	unsigned int matches = 16;
+	unsigned int ticks = 20000;
+	SweepInput input = AIInput;
+	SweepFormat format = CSV;
+	std::string output_path;
+	///Static obstacles of the field of every match (nullptr - the empty field)
+	std::shared_ptr<const ArenaMap> arena;
+	///0 - one per hardware thread
+	unsigned int threads = 0;
+	std::uint64_t seed = 1;
+
+	///Parse the command line
+	///@param error the result: description of the problem (reference)
+	///@returns false if the arguments are invalid or a value can not be played (e.g. the paddle is higher
+	///than the field)
+	bool parse(int argc, const char* const* argv, std::string& error);
+
+	///Build the list of configurations to play
+	std::vector<SweepConfig> configs() const;
+};
+
+///Aggregated statistics of all matches of one configuration
+struct SweepResult {
+	unsigned int matches = 0;
+	unsigned long long ticks = 0;
+	unsigned long long player_points = 0, enemy_points = 0;
+	unsigned long long rallies = 0, rally_hits = 0;
+	unsigned int longest_rally = 0;
+	unsigned long long segment_collisions[9] = { };
+	unsigned long long tunneling_events = 0;
+
+	///Add the statistics of one match
+	void add(Server& server);
+};
+
+///Plays every configuration of the spec on a WorkStealingPool and streams the results
+class SweepRunner {
+public:
+	SweepRunner(const SweepSpec& spec, std::ostream& output);
+
+	///Play everything and write the results (one line per configuration, in order of completion)
+	void run();
+
+private:
+	///State of the configuration while its matches are played
+	struct ConfigState {
+		SweepConfig config;
+		SweepResult result;
+		std::mutex mutex;
+		///Matches left to play, the last one writes the result
+		std::atomic<unsigned int> matches_left;
+	};
+
+	const SweepSpec& spec;
+	std::ostream& output;
+	std::mutex output_mutex;
+
+	///Play one headless match
+	void play_match(ConfigState& state, unsigned int config_index, unsigned int match_index);
+	void write_header();
+	void write_result(unsigned int config_index, const ConfigState& state);
+};
@@ -0,0 +1,65 @@
+/*
+ * PongX parameter sweep
+ * Copyright (C) 2021  Artem Kliminskyi <artemklim50@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <fstream>
+#include <iostream>
+
+#include "Sweep.hpp"
+
+static const char* const USAGE =
+	"Usage: pongx_sweep [options] [parameter=values]...\n"
+	"Plays headless singleplayer matches for every configuration and prints statistics per configuration.\n"
+	"\n"
+	"Parameters: ball_radius, ball_speed, paddle_width, paddle_height, ai_reaction_delay, ai_error\n"
+	"  name=v1,v2,v3      values of the grid search\n"
+	"  name=min:max:step  range of the grid search\n"
+	"  name=min:max       range of the random search\n"
+	"\n"
+	"Options:\n"
+	"  --grid             play every combination of the values (default)\n"
+	"  --random N         play N random configurations\n"
+	"  --matches N        matches per configuration (default 16)\n"
+	"  --ticks N          ticks per match (default 20000)\n"
+	"  --input ai|scripted  what controls the player (default ai)\n"
+	"  --format csv|jsonl (default csv)\n"
+	"  --output PATH      write to the file instead of the standard output\n"
+	"  --arena PATH       play on the arena file made by pongx_arena\n"
+	"  --threads N        worker threads (default: one per hardware thread)\n"
+	"  --seed N           seed of the matches and the random search (default 1)\n";
+
+int main(int argc, char** argv) {
+	SweepSpec spec;
+	std::string error;
+	if (!spec.parse(argc, argv, error)) {
+		std::cerr << "pongx_sweep: " << error << "\n\n" << USAGE;
+		return 1;
+	}
+
+	std::ofstream file;
+	if (!spec.output_path.empty()) {
+		file.open(spec.output_path);
+		if (!file) {
+			std::cerr << "pongx_sweep: can not open " << spec.output_path << '\n';
+			return 1;
+		}
+	}
+
+	SweepRunner runner(spec, spec.output_path.empty() ? std::cout : file);
+	runner.run();
+	return 0;
+}
@@ -0,0 +1,164 @@
+/*
+ * PongX arena tests
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+#include "macros.hpp"
+#include "../src/Server/ArenaMap.hpp"
+#include "../src/Server/Server.hpp"
+
+///Random obstacles of every type over the field
+std::vector<ArenaMap::Obstacle> random_obstacles(unsigned int count, unsigned int seed) {
+	gm::Randomizer randomizer(seed);
+	std::vector<ArenaMap::Obstacle> obstacles;
+	for (unsigned int i = 0; i < count; i++) {
+		float x = gm::random_number(randomizer, 0.0F, 1280.0F), y = gm::random_number(randomizer, 0.0F, 720.0F);
+		float size = gm::random_number(randomizer, 5.0F, 40.0F);
+		ArenaMap::Obstacle obstacle = { static_cast<std::uint32_t>(i % 3), x, y, x, y, size };
+		if (obstacle.type == ArenaMap::RoundedRect) {
+			obstacle.x2 = x + size * 2.0F;
+			obstacle.y2 = y + size;
+			obstacle.radius = size * 0.25F;
+		} else if (obstacle.type == ArenaMap::Segment) {
+			obstacle.x2 = x + gm::random_number(randomizer, -60.0F, 60.0F);
+			obstacle.y2 = y + gm::random_number(randomizer, -60.0F, 60.0F);
+			obstacle.radius = size * 0.2F;
+		}
+		obstacles.push_back(obstacle);
+	}
+	return obstacles;
+}
+
+///Deepest overlap of the ball by checking every obstacle
+float brute_force_depth(const ArenaMap& arena, sf::Vector2f ball_pos, float ball_radius) {
+	float depth = 0.0F;
+	for (unsigned int i = 0; i < arena.get_obstacle_count(); i++) {
+		sf::Vector2f normal;
+		depth = std::max(depth, ball_radius - ArenaMap::obstacle_distance(arena.get_obstacle(i), ball_pos, normal));
+	}
+	return depth;
+}
+
+TEST(arena_map, distances) {
+	sf::Vector2f normal;
+	ArenaMap::Obstacle circle = { ArenaMap::Circle, 100.0F, 100.0F, 100.0F, 100.0F, 10.0F };
+	EXPECT_FLOAT_EQ(ArenaMap::obstacle_distance(circle, { 100.0F, 130.0F }, normal), 20.0F);
+	sf::Vector2f down(0.0F, 1.0F);
+	EXPECT_NEAR_V2(normal, down, 1e-6F);
+
+	ArenaMap::Obstacle segment = { ArenaMap::Segment, 0.0F, 0.0F, 100.0F, 0.0F, 5.0F };
+	EXPECT_FLOAT_EQ(ArenaMap::obstacle_distance(segment, { 50.0F, -20.0F }, normal), 15.0F);
+	EXPECT_FLOAT_EQ(ArenaMap::obstacle_distance(segment, { 110.0F, 0.0F }, normal), 5.0F);
+	EXPECT_FLOAT_EQ(ArenaMap::obstacle_distance(segment, { 50.0F, 2.0F }, normal), -3.0F);
+
+	ArenaMap::Obstacle rect = { ArenaMap::RoundedRect, 0.0F, 0.0F, 100.0F, 50.0F, 10.0F };
+	EXPECT_FLOAT_EQ(ArenaMap::obstacle_distance(rect, { 50.0F, 60.0F }, normal), 10.0F);
+	EXPECT_FLOAT_EQ(ArenaMap::obstacle_distance(rect, { 95.0F, 25.0F }, normal), -5.0F);
+	sf::Vector2f right(1.0F, 0.0F);
+	EXPECT_NEAR_V2(normal, right, 1e-6F);
+	//The rounded corner is farther than the sharp one
+	EXPECT_NEAR(ArenaMap::obstacle_distance(rect, { -10.0F, -10.0F }, normal), std::sqrt(800.0F) - 10.0F, 1e-4F);
+}
+
+TEST(arena_map, query_matches_brute_force) {
+	ArenaMap arena(random_obstacles(1000, 7));
+	ASSERT_EQ(arena.get_obstacle_count(), 1000U);
+
+	gm::Randomizer randomizer(8);
+	unsigned int contacts = 0;
+	for (unsigned int i = 0; i < 5000; i++) {
+		sf::Vector2f ball_pos(gm::random_number(randomizer, 0.0F, 1280.0F),
+							  gm::random_number(randomizer, 0.0F, 720.0F));
+		ArenaMap::Contact contact;
+		float expected_depth = brute_force_depth(arena, ball_pos, 10.0F);
+		bool touched = arena.query(ball_pos, 10.0F, contact);
+		ASSERT_EQ(touched, expected_depth > 0.0F);
+		if (touched) {
+			EXPECT_FLOAT_EQ(contact.depth, expected_depth);
+			contacts++;
+		}
+	}
+	//The test is meaningful only if the balls hit something
+	EXPECT_GT(contacts, 500U);
+}
+
+TEST(arena_map, file) {
+	ArenaMap arena(random_obstacles(100, 9));
+	std::string path = ::testing::TempDir() + "pongx_arena_test.pxa";
+	ASSERT_TRUE(arena.save(path));
+
+	std::shared_ptr<ArenaMap> loaded = ArenaMap::load(path);
+	ASSERT_NE(loaded, nullptr);
+	ASSERT_EQ(loaded->get_obstacle_count(), arena.get_obstacle_count());
+	for (float x = 0.0F; x < 1280.0F; x += 37.0F) {
+		for (float y = 0.0F; y < 720.0F; y += 23.0F) {
+			//A miss leaves the contact as it is
+			ArenaMap::Contact expected = { }, actual = { };
+			ASSERT_EQ(loaded->query({ x, y }, 15.0F, actual), arena.query({ x, y }, 15.0F, expected));
+			EXPECT_EQ(actual.obstacle, expected.obstacle);
+		}
+	}
+
+	//Not an arena
+	std::ofstream(path, std::ios::binary) << "PXAR but not really";
+	EXPECT_EQ(ArenaMap::load(path), nullptr);
+	std::remove(path.c_str());
+	EXPECT_EQ(ArenaMap::load(path), nullptr);
+}
+
+///Server without paddles on the arena
+class ArenaServer : public Server {
+public:
+	ArenaServer(std::shared_ptr<const ArenaMap> arena, sf::Vector2f ball_pos, float ball_direction)
+		: Server({ 1280, 720 }) {
+		this->arena = arena;
+		this->ball_pos = ball_pos;
+		this->ball_direction = ball_direction;
+		ball_speed = 5.0F;
+		ball_radius = 10.0F;
+		player_rect = enemy_rect = sf::FloatRect({ -10000.0F, 0.0F }, { 1.0F, 1.0F });
+		waiting_for_input = false;
+	}
+
+	void update() override {
+		internal_update();
+	}
+};
+
+TEST(arena_map, server_reflects_ball) {
+	//Wall across the field: the ball comes back
+	std::shared_ptr<ArenaMap> wall(new ArenaMap({ { ArenaMap::RoundedRect, 900.0F, 0.0F, 920.0F, 720.0F, 0.0F } }));
+	ArenaServer server(wall, { 640.0F, 360.0F }, 0.2F);
+	for (unsigned int i = 0; i < 200; i++) {
+		server.update();
+		EXPECT_LE(server.get_ball_pos().x, 890.0F + 1e-3F);
+	}
+	EXPECT_LT(std::cos(server.get_ball_dir()), 0.0F);
+	EXPECT_NEAR(std::sin(server.get_ball_dir()), std::sin(0.2F), 1e-4F);
+
+	//Circle hit in the center: the ball goes straight back
+	std::shared_ptr<ArenaMap> circle(new ArenaMap({ { ArenaMap::Circle, 800.0F, 360.0F, 800.0F, 360.0F, 30.0F } }));
+	ArenaServer circle_server(circle, { 640.0F, 360.0F }, 0.0F);
+	for (unsigned int i = 0; i < 60; i++)
+		circle_server.update();
+	EXPECT_NEAR(std::cos(circle_server.get_ball_dir()), -1.0F, 1e-4F);
+}
@@ -0,0 +1,189 @@
+/*
+ * PongX audio engine tests
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../src/Audio/AudioEngine.hpp"
+
+static AudioCommand play_command(unsigned int sound, float gain, float pan) {
+	return { 0, sound, gain, pan, PlaySound };
+}
+
+TEST(audio_engine, mixer_gain_and_pan) {
+	std::vector<std::int16_t> samples(200);
+	for (unsigned int i = 0; i < samples.size(); i++)
+		samples[i] = static_cast<std::int16_t>(i * 100);
+	std::shared_ptr<SoundBank> bank = std::make_shared<SoundBank>();
+	unsigned int sound = bank->add(samples.data(), samples.size());
+
+	AudioMixer mixer(bank);
+	mixer.execute(play_command(sound, 0.5F, 0.0F));
+	mixer.execute(play_command(sound, 1.0F, 1.0F));
+	EXPECT_EQ(2u, mixer.get_active_voices());
+
+	std::int16_t frames[2 * 128];
+	unsigned int played = 0;
+	for (unsigned int period = 0; period < 2; period++) {
+		mixer.mix(frames, 128);
+		for (unsigned int i = 0; i < 128; i++, played++) {
+			std::int16_t sample = played < samples.size() ? samples[played] : 0;
+			//The center voice is in both channels, the right one only in the right channel
+			EXPECT_EQ(sample / 2, frames[2 * i]);
+			EXPECT_EQ(sample / 2 + sample, frames[2 * i + 1]);
+		}
+	}
+	//The finished voices are released
+	EXPECT_EQ(0u, mixer.get_active_voices());
+}
+
+TEST(audio_engine, mixer_saturates) {
+	std::vector<std::int16_t> samples(64, 30000);
+	std::shared_ptr<SoundBank> bank = std::make_shared<SoundBank>();
+	unsigned int sound = bank->add(samples.data(), samples.size());
+
+	AudioMixer mixer(bank);
+	for (unsigned int i = 0; i < 4; i++)
+		mixer.execute(play_command(sound, 1.0F, 0.0F));
+	std::int16_t frames[2 * 64];
+	mixer.mix(frames, 64);
+	for (std::int16_t frame : frames)
+		EXPECT_EQ(32767, frame);
+}
+
+TEST(audio_engine, mixer_voice_limit) {
+	std::vector<std::int16_t> samples(1000, 100);
+	std::shared_ptr<SoundBank> bank = std::make_shared<SoundBank>();
+	unsigned int short_sound = bank->add(samples.data(), 10);
+	unsigned int long_sound = bank->add(samples.data(), samples.size());
+
+	AudioMixer mixer(bank);
+	mixer.execute(play_command(short_sound, 1.0F, 0.0F));
+	for (unsigned int i = 1; i < AudioMixer::MAX_VOICES; i++)
+		mixer.execute(play_command(long_sound, 1.0F, 0.0F));
+	EXPECT_EQ(AudioMixer::MAX_VOICES, mixer.get_active_voices());
+	EXPECT_EQ(0u, mixer.get_stolen_voices());
+
+	//The short sound is the closest to its end, so the new sound takes its voice
+	mixer.execute(play_command(long_sound, 1.0F, 0.0F));
+	EXPECT_EQ(AudioMixer::MAX_VOICES, mixer.get_active_voices());
+	EXPECT_EQ(1u, mixer.get_stolen_voices());
+	std::int16_t frames[2 * 16];
+	mixer.mix(frames, 16);
+	EXPECT_EQ(AudioMixer::MAX_VOICES, mixer.get_active_voices());
+	EXPECT_EQ(100 * static_cast<int>(AudioMixer::MAX_VOICES), frames[30]);
+
+	//Unknown sounds are ignored
+	mixer.execute(play_command(7, 1.0F, 0.0F));
+	EXPECT_EQ(1u, mixer.get_stolen_voices());
+	mixer.execute({ 0, 0, 0.0F, 0.0F, StopAllSounds });
+	EXPECT_EQ(0u, mixer.get_active_voices());
+}
+
+TEST(audio_engine, command_queue) {
+	AudioCommandQueue queue(4);
+	for (unsigned int i = 0; i < 4; i++)
+		EXPECT_TRUE(queue.push(play_command(i, 1.0F, 0.0F)));
+	EXPECT_FALSE(queue.push(play_command(4, 1.0F, 0.0F)));
+
+	AudioCommand command;
+	for (unsigned int i = 0; i < 4; i++) {
+		ASSERT_TRUE(queue.pop(command));
+		EXPECT_EQ(i, command.sound);
+	}
+	EXPECT_FALSE(queue.pop(command));
+	EXPECT_TRUE(queue.push(play_command(5, 1.0F, 0.0F)));
+}
+
+///Wait until the mixer takes the commands
+static bool wait_started(const AudioEngine& engine, std::uint64_t count) {
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (engine.get_started_sounds() < count) {
+		if (std::chrono::steady_clock::now() > deadline)
+			return false;
+		std::this_thread::sleep_for(std::chrono::microseconds(100));
+	}
+	return true;
+}
+
+TEST(audio_engine, offline_device) {
+	std::shared_ptr<SoundBank> bank = std::make_shared<SoundBank>();
+	unsigned int tone = bank->add_tone(440.0F, 0.1F, 0.5F, 3.0F);
+	NullAudioDevice* device = new NullAudioDevice(false);
+	std::unique_ptr<AudioEngine> engine = AudioEngine::start(bank, std::unique_ptr<AudioDevice>(device));
+	ASSERT_NE(nullptr, engine);
+
+	auto start = std::chrono::steady_clock::now();
+	for (unsigned int i = 0; i < 100; i++)
+		EXPECT_TRUE(engine->play(tone, 1.0F, 0.0F));
+	ASSERT_TRUE(wait_started(*engine, 100));
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	//The offline device does not wait for the playback
+	EXPECT_GT(static_cast<double>(engine->get_mixed_frames()), 2 * 48000 * seconds);
+	EXPECT_GT(device->get_peak(), 10000);
+	EXPECT_EQ(0u, engine->get_dropped_commands());
+	EXPECT_EQ(100u - AudioMixer::MAX_VOICES, engine->get_stolen_voices());
+}
+
+TEST(audio_engine, realtime_latency) {
+	std::shared_ptr<SoundBank> bank = std::make_shared<SoundBank>();
+	unsigned int tone = bank->add_tone(880.0F, 0.05F, 0.5F, 5.0F);
+	std::unique_ptr<AudioEngine> engine = AudioEngine::start(bank, std::unique_ptr<AudioDevice>(
+		new NullAudioDevice(true)));
+	ASSERT_NE(nullptr, engine);
+
+	for (unsigned int i = 0; i < 20; i++) {
+		engine->play(tone, 1.0F, 0.0F);
+		std::this_thread::sleep_for(std::chrono::milliseconds(3));
+	}
+	ASSERT_TRUE(wait_started(*engine, 20));
+
+	//At most a period waiting for the mixer and a period playing, 2.7 ms each. It holds for the null device
+	//only: the SFML stream buffers several periods of at least 10 ms
+	EXPECT_LT(engine->get_max_latency(), sf::milliseconds(10));
+	EXPECT_GE(engine->get_mean_latency(), engine->get_device().get_buffered_time());
+}
+
+///Offline device that needs the periods as long as the SFML stream does at 48 kHz
+class LongPeriodDevice : public NullAudioDevice {
+public:
+	LongPeriodDevice() : NullAudioDevice(false) { }
+
+	unsigned int get_min_period(unsigned int) const override {
+		return 512;
+	}
+};
+
+TEST(audio_engine, device_min_period) {
+	std::shared_ptr<SoundBank> bank = std::make_shared<SoundBank>();
+	std::unique_ptr<AudioEngine> engine = AudioEngine::start(bank, std::unique_ptr<AudioDevice>(
+		new LongPeriodDevice()));
+	ASSERT_NE(nullptr, engine);
+	EXPECT_EQ(512u, engine->get_period());
+
+	//The period asked for is used if it is long enough
+	std::unique_ptr<AudioEngine> long_engine = AudioEngine::start(bank, std::unique_ptr<AudioDevice>(
+		new LongPeriodDevice()), 1024);
+	ASSERT_NE(nullptr, long_engine);
+	EXPECT_EQ(1024u, long_engine->get_period());
+}
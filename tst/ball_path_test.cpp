@@ -0,0 +1,153 @@
+/*
+ * PongX ball path prediction unit test
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include "macros.hpp"
+#include "../src/game_math.hpp"
+#include "../src/Server/Server.hpp"
+
+///Server without paddles where the ball can be placed anywhere
+class BallOnlyServer : public Server {
+public:
+	BallOnlyServer(sf::Vector2u window_size, sf::Vector2f ball_pos, float ball_direction, float ball_speed,
+				   float ball_radius) : Server(window_size) {
+		this->ball_pos = ball_pos;
+		this->ball_direction = ball_direction;
+		this->ball_speed = ball_speed;
+		this->ball_radius = ball_radius;
+		//Paddles far outside the field
+		player_rect = enemy_rect = sf::FloatRect({ -10000.0F, 0.0F }, { 1.0F, 1.0F });
+		waiting_for_input = false;
+	}
+
+	void update() override {
+		internal_update();
+	}
+};
+
+///Step the real server until the ball crosses the line and compare it with the prediction
+void expect_path_like_server(sf::Vector2f ball_pos, float direction, float speed, float radius, float target_x) {
+	const sf::Vector2u window_size(1280, 720);
+	BallOnlyServer server(window_size, ball_pos, direction, speed, radius);
+
+	unsigned int ticks = 0, bounces = 0;
+	float previous_direction = server.get_ball_dir();
+	while ((target_x - server.get_ball_pos().x) * std::cos(server.get_ball_dir()) > 0.0F) {
+		server.update();
+		ticks++;
+		if (server.get_ball_dir() != previous_direction)
+			bounces++;
+		previous_direction = server.get_ball_dir();
+	}
+
+	//Predict the path to the place where the stepped ball is now, it is reached exactly in "ticks" ticks
+	gm::BallPath path;
+	ASSERT_TRUE(gm::predict_ball_path(ball_pos, direction, speed, radius, window_size, server.get_ball_pos().x,
+									  path));
+	EXPECT_NEAR(server.get_ball_pos().y, path.intercept.y, 0.5F);
+	EXPECT_NEAR(static_cast<float>(ticks), path.time, 0.01F * ticks);
+	EXPECT_EQ(bounces, path.bounces);
+	EXPECT_NEAR(std::cos(server.get_ball_dir()), std::cos(path.direction), 1e-4F);
+	EXPECT_NEAR(std::sin(server.get_ball_dir()), std::sin(path.direction), 1e-4F);
+}
+
+TEST(ball_path, matches_server) {
+	for (float direction : { 0.3F, -0.3F, 1.2F, 4.9F, 2.8F, 3.6F }) {
+		for (float y : { 40.0F, 360.0F, 650.0F }) {
+			float target_x = std::cos(direction) > 0.0F ? 1250.0F : 30.0F;
+			expect_path_like_server({ 640.0F, y }, direction, 5.0F, 20.0F, target_x);
+			expect_path_like_server({ 640.0F, y }, direction, 13.0F, 10.0F, target_x);
+		}
+	}
+}
+
+TEST(ball_path, no_path) {
+	gm::BallPath path;
+	EXPECT_FALSE(gm::predict_ball_path({ 640.0F, 360.0F }, 3.0F, 5.0F, 10.0F, { 1280, 720 }, 1200.0F, path));
+	EXPECT_FALSE(gm::predict_ball_path({ 640.0F, 360.0F }, 0.0F, 0.0F, 10.0F, { 1280, 720 }, 1200.0F, path));
+}
+
+TEST(ball_path, straight) {
+	gm::BallPath path;
+	ASSERT_TRUE(gm::predict_ball_path({ 100.0F, 300.0F }, 0.0F, 4.0F, 10.0F, { 1280, 720 }, 500.0F, path));
+	EXPECT_NEAR_V2(sf::Vector2f(500.0F, 300.0F), path.intercept, 1e-3F);
+	EXPECT_FLOAT_EQ(100.0F, path.time);
+	EXPECT_EQ(0U, path.bounces);
+}
+
+TEST(ball_path, bounce_points) {
+	//45 degrees down from (0, 360) in the field 720 high with the ball of radius 10:
+	//reflections at y = 710 (x = 350), y = 10 (x = 1050), y = 710 (x = 1750)
+	const float direction = std::atan2(1.0F, 1.0F);
+	sf::Vector2f points[4];
+
+	gm::BallPath path;
+	ASSERT_TRUE(gm::predict_ball_path({ 0.0F, 360.0F }, direction, 1.0F, 10.0F, { 1280, 720 }, 2000.0F, path));
+	EXPECT_EQ(3U, path.bounces);
+	EXPECT_NEAR(460.0F, path.intercept.y, 1e-2F);
+
+	ASSERT_EQ(3U, gm::ball_path_bounce_points({ 0.0F, 360.0F }, direction, 10.0F, { 1280, 720 }, 2000.0F,
+											  points, 4));
+	EXPECT_NEAR_V2(sf::Vector2f(350.0F, 710.0F), points[0], 1e-2F);
+	EXPECT_NEAR_V2(sf::Vector2f(1050.0F, 10.0F), points[1], 1e-2F);
+	EXPECT_NEAR_V2(sf::Vector2f(1750.0F, 710.0F), points[2], 1e-2F);
+
+	//Limited output
+	EXPECT_EQ(1U, gm::ball_path_bounce_points({ 0.0F, 360.0F }, direction, 10.0F, { 1280, 720 }, 2000.0F,
+											  points, 1));
+
+	//The same path, but upwards
+	ASSERT_EQ(3U, gm::ball_path_bounce_points({ 0.0F, 360.0F }, -direction, 10.0F, { 1280, 720 }, 2000.0F,
+											  points, 4));
+	EXPECT_NEAR_V2(sf::Vector2f(350.0F, 10.0F), points[0], 1e-2F);
+	EXPECT_NEAR_V2(sf::Vector2f(1050.0F, 710.0F), points[1], 1e-2F);
+}
+
+TEST(ball_path, bounce_points_from_bound) {
+	const float direction = std::atan2(1.0F, 1.0F);
+	sf::Vector2f points[4];
+	gm::BallPath path;
+
+	//From the top bound downwards: the start is not a reflection
+	ASSERT_TRUE(gm::predict_ball_path({ 0.0F, 10.0F }, direction, 1.0F, 10.0F, { 1280, 720 }, 2000.0F, path));
+	ASSERT_EQ(path.bounces, gm::ball_path_bounce_points({ 0.0F, 10.0F }, direction, 10.0F, { 1280, 720 }, 2000.0F,
+														 points, 4));
+	ASSERT_EQ(2U, path.bounces);
+	EXPECT_NEAR_V2(sf::Vector2f(700.0F, 710.0F), points[0], 1e-2F);
+	EXPECT_NEAR_V2(sf::Vector2f(1400.0F, 10.0F), points[1], 1e-2F);
+
+	//From the bottom bound upwards
+	ASSERT_TRUE(gm::predict_ball_path({ 0.0F, 710.0F }, -direction, 1.0F, 10.0F, { 1280, 720 }, 2000.0F, path));
+	ASSERT_EQ(path.bounces, gm::ball_path_bounce_points({ 0.0F, 710.0F }, -direction, 10.0F, { 1280, 720 },
+														 2000.0F, points, 4));
+	ASSERT_EQ(2U, path.bounces);
+	EXPECT_NEAR_V2(sf::Vector2f(700.0F, 10.0F), points[0], 1e-2F);
+	EXPECT_NEAR_V2(sf::Vector2f(1400.0F, 710.0F), points[1], 1e-2F);
+
+	//From the top bound upwards: reflected right at the start
+	ASSERT_TRUE(gm::predict_ball_path({ 0.0F, 10.0F }, -direction, 1.0F, 10.0F, { 1280, 720 }, 2000.0F, path));
+	ASSERT_EQ(path.bounces, gm::ball_path_bounce_points({ 0.0F, 10.0F }, -direction, 10.0F, { 1280, 720 },
+														 2000.0F, points, 4));
+	ASSERT_EQ(3U, path.bounces);
+	EXPECT_NEAR_V2(sf::Vector2f(0.0F, 10.0F), points[0], 1e-2F);
+	EXPECT_NEAR_V2(sf::Vector2f(700.0F, 710.0F), points[1], 1e-2F);
+	EXPECT_NEAR_V2(sf::Vector2f(1400.0F, 10.0F), points[2], 1e-2F);
+}
@@ -56,3 +56,11 @@ TEST(basic_math, is_higher_semiplane) {
 	EXPECT_EQ(true, gm::is_higher_semiplane(3, -4, {-2, 0}));
 	EXPECT_EQ(false, gm::is_higher_semiplane(-2, 4, {-2, 4}));
 }
+
+TEST(basic_math, fold_into_range) {
+	EXPECT_FLOAT_EQ(5.0F, gm::fold_into_range(5.0F, 0.0F, 10.0F));
+	EXPECT_FLOAT_EQ(8.0F, gm::fold_into_range(12.0F, 0.0F, 10.0F)); //One bounce off the max
+	EXPECT_FLOAT_EQ(3.0F, gm::fold_into_range(-3.0F, 0.0F, 10.0F)); //One bounce off the min
+	EXPECT_FLOAT_EQ(7.0F, gm::fold_into_range(27.0F, 0.0F, 10.0F)); //Two bounces
+	EXPECT_FLOAT_EQ(14.0F, gm::fold_into_range(-34.0F, 10.0F, 20.0F));
+}
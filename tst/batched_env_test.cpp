@@ -0,0 +1,120 @@
+/*
+ * PongX batched environment unit test
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../src/Env/BatchedEnv.hpp"
+
+///Buffers of one step
+struct StepBuffers {
+	std::vector<float> actions, observations, rewards;
+	std::vector<std::uint8_t> dones;
+
+	StepBuffers(unsigned int env_count) : actions(env_count),
+										  observations(env_count * BatchedEnv::OBSERVATION_SIZE),
+										  rewards(env_count), dones(env_count) { }
+};
+
+///Simple controller: follow the ball
+void follow_ball(StepBuffers& buffers) {
+	for (std::size_t i = 0; i < buffers.actions.size(); i++) {
+		const float* observation = &buffers.observations[i * BatchedEnv::OBSERVATION_SIZE];
+		buffers.actions[i] = observation[1] > observation[4] ? 1.0F : -1.0F;
+	}
+}
+
+///Play the steps and collect every observation
+std::vector<float> play(unsigned int threads, unsigned int env_count, unsigned int steps) {
+	EnvSettings settings;
+	settings.threads = threads;
+	BatchedEnv env(settings, env_count, nullptr);
+	StepBuffers buffers(env_count);
+
+	std::vector<float> history;
+	env.reset(buffers.observations.data());
+	for (unsigned int i = 0; i < steps; i++) {
+		follow_ball(buffers);
+		env.step(buffers.actions.data(), buffers.observations.data(), buffers.rewards.data(), buffers.dones.data());
+		history.insert(history.end(), buffers.observations.begin(), buffers.observations.end());
+		history.insert(history.end(), buffers.rewards.begin(), buffers.rewards.end());
+	}
+	return history;
+}
+
+TEST(batched_env, deterministic) {
+	//Same seeds - same matches, no matter how many threads step them
+	std::vector<float> single_thread = play(1, 64, 2000);
+	EXPECT_EQ(single_thread, play(1, 64, 2000));
+	EXPECT_EQ(single_thread, play(4, 64, 2000));
+}
+
+TEST(batched_env, seeds) {
+	EnvSettings settings;
+	settings.threads = 1;
+	std::uint64_t seeds[] = { 5, 5, 6 };
+	BatchedEnv env(settings, 3, seeds);
+	StepBuffers buffers(3);
+	env.reset(buffers.observations.data());
+
+	const unsigned int size = BatchedEnv::OBSERVATION_SIZE;
+	const float* observations = buffers.observations.data();
+	EXPECT_TRUE(std::equal(observations, observations + size, observations + size));
+	EXPECT_FALSE(std::equal(observations, observations + size, observations + 2 * size));
+}
+
+TEST(batched_env, auto_reset) {
+	EnvSettings settings;
+	settings.threads = 2;
+	settings.ball_speed = 20.0F;
+	BatchedEnv env(settings, 8, nullptr);
+	StepBuffers buffers(8);
+	env.reset(buffers.observations.data());
+
+	//The player does not move, so the AI scores sooner or later in every match
+	std::vector<bool> scored(8, false);
+	for (unsigned int step = 0; step < 5000; step++) {
+		env.step(buffers.actions.data(), buffers.observations.data(), buffers.rewards.data(), buffers.dones.data());
+		for (unsigned int i = 0; i < 8; i++) {
+			if (buffers.dones[i] == 0)
+				continue;
+			if (buffers.rewards[i] == -1.0F)
+				scored[i] = true;
+			//The new match starts with the ball in the center
+			EXPECT_FLOAT_EQ(0.5F, buffers.observations[i * BatchedEnv::OBSERVATION_SIZE]);
+			EXPECT_FLOAT_EQ(0.5F, buffers.observations[i * BatchedEnv::OBSERVATION_SIZE + 1]);
+		}
+	}
+	EXPECT_EQ(std::vector<bool>(8, true), scored);
+}
+
+TEST(batched_env, truncation) {
+	EnvSettings settings;
+	settings.threads = 1;
+	settings.max_steps = 10;
+	BatchedEnv env(settings, 1, nullptr);
+	StepBuffers buffers(1);
+	env.reset(buffers.observations.data());
+
+	for (unsigned int step = 1; step <= 10; step++) {
+		env.step(buffers.actions.data(), buffers.observations.data(), buffers.rewards.data(), buffers.dones.data());
+		EXPECT_EQ(step == 10, buffers.dones[0] == 1);
+	}
+}
@@ -0,0 +1,86 @@
+/*
+ * PongX fast trigonometry tests
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../src/fast_trig.hpp"
+
+TEST(fast_trig, sin_cos_error) {
+	double max_error = 0.0;
+	for (float angle = -8192.0F; angle < 8192.0F; angle += 0.0137F) {
+		float sin, cos;
+		gm::fast_sin_cos(angle, sin, cos);
+		max_error = std::max(max_error, std::abs(sin - std::sin(static_cast<double>(angle))));
+		max_error = std::max(max_error, std::abs(cos - std::cos(static_cast<double>(angle))));
+	}
+	EXPECT_LT(max_error, 1e-7);
+
+	//Exact values where they matter for the game (the ball moving straight)
+	float sin, cos;
+	gm::fast_sin_cos(0.0F, sin, cos);
+	EXPECT_EQ(sin, 0.0F);
+	EXPECT_EQ(cos, 1.0F);
+}
+
+TEST(fast_trig, atan2_error) {
+	double max_error = 0.0;
+	for (float angle = -3.14159F; angle < 3.14159F; angle += 0.0001F) {
+		for (float length : { 1e-3F, 1.0F, 1e4F }) {
+			float x = std::cos(angle) * length, y = std::sin(angle) * length;
+			max_error = std::max(max_error, std::abs(gm::fast_atan2(y, x) - std::atan2(static_cast<double>(y), x)));
+		}
+	}
+	EXPECT_LT(max_error, 3e-7);
+
+	EXPECT_EQ(gm::fast_atan2(0.0F, 0.0F), 0.0F);
+	EXPECT_EQ(gm::fast_atan2(0.0F, 1.0F), 0.0F);
+	EXPECT_FLOAT_EQ(gm::fast_atan2(1.0F, 0.0F), 1.57079632679F);
+	EXPECT_FLOAT_EQ(gm::fast_atan2(0.0F, -1.0F), 3.14159265359F);
+	EXPECT_FLOAT_EQ(gm::fast_atan2(-1.0F, -1.0F), -2.35619449019F);
+}
+
+TEST(fast_trig, arrays_match_scalar) {
+	//Odd amount, so the tail is computed by the scalar code too
+	std::vector<float> angles, x, y;
+	for (float angle = -100.0F; angle < 100.0F; angle += 0.0071F) {
+		angles.push_back(angle);
+		x.push_back(std::cos(angle * 3.0F) * (angle + 0.5F));
+		y.push_back(std::sin(angle * 5.0F));
+	}
+	angles.push_back(1e20F);
+	angles.push_back(std::nanf(""));
+	x.resize(angles.size(), 0.0F);
+	y.resize(angles.size(), 0.0F);
+
+	std::vector<float> sin(angles.size()), cos(angles.size()), atan(angles.size());
+	gm::fast_sin_cos(angles.data(), sin.data(), cos.data(), angles.size());
+	gm::fast_atan2(y.data(), x.data(), atan.data(), angles.size());
+	for (std::size_t i = 0; i < angles.size(); i++) {
+		float scalar_sin, scalar_cos;
+		gm::fast_sin_cos(angles[i], scalar_sin, scalar_cos);
+		float scalar_atan = gm::fast_atan2(y[i], x[i]);
+		//Bit by bit, NaNs included
+		ASSERT_EQ(std::memcmp(&sin[i], &scalar_sin, sizeof(float)), 0) << angles[i];
+		ASSERT_EQ(std::memcmp(&cos[i], &scalar_cos, sizeof(float)), 0) << angles[i];
+		ASSERT_EQ(std::memcmp(&atan[i], &scalar_atan, sizeof(float)), 0) << y[i] << ' ' << x[i];
+	}
+}
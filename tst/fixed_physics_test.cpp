@@ -0,0 +1,96 @@
+/*
+ * PongX fixed-point physics tests
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "../src/fixed_math.hpp"
+#include "../src/Server/Server.hpp"
+
+TEST(fixed_math, arithmetic) {
+	EXPECT_EQ(fx::mul(fx::from_float(1.5F), fx::from_float(-2.25F)), fx::from_float(-3.375F));
+	EXPECT_EQ(fx::div(fx::from_int(7), fx::from_int(2)), fx::from_float(3.5F));
+	EXPECT_EQ(fx::sqrt(fx::from_int(144)), fx::from_int(12));
+	EXPECT_NEAR(fx::to_float(fx::sqrt(fx::from_int(2))), std::sqrt(2.0F), 2e-5F);
+	EXPECT_EQ(fx::sqrt(-fx::ONE), 0);
+}
+
+TEST(fixed_math, sin_cos) {
+	for (float angle = -10.0F; angle < 10.0F; angle += 0.01F) {
+		fx::Fixed sin, cos;
+		fx::sin_cos(fx::from_float(angle), sin, cos);
+		EXPECT_NEAR(fx::to_float(sin), std::sin(angle), 2e-4F) << angle;
+		EXPECT_NEAR(fx::to_float(cos), std::cos(angle), 2e-4F) << angle;
+	}
+}
+
+///Server of the fixed-point mode for the golden test
+std::unique_ptr<Server> fixed_server(unsigned int seed) {
+	ServerSettings settings;
+	settings.server_type = LocalNetworkHost;
+	settings.physics = FixedPointPhysics;
+	settings.window_size = { 1280, 720 };
+	settings.ball_speed = 7.0F;
+	settings.player_rect = sf::FloatRect({ 10, 250 }, { 45, 160 });
+	settings.enemy_rect = sf::FloatRect({ 1225, 250 }, { 45, 160 });
+	settings.seed = seed;
+	return std::unique_ptr<Server>(Server::create(settings));
+}
+
+///Play the match with the inputs made of integers only
+std::uint64_t play_fixed_match(unsigned int ticks) {
+	std::unique_ptr<Server> server = fixed_server(2021);
+	std::uint32_t input = 1;
+	for (unsigned int tick = 0; tick < ticks; tick++) {
+		//Xorshift: -1, -0.5, 0, 0.5 or 1 for both paddles every 16 ticks
+		if (tick % 16 == 0) {
+			input ^= input << 13;
+			input ^= input >> 17;
+			input ^= input << 5;
+		}
+		server->player_relative_speed = static_cast<float>(static_cast<int>(input % 5) - 2) * 0.5F;
+		server->set_enemy_relative_speed(static_cast<float>(static_cast<int>((input >> 8) % 5) - 2) * 0.5F);
+		server->update();
+	}
+	EXPECT_GT(server->get_stats().rallies, 50U) << "the match is too simple to test anything";
+	return server->state_hash();
+}
+
+TEST(fixed_physics, golden_hash) {
+	//Recorded once. Every build on every machine has to give the same, otherwise the lockstep desyncs
+	EXPECT_EQ(play_fixed_match(1000000), 0x20dfd3aded6144daULL);
+}
+
+TEST(fixed_physics, savestate) {
+	std::unique_ptr<Server> server = fixed_server(3), copy = fixed_server(4);
+	server->player_relative_speed = 1.0F;
+	for (unsigned int tick = 0; tick < 1000; tick++)
+		server->update();
+
+	ServerState state;
+	server->save_state(state);
+	copy->load_state(state);
+	EXPECT_EQ(copy->state_hash(), server->state_hash());
+	for (unsigned int tick = 0; tick < 1000; tick++) {
+		server->update();
+		copy->update();
+	}
+	EXPECT_EQ(copy->state_hash(), server->state_hash());
+}
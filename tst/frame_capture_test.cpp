@@ -0,0 +1,131 @@
+/*
+ * PongX frame capture tests
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../src/Render/FrameCapture.hpp"
+
+///Frame of one color
+static std::vector<std::uint8_t> solid_frame(unsigned int width, unsigned int height, sf::Color color) {
+	std::vector<std::uint8_t> pixels;
+	for (unsigned int i = 0; i < width * height; i++)
+		pixels.insert(pixels.end(), { color.r, color.g, color.b, 255 });
+	return pixels;
+}
+
+TEST(frame_capture, y4m_video) {
+	std::string path = ::testing::TempDir() + "pongx_capture_test.y4m";
+	FrameCaptureSettings settings;
+	settings.path = path;
+	settings.policy = BlockRenderer;
+	std::unique_ptr<FrameCapture> capture = FrameCapture::start(settings);
+	ASSERT_NE(nullptr, capture);
+
+	//5x3: the last column and row of the chroma blocks are repeated
+	for (sf::Color color : { sf::Color::White, sf::Color::Black, sf::Color::Red })
+		EXPECT_TRUE(capture->capture(solid_frame(5, 3, color).data(), 5, 3));
+	//The size of the video can not change
+	EXPECT_TRUE(capture->capture(solid_frame(4, 4, sf::Color::White).data(), 4, 4));
+	capture->flush();
+	EXPECT_EQ(4u, capture->get_captured_frames());
+	EXPECT_EQ(3u, capture->get_written_frames());
+	EXPECT_EQ(1u, capture->get_failed_frames());
+	capture.reset();
+
+	std::ifstream file(path, std::ios::binary);
+	std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	std::string header = "YUV4MPEG2 W5 H3 F60:1 Ip A1:1 C420jpeg\n";
+	//Y plane of 15 bytes, U and V planes of 3 x 2 bytes
+	std::size_t frame_size = 6 + 15 + 2 * 6;
+	ASSERT_EQ(header.size() + 3 * frame_size, data.size());
+	EXPECT_EQ(header, data.substr(0, header.size()));
+
+	//Y, U and V of white, black and red in the studio range
+	int expected[3][3] = { { 235, 128, 128 }, { 16, 128, 128 }, { 82, 90, 240 } };
+	for (unsigned int frame = 0; frame < 3; frame++) {
+		std::size_t offset = header.size() + frame * frame_size;
+		EXPECT_EQ("FRAME\n", data.substr(offset, 6));
+		const std::uint8_t* planes = reinterpret_cast<const std::uint8_t*>(data.data() + offset + 6);
+		EXPECT_EQ(expected[frame][0], planes[0]);
+		EXPECT_EQ(expected[frame][0], planes[14]);
+		EXPECT_EQ(expected[frame][1], planes[15 + 5]);
+		EXPECT_EQ(expected[frame][2], planes[15 + 6 + 5]);
+	}
+	std::remove(path.c_str());
+}
+
+TEST(frame_capture, policies) {
+	//One buffer for the big frames, so the renderer is faster than the encoder
+	std::vector<std::uint8_t> pixels = solid_frame(640, 360, sf::Color::Blue);
+	for (CapturePolicy policy : { DropNewFrames, DropOldFrames, BlockRenderer }) {
+		std::string path = ::testing::TempDir() + "pongx_capture_policy.y4m";
+		FrameCaptureSettings settings;
+		settings.path = path;
+		settings.policy = policy;
+		settings.buffers = 1;
+		std::unique_ptr<FrameCapture> capture = FrameCapture::start(settings);
+		ASSERT_NE(nullptr, capture);
+
+		unsigned int accepted = 0;
+		for (unsigned int i = 0; i < 20; i++)
+			accepted += capture->capture(pixels.data(), 640, 360) ? 1 : 0;
+		capture->flush();
+
+		//Every frame is written or dropped
+		EXPECT_EQ(20u, capture->get_written_frames() + capture->get_dropped_frames());
+		EXPECT_EQ(accepted, capture->get_captured_frames());
+		EXPECT_EQ(0u, capture->get_failed_frames());
+		if (policy == BlockRenderer) {
+			EXPECT_EQ(0u, capture->get_dropped_frames());
+		}
+		capture.reset();
+		std::remove(path.c_str());
+	}
+}
+
+TEST(frame_capture, png_sequence) {
+	std::filesystem::path directory = std::filesystem::path(::testing::TempDir()) / "pongx_capture_png";
+	std::filesystem::remove_all(directory);
+	FrameCaptureSettings settings;
+	settings.path = directory.string();
+	settings.format = PngSequence;
+	settings.policy = BlockRenderer;
+	std::unique_ptr<FrameCapture> capture = FrameCapture::start(settings);
+	ASSERT_NE(nullptr, capture);
+	EXPECT_TRUE(std::filesystem::is_directory(directory));
+
+	for (unsigned int i = 0; i < 3; i++)
+		capture->capture(solid_frame(8, 8, sf::Color::Green).data(), 8, 8);
+	capture->flush();
+	EXPECT_EQ(3u, capture->get_written_frames());
+	capture.reset();
+	std::filesystem::remove_all(directory);
+}
+
+TEST(frame_capture, bad_path) {
+	FrameCaptureSettings settings;
+	settings.path = "/nonexistent/pongx/video.y4m";
+	EXPECT_EQ(nullptr, FrameCapture::start(settings));
+}
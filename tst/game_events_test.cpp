@@ -0,0 +1,155 @@
+/*
+ * PongX game events tests
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../src/Server/Server.hpp"
+
+static GameEvent numbered_event(std::uint64_t number) {
+	return { number, static_cast<float>(number), 0.0F, PaddleHit, 4, false };
+}
+
+TEST(game_events, batches_in_order) {
+	std::shared_ptr<GameEventBus> bus = std::make_shared<GameEventBus>(100);
+	EXPECT_EQ(128U, bus->get_capacity());
+	bus->publish(numbered_event(1000));
+
+	//Only the events after the subscription
+	GameEventSubscriber subscriber(bus);
+	for (std::uint64_t i = 0; i < 50; i++)
+		bus->publish(numbered_event(i));
+
+	GameEvent events[32];
+	ASSERT_EQ(32U, subscriber.poll(events, 32));
+	EXPECT_EQ(0U, events[0].tick);
+	EXPECT_EQ(31U, events[31].tick);
+	ASSERT_EQ(18U, subscriber.poll(events, 32));
+	EXPECT_EQ(49U, events[17].tick);
+	EXPECT_EQ(49.0F, events[17].x);
+	EXPECT_EQ(0U, subscriber.poll(events, 32));
+	EXPECT_EQ(0U, subscriber.get_lost());
+}
+
+TEST(game_events, slow_subscriber) {
+	std::shared_ptr<GameEventBus> bus = std::make_shared<GameEventBus>(8);
+	GameEventSubscriber subscriber(bus);
+	for (std::uint64_t i = 0; i < 20; i++)
+		bus->publish(numbered_event(i));
+
+	//The server does not wait, the oldest events are gone
+	GameEvent events[32];
+	ASSERT_EQ(8U, subscriber.poll(events, 32));
+	EXPECT_EQ(12U, events[0].tick);
+	EXPECT_EQ(12U, subscriber.get_lost());
+}
+
+TEST(game_events, concurrent_subscribers) {
+	constexpr std::uint64_t EVENTS = 500000;
+	std::shared_ptr<GameEventBus> bus = std::make_shared<GameEventBus>(256);
+	std::vector<std::unique_ptr<GameEventSubscriber>> subscribers;
+	for (unsigned int i = 0; i < 3; i++)
+		subscribers.emplace_back(new GameEventSubscriber(bus));
+
+	std::atomic<bool> done { false };
+	std::vector<std::thread> threads;
+	std::vector<std::uint64_t> received(subscribers.size());
+	for (std::size_t i = 0; i < subscribers.size(); i++)
+		threads.emplace_back([&, i]() {
+			GameEvent events[64];
+			std::uint64_t next = 0;
+			while (true) {
+				bool finished = done;
+				std::size_t count = subscribers[i]->poll(events, 64);
+				for (std::size_t j = 0; j < count; j++) {
+					//In order, never torn: the position matches the number
+					ASSERT_GE(events[j].tick, next);
+					ASSERT_EQ(static_cast<float>(events[j].tick), events[j].x);
+					next = events[j].tick + 1;
+				}
+				received[i] += count;
+				if (finished && count == 0)
+					break;
+			}
+		});
+
+	for (std::uint64_t i = 0; i < EVENTS; i++)
+		bus->publish(numbered_event(i));
+	done = true;
+	for (std::thread& thread : threads)
+		thread.join();
+
+	for (std::size_t i = 0; i < subscribers.size(); i++)
+		EXPECT_EQ(EVENTS, received[i] + subscribers[i]->get_lost());
+}
+
+///Play the match with the events and compare them with the statistics
+static void check_match_events(PhysicsBackend physics) {
+	ServerSettings settings;
+	settings.server_type = LocalNetworkHost;
+	settings.physics = physics;
+	settings.window_size = { 1280, 720 };
+	settings.seed = 5;
+	std::unique_ptr<Server> server(Server::create(settings));
+	GameEventSubscriber subscriber(server->enable_events(1 << 16));
+
+	server->serve();
+	for (unsigned int tick = 0; tick < 20000; tick++) {
+		//The player follows the ball and the enemy stands, so there are hits and points
+		float ball_y = server->get_ball_pos().y;
+		sf::FloatRect player = server->get_player_rect();
+		server->player_relative_speed = ball_y < player.top + player.height * 0.5F ? -0.6F : 0.6F;
+		server->update();
+	}
+
+	std::vector<GameEvent> events(1 << 16);
+	std::size_t count = subscriber.poll(events.data(), events.size());
+	unsigned int counts[5] = { }, player_points = 0, hits[9] = { };
+	for (std::size_t i = 0; i < count; i++) {
+		counts[events[i].type]++;
+		if (events[i].type == Score && events[i].player)
+			player_points++;
+		if (events[i].type == PaddleHit)
+			hits[events[i].detail]++;
+		if (events[i].type == WallBounce) {
+			EXPECT_TRUE(events[i].detail == 1 || events[i].detail == 2);
+		}
+	}
+
+	EXPECT_EQ(0U, subscriber.get_lost());
+	EXPECT_EQ(1U, counts[Serve]);
+	EXPECT_EQ(server->get_player_score() + server->get_enemy_score(), counts[Score]);
+	EXPECT_EQ(server->get_player_score(), player_points);
+	EXPECT_EQ(counts[Score], counts[Resume]);
+	EXPECT_GT(counts[WallBounce], 0U);
+	EXPECT_GT(counts[PaddleHit], 0U);
+	for (unsigned int segment = 1; segment < 9; segment++)
+		EXPECT_EQ(server->get_stats().segment_collisions[segment], hits[segment]);
+}
+
+TEST(game_events, match_float) {
+	check_match_events(FloatPhysics);
+}
+
+TEST(game_events, match_fixed) {
+	check_match_events(FixedPointPhysics);
+}
@@ -0,0 +1,187 @@
+/*
+ * PongX input latency test
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../src/GameManager.hpp"
+#include "../src/Input/InputSampler.hpp"
+#include "../src/Input/LatencyMeter.hpp"
+#include "../src/Server/Server.hpp"
+
+///One frame at 60 FPS
+const sf::Time FRAME_TIME = sf::microseconds(16667);
+///Input must be presented not later than in the next frame
+const sf::Time LATENCY_BUDGET = FRAME_TIME * 2.0F;
+///Synthetic cost of the simulation step and the drawing of the test page
+const sf::Time SIMULATION_TIME = sf::milliseconds(1), RENDER_TIME = sf::milliseconds(4);
+
+sf::Event key_event(sf::Event::EventType type, sf::Keyboard::Key key) {
+	sf::Event event;
+	event.type = type;
+	event.key.code = key;
+	return event;
+}
+
+///Time of the synthetic clock of GameManager
+static sf::Time test_time;
+///Window is not opened, the frames are presented nowhere
+static sf::RenderWindow window;
+
+///Local match that takes the input like GamePage, the simulation and the drawing take the synthetic time
+class LatencyTestPage : public Page {
+public:
+	std::unique_ptr<Server> server;
+	///Input of the last simulation step and the time when the step started
+	InputSnapshot last_input;
+	sf::Time last_update_time;
+
+	explicit LatencyTestPage(sf::RenderWindow* window) {
+		this->window = window;
+		ServerSettings settings;
+		settings.server_type = LocalMultiplayer;
+		settings.window_size = { 1280, 720 };
+		settings.player_rect.top = settings.enemy_rect.top = 200.0F;
+		server.reset(Server::create(settings));
+	}
+
+	void update(const InputSnapshot& input) override {
+		last_input = input;
+		last_update_time = test_time;
+		server->player_relative_speed = input.axis(sf::Keyboard::W, sf::Keyboard::S);
+		server->apply_local_input(input);
+		server->update();
+		test_time += SIMULATION_TIME;
+	}
+
+	void render() override {
+		test_time += RENDER_TIME;
+	}
+};
+
+///Runs the frames of GameManager by the synthetic clock
+class input_latency_loop : public testing::Test {
+protected:
+	LatencyTestPage* page;
+
+	void SetUp() override {
+		test_time = sf::Time::Zero;
+		GameManager::use_clock([]() { return test_time; });
+		page = new LatencyTestPage(&window);
+		GameManager::switch_page(page);
+		//The first frame shows the page
+		run_frame({ });
+		GameManager::get_input().reset();
+		GameManager::get_latency_meter().reset();
+	}
+
+	void TearDown() override {
+		//The other tests of the binary see no page
+		GameManager::close_pages();
+		GameManager::use_clock(nullptr);
+	}
+
+	///Frame of the main loop: the events are handled when the loop wakes up, then the frame is run.
+	///The next frame starts after FRAME_TIME (vsync)
+	void run_frame(const std::vector<sf::Event>& events) {
+		sf::Time frame_start = test_time;
+		for (const sf::Event& event : events)
+			GameManager::handle_event(window, event);
+		GameManager::run_frame(window);
+		ASSERT_LE(test_time, frame_start + FRAME_TIME);
+		test_time = frame_start + FRAME_TIME;
+	}
+};
+
+TEST(input_latency, axis) {
+	InputSampler sampler;
+	sampler.handle_event(key_event(sf::Event::KeyPressed, sf::Keyboard::S), sf::milliseconds(1));
+	EXPECT_EQ(1.0F, sampler.latch(sf::milliseconds(2)).axis(sf::Keyboard::W, sf::Keyboard::S));
+
+	sampler.handle_event(key_event(sf::Event::KeyPressed, sf::Keyboard::W), sf::milliseconds(3));
+	EXPECT_EQ(0.0F, sampler.latch(sf::milliseconds(4)).axis(sf::Keyboard::W, sf::Keyboard::S));
+
+	sampler.handle_event(key_event(sf::Event::KeyReleased, sf::Keyboard::S), sf::milliseconds(5));
+	EXPECT_EQ(-1.0F, sampler.latch(sf::milliseconds(6)).axis(sf::Keyboard::W, sf::Keyboard::S));
+}
+
+TEST(input_latency, tap_between_latches) {
+	InputSampler sampler;
+	sampler.handle_event(key_event(sf::Event::KeyPressed, sf::Keyboard::W), sf::milliseconds(1));
+	sampler.handle_event(key_event(sf::Event::KeyReleased, sf::Keyboard::W), sf::milliseconds(2));
+
+	//The tap is seen by exactly one simulation step
+	InputSnapshot input = sampler.latch(sf::milliseconds(3));
+	EXPECT_TRUE(input.is_key_pressed(sf::Keyboard::W));
+	EXPECT_TRUE(input.has_new_input);
+	EXPECT_EQ(sf::milliseconds(1), input.oldest_event_time);
+
+	input = sampler.latch(sf::milliseconds(4));
+	EXPECT_FALSE(input.is_key_pressed(sf::Keyboard::W));
+	EXPECT_FALSE(input.has_new_input);
+}
+
+TEST(input_latency, key_repeat_is_not_new_input) {
+	InputSampler sampler;
+	sampler.handle_event(key_event(sf::Event::KeyPressed, sf::Keyboard::S), sf::milliseconds(1));
+	sampler.latch(sf::milliseconds(2));
+
+	sampler.handle_event(key_event(sf::Event::KeyPressed, sf::Keyboard::S), sf::milliseconds(3));
+	EXPECT_FALSE(sampler.latch(sf::milliseconds(4)).has_new_input);
+}
+
+TEST_F(input_latency_loop, input_moves_paddles_in_next_frame) {
+	float player_top = page->server->get_player_rect().top, enemy_top = page->server->get_enemy_rect().top;
+
+	run_frame({ key_event(sf::Event::KeyPressed, sf::Keyboard::S),
+				key_event(sf::Event::KeyPressed, sf::Keyboard::Up) });
+
+	EXPECT_GT(page->server->get_player_rect().top, player_top);
+	EXPECT_LT(page->server->get_enemy_rect().top, enemy_top);
+}
+
+TEST_F(input_latency_loop, budget) {
+	const LatencyMeter& meter = GameManager::get_latency_meter();
+	for (unsigned int i = 0; i < 120; i++) {
+		sf::Keyboard::Key key = i % 2 ? sf::Keyboard::W : sf::Keyboard::S;
+		for (sf::Event::EventType type : { sf::Event::KeyPressed, sf::Event::KeyReleased }) {
+			run_frame({ key_event(type, key) });
+
+			//The input of the frame is latched before the simulation step of the same frame
+			EXPECT_TRUE(page->last_input.has_new_input);
+			EXPECT_LE(page->last_input.latch_time, page->last_update_time);
+			//And the stages go in order
+			const FrameLatency& frame = meter.get_last_frame();
+			for (unsigned int stage = InputLatched; stage < LatencyStageCount; stage++)
+				EXPECT_LE(frame.stage_times[stage - 1], frame.stage_times[stage]);
+		}
+	}
+
+	EXPECT_EQ(240U, meter.get_frames_with_input());
+	EXPECT_LE(meter.get_worst_total(), LATENCY_BUDGET);
+	//The input waits only for the simulation and the drawing of its own frame
+	EXPECT_EQ(SIMULATION_TIME + RENDER_TIME, meter.get_worst_total());
+
+	const FrameLatency& frame = meter.get_last_frame();
+	EXPECT_TRUE(frame.has_input);
+	EXPECT_EQ(sf::Time::Zero, frame.stage_duration(InputLatched));
+	EXPECT_EQ(SIMULATION_TIME, frame.stage_duration(Simulated));
+	EXPECT_EQ(RENDER_TIME, frame.stage_duration(Rendered));
+}
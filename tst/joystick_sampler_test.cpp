@@ -0,0 +1,147 @@
+/*
+ * PongX tests of the analog stick sampling
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "../src/Input/JoystickSampler.hpp"
+
+///Stick moved by the test
+class ScriptedJoystickDevice : public JoystickDevice {
+public:
+	ScriptedJoystickDevice(std::atomic<float>& position, std::atomic<bool>& connected)
+		: position(position), connected(connected) { }
+
+	bool read(float& position) override {
+		position = this->position.load();
+		return connected.load();
+	}
+
+private:
+	std::atomic<float>& position;
+	std::atomic<bool>& connected;
+};
+
+///Clock of the samples set by the test, so the averages are exact
+struct ScriptedJoystick {
+	std::atomic<float> position { 0.0F };
+	std::atomic<bool> connected { true };
+	std::atomic<std::int64_t> time { 0 };
+	std::unique_ptr<JoystickSampler> sampler;
+
+	ScriptedJoystick(std::size_t queue_capacity = 1024) {
+		JoystickSettings settings;
+		settings.dead_zone = 0.1F;
+		settings.queue_capacity = queue_capacity;
+		settings.clock = [this]() { return sf::microseconds(time.load()); };
+		sampler = JoystickSampler::start(std::unique_ptr<JoystickDevice>(new ScriptedJoystickDevice(position,
+																									  connected)),
+										 settings);
+	}
+
+	///Move the stick at the time and wait until the sampler reads it
+	void move(std::int64_t move_time, float move_position) {
+		time.store(move_time);
+		position.store(move_position);
+		std::uint64_t reads = sampler->get_read_count();
+		while (sampler->get_read_count() < reads + 2)
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+	}
+
+	InputSnapshot latch(std::int64_t latch_time) {
+		InputSnapshot snapshot;
+		snapshot.latch_time = sf::microseconds(latch_time);
+		sampler->latch(snapshot);
+		return snapshot;
+	}
+};
+
+TEST(joystick_sampler, no_device) {
+	EXPECT_EQ(JoystickSampler::start(nullptr), nullptr);
+	EXPECT_EQ(LinuxJoystickDevice::open("/nonexistent/js0"), nullptr);
+}
+
+TEST(joystick_sampler, average_between_latches) {
+	ScriptedJoystick joystick;
+	joystick.move(0, 0.0F);
+
+	//Center till 10 ms, max down till the latch at 16 ms
+	joystick.move(10000, 1.0F);
+	InputSnapshot snapshot = joystick.latch(16000);
+	EXPECT_FLOAT_EQ(snapshot.stick, 6.0F / 16.0F);
+	EXPECT_TRUE(snapshot.has_new_input);
+	EXPECT_EQ(snapshot.oldest_event_time, sf::microseconds(10000));
+
+	//A short move inside the frame is not lost: up for 2 ms of the next 16 ms
+	joystick.move(20000, -1.0F);
+	joystick.move(22000, 1.0F);
+	EXPECT_FLOAT_EQ(joystick.latch(32000).stick, 14.0F / 16.0F - 2.0F / 16.0F);
+
+	//Nothing new: the stick holds
+	snapshot = joystick.latch(48000);
+	EXPECT_FLOAT_EQ(snapshot.stick, 1.0F);
+	EXPECT_FALSE(snapshot.has_new_input);
+}
+
+TEST(joystick_sampler, sample_after_latch_waits) {
+	ScriptedJoystick joystick;
+	joystick.move(0, 0.0F);
+	joystick.latch(0);
+
+	//Read already, but belongs to the next step
+	joystick.move(20000, 1.0F);
+	InputSnapshot snapshot = joystick.latch(16000);
+	EXPECT_FLOAT_EQ(snapshot.stick, 0.0F);
+	EXPECT_FALSE(snapshot.has_new_input);
+
+	snapshot = joystick.latch(32000);
+	EXPECT_FLOAT_EQ(snapshot.stick, 12.0F / 16.0F);
+	EXPECT_TRUE(snapshot.has_new_input);
+	EXPECT_EQ(snapshot.oldest_event_time, sf::microseconds(20000));
+}
+
+TEST(joystick_sampler, dead_zone_and_disconnect) {
+	ScriptedJoystick joystick;
+	joystick.move(1000, 0.05F);
+	EXPECT_FLOAT_EQ(joystick.latch(2000).stick, 0.0F);
+
+	joystick.move(2000, -0.55F);
+	EXPECT_FLOAT_EQ(joystick.latch(3000).stick, -0.5F);
+
+	//The unplugged stick stops the paddle
+	joystick.connected.store(false);
+	joystick.move(3000, -0.55F);
+	EXPECT_FLOAT_EQ(joystick.latch(4000).stick, 0.0F);
+}
+
+TEST(joystick_sampler, resync_after_dropped_samples) {
+	//Nobody latches (e.g. the menu is shown), so the queue overflows
+	ScriptedJoystick joystick(4);
+	for (int i = 1; i <= 12; i++)
+		joystick.move(i * 1000, (i % 2 == 0) ? 0.5F : -0.5F);
+	joystick.move(13000, 0.8F);
+	EXPECT_GT(joystick.sampler->get_dropped_samples(), 0U);
+
+	//The lost history is skipped, the stick is where it is now
+	EXPECT_NEAR(joystick.latch(14000).stick, (0.8F - 0.1F) / 0.9F, 1e-6F);
+	joystick.move(15000, 0.0F);
+	EXPECT_NEAR(joystick.latch(16000).stick, (0.8F - 0.1F) / 0.9F * 0.5F, 1e-6F);
+}
@@ -0,0 +1,136 @@
+/*
+ * PongX match snapshot tests
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../src/Server/Server.hpp"
+
+///Server in the middle of a rally
+std::unique_ptr<Server> playing_server() {
+	ServerSettings settings;
+	settings.server_type = LocalNetworkHost;
+	settings.window_size = { 1280, 720 };
+	settings.player_rect = sf::FloatRect({ 10, 250 }, { 45, 160 });
+	settings.enemy_rect = sf::FloatRect({ 1225, 250 }, { 45, 160 });
+	settings.seed = 7;
+	std::unique_ptr<Server> server(Server::create(settings));
+	server->serve();
+	server->player_relative_speed = -0.5F;
+	for (unsigned int i = 0; i < 100; i++)
+		server->update();
+	return server;
+}
+
+TEST(match_snapshot, same_as_getters) {
+	std::unique_ptr<Server> server = playing_server();
+	MatchSnapshot snapshot;
+	server->write_snapshot(snapshot);
+
+	EXPECT_EQ(server->get_ball_pos(), snapshot.get_ball_pos());
+	EXPECT_EQ(server->get_ball_dir(), snapshot.ball_direction);
+	EXPECT_EQ(server->get_player_rect(), snapshot.get_player_rect());
+	EXPECT_EQ(server->get_enemy_rect(), snapshot.get_enemy_rect());
+	EXPECT_EQ(server->get_stats().ticks, snapshot.tick);
+	EXPECT_EQ(1280U, snapshot.window_width);
+	EXPECT_EQ(-0.5F, snapshot.player_relative_speed);
+	EXPECT_FALSE(snapshot.has_flag(SnapshotWaitingForInput));
+	EXPECT_FALSE(snapshot.has_flag(SnapshotMultiBall));
+}
+
+TEST(match_snapshot, view_in_place) {
+	std::unique_ptr<Server> server = playing_server();
+	//The snapshot is written straight into the buffer and read from it without copying
+	std::vector<std::uint64_t> buffer(sizeof(MatchSnapshot) / sizeof(std::uint64_t));
+	server->write_snapshot(*reinterpret_cast<MatchSnapshot*>(buffer.data()));
+
+	const MatchSnapshot* snapshot = MatchSnapshot::view(buffer.data(), sizeof(MatchSnapshot));
+	ASSERT_EQ(static_cast<const void*>(buffer.data()), static_cast<const void*>(snapshot));
+	EXPECT_EQ(server->get_ball_pos(), snapshot->get_ball_pos());
+
+	EXPECT_EQ(nullptr, MatchSnapshot::view(buffer.data(), sizeof(MatchSnapshot) - 1));
+	reinterpret_cast<char*>(buffer.data())[0] = 'X';
+	EXPECT_EQ(nullptr, MatchSnapshot::view(buffer.data(), sizeof(MatchSnapshot)));
+}
+
+TEST(match_snapshot, newer_version) {
+	std::unique_ptr<Server> server = playing_server();
+	//A future version with 16 more bytes: the known prefix is read in place and by read()
+	std::vector<std::uint64_t> buffer(sizeof(MatchSnapshot) / sizeof(std::uint64_t) + 2, ~0ULL);
+	MatchSnapshot& written = *reinterpret_cast<MatchSnapshot*>(buffer.data());
+	server->write_snapshot(written);
+	written.version = MatchSnapshot::VERSION + 1;
+	written.size = sizeof(MatchSnapshot) + 16;
+
+	const MatchSnapshot* snapshot = MatchSnapshot::view(buffer.data(), buffer.size() * sizeof(std::uint64_t));
+	ASSERT_NE(nullptr, snapshot);
+	EXPECT_EQ(server->get_enemy_rect(), snapshot->get_enemy_rect());
+
+	MatchSnapshot copy;
+	ASSERT_TRUE(MatchSnapshot::read(buffer.data(), buffer.size() * sizeof(std::uint64_t), copy));
+	EXPECT_EQ(MatchSnapshot::VERSION, copy.version);
+	EXPECT_EQ(server->get_ball_pos(), copy.get_ball_pos());
+	EXPECT_FALSE(MatchSnapshot::read(buffer.data(), sizeof(MatchSnapshot), copy));
+}
+
+TEST(match_snapshot, read_misaligned) {
+	std::unique_ptr<Server> server = playing_server();
+	MatchSnapshot written;
+	server->write_snapshot(written);
+	std::vector<char> bytes(sizeof(MatchSnapshot) + 1);
+	std::memcpy(bytes.data() + 1, &written, sizeof(MatchSnapshot));
+
+	EXPECT_EQ(nullptr, MatchSnapshot::view(bytes.data() + 1, sizeof(MatchSnapshot)));
+	MatchSnapshot copy;
+	ASSERT_TRUE(MatchSnapshot::read(bytes.data() + 1, sizeof(MatchSnapshot), copy));
+	EXPECT_EQ(0, std::memcmp(&written, &copy, sizeof(MatchSnapshot)));
+}
+
+TEST(match_snapshot, quantized) {
+	std::unique_ptr<Server> server = playing_server();
+	MatchSnapshot base, snapshot, decoded;
+	server->write_snapshot(base);
+	for (unsigned int i = 0; i < 1000; i++) {
+		server->player_relative_speed = i % 200 < 100 ? 1.0F : -0.3F;
+		server->update();
+		server->write_snapshot(snapshot);
+
+		QuantizedSnapshot quantized;
+		quantized.encode(snapshot);
+		ASSERT_TRUE(quantized.decode(base, decoded));
+
+		//Half of a step (2 / 65535 of the side) and the rounding of float
+		constexpr float ERROR = 1.05F / 65535.0F;
+		EXPECT_NEAR(snapshot.ball_x, decoded.ball_x, 1280.0F * ERROR);
+		EXPECT_NEAR(snapshot.ball_y, decoded.ball_y, 720.0F * ERROR);
+		EXPECT_NEAR(snapshot.player_top, decoded.player_top, 720.0F * ERROR);
+		EXPECT_NEAR(snapshot.enemy_top, decoded.enemy_top, 720.0F * ERROR);
+		EXPECT_NEAR(std::sin(snapshot.ball_direction), std::sin(decoded.ball_direction), 1e-4F);
+		EXPECT_NEAR(std::cos(snapshot.ball_direction), std::cos(decoded.ball_direction), 1e-4F);
+		EXPECT_NEAR(snapshot.player_relative_speed, decoded.player_relative_speed, 0.5F / 127.0F);
+		EXPECT_EQ(snapshot.tick, decoded.tick);
+		EXPECT_EQ(snapshot.player_score, decoded.player_score);
+		EXPECT_EQ(snapshot.enemy_score, decoded.enemy_score);
+		EXPECT_EQ(snapshot.flags, decoded.flags);
+		EXPECT_EQ(snapshot.get_player_rect().width, decoded.get_player_rect().width);
+	}
+}
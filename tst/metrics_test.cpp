@@ -0,0 +1,99 @@
+/*
+ * PongX metrics tests
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../src/Utils/Metrics.hpp"
+
+static MetricCounter test_counter("pongx_test_events_total", "Events of the test", "kind=\"a\"");
+static MetricCounter test_other_counter("pongx_test_events_total", "Events of the test", "kind=\"b\"");
+static MetricCounter test_late_counter("pongx_test_late_events_total", "Events recorded by the finishing threads");
+static MetricGauge test_gauge("pongx_test_level", "Level of the test");
+static MetricHistogram test_histogram("pongx_test_duration_seconds", "Durations of the test", { 10, 100, 1000 },
+									  1e-3);
+
+TEST(metrics, counters_of_threads) {
+	std::uint64_t before = test_counter.get();
+	std::vector<std::thread> threads;
+	for (unsigned int i = 0; i < 4; i++)
+		threads.emplace_back([]() {
+			for (unsigned int j = 0; j < 100000; j++)
+				test_counter.add();
+		});
+	for (std::thread& thread : threads)
+		thread.join();
+
+	//The finished threads keep their counts
+	test_counter.add(5);
+	EXPECT_EQ(before + 400005, test_counter.get());
+}
+
+///Records from its destructor, which runs after the shard of the thread is given back
+struct LateRecorder {
+	~LateRecorder() {
+		test_late_counter.add(3);
+	}
+};
+
+TEST(metrics, record_after_thread_shard) {
+	std::uint64_t before = test_late_counter.get();
+	std::thread thread([]() {
+		//Constructed before the shard, so destroyed after it
+		thread_local LateRecorder recorder;
+		(void)recorder;
+		test_late_counter.add();
+	});
+	thread.join();
+
+	EXPECT_EQ(before + 4, test_late_counter.get());
+}
+
+TEST(metrics, histogram) {
+	std::uint64_t count = test_histogram.get_count(), sum = test_histogram.get_sum();
+	for (std::uint64_t value : { 5, 10, 50, 5000 })
+		test_histogram.record(value);
+
+	EXPECT_EQ(count + 4, test_histogram.get_count());
+	EXPECT_EQ(sum + 5065, test_histogram.get_sum());
+}
+
+TEST(metrics, prometheus_text) {
+	test_other_counter.add(3);
+	test_gauge.set(2.5);
+	test_gauge.add(-1.0);
+	std::ostringstream stream;
+	Metrics::write_prometheus(stream);
+	std::string text = stream.str();
+
+	//One header for the samples of the same name
+	std::size_t help = text.find("# HELP pongx_test_events_total Events of the test\n"
+								 "# TYPE pongx_test_events_total counter\n"
+								 "pongx_test_events_total{kind=\"a\"} ");
+	ASSERT_NE(std::string::npos, help);
+	EXPECT_EQ(std::string::npos, text.find("# HELP pongx_test_events_total", help + 1));
+	EXPECT_NE(std::string::npos, text.find("pongx_test_events_total{kind=\"b\"} 3\n"));
+	EXPECT_NE(std::string::npos, text.find("# TYPE pongx_test_level gauge\npongx_test_level 1.5\n"));
+	EXPECT_NE(std::string::npos, text.find("# TYPE pongx_test_duration_seconds histogram\n"));
+	EXPECT_NE(std::string::npos, text.find("pongx_test_duration_seconds_bucket{le=\"0.01\"} "));
+	EXPECT_NE(std::string::npos, text.find("pongx_test_duration_seconds_bucket{le=\"+Inf\"} "));
+	EXPECT_NE(std::string::npos, text.find("pongx_ticks_total "));
+}
@@ -0,0 +1,138 @@
+/*
+ * PongX multi-ball world unit test
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "macros.hpp"
+#include "../src/Server/MultiBallWorld.hpp"
+#include "../src/Server/Server.hpp"
+
+///Paddles far outside the field
+const sf::FloatRect NO_PADDLE({ -10000.0F, 0.0F }, { 1.0F, 1.0F });
+
+///Count touching pairs by testing every pair
+unsigned int brute_force_contacts(const MultiBallWorld& world) {
+	unsigned int contacts = 0;
+	float diameter = 2.0F * world.get_ball_radius();
+	for (std::size_t i = 0; i < world.size(); i++) {
+		for (std::size_t j = i + 1; j < world.size(); j++) {
+			sf::Vector2f delta = world.get_position(j) - world.get_position(i);
+			float distance_squared = delta.x * delta.x + delta.y * delta.y;
+			contacts += distance_squared < diameter * diameter && distance_squared != 0.0F;
+		}
+	}
+	return contacts;
+}
+
+TEST(multi_ball, head_on_collision) {
+	MultiBallWorld world({ 1280, 720 }, 2, 10.0F, 5.0F, 1);
+	world.set_position(0, { 600.0F, 360.0F });
+	world.set_position(1, { 625.0F, 360.0F });
+	world.set_velocity(0, { 5.0F, 0.0F });
+	world.set_velocity(1, { -3.0F, 0.0F });
+
+	unsigned int player_points, enemy_points;
+	world.update(NO_PADDLE, NO_PADDLE, player_points, enemy_points);
+
+	//Equal masses: velocities are exchanged
+	EXPECT_EQ(1U, world.get_last_contacts());
+	EXPECT_NEAR_V2(sf::Vector2f(-3.0F, 0.0F), world.get_velocity(0), 1e-4F);
+	EXPECT_NEAR_V2(sf::Vector2f(5.0F, 0.0F), world.get_velocity(1), 1e-4F);
+}
+
+TEST(multi_ball, momentum_and_energy) {
+	MultiBallWorld world({ 1280, 720 }, 2, 10.0F, 5.0F, 1);
+	world.set_position(0, { 600.0F, 360.0F });
+	world.set_position(1, { 612.0F, 370.0F });
+	world.set_velocity(0, { 4.0F, 1.0F });
+	world.set_velocity(1, { -2.0F, -3.0F });
+
+	unsigned int player_points, enemy_points;
+	world.update(NO_PADDLE, NO_PADDLE, player_points, enemy_points);
+
+	sf::Vector2f velocity_1 = world.get_velocity(0), velocity_2 = world.get_velocity(1);
+	sf::Vector2f momentum = velocity_1 + velocity_2;
+	EXPECT_NEAR_V2(sf::Vector2f(2.0F, -2.0F), momentum, 1e-4F);
+	EXPECT_NEAR(16.0F + 1.0F + 4.0F + 9.0F, velocity_1.x * velocity_1.x + velocity_1.y * velocity_1.y +
+				velocity_2.x * velocity_2.x + velocity_2.y * velocity_2.y, 1e-3F);
+}
+
+TEST(multi_ball, broadphase_finds_every_contact) {
+	//Dense world, so many pairs cross the borders of the cells
+	MultiBallWorld world({ 400, 300 }, 600, 6.0F, 3.0F, 7);
+	unsigned int player_points, enemy_points;
+	for (unsigned int tick = 0; tick < 20; tick++) {
+		unsigned int contacts = brute_force_contacts(world);
+		EXPECT_EQ(contacts, world.count_contacts());
+		EXPECT_GT(contacts, 0U);
+		world.update(NO_PADDLE, NO_PADDLE, player_points, enemy_points);
+	}
+}
+
+TEST(multi_ball, paddle_and_walls) {
+	MultiBallWorld world({ 1280, 720 }, 1, 10.0F, 5.0F, 1);
+	sf::FloatRect enemy({ 1225.0F, 250.0F }, { 45.0F, 225.0F });
+	world.set_position(0, { 1200.0F, 360.0F });
+	world.set_velocity(0, { 5.0F, 0.0F });
+
+	unsigned int player_points, enemy_points;
+	for (unsigned int tick = 0; tick < 5; tick++)
+		world.update(NO_PADDLE, enemy, player_points, enemy_points);
+	EXPECT_LT(world.get_velocity(0).x, 0.0F);
+	EXPECT_LE(world.get_position(0).x, 1215.0F);
+
+	//Reflection off the bottom
+	world.set_position(0, { 640.0F, 705.0F });
+	world.set_velocity(0, { 0.0F, 10.0F });
+	world.update(NO_PADDLE, NO_PADDLE, player_points, enemy_points);
+	EXPECT_FLOAT_EQ(-10.0F, world.get_velocity(0).y);
+	EXPECT_FLOAT_EQ(705.0F, world.get_position(0).y);
+}
+
+TEST(multi_ball, scoring_respawns) {
+	MultiBallWorld world({ 1280, 720 }, 1, 10.0F, 5.0F, 1);
+	world.set_position(0, { 1285.0F, 360.0F });
+	world.set_velocity(0, { 10.0F, 0.0F });
+
+	unsigned int player_points, enemy_points;
+	world.update(NO_PADDLE, NO_PADDLE, player_points, enemy_points);
+	EXPECT_EQ(1U, player_points);
+	EXPECT_EQ(0U, enemy_points);
+	EXPECT_TRUE(world.get_position(0).x >= 320.0F && world.get_position(0).x <= 960.0F);
+}
+
+TEST(multi_ball, chaos_server) {
+	ServerSettings settings;
+	settings.server_type = Singleplayer;
+	settings.window_size = { 1280, 720 };
+	settings.chaos_balls = 500;
+	settings.seed = 3;
+	std::unique_ptr<Server> server(Server::create(settings));
+	ASSERT_NE(nullptr, server->get_multi_ball());
+	EXPECT_EQ(500U, server->get_multi_ball()->size());
+
+	server->serve();
+	for (unsigned int tick = 0; tick < 1000; tick++)
+		server->update();
+	//Many balls, many points, and the game never waits
+	EXPECT_GT(server->get_player_score() + server->get_enemy_score(), 10U);
+	EXPECT_FALSE(server->is_waiting_for_input());
+}
@@ -0,0 +1,112 @@
+/*
+ * PongX paddle AI unit test
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "../src/Server/PaddleAI.hpp"
+#include "../src/Server/SingleplayerServer.hpp"
+
+///Move the ball tick by tick, reflecting it off the top and bottom bounds, until it crosses target_x
+float brute_force_intercept(sf::Vector2f ball_pos, float direction, float radius, float height, float target_x) {
+	double x = ball_pos.x, y = ball_pos.y;
+	double velocity_x = std::cos(direction), velocity_y = std::sin(direction);
+	const double step = 0.01;
+	while ((target_x - x) * velocity_x > 0.0) {
+		x += velocity_x * step;
+		y += velocity_y * step;
+		if ((y < radius && velocity_y < 0.0) || (y > height - radius && velocity_y > 0.0))
+			velocity_y = -velocity_y;
+	}
+	return static_cast<float>(y);
+}
+
+std::unique_ptr<Server> create_bot_game(unsigned int reaction_delay, float error) {
+	ServerSettings settings;
+	settings.server_type = Singleplayer;
+	settings.window_size = { 1280, 720 };
+	settings.ball_radius = 20.0F;
+	settings.ai_reaction_delay = reaction_delay;
+	settings.ai_error = error;
+	settings.seed = 42;
+	return std::unique_ptr<Server>(Server::create(settings));
+}
+
+///Play the game where the player is controlled by the AI too
+///@returns the sum of the scores
+unsigned int play_bot_game(Server& server, PaddleAI& player_ai, unsigned int ticks) {
+	for (unsigned int i = 0; i < ticks; i++) {
+		player_ai.reset(); //Reset before the serve, so the player reacts at once
+		float speed = player_ai.update(server.get_player_rect(), server.get_ball_pos(), server.get_ball_dir(),
+									   server.get_ball_radius(), server.get_window_size());
+		//Serve if the ball waits
+		server.player_relative_speed = speed != 0.0F ? speed : 0.1F;
+		server.update();
+	}
+	return server.get_player_score() + server.get_enemy_score();
+}
+
+TEST(paddle_ai, predict_intercept) {
+	const float radius = 10.0F, height = 720.0F, target_x = 1200.0F;
+	const sf::Vector2u window_size(1280, 720);
+	for (float direction : { 0.1F, -0.3F, 0.7F, -1.2F, 1.4F, 5.9F }) {
+		for (float y : { 15.0F, 200.0F, 360.0F, 700.0F }) {
+			float intercept;
+			ASSERT_TRUE(PaddleAI::predict_intercept({ 100.0F, y }, direction, radius, window_size, target_x,
+													intercept));
+			EXPECT_NEAR(brute_force_intercept({ 100.0F, y }, direction, radius, height, target_x), intercept, 0.5F);
+		}
+	}
+}
+
+TEST(paddle_ai, moves_away) {
+	float intercept;
+	EXPECT_FALSE(PaddleAI::predict_intercept({ 600.0F, 360.0F }, 3.0F, 10.0F, { 1280, 720 }, 1200.0F,
+											 intercept));
+	EXPECT_FALSE(PaddleAI::predict_intercept({ 600.0F, 360.0F }, 1.5707964F * 3.0F, 10.0F, { 1280, 720 },
+											 1200.0F, intercept));
+}
+
+TEST(paddle_ai, goes_to_intercept) {
+	PaddleAI ai(1);
+	sf::FloatRect paddle({ 1225.0F, 0.0F }, { 45.0F, 225.0F });
+	//The ball goes down-right and crosses the paddle's side below its center
+	for (unsigned int i = 0; i < 100; i++) {
+		paddle.top += ai.update(paddle, { 640.0F, 360.0F }, 0.2F, 10.0F, { 1280, 720 }) * 10.0F;
+	}
+
+	float intercept;
+	PaddleAI::predict_intercept({ 640.0F, 360.0F }, 0.2F, 10.0F, { 1280, 720 }, 1225.0F - 10.0F, intercept);
+	EXPECT_NEAR(intercept, paddle.top + paddle.height * 0.5F, 2.0F);
+}
+
+TEST(paddle_ai, perfect_bots_do_not_miss) {
+	std::unique_ptr<Server> server = create_bot_game(0, 0.0F);
+	PaddleAI player_ai(7);
+	EXPECT_EQ(0U, play_bot_game(*server, player_ai, 20000));
+}
+
+TEST(paddle_ai, weak_bot_misses) {
+	std::unique_ptr<Server> server = create_bot_game(30, 200.0F);
+	PaddleAI player_ai(7);
+	play_bot_game(*server, player_ai, 20000);
+	EXPECT_GT(server->get_player_score(), 0U);
+	EXPECT_EQ(0U, server->get_enemy_score());
+}
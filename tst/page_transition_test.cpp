@@ -0,0 +1,89 @@
+/*
+ * PongX page transition unit test
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "../src/GameManager.hpp"
+
+///Construction time of the page built in the background
+const sf::Time BUILD_TIME = sf::milliseconds(5);
+
+///Window is not opened, only the bookkeeping of the transitions is checked
+static sf::RenderWindow window;
+
+///Threads that deleted the test pages
+static std::mutex deleted_by_mutex;
+static std::thread::id deleted_by[2];
+
+///Page that takes a while to build and remembers the thread that deletes it
+class TransitionTestPage : public Page {
+public:
+	TransitionTestPage(sf::RenderWindow* window, unsigned int index, bool background)
+		: index(index), background(background) {
+		this->window = window;
+		if (background)
+			std::this_thread::sleep_for(std::chrono::microseconds(BUILD_TIME.asMicroseconds()));
+	}
+
+	~TransitionTestPage() override {
+		std::lock_guard<std::mutex> lock(deleted_by_mutex);
+		deleted_by[index] = std::this_thread::get_id();
+	}
+
+	void render() override { };
+	bool delete_in_background() const override { return background; };
+
+private:
+	unsigned int index;
+	bool background;
+};
+
+TEST(page_transition, stats_and_teardown_thread) {
+	GameManager::switch_page(new TransitionTestPage(&window, 0, false));
+	GameManager::run_frame(window);
+
+	ASSERT_TRUE(GameManager::switch_page_async([]() { return new TransitionTestPage(&window, 1, true); }));
+	//One transition at a time
+	EXPECT_FALSE(GameManager::switch_page_async([]() { return new TransitionTestPage(&window, 1, true); }));
+	while (GameManager::is_switching_page()) {
+		GameManager::run_frame(window);
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	PageTransitionStats stats = GameManager::get_last_transition_stats();
+	EXPECT_GE(stats.build_time, BUILD_TIME);
+	EXPECT_GE(stats.latency, stats.build_time);
+	EXPECT_LE(stats.swap_time, stats.latency);
+	//The page that does not allow the background deletion is deleted by the render thread
+	{
+		std::lock_guard<std::mutex> lock(deleted_by_mutex);
+		EXPECT_EQ(std::this_thread::get_id(), deleted_by[0]);
+	}
+
+	//The UI-like page goes to the background
+	GameManager::switch_page(new TransitionTestPage(&window, 0, false));
+	GameManager::run_frame(window);
+	GameManager::close_pages();
+	std::lock_guard<std::mutex> lock(deleted_by_mutex);
+	EXPECT_NE(std::thread::id(), deleted_by[1]);
+	EXPECT_NE(std::this_thread::get_id(), deleted_by[1]);
+}
@@ -0,0 +1,103 @@
+/*
+ * PongX particle system tests
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../src/Render/ParticleSystem.hpp"
+
+///Particles that fly right with the same speed
+static ParticleBurst straight_burst(sf::Vector2f position, unsigned int count, float speed, float life) {
+	ParticleBurst burst;
+	burst.position = position;
+	burst.count = count;
+	burst.min_speed = burst.max_speed = speed;
+	burst.spread = 0;
+	burst.life = life;
+	return burst;
+}
+
+TEST(particle_system, capacity) {
+	ParticleSystem particles(10);
+	particles.emit(straight_burst({ 0, 0 }, 15, 0, 1));
+	EXPECT_EQ(10u, particles.size());
+	EXPECT_EQ(5u, particles.get_dropped());
+}
+
+TEST(particle_system, integrate) {
+	//7 particles: a group of 4 and the rest
+	ParticleSystem particles(100);
+	particles.emit(straight_burst({ 10, 20 }, 7, 100, 1));
+	particles.update(0.5F);
+	ASSERT_EQ(7u, particles.size());
+	for (std::size_t i = 0; i < particles.size(); i++) {
+		EXPECT_NEAR(60.0F, particles.get_position(i).x, 1e-3F);
+		EXPECT_NEAR(20.0F, particles.get_position(i).y, 1e-3F);
+		EXPECT_FLOAT_EQ(0.5F, particles.get_alpha(i));
+	}
+}
+
+TEST(particle_system, forces) {
+	ParticleSystem particles(100, 200, 1);
+	particles.emit(straight_burst({ 0, 0 }, 5, 100, 10));
+	particles.update(0.1F);
+	float damping = std::exp(-0.1F);
+	for (std::size_t i = 0; i < particles.size(); i++) {
+		EXPECT_NEAR(100 * damping * 0.1F, particles.get_position(i).x, 1e-3F);
+		EXPECT_NEAR(200 * 0.1F * 0.1F, particles.get_position(i).y, 1e-3F);
+	}
+}
+
+TEST(particle_system, cull_keeps_order) {
+	ParticleSystem particles(100);
+	for (unsigned int i = 0; i < 10; i++)
+		particles.emit(straight_burst({ static_cast<float>(i), 0 }, 1, 0, i % 3 == 0 ? 0.25F : 1.0F));
+	particles.update(0.5F);
+
+	ASSERT_EQ(6u, particles.size());
+	float expected[] = { 1, 2, 4, 5, 7, 8 };
+	for (std::size_t i = 0; i < particles.size(); i++)
+		EXPECT_EQ(expected[i], particles.get_position(i).x);
+
+	particles.update(0.5F);
+	EXPECT_EQ(0u, particles.size());
+}
+
+TEST(particle_system, vertices) {
+	ParticleSystem particles(100);
+	ParticleBurst burst = straight_burst({ 100, 50 }, 3, 0, 2);
+	burst.size = 4;
+	burst.color = sf::Color(10, 20, 30, 200);
+	particles.emit(burst);
+	particles.update(1.0F);
+
+	std::vector<sf::Vertex> vertices;
+	particles.build_vertices(vertices);
+	ASSERT_EQ(9u, vertices.size());
+	for (unsigned int i = 0; i < 3; i++) {
+		sf::Vector2f center = (vertices[3 * i].position + vertices[3 * i + 1].position +
+							   vertices[3 * i + 2].position) / 3.0F;
+		EXPECT_NEAR(100.0F, center.x, 1e-3F);
+		EXPECT_NEAR(50.0F, center.y, 1e-3F);
+		EXPECT_NEAR(4.0F, center.y - vertices[3 * i].position.y, 1e-3F);
+		//Half of the life is left
+		EXPECT_EQ(sf::Color(10, 20, 30, 100), vertices[3 * i].color);
+	}
+}
@@ -0,0 +1,191 @@
+/*
+ * PongX rollback tests
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "../src/Net/RollbackSession.hpp"
+
+///One direction of the connection between the peers with the latency and the jitter in ticks.
+///Every input is sent twice, the copies may come in any order
+class LoopbackLink {
+public:
+	LoopbackLink(unsigned int delay, unsigned int jitter, unsigned int seed) : randomizer(seed) {
+		this->delay = delay;
+		this->jitter = jitter;
+	}
+
+	void send(unsigned int now, unsigned int tick, PeerInput input) {
+		for (unsigned int copy = 0; copy < 2; copy++) {
+			unsigned int arrival = now + delay + static_cast<unsigned int>(randomizer() % (jitter + 1));
+			messages.push_back({ arrival, tick, input });
+		}
+	}
+
+	///Pass the messages that arrived by now to the session
+	void deliver(unsigned int now, RollbackSession& session) {
+		for (std::size_t i = 0; i < messages.size(); i++) {
+			if (messages[i].arrival > now)
+				continue;
+			ASSERT_TRUE(session.receive_remote_input(messages[i].tick, messages[i].input));
+			messages[i] = messages.back();
+			messages.pop_back();
+			i--;
+		}
+	}
+
+	bool empty() {
+		return messages.empty();
+	}
+
+private:
+	struct Message {
+		unsigned int arrival;
+		unsigned int tick;
+		PeerInput input;
+	};
+
+	unsigned int delay, jitter;
+	gm::Randomizer randomizer;
+	std::vector<Message> messages;
+};
+
+ServerSettings rollback_settings() {
+	ServerSettings settings;
+	settings.window_size = { 1280, 720 };
+	settings.ball_speed = 9.0F;
+	settings.player_rect = sf::FloatRect({ 10, 250 }, { 45, 160 });
+	settings.enemy_rect = sf::FloatRect({ 1225, 250 }, { 45, 160 });
+	settings.seed = 5;
+	return settings;
+}
+
+///Inputs of the peer that change every few ticks
+std::vector<PeerInput> scripted_inputs(unsigned int ticks, unsigned int seed) {
+	gm::Randomizer randomizer(seed);
+	std::vector<PeerInput> inputs(ticks);
+	PeerInput input = 0;
+	for (unsigned int tick = 0; tick < ticks; tick++) {
+		if (randomizer() % 10 == 0)
+			input = static_cast<PeerInput>(static_cast<int>(randomizer() % 255) - 127);
+		inputs[tick] = input;
+	}
+	return inputs;
+}
+
+void expect_same_state(Server& server, Server& reference) {
+	ServerState state, reference_state;
+	server.save_state(state);
+	reference.save_state(reference_state);
+	EXPECT_EQ(state.ball_pos, reference_state.ball_pos);
+	EXPECT_EQ(state.ball_direction, reference_state.ball_direction);
+	EXPECT_EQ(state.player_rect, reference_state.player_rect);
+	EXPECT_EQ(state.enemy_rect, reference_state.enemy_rect);
+	EXPECT_EQ(state.player_score, reference_state.player_score);
+	EXPECT_EQ(state.enemy_score, reference_state.enemy_score);
+	EXPECT_EQ(state.waiting_for_input, reference_state.waiting_for_input);
+	EXPECT_EQ(state.randomizer, reference_state.randomizer);
+	EXPECT_EQ(state.stats.ticks, reference_state.stats.ticks);
+	EXPECT_EQ(state.stats.rallies, reference_state.stats.rallies);
+}
+
+///Play the match over the loopback links and compare both peers with the match played with known inputs
+void play_loopback(unsigned int delay, unsigned int jitter) {
+	const unsigned int TICKS = 3000;
+	std::vector<PeerInput> host_inputs = scripted_inputs(TICKS, 1), client_inputs = scripted_inputs(TICKS, 2);
+
+	RollbackSession host(rollback_settings(), true), client(rollback_settings(), false);
+	LoopbackLink to_host(delay, jitter, 3), to_client(delay, jitter, 4);
+
+	for (unsigned int now = 0; host.get_tick() < TICKS || client.get_tick() < TICKS ||
+		 !to_host.empty() || !to_client.empty(); now++) {
+		to_host.deliver(now, host);
+		to_client.deliver(now, client);
+
+		//The peer that is too far ahead stalls
+		unsigned int tick = host.get_tick();
+		if (tick < TICKS && host.advance(host_inputs[tick]))
+			to_client.send(now, tick, host_inputs[tick]);
+		tick = client.get_tick();
+		if (tick < TICKS && client.advance(client_inputs[tick]))
+			to_host.send(now, tick, client_inputs[tick]);
+		ASSERT_LT(now, TICKS * 10) << "peers do not progress";
+	}
+	host.resimulate();
+	client.resimulate();
+	EXPECT_EQ(host.get_confirmed_tick(), TICKS);
+	EXPECT_EQ(client.get_confirmed_tick(), TICKS);
+	if (delay + jitter > 0) {
+		EXPECT_GT(host.get_rollback_count(), 0U);
+		EXPECT_GT(client.get_rollback_count(), 0U);
+	}
+
+	std::unique_ptr<Server> reference(Server::create([]() {
+		ServerSettings settings = rollback_settings();
+		settings.server_type = LocalNetworkHost;
+		return settings;
+	}()));
+	for (unsigned int tick = 0; tick < TICKS; tick++) {
+		reference->player_relative_speed = host_inputs[tick] / 127.0F;
+		reference->set_enemy_relative_speed(client_inputs[tick] / 127.0F);
+		reference->update();
+	}
+	//Somebody has to score, otherwise the match is too simple to test anything
+	EXPECT_GT(reference->get_player_score() + reference->get_enemy_score(), 0U);
+
+	expect_same_state(host.get_server(), *reference);
+	expect_same_state(client.get_server(), *reference);
+}
+
+TEST(rollback, no_latency) {
+	play_loopback(0, 0);
+}
+
+TEST(rollback, latency_and_jitter) {
+	play_loopback(3, 4);
+	play_loopback(8, 10);
+}
+
+TEST(rollback, latency_over_rollback_window) {
+	//The peers have to stall
+	play_loopback(20, 6);
+}
+
+TEST(rollback, savestate) {
+	std::unique_ptr<Server> server(Server::create([]() {
+		ServerSettings settings = rollback_settings();
+		settings.server_type = LocalNetworkHost;
+		return settings;
+	}()));
+	server->player_relative_speed = 0.5F;
+	ServerState state;
+	server->save_state(state);
+	for (unsigned int i = 0; i < 500; i++)
+		server->update();
+
+	//The same ticks after the restore give the same state
+	std::unique_ptr<Server> copy(Server::create([]() {
+		ServerSettings settings = rollback_settings();
+		settings.server_type = LocalNetworkHost;
+		settings.seed = 77;
+		return settings;
+	}()));
+	copy->load_state(state);
+	for (unsigned int i = 0; i < 500; i++)
+		copy->update();
+	expect_same_state(*copy, *server);
+}
@@ -0,0 +1,87 @@
+/*
+ * PongX tests of the servers specialized at compile time
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "../src/Server/LocalMultiplayerServer.hpp"
+#include "../src/Server/PeerServer.hpp"
+#include "../src/Server/SingleplayerServer.hpp"
+
+ServerSettings core_settings(GameType type) {
+	ServerSettings settings;
+	settings.server_type = type;
+	settings.window_size = { 1280, 720 };
+	settings.seed = 7;
+	return settings;
+}
+
+TEST(server_core, create_picks_policies) {
+	ServerSettings settings = core_settings(Singleplayer);
+	std::unique_ptr<Server> server(Server::create(settings));
+	EXPECT_NE(dynamic_cast<SingleplayerServer<>*>(server.get()), nullptr);
+
+	settings.server_type = LocalMultiplayer;
+	server.reset(Server::create(settings));
+	EXPECT_NE(dynamic_cast<LocalMultiplayerServer<>*>(server.get()), nullptr);
+
+	settings.server_type = LocalNetworkClient;
+	settings.physics = FixedPointPhysics;
+	server.reset(Server::create(settings));
+	EXPECT_NE((dynamic_cast<PeerServer<PaddleCollision, fx::Fixed>*>(server.get())), nullptr);
+
+	settings.physics = FloatPhysics;
+	settings.chaos_balls = 8;
+	server.reset(Server::create(settings));
+	EXPECT_NE(dynamic_cast<PeerServer<MultiBallCollision>*>(server.get()), nullptr);
+
+	settings.chaos_balls = 0;
+	settings.arena.reset(new ArenaMap({ { ArenaMap::Circle, 640.0F, 100.0F, 640.0F, 100.0F, 30.0F } }));
+	server.reset(Server::create(settings));
+	EXPECT_NE(dynamic_cast<PeerServer<ArenaCollision>*>(server.get()), nullptr);
+}
+
+TEST(server_core, step_matches_update) {
+	//The exact type and the type-erased server play the same match
+	ServerSettings settings = core_settings(Singleplayer);
+	std::unique_ptr<Server> server(Server::create(settings));
+	SingleplayerServer<> core(settings);
+	for (unsigned int tick = 0; tick < 20000; tick++) {
+		float speed = (tick & 128) != 0 ? 1.0F : -0.5F;
+		server->player_relative_speed = speed;
+		core.player_relative_speed = speed;
+		server->update();
+		core.step();
+	}
+	EXPECT_GT(core.get_stats().rallies, 0U);
+	EXPECT_EQ(core.state_hash(), server->state_hash());
+}
+
+TEST(server_core, shared_keyboard_input) {
+	//The second player moves the enemy up from the middle
+	ServerSettings settings = core_settings(LocalMultiplayer);
+	settings.enemy_rect.top = 300.0F;
+	LocalMultiplayerServer<> server(settings);
+	InputSnapshot input;
+	input.keys[sf::Keyboard::Up] = true;
+	server.apply_local_input(input);
+	server.step();
+	EXPECT_FALSE(server.is_waiting_for_input());
+	EXPECT_LT(server.get_enemy_rect().top, 300.0F);
+}
@@ -0,0 +1,71 @@
+/*
+ * PongX server statistics unit test
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "../src/Server/Server.hpp"
+
+///Server with the ball placed by the test
+class PlacedBallServer : public Server {
+public:
+	PlacedBallServer(sf::Vector2f ball_pos, float ball_direction, float ball_speed) : Server({ 1280, 720 }) {
+		this->ball_pos = ball_pos;
+		this->ball_direction = ball_direction;
+		this->ball_speed = ball_speed;
+		ball_radius = 10.0F;
+		player_rect = sf::FloatRect({ 10.0F, 250.0F }, { 45.0F, 225.0F });
+		enemy_rect = sf::FloatRect({ 1225.0F, 250.0F }, { 45.0F, 225.0F });
+		waiting_for_input = false;
+	}
+
+	void update() override {
+		internal_update();
+	}
+};
+
+TEST(server_stats, paddle_hit) {
+	//Straight to the left side of the enemy
+	PlacedBallServer server({ 1150.0F, 360.0F }, 0.0F, 10.0F);
+	for (unsigned int i = 0; i < 10; i++)
+		server.update();
+
+	EXPECT_EQ(1U, server.get_stats().segment_collisions[4]);
+	EXPECT_EQ(1U, server.get_stats().current_rally_hits);
+	EXPECT_EQ(0U, server.get_stats().tunneling_events);
+	EXPECT_EQ(10U, server.get_stats().ticks);
+}
+
+TEST(server_stats, tunneling) {
+	//Faster than the paddle is thick: jumps from x = 1200 to x = 1300 over the enemy
+	PlacedBallServer server({ 1200.0F, 360.0F }, 0.0F, 100.0F);
+	server.update();
+
+	EXPECT_EQ(1U, server.get_stats().tunneling_events);
+	EXPECT_EQ(0U, server.get_stats().segment_collisions[4]);
+}
+
+TEST(server_stats, rally) {
+	//The ball passes the enemy below it and the player scores
+	PlacedBallServer server({ 1200.0F, 600.0F }, 0.0F, 10.0F);
+	for (unsigned int i = 0; i < 20; i++)
+		server.update();
+
+	EXPECT_EQ(1U, server.get_player_score());
+	EXPECT_EQ(1U, server.get_stats().rallies);
+	EXPECT_EQ(0U, server.get_stats().current_rally_hits);
+}
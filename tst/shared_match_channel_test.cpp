@@ -0,0 +1,163 @@
+/*
+ * PongX shared match channel tests
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _WIN32
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "../src/Net/SharedMatchChannel.hpp"
+
+///Name of the shared memory unique for the test process
+static std::string channel_name(const char* test) {
+	return std::string("/pongx-test-") + test + '-' + std::to_string(getpid());
+}
+
+///Snapshot whose fields all depend on the number, so a torn read is visible
+static MatchSnapshot numbered_snapshot(std::uint32_t number) {
+	MatchSnapshot snapshot;
+	std::memset(&snapshot, 0, sizeof(snapshot));
+	snapshot.init_header();
+	snapshot.tick = number;
+	snapshot.ball_x = static_cast<float>(number);
+	snapshot.player_score = number;
+	snapshot.reserved = number;
+	return snapshot;
+}
+
+TEST(shared_match_channel, publish_and_read) {
+	std::string name = channel_name("read");
+	std::unique_ptr<SharedMatchChannel> simulation = SharedMatchChannel::create(name);
+	ASSERT_NE(nullptr, simulation);
+	std::unique_ptr<SharedMatchChannel> viewer = SharedMatchChannel::attach(name);
+	ASSERT_NE(nullptr, viewer);
+
+	MatchSnapshot snapshot;
+	EXPECT_FALSE(viewer->read(snapshot));
+	simulation->publish(numbered_snapshot(42));
+	ASSERT_TRUE(viewer->read(snapshot));
+	EXPECT_EQ(42U, snapshot.tick);
+	EXPECT_NE(nullptr, MatchSnapshot::view(&snapshot, sizeof(snapshot)));
+
+	float speed;
+	EXPECT_FALSE(simulation->take_input(speed));
+	viewer->send_input(-0.75F);
+	ASSERT_TRUE(simulation->take_input(speed));
+	EXPECT_EQ(-0.75F, speed);
+
+	//Detach and attach again, the simulation does not notice it
+	viewer.reset();
+	simulation->publish(numbered_snapshot(43));
+	viewer = SharedMatchChannel::attach(name);
+	ASSERT_NE(nullptr, viewer);
+	ASSERT_TRUE(viewer->read(snapshot));
+	EXPECT_EQ(43U, snapshot.tick);
+
+	//The channel is removed with the simulation
+	simulation.reset();
+	EXPECT_EQ(nullptr, SharedMatchChannel::attach(name));
+}
+
+TEST(shared_match_channel, no_torn_reads) {
+	std::string name = channel_name("torn");
+	std::unique_ptr<SharedMatchChannel> simulation = SharedMatchChannel::create(name);
+	std::unique_ptr<SharedMatchChannel> viewer = SharedMatchChannel::attach(name);
+	ASSERT_NE(nullptr, viewer);
+	simulation->publish(numbered_snapshot(0));
+
+	std::atomic<bool> done { false };
+	std::thread writer([&]() {
+		for (std::uint32_t number = 1; number <= 200000; number++)
+			simulation->publish(numbered_snapshot(number));
+		done = true;
+	});
+
+	unsigned int reads = 0;
+	std::uint64_t last_tick = 0;
+	while (!done || reads == 0) {
+		MatchSnapshot snapshot;
+		if (!viewer->read(snapshot))
+			continue;
+		reads++;
+		ASSERT_EQ(snapshot.tick, snapshot.player_score);
+		ASSERT_EQ(snapshot.tick, snapshot.reserved);
+		ASSERT_EQ(static_cast<float>(snapshot.tick), snapshot.ball_x);
+		ASSERT_GE(snapshot.tick, last_tick);
+		last_tick = snapshot.tick;
+	}
+	writer.join();
+	EXPECT_GT(reads, 0U);
+}
+
+TEST(shared_match_channel, name_taken) {
+	std::string name = channel_name("taken");
+	std::unique_ptr<SharedMatchChannel> simulation = SharedMatchChannel::create(name);
+	ASSERT_NE(nullptr, simulation);
+	simulation->publish(numbered_snapshot(7));
+
+	//The second simulation with the same name neither clears nor removes the channel
+	EXPECT_EQ(nullptr, SharedMatchChannel::create(name));
+	std::unique_ptr<SharedMatchChannel> viewer = SharedMatchChannel::attach(name);
+	ASSERT_NE(nullptr, viewer);
+	MatchSnapshot snapshot;
+	ASSERT_TRUE(viewer->read(snapshot));
+	EXPECT_EQ(7U, snapshot.tick);
+}
+
+TEST(shared_match_channel, crashed_viewer) {
+	std::string name = channel_name("crash");
+	std::unique_ptr<SharedMatchChannel> simulation = SharedMatchChannel::create(name);
+	ASSERT_NE(nullptr, simulation);
+	simulation->publish(numbered_snapshot(1));
+
+	pid_t child = fork();
+	ASSERT_GE(child, 0);
+	if (child == 0) {
+		//The viewer sends the input and dies without detaching
+		std::unique_ptr<SharedMatchChannel> viewer = SharedMatchChannel::attach(name);
+		if (viewer)
+			viewer->send_input(1.0F);
+		std::abort();
+	}
+	int status;
+	ASSERT_EQ(child, waitpid(child, &status, 0));
+	EXPECT_TRUE(WIFSIGNALED(status));
+
+	//The input of the dead viewer expires, the simulation goes on
+	float speed;
+	ASSERT_TRUE(simulation->take_input(speed));
+	EXPECT_EQ(1.0F, speed);
+	std::this_thread::sleep_for(std::chrono::milliseconds(SharedMatchChannel::INPUT_TIMEOUT_MS + 50));
+	EXPECT_FALSE(simulation->take_input(speed));
+	simulation->publish(numbered_snapshot(2));
+
+	std::unique_ptr<SharedMatchChannel> viewer = SharedMatchChannel::attach(name);
+	ASSERT_NE(nullptr, viewer);
+	MatchSnapshot snapshot;
+	ASSERT_TRUE(viewer->read(snapshot));
+	EXPECT_EQ(2U, snapshot.tick);
+}
+#endif
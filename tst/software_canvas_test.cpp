@@ -0,0 +1,141 @@
+/*
+ * PongX software rasterizer tests
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+#include "../src/game_math.hpp"
+#include "../src/Render/MatchPainter.hpp"
+
+///Count the pixels of the color
+static unsigned int count_pixels(const SoftwareCanvas& canvas, sf::Color color) {
+	unsigned int count = 0;
+	for (unsigned int y = 0; y < canvas.get_height(); y++) {
+		for (unsigned int x = 0; x < canvas.get_width(); x++)
+			count += canvas.get_pixel(x, y) == color ? 1 : 0;
+	}
+	return count;
+}
+
+TEST(software_canvas, rect_pixel_centers) {
+	SoftwareCanvas canvas(64, 48, 1);
+	canvas.fill_rect({ 10.4F, 20.6F, 5.0F, 3.0F }, sf::Color::Red);
+	canvas.render();
+
+	//Centers x + 0.5 in [10.4;15.4) and y + 0.5 in [20.6;23.6)
+	EXPECT_EQ(15u, count_pixels(canvas, sf::Color::Red));
+	EXPECT_EQ(sf::Color::Red, canvas.get_pixel(10, 21));
+	EXPECT_EQ(sf::Color::Red, canvas.get_pixel(14, 23));
+	EXPECT_EQ(sf::Color::Black, canvas.get_pixel(9, 21));
+	EXPECT_EQ(sf::Color::Black, canvas.get_pixel(15, 21));
+	EXPECT_EQ(sf::Color::Black, canvas.get_pixel(10, 20));
+}
+
+TEST(software_canvas, circle_area) {
+	SoftwareCanvas canvas(200, 200, 1);
+	canvas.fill_circle({ 100.3F, 99.6F }, 50.0F, sf::Color::White);
+	canvas.render();
+	EXPECT_NEAR(3.14159265F * 2500.0F, static_cast<float>(count_pixels(canvas, sf::Color::White)), 30.0F);
+}
+
+TEST(software_canvas, shared_edge_blended_once) {
+	//The halves of the rect share the diagonal, every pixel is covered by exactly one of them
+	SoftwareCanvas canvas(128, 128, 1);
+	canvas.clear(sf::Color::Black);
+	sf::Color half_white(255, 255, 255, 128);
+	canvas.fill_triangle({ 10.3F, 10.7F }, { 100.2F, 10.7F }, { 100.2F, 80.9F }, half_white);
+	canvas.fill_triangle({ 10.3F, 10.7F }, { 100.2F, 80.9F }, { 10.3F, 80.9F }, half_white);
+	canvas.render();
+
+	//Centers x + 0.5 in [10.3;100.2) and y + 0.5 in [10.7;80.9)
+	EXPECT_EQ(90u * 70u, count_pixels(canvas, sf::Color(128, 128, 128)));
+	EXPECT_EQ(128u * 128u - 90u * 70u, count_pixels(canvas, sf::Color::Black));
+}
+
+TEST(software_canvas, text) {
+	SoftwareCanvas canvas(200, 100, 1);
+	canvas.draw_text("1 7", { 20.0F, 10.0F }, 80.0F, sf::Color::Green);
+	canvas.render();
+
+	//Font pixels are 10 x 10: the stem of "1" is the column 2 of the glyph, "7" starts with the full row
+	EXPECT_EQ(sf::Color::Green, canvas.get_pixel(45, 50));
+	EXPECT_EQ(sf::Color::Black, canvas.get_pixel(35, 50));
+	EXPECT_EQ(sf::Color::Green, canvas.get_pixel(145, 15));
+	EXPECT_EQ(sf::Color::Black, canvas.get_pixel(80, 15));
+	EXPECT_FLOAT_EQ(170.0F, SoftwareCanvas::get_text_width("1 7", 80.0F));
+	EXPECT_EQ(2u, canvas.get_command_count());
+}
+
+TEST(software_canvas, threads_match_one_thread) {
+	//The same scene on one thread and on 4 threads, with the shapes across the borders of the tiles
+	SoftwareCanvas single(300, 200, 1), multi(300, 200, 4);
+	gm::Randomizer randomizer(5);
+	for (SoftwareCanvas* canvas : { &single, &multi }) {
+		randomizer.seed(5);
+		canvas->clear(sf::Color(10, 20, 30));
+		for (unsigned int i = 0; i < 300; i++) {
+			sf::Vector2f a(gm::random_number(randomizer, -20, 320), gm::random_number(randomizer, -20, 220));
+			sf::Vector2f b(gm::random_number(randomizer, -20, 320), gm::random_number(randomizer, -20, 220));
+			sf::Color color(static_cast<sf::Uint8>(i * 7), static_cast<sf::Uint8>(i * 13),
+							static_cast<sf::Uint8>(i * 29), static_cast<sf::Uint8>(64 + i % 192));
+			switch (i % 5) {
+				case 0: canvas->fill_rect({ a.x, a.y, 40, 30 }, color); break;
+				case 1: canvas->fill_circle(a, 25, color); break;
+				case 2: canvas->fill_triangle(a, b, { a.x, b.y }, color); break;
+				case 3: canvas->draw_line(a, b, color, 3); break;
+				default: canvas->draw_text("42", a, 24, color);
+			}
+		}
+		canvas->render();
+	}
+	EXPECT_EQ(0, std::memcmp(single.get_pixels(), multi.get_pixels(), 300 * 200 * 4));
+}
+
+TEST(software_canvas, match_painter) {
+	MatchSnapshot snapshot = { };
+	snapshot.init_header();
+	snapshot.window_width = 640;
+	snapshot.window_height = 360;
+	snapshot.ball_x = 200;
+	//Off the border of the pixels, so the 1 pixel line covers exactly one row
+	snapshot.ball_y = 180.2F;
+	snapshot.ball_radius = 10;
+	snapshot.ball_direction = 3.14159265F;
+	snapshot.player_left = 20;
+	snapshot.player_top = 100;
+	snapshot.player_width = 10;
+	snapshot.player_height = 80;
+	snapshot.enemy_left = 610;
+	snapshot.enemy_top = 200;
+	snapshot.enemy_width = 10;
+	snapshot.enemy_height = 80;
+	snapshot.player_score = 3;
+
+	SoftwareCanvas canvas(640, 360, 2);
+	MatchPainter().paint(canvas, snapshot);
+	canvas.render();
+	EXPECT_EQ(sf::Color::White, canvas.get_pixel(25, 140));
+	EXPECT_EQ(sf::Color::White, canvas.get_pixel(615, 250));
+	EXPECT_EQ(sf::Color::White, canvas.get_pixel(205, 185));
+	EXPECT_EQ(sf::Color::White, canvas.get_pixel(320, 300));
+	EXPECT_EQ(sf::Color::Black, canvas.get_pixel(400, 300));
+	//The direction line goes left from the ball
+	EXPECT_EQ(sf::Color::White, canvas.get_pixel(100, 180));
+	EXPECT_EQ(sf::Color::Black, canvas.get_pixel(100, 170));
+}
@@ -0,0 +1,183 @@
+/*
+ * PongX spectator relay tests
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "../src/Net/SpectatorRelay.hpp"
+#include "../src/Server/Server.hpp"
+
+///Spectator in memory that takes at most budget bytes per send() (-1 - the connection is closed)
+class MemoryConnection : public SpectatorConnection {
+public:
+	MemoryConnection(long budget) {
+		this->budget = budget;
+	}
+
+	long send(const SendChunk* chunks, unsigned int count) override {
+		if (budget < 0)
+			return -1;
+		long sent = 0;
+		for (unsigned int i = 0; i < count && sent < budget; i++) {
+			std::size_t size = std::min(chunks[i].size, static_cast<std::size_t>(budget - sent));
+			decoder.feed(chunks[i].data, size);
+			sent += static_cast<long>(size);
+		}
+		return sent;
+	}
+
+	long budget;
+	SpectatorDecoder decoder;
+};
+
+///Match whose snapshots are published, one per tick
+class SpectatedMatch {
+public:
+	SpectatedMatch() {
+		ServerSettings settings;
+		settings.server_type = LocalNetworkHost;
+		settings.window_size = { 1280, 720 };
+		settings.seed = 3;
+		server.reset(Server::create(settings));
+		server->serve();
+	}
+
+	void play(SpectatorRelay& relay, unsigned int ticks) {
+		for (unsigned int i = 0; i < ticks; i++) {
+			server->player_relative_speed = (snapshots.size() & 32) != 0 ? 1.0F : -1.0F;
+			server->update();
+			snapshots.emplace_back();
+			server->write_snapshot(snapshots.back());
+			relay.publish(snapshots.back());
+		}
+	}
+
+	std::unique_ptr<Server> server;
+	///Snapshot of every published tick
+	std::vector<MatchSnapshot> snapshots;
+};
+
+///Decode everything the spectator received and compare it with the published ticks from the first one
+///@returns amount of the decoded ticks
+unsigned int check_stream(SpectatorDecoder& decoder, const SpectatedMatch& match, unsigned int first_tick) {
+	MatchSnapshot snapshot;
+	unsigned int tick = first_tick;
+	while (decoder.next(snapshot)) {
+		const MatchSnapshot& published = match.snapshots[tick++];
+		EXPECT_EQ(published.tick, snapshot.tick);
+		EXPECT_NEAR(published.ball_x, snapshot.ball_x, 0.05F);
+		EXPECT_NEAR(published.player_top, snapshot.player_top, 0.05F);
+		EXPECT_EQ(published.get_enemy_rect().width, snapshot.get_enemy_rect().width);
+	}
+	EXPECT_EQ(0U, decoder.get_errors());
+	return tick - first_tick;
+}
+
+TEST(spectator_relay, delays) {
+	SpectatorRelay relay(100, 50, 10);
+	SpectatedMatch match;
+	match.play(relay, 5);
+
+	MemoryConnection* live = new MemoryConnection(100000);
+	MemoryConnection* delayed = new MemoryConnection(100000);
+	relay.add_viewer(std::unique_ptr<SpectatorConnection>(live), 0);
+	relay.add_viewer(std::unique_ptr<SpectatorConnection>(delayed), 25);
+	match.play(relay, 195);
+
+	//Both start from a keyframe: the live one from the tick 10, the delayed one from the tick 0
+	EXPECT_EQ(190U, check_stream(live->decoder, match, 10));
+	EXPECT_EQ(175U, check_stream(delayed->decoder, match, 0));
+	EXPECT_EQ(200U, relay.get_encoded_frames());
+	EXPECT_EQ(0U, relay.get_dropped_viewers());
+}
+
+TEST(spectator_relay, partial_sends) {
+	SpectatorRelay relay(100, 50, 10);
+	SpectatedMatch match;
+	//Less than a keyframe per send, the frames are split between the calls
+	MemoryConnection* connection = new MemoryConnection(50);
+	relay.add_viewer(std::unique_ptr<SpectatorConnection>(connection), 0);
+	match.play(relay, 300);
+
+	EXPECT_EQ(1U, relay.get_viewer_count());
+	EXPECT_GT(check_stream(connection->decoder, match, 0), 290U);
+}
+
+TEST(spectator_relay, slow_viewers) {
+	SpectatorRelay relay(100, 50, 10);
+	SpectatedMatch match;
+	MemoryConnection* stalled = new MemoryConnection(0);
+	relay.add_viewer(std::unique_ptr<SpectatorConnection>(stalled), 0);
+	relay.add_viewer(std::unique_ptr<SpectatorConnection>(new MemoryConnection(-1)), 0);
+	relay.add_viewer(std::unique_ptr<SpectatorConnection>(new MemoryConnection(100000)), 0);
+
+	match.play(relay, 1);
+	//The closed connection is dropped at once
+	EXPECT_EQ(2U, relay.get_viewer_count());
+	match.play(relay, 49);
+	EXPECT_EQ(2U, relay.get_viewer_count());
+	//The stalled connection is dropped when its backlog is over 50 frames
+	match.play(relay, 1);
+	EXPECT_EQ(1U, relay.get_viewer_count());
+	EXPECT_EQ(2U, relay.get_dropped_viewers());
+}
+
+#ifndef _WIN32
+TEST(spectator_relay, socket) {
+	int sockets[2];
+	ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sockets));
+	SpectatorRelay relay(100, 50, 10);
+	SpectatedMatch match;
+	relay.add_viewer(std::unique_ptr<SpectatorConnection>(new SocketSpectatorConnection(sockets[0])), 0);
+	match.play(relay, 40);
+
+	SpectatorDecoder decoder;
+	char buffer[4096];
+	relay.remove_viewer(0);
+	for (long size; (size = read(sockets[1], buffer, sizeof(buffer))) > 0;)
+		decoder.feed(buffer, static_cast<std::size_t>(size));
+	close(sockets[1]);
+	EXPECT_EQ(40U, check_stream(decoder, match, 0));
+}
+#endif
+
+TEST(spectator_relay, ten_thousand_viewers) {
+	constexpr unsigned int VIEWERS = 10000;
+	SpectatorRelay relay(100, 50, 10);
+	SpectatedMatch match;
+	std::vector<MemoryConnection*> connections;
+	for (unsigned int i = 0; i < VIEWERS; i++) {
+		connections.push_back(new MemoryConnection(100000));
+		relay.add_viewer(std::unique_ptr<SpectatorConnection>(connections.back()), i % 4);
+	}
+	match.play(relay, 20);
+
+	//One encoding per tick for all the spectators
+	EXPECT_EQ(20U, relay.get_encoded_frames());
+	EXPECT_EQ(VIEWERS, relay.get_viewer_count());
+	for (unsigned int i = 0; i < VIEWERS; i += 997)
+		EXPECT_EQ(20U - i % 4, check_stream(connections[i]->decoder, match, 0));
+}
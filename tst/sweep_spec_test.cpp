@@ -0,0 +1,86 @@
+/*
+ * PongX sweep command line unit test
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../tools/sweep/Sweep.hpp"
+
+///Parse the arguments given without the program name
+static bool parse(SweepSpec& spec, std::vector<const char*> arguments, std::string& error) {
+	arguments.insert(arguments.begin(), "pongx_sweep");
+	return spec.parse(static_cast<int>(arguments.size()), arguments.data(), error);
+}
+
+TEST(sweep_spec, grid_and_defaults) {
+	SweepSpec spec;
+	std::string error;
+	ASSERT_TRUE(parse(spec, { "ball_speed=1:2:0.5", "paddle_height=80,120", "--matches", "4" }, error)) << error;
+
+	EXPECT_EQ(std::vector<float>({ 1.0F, 1.5F, 2.0F }), spec.values[BallSpeed]);
+	EXPECT_EQ(std::vector<float>({ 80.0F, 120.0F }), spec.values[PaddleHeight]);
+	EXPECT_EQ(4U, spec.matches);
+	EXPECT_FALSE(spec.random_search);
+	//Not specified parameters have one default value
+	EXPECT_EQ(1U, spec.values[BallRadius].size());
+	EXPECT_EQ(1U, spec.values[AIReactionDelay].size());
+	EXPECT_EQ(3U * 2U, spec.configs().size());
+}
+
+TEST(sweep_spec, random_range) {
+	SweepSpec spec;
+	std::string error;
+	ASSERT_TRUE(parse(spec, { "--random", "10", "ai_error=0:0.5" }, error)) << error;
+
+	EXPECT_TRUE(spec.random_search);
+	EXPECT_EQ(std::vector<float>({ 0.0F, 0.5F }), spec.values[AIError]);
+	EXPECT_EQ(10U, spec.configs().size());
+}
+
+TEST(sweep_spec, invalid_arguments) {
+	const std::vector<std::vector<const char*>> invalid = {
+		{ "unknown=1" }, { "ball_speed=2:1" }, { "ball_speed=1:2:0" }, { "ball_speed=fast" },
+		{ "--random", "0" }, { "--matches" }, { "--matches", "0" }, { "--format", "xml" }
+	};
+	for (const std::vector<const char*>& arguments : invalid) {
+		SweepSpec spec;
+		std::string error;
+		EXPECT_FALSE(parse(spec, arguments, error)) << arguments[0];
+		EXPECT_FALSE(error.empty()) << arguments[0];
+	}
+}
+
+TEST(sweep_spec, out_of_range_values) {
+	const std::vector<const char*> invalid = {
+		"ball_radius=0", "ball_radius=-2,4", "ball_speed=-1:1", "ball_speed=0", "paddle_width=0",
+		"paddle_height=0", "paddle_height=100:721", "ai_reaction_delay=-1", "ai_error=-0.1"
+	};
+	for (const char* argument : invalid) {
+		SweepSpec spec;
+		std::string error;
+		EXPECT_FALSE(parse(spec, { argument }, error)) << argument;
+		EXPECT_FALSE(error.empty()) << argument;
+	}
+
+	//The borders are valid
+	SweepSpec spec;
+	std::string error;
+	EXPECT_TRUE(parse(spec, { "paddle_height=720", "ai_reaction_delay=0", "ai_error=0" }, error)) << error;
+}
@@ -0,0 +1,72 @@
+/*
+ * PongX work-stealing pool unit test
+ * Copyright (C) 2021  Artem Kliminskyi artemklim50@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../src/Utils/WorkStealingPool.hpp"
+
+TEST(work_stealing_pool, runs_every_job) {
+	WorkStealingPool pool(4);
+	std::vector<std::atomic<unsigned int>> runs(1000);
+	for (unsigned int i = 0; i < runs.size(); i++)
+		pool.submit([&runs, i]() { runs[i]++; });
+	pool.wait();
+
+	for (const std::atomic<unsigned int>& count : runs)
+		EXPECT_EQ(1U, count);
+}
+
+TEST(work_stealing_pool, nested_jobs) {
+	WorkStealingPool pool(3);
+	std::atomic<unsigned int> leaves(0);
+	for (unsigned int i = 0; i < 10; i++) {
+		pool.submit([&pool, &leaves]() {
+			for (unsigned int j = 0; j < 10; j++)
+				pool.submit([&leaves]() { leaves++; });
+		});
+	}
+	pool.wait();
+	EXPECT_EQ(100U, leaves);
+}
+
+TEST(work_stealing_pool, idle_workers_steal) {
+	WorkStealingPool pool(4);
+	//All jobs are submitted from one worker, so they go to its queue and the others have to steal them
+	pool.submit([&pool]() {
+		for (unsigned int i = 0; i < 64; i++)
+			pool.submit([]() { std::this_thread::sleep_for(std::chrono::milliseconds(1)); });
+	});
+	pool.wait();
+	EXPECT_GT(pool.get_steal_count(), 0U);
+}
+
+TEST(work_stealing_pool, reuse) {
+	WorkStealingPool pool(2);
+	std::atomic<unsigned int> count(0);
+	for (unsigned int round = 0; round < 3; round++) {
+		for (unsigned int i = 0; i < 50; i++)
+			pool.submit([&count]() { count++; });
+		pool.wait();
+		EXPECT_EQ((round + 1) * 50, count);
+	}
+}